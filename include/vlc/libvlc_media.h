@@ -100,6 +100,12 @@ enum
     libvlc_media_option_unique = 0x100
 };
 
+/**
+ * Media statistics, filled by libvlc_media_get_stats().
+ *
+ * \note The stream output fields were added in LibVLC 4.0.0, changing the
+ * size of the structure.
+ */
 typedef struct libvlc_media_stats_t
 {
     /* Input */
@@ -124,6 +130,22 @@ typedef struct libvlc_media_stats_t
     /* Audio output */
     uint64_t     i_played_abuffers;
     uint64_t     i_lost_abuffers;
+
+    /* Stream output */
+    uint64_t     i_sout_fifo_blocks;  /**< blocks queued before the muxers */
+    uint64_t     i_sout_fifo_bytes;
+    uint64_t     i_sout_fifo_peak;    /**< deepest muxer input queue */
+    uint64_t     i_sout_muxed_blocks;
+    int64_t      i_sout_mux_wait;     /**< average queueing delay (us) */
+    int64_t      i_sout_mux_wait_max; /**< (us) */
+    uint64_t     i_sent_packets;
+    uint64_t     i_sent_bytes;
+    float        f_send_bitrate;
+    int64_t      i_sout_write_latency;     /**< average write time (us) */
+    int64_t      i_sout_write_latency_max; /**< (us) */
+    uint64_t     i_sout_write_errors;
+    uint64_t     i_sout_dropped;
+    uint64_t     i_sout_late;
 } libvlc_media_stats_t;
 
 /**
@@ -71,7 +71,9 @@ VLC_API void vlc_input_decoder_Delete( vlc_input_decoder_t * decoder);
  *
  * @param p_dec the decoder object
  * @param frame the data frame
- * @param do_pace whether we wait for some decoding to happen or not
+ * @param do_pace whether we wait for some decoding to happen or not, i.e.
+ *        whether the buffered duration and size are limited by
+ *        "decoder-fifo-duration" and "decoder-fifo-size"
  */
 VLC_API void vlc_input_decoder_Decode( vlc_input_decoder_t *p_dec, struct vlc_frame_t *frame, bool do_pace );
 
@@ -113,6 +113,10 @@ enum es_out_query_e
     ES_OUT_SPU_SET_HIGHLIGHT, /* arg1= es_out_id_t* (spu es),
                                  arg2= const vlc_spu_highlight_t *, res=can fail  */
 
+    /* Scale the playback rate chosen by the user by a small factor, ie. to
+     * catch up with a live edge. 1.0 restores the user rate. */
+    ES_OUT_SET_RATE_CORRECTION, /* arg1=double, res=can fail */
+
     /* First value usable for private control */
     ES_OUT_PRIVATE_START = 0x10000,
 };
@@ -117,6 +117,8 @@ struct vlc_frame_callbacks
     void (*free)(vlc_frame_t *);
 };
 
+struct vlc_frame_payload;
+
 struct vlc_frame_t
 {
     vlc_frame_t    *p_next;
@@ -136,6 +138,7 @@ struct vlc_frame_t
     vlc_ancillary_array ancillaries;
 
     const struct vlc_frame_callbacks *cbs;
+    struct vlc_frame_payload *payload; /**< Shared payload, or NULL */
 };
 
 /**
@@ -324,6 +327,37 @@ static inline vlc_frame_t *vlc_frame_Duplicate( const vlc_frame_t *frame )
     return p_dup;
 }
 
+/**
+ * Shares the payload of a frame.
+ *
+ * Creates a new frame with the same properties and referencing the same
+ * payload as the given frame, without copying it. The payload is released
+ * with the last frame referencing it.
+ *
+ * Frames sharing a payload must not modify it in place: use
+ * vlc_frame_Writable() first. vlc_frame_Realloc() and vlc_frame_TryRealloc()
+ * copy the payload before growing it.
+ *
+ * @param frame the frame to share (it must not be used from another thread
+ *        during this call)
+ * @return the new frame on success, NULL on error.
+ */
+VLC_API vlc_frame_t *vlc_frame_Share(vlc_frame_t *frame) VLC_USED;
+
+/**
+ * Makes the payload of a frame writable.
+ *
+ * If the payload is shared with other frames (see vlc_frame_Share()), it is
+ * copied into a new frame, and the given frame is released. Otherwise, the
+ * frame is returned as is.
+ *
+ * @param frame the frame to modify, which will be freed if it is copied
+ * @return a frame whose payload can be modified in place, or NULL on error.
+ *
+ * @note On error, the frame is discarded.
+ */
+VLC_API vlc_frame_t *vlc_frame_Writable(vlc_frame_t *frame) VLC_USED;
+
 /**
  * Wraps heap in a frame.
  *
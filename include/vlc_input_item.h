@@ -550,6 +550,22 @@ struct input_stats_t
     /* Aout */
     uint64_t i_played_abuffers;
     uint64_t i_lost_abuffers;
+
+    /* Stream output */
+    uint64_t i_sout_fifo_blocks;      /**< Blocks queued before the muxers */
+    uint64_t i_sout_fifo_bytes;       /**< Bytes queued before the muxers */
+    uint64_t i_sout_fifo_peak;        /**< Deepest muxer input fifo */
+    uint64_t i_sout_muxed_blocks;
+    vlc_tick_t i_sout_mux_wait;       /**< Average wait before muxing */
+    vlc_tick_t i_sout_mux_wait_max;
+    uint64_t i_sent_packets;
+    uint64_t i_sent_bytes;
+    float f_send_bitrate;
+    vlc_tick_t i_sout_write_latency;  /**< Average access output write */
+    vlc_tick_t i_sout_write_latency_max;
+    uint64_t i_sout_write_errors;
+    uint64_t i_sout_dropped;          /**< Blocks dropped by the muxers */
+    uint64_t i_sout_late;             /**< Blocks too late for the muxers */
 };
 
 /**
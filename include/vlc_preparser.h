@@ -47,7 +47,8 @@ typedef struct vlc_preparser_t vlc_preparser_t;
  * Preparser request opaque handle.
  *
  * Identifies a request submitted via vlc_preparser_Push(),
- * vlc_preparser_GenerateThumbnail(), or vlc_preparser_GenerateThumbnailToFiles().
+ * vlc_preparser_GenerateThumbnail(), vlc_preparser_GenerateThumbnailToFiles()
+ * or vlc_preparser_GenerateThumbnailSheet().
  * It can be passed to vlc_preparser_Cancel() to cancel that request.
  *
  * @note
@@ -64,6 +65,7 @@ typedef struct vlc_preparser_req vlc_preparser_req;
 #define VLC_PREPARSER_TYPE_FETCHMETA_NET    0x04
 #define VLC_PREPARSER_TYPE_THUMBNAIL        0x08
 #define VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES 0x10
+#define VLC_PREPARSER_TYPE_THUMBNAIL_SHEET  0x20
 #define VLC_PREPARSER_TYPE_FETCHMETA_ALL \
     (VLC_PREPARSER_TYPE_FETCHMETA_LOCAL|VLC_PREPARSER_TYPE_FETCHMETA_NET)
 
@@ -222,6 +224,53 @@ struct vlc_thumbnailer_arg
     bool hw_dec;
 };
 
+/**
+ * Preparser thumbnail sheet callbacks
+ *
+ * Used by vlc_preparser_GenerateThumbnailSheet()
+ */
+struct vlc_thumbnailer_sheet_cbs
+{
+    /**
+     * Event received for each generated thumbnail
+     *
+     * @note This callback is optional. It is called from the thumbnailer
+     * thread, in the order of the requested points, as soon as the thumbnail
+     * is decoded.
+     *
+     * @param req request handle returned by
+     * vlc_preparser_GenerateThumbnailSheet()
+     * @param index index of the point in the request
+     * @param thumbnail the thumbnail, scaled to the tile size. It is owned by
+     * the thumbnailer, and must be acquired with picture_Hold() to be used
+     * outside of this callback.
+     * @param data opaque pointer passed by
+     * vlc_preparser_GenerateThumbnailSheet()
+     */
+    void (*on_thumbnail)(vlc_preparser_req *req, size_t index,
+                         picture_t *thumbnail, void *data);
+
+    /**
+     * Event received on completion or error
+     *
+     * @note This callback is mandatory.
+     *
+     * @param req request handle returned by
+     * vlc_preparser_GenerateThumbnailSheet()
+     * @param status VLC_SUCCESS if at least one thumbnail was generated and
+     * all the files were written, VLC_ETIMEOUT in case of timeout, -EINTR if
+     * cancelled, an error otherwise
+     * @param sheet the tiled picture if the request asked for one and
+     * status is VLC_SUCCESS, NULL otherwise. It is owned by the thumbnailer,
+     * and must be acquired with picture_Hold() to be used outside of this
+     * callback.
+     * @param data opaque pointer passed by
+     * vlc_preparser_GenerateThumbnailSheet()
+     */
+    void (*on_ended)(vlc_preparser_req *req, int status, picture_t *sheet,
+                     void *data);
+};
+
 /**
  * Thumbnailer output format
  */
@@ -271,6 +320,62 @@ struct vlc_thumbnailer_output
     unsigned int creat_mode;
 };
 
+/**
+ * Thumbnail sheet argument
+ *
+ * Used by vlc_preparser_GenerateThumbnailSheet()
+ */
+struct vlc_thumbnailer_sheet_arg
+{
+    /** Points of the media to take a thumbnail at */
+    struct
+    {
+        enum
+        {
+            /** count points evenly spaced over the media (default) */
+            VLC_THUMBNAILER_POINTS_SPACED,
+            /** count times, from the times array */
+            VLC_THUMBNAILER_POINTS_TIME,
+            /** count positions, from the positions array */
+            VLC_THUMBNAILER_POINTS_POS,
+        } type;
+        union
+        {
+            /** Times if type == VLC_THUMBNAILER_POINTS_TIME */
+            const vlc_tick_t *times;
+            /** Positions if type == VLC_THUMBNAILER_POINTS_POS */
+            const double *positions;
+        };
+        /** Number of points, must be > 0 */
+        size_t count;
+    } points;
+
+    /**
+     * Size of a tile, thumbnails are scaled to it
+     *
+     * If one of them is 0, it is computed from the other one and the aspect
+     * ratio of the first thumbnail. If both are 0, the thumbnails are not
+     * scaled.
+     */
+    unsigned tile_width;
+    unsigned tile_height;
+
+    /**
+     * Number of tiles per row of the sheet, 0 for a square-ish sheet. Only
+     * used if tiled is true.
+     */
+    unsigned columns;
+
+    /** True to assemble the thumbnails into a single tiled picture */
+    bool tiled;
+
+    /** True to only decode key frames (false by default) */
+    bool keyframes_only;
+
+    /** True to enable hardware decoder (false by default) */
+    bool hw_dec;
+};
+
 /**
  * Preparser creation configuration
  */
@@ -401,6 +506,38 @@ vlc_preparser_GenerateThumbnailToFiles( vlc_preparser_t *preparser, input_item_t
                                         const struct vlc_thumbnailer_to_files_cbs *cbs,
                                         void *cbs_userdata );
 
+/**
+ * This function generates thumbnails at several points of a media
+ *
+ * The media is opened once, and each point is reached by a fast seek, so
+ * that the thumbnail is the nearest key frame.
+ *
+ * @param preparser the preparser object
+ * @param item a valid item to generate the thumbnails for
+ * @param arg pointer to the arg struct (can't be NULL)
+ * @param outputs array of outputs, can be NULL. If arg->tiled is true, the
+ * sheet is written to each output. Otherwise, output_count must be equal to
+ * arg->points.count, and the thumbnail of each point is written to the
+ * output of the same index.
+ * @param output_count outputs array size
+ * @param cbs callback to listen to events (can't be NULL)
+ * @param cbs_userdata opaque pointer used by the callbacks
+ * @return NULL in case of error, or a valid request handle if the
+ * item was scheduled for thumbnailing. If this returns an
+ * error, the on_ended callback will *not* be invoked
+ *
+ * The provided input_item will be held by the thumbnailer and can safely be
+ * released safely after calling this function.
+ */
+VLC_API vlc_preparser_req *
+vlc_preparser_GenerateThumbnailSheet( vlc_preparser_t *preparser,
+                                      input_item_t *item,
+                                      const struct vlc_thumbnailer_sheet_arg *arg,
+                                      const struct vlc_thumbnailer_output *outputs,
+                                      size_t output_count,
+                                      const struct vlc_thumbnailer_sheet_cbs *cbs,
+                                      void *cbs_userdata );
+
 /**
  * This function cancels ongoing or queued preparsing/thumbnail generation
  * for a given request handle.
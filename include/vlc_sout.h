@@ -155,6 +155,15 @@ VLC_API int sout_MuxSendBuffer( sout_mux_t *, sout_input_t  *, block_t * );
 VLC_API int sout_MuxGetStream(sout_mux_t *, unsigned, vlc_tick_t *);
 VLC_API void sout_MuxFlush( sout_mux_t *, sout_input_t * );
 
+/**
+ * Releases a block the muxer could not use and accounts it in the stream
+ * output statistics.
+ *
+ * \param late true if the block was discarded because it came too late,
+ *             false if it was unusable (e.g. not dated)
+ */
+VLC_API void sout_MuxDropBlock( sout_mux_t *, block_t *, bool late );
+
 static inline int sout_MuxControl( sout_mux_t *p_mux, int i_query, ... )
 {
     va_list args;
@@ -329,6 +329,20 @@ VLC_API void subpicture_Update( subpicture_t *, const video_format_t *src, const
  */
 VLC_API unsigned picture_BlendSubpicture( picture_t *, vlc_blender_t *, vlc_render_subpicture * );
 
+/**
+ * This function will copy a picture and blend a given subpicture onto the
+ * copy, in a single pass.
+ *
+ * It is equivalent to picture_Copy() followed by picture_BlendSubpicture(),
+ * but the lines covered by the subpicture regions are blended right after
+ * being copied, and the other lines are copied straight.
+ *
+ * The same restrictions as picture_BlendSubpicture() apply.
+ * \return the number of region(s) successfully blent
+ */
+VLC_API unsigned picture_CopyBlendSubpicture( picture_t *dst, const picture_t *src,
+                                              vlc_blender_t *, vlc_render_subpicture * );
+
 /**
  * Create a vlc_render_subpicture.
  *
@@ -651,6 +651,24 @@ bool libvlc_media_get_stats(libvlc_media_t *p_md,
     p_stats->i_played_abuffers = p_itm_stats->i_played_abuffers;
     p_stats->i_lost_abuffers = p_itm_stats->i_lost_abuffers;
 
+    p_stats->i_sout_fifo_blocks = p_itm_stats->i_sout_fifo_blocks;
+    p_stats->i_sout_fifo_bytes = p_itm_stats->i_sout_fifo_bytes;
+    p_stats->i_sout_fifo_peak = p_itm_stats->i_sout_fifo_peak;
+    p_stats->i_sout_muxed_blocks = p_itm_stats->i_sout_muxed_blocks;
+    p_stats->i_sout_mux_wait = US_FROM_VLC_TICK(p_itm_stats->i_sout_mux_wait);
+    p_stats->i_sout_mux_wait_max =
+        US_FROM_VLC_TICK(p_itm_stats->i_sout_mux_wait_max);
+    p_stats->i_sent_packets = p_itm_stats->i_sent_packets;
+    p_stats->i_sent_bytes = p_itm_stats->i_sent_bytes;
+    p_stats->f_send_bitrate = p_itm_stats->f_send_bitrate;
+    p_stats->i_sout_write_latency =
+        US_FROM_VLC_TICK(p_itm_stats->i_sout_write_latency);
+    p_stats->i_sout_write_latency_max =
+        US_FROM_VLC_TICK(p_itm_stats->i_sout_write_latency_max);
+    p_stats->i_sout_write_errors = p_itm_stats->i_sout_write_errors;
+    p_stats->i_sout_dropped = p_itm_stats->i_sout_dropped;
+    p_stats->i_sout_late = p_itm_stats->i_sout_late;
+
     vlc_mutex_unlock( &item->lock );
     return true;
 }
@@ -66,8 +66,23 @@ typedef struct
     int fd;
 
     bool b_pace_control;
+#ifdef HAVE_POSIX_FADVISE
+    bool b_drop_behind;
+    size_t i_readahead;
+    uint64_t i_offset; /**< current file offset */
+    uint64_t i_linear; /**< offset where linear reading started */
+    uint64_t i_advised; /**< end of the read-ahead window */
+    uint64_t i_dropped; /**< end of the data dropped from the cache */
+#endif
 } access_sys_t;
 
+#ifdef HAVE_POSIX_FADVISE
+/* Minimum amount of linear reading before read-ahead is requested */
+# define LINEAR_THRESHOLD (256 << 10)
+/* Granularity of drop-behind requests */
+# define DROP_BEHIND_CHUNK (4 << 20)
+#endif
+
 #if !defined (_WIN32) && !defined (__OS2__)
 static bool IsRemote (int fd)
 {
@@ -252,6 +267,14 @@ int FileOpen( vlc_object_t *p_this )
     p_access->pf_control = FileControl;
     p_access->p_sys = p_sys;
     p_sys->fd = fd;
+#ifdef HAVE_POSIX_FADVISE
+    p_sys->b_drop_behind = false;
+    p_sys->i_readahead = 0;
+    p_sys->i_offset = 0;
+    p_sys->i_linear = 0;
+    p_sys->i_advised = 0;
+    p_sys->i_dropped = 0;
+#endif
 
     if (S_ISREG (st.st_mode) || S_ISBLK (st.st_mode))
     {
@@ -262,6 +285,13 @@ int FileOpen( vlc_object_t *p_this )
         posix_fadvise (fd, 0, 4096, POSIX_FADV_WILLNEED);
         /* In most cases, we only read the file once. */
         posix_fadvise (fd, 0, 0, POSIX_FADV_NOREUSE);
+#ifdef HAVE_POSIX_FADVISE
+        p_sys->i_readahead = var_InheritInteger (p_access, "file-readahead")
+                             << 10;
+        p_sys->b_drop_behind = var_InheritBool (p_access, "file-drop-behind");
+        if (p_sys->i_readahead > 0)
+            posix_fadvise (fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 #ifdef F_NOCACHE
         fcntl (fd, F_NOCACHE, 0);
 #endif
@@ -303,6 +333,39 @@ void FileClose (vlc_object_t * p_this)
     vlc_close (p_sys->fd);
 }
 
+#ifdef HAVE_POSIX_FADVISE
+/**
+ * Gives the operating system hints about upcoming and past reads.
+ *
+ * Once the file has been read linearly for a while, the kernel is asked to
+ * read the next window in advance. With drop-behind, data that has been read
+ * already is evicted from the page cache, so that a one-pass batch job does
+ * not push everything else out of the cache.
+ */
+static void FileAdvise (access_sys_t *p_sys)
+{
+    const uint64_t offset = p_sys->i_offset;
+
+    if (p_sys->i_readahead > 0
+     && offset - p_sys->i_linear >= LINEAR_THRESHOLD
+     && offset + p_sys->i_readahead / 2 >= p_sys->i_advised)
+    {
+        uint64_t start = __MAX(offset, p_sys->i_advised);
+        uint64_t end = offset + p_sys->i_readahead;
+
+        posix_fadvise (p_sys->fd, start, end - start, POSIX_FADV_WILLNEED);
+        p_sys->i_advised = end;
+    }
+
+    if (p_sys->b_drop_behind
+     && offset - p_sys->i_dropped >= DROP_BEHIND_CHUNK)
+    {
+        posix_fadvise (p_sys->fd, p_sys->i_dropped,
+                       offset - p_sys->i_dropped, POSIX_FADV_DONTNEED);
+        p_sys->i_dropped = offset;
+    }
+}
+#endif
 
 static ssize_t Read (stream_t *p_access, void *p_buffer, size_t i_len)
 {
@@ -323,6 +386,14 @@ static ssize_t Read (stream_t *p_access, void *p_buffer, size_t i_len)
         val = 0;
     }
 
+#ifdef HAVE_POSIX_FADVISE
+    if (val > 0 && p_access->pf_seek != NULL)
+    {
+        p_sys->i_offset += val;
+        FileAdvise (p_sys);
+    }
+#endif
+
     return val;
 }
 
@@ -335,6 +406,18 @@ static int FileSeek (stream_t *p_access, uint64_t i_pos)
 
     if (lseek(sys->fd, i_pos, SEEK_SET) == (off_t)-1)
         return VLC_EGENERIC;
+
+#ifdef HAVE_POSIX_FADVISE
+    if (sys->b_drop_behind && sys->i_offset > sys->i_dropped)
+        posix_fadvise (sys->fd, sys->i_dropped,
+                       sys->i_offset - sys->i_dropped, POSIX_FADV_DONTNEED);
+
+    /* Linear reading starts over */
+    sys->i_offset = i_pos;
+    sys->i_linear = i_pos;
+    sys->i_advised = i_pos;
+    sys->i_dropped = i_pos;
+#endif
     return VLC_SUCCESS;
 }
 
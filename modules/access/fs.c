@@ -38,6 +38,19 @@ vlc_module_begin ()
     add_shortcut( "file", "fd", "stream" )
     set_callbacks( FileOpen, FileClose )
 
+#ifdef HAVE_POSIX_FADVISE
+    add_integer("file-readahead", 2048, N_("Read-ahead (KiB)"),
+                N_("Amount of data the operating system is asked to read "
+                   "in advance while a file is read linearly. "
+                   "0 disables read-ahead hints."))
+        change_integer_range(0, 1 << 20)
+    add_bool("file-drop-behind", false, N_("Drop read data from the cache"),
+             N_("Evict file data from the operating system cache once it "
+                "has been read. This avoids evicting everything else from "
+                "the cache when large files are processed only once, "
+                "e.g. by batch conversion jobs."))
+#endif
+
     add_submodule()
     set_section( N_("Directory" ), NULL )
     set_capability( "access", 55 )
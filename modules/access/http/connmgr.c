@@ -24,7 +24,9 @@
 
 #include <assert.h>
 #include <vlc_common.h>
+#include <vlc_list.h>
 #include <vlc_network.h>
+#include <vlc_threads.h>
 #include <vlc_tls.h>
 #include <vlc_url.h>
 #include "transport.h"
@@ -96,50 +98,129 @@ static char *vlc_http_proxy_find(const char *hostname, unsigned port,
 }
 
 
+/* Connections kept alive per manager, and for how long once unused */
+#define VLC_HTTP_POOL_SIZE 8
+#define VLC_HTTP_POOL_IDLE VLC_TICK_FROM_SEC(30)
+
+struct vlc_http_mgr_conn
+{
+    struct vlc_http_conn *conn;
+    char *host;
+    unsigned port;
+    bool secure;
+    vlc_tick_t last_use;
+    struct vlc_list node;
+};
+
 struct vlc_http_mgr
 {
     struct vlc_logger *logger;
     vlc_object_t *obj;
     vlc_tls_client_t *creds;
     struct vlc_http_cookie_jar_t *jar;
-    struct vlc_http_conn *conn;
+    struct vlc_list conns; /**< Pooled connections, most recent first */
+    size_t conn_count;
+    unsigned hits;
+    unsigned misses;
 };
 
-static struct vlc_http_conn *vlc_http_mgr_find(struct vlc_http_mgr *mgr,
-                                               const char *host, unsigned port)
+static void vlc_http_mgr_release(struct vlc_http_mgr *mgr,
+                                 struct vlc_http_mgr_conn *entry)
 {
-    (void) host; (void) port;
-    return mgr->conn;
+    assert(mgr->conn_count > 0);
+    vlc_list_remove(&entry->node);
+    mgr->conn_count--;
+
+    vlc_http_conn_release(entry->conn);
+    free(entry->host);
+    free(entry);
 }
 
-static void vlc_http_mgr_release(struct vlc_http_mgr *mgr,
-                                 struct vlc_http_conn *conn)
+static void vlc_http_mgr_expire(struct vlc_http_mgr *mgr)
 {
-    assert(mgr->conn == conn);
-    mgr->conn = NULL;
+    struct vlc_http_mgr_conn *entry;
+    const vlc_tick_t now = vlc_tick_now();
+
+    vlc_list_foreach(entry, &mgr->conns, node)
+        if (now - entry->last_use >= VLC_HTTP_POOL_IDLE)
+            vlc_http_mgr_release(mgr, entry);
+}
 
-    vlc_http_conn_release(conn);
+static struct vlc_http_mgr_conn *vlc_http_mgr_add(struct vlc_http_mgr *mgr,
+                                                  bool secure,
+                                                  const char *host,
+                                                  unsigned port,
+                                                  struct vlc_http_conn *conn)
+{
+    struct vlc_http_mgr_conn *entry = malloc(sizeof (*entry));
+    if (unlikely(entry == NULL))
+        return NULL;
+
+    entry->host = strdup(host);
+    if (unlikely(entry->host == NULL))
+    {
+        free(entry);
+        return NULL;
+    }
+
+    if (mgr->conn_count >= VLC_HTTP_POOL_SIZE)
+    {   /* Evict the least recently used connection */
+        struct vlc_http_mgr_conn *oldest =
+            vlc_list_last_entry_or_null(&mgr->conns, struct vlc_http_mgr_conn,
+                                        node);
+        vlc_http_mgr_release(mgr, oldest);
+    }
+
+    entry->conn = conn;
+    entry->port = port;
+    entry->secure = secure;
+    entry->last_use = vlc_tick_now();
+    vlc_list_prepend(&entry->node, &mgr->conns);
+    mgr->conn_count++;
+    return entry;
+}
+
+static struct vlc_http_msg *vlc_http_conn_request(struct vlc_http_conn *conn,
+                                                  const struct vlc_http_msg *req,
+                                                  bool payload)
+{
+    struct vlc_http_stream *stream = vlc_http_stream_open(conn, req, payload);
+    if (stream == NULL)
+        return NULL;
+    return vlc_http_msg_get_initial(stream);
 }
 
 static
-struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr,
+struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr, bool secure,
                                         const char *host, unsigned port,
                                         const struct vlc_http_msg *req,
                                         bool payload)
 {
-    struct vlc_http_conn *conn = vlc_http_mgr_find(mgr, host, port);
-    if (conn == NULL)
-        return NULL;
+    struct vlc_http_mgr_conn *entry;
 
-    struct vlc_http_stream *stream = vlc_http_stream_open(conn, req, payload);
-    if (stream != NULL)
+    vlc_http_mgr_expire(mgr);
+
+    vlc_list_foreach(entry, &mgr->conns, node)
     {
-        struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
+        if (entry->secure != secure || entry->port != port
+         || strcasecmp(entry->host, host))
+            continue;
+
+        /* HTTP/2 connections accept concurrent streams, so the same one
+         * serves all requests to a given origin. */
+        struct vlc_http_msg *m = vlc_http_conn_request(entry->conn, req,
+                                                       payload);
         if (m != NULL)
+        {
+            entry->last_use = vlc_tick_now();
+            vlc_list_remove(&entry->node);
+            vlc_list_prepend(&entry->node, &mgr->conns);
+            mgr->hits++;
             return m;
+        }
+        /* Get rid of closing or reset connection */
+        vlc_http_mgr_release(mgr, entry);
     }
-    /* Get rid of closing or reset connection */
-    vlc_http_mgr_release(mgr, conn);
     return NULL;
 }
 
@@ -151,8 +232,8 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
     vlc_tls_t *tls;
     bool http2 = true;
 
-    if (mgr->creds == NULL && mgr->conn != NULL)
-        return NULL; /* switch from HTTP to HTTPS not implemented */
+    if (port == 0)
+        port = 443;
 
     if (mgr->creds == NULL)
     {   /* First TLS connection: load x509 credentials */
@@ -167,12 +248,14 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
          * the nonidempotent request was processed if the connection fails
          * before the response is received.
          */
-        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, host, port, req,
-                                                       payload);
+        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, true, host, port,
+                                                       req, payload);
         if (resp != NULL)
             return resp; /* existing connection reused */
     }
 
+    mgr->misses++;
+
     char *proxy = vlc_http_proxy_find(host, port, true);
     if (proxy != NULL)
     {
@@ -206,11 +289,18 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
+    struct vlc_http_mgr_conn *entry = vlc_http_mgr_add(mgr, true, host, port,
+                                                       conn);
+    if (unlikely(entry == NULL))
+    {
+        vlc_http_conn_release(conn);
+        return NULL;
+    }
 
-    mgr->conn = conn;
-    return vlc_http_mgr_reuse(mgr, host, port, req, payload);
+    struct vlc_http_msg *resp = vlc_http_conn_request(conn, req, payload);
+    if (resp == NULL)
+        vlc_http_mgr_release(mgr, entry);
+    return resp;
 }
 
 static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
@@ -218,17 +308,19 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
                                              const struct vlc_http_msg *req,
                                              bool idempotent, bool payload)
 {
-    if (mgr->creds != NULL && mgr->conn != NULL)
-        return NULL; /* switch from HTTPS to HTTP not implemented */
+    if (port == 0)
+        port = 80;
 
     if (idempotent)
     {
-        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, host, port, req,
-                                                       payload);
+        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, false, host, port,
+                                                       req, payload);
         if (resp != NULL)
             return resp;
     }
 
+    mgr->misses++;
+
     struct vlc_http_conn *conn;
     struct vlc_http_stream *stream;
 
@@ -250,7 +342,7 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
         vlc_UrlClean(&url);
     }
     else
-        stream = vlc_h1_request(mgr->logger, host, port ? port : 80, false,
+        stream = vlc_h1_request(mgr->logger, host, port, false,
                                 req, idempotent, payload, &conn);
 
     if (stream == NULL)
@@ -263,10 +355,8 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
-
-    mgr->conn = conn;
+    if (vlc_http_mgr_add(mgr, false, host, port, conn) == NULL)
+        vlc_http_conn_release(conn); /* not reusable, closed after use */
     return resp;
 }
 
@@ -287,6 +377,13 @@ struct vlc_http_cookie_jar_t *vlc_http_mgr_get_jar(struct vlc_http_mgr *mgr)
     return mgr->jar;
 }
 
+void vlc_http_mgr_get_stats(const struct vlc_http_mgr *mgr,
+                            unsigned *restrict hits, unsigned *restrict misses)
+{
+    *hits = mgr->hits;
+    *misses = mgr->misses;
+}
+
 struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
                                          struct vlc_http_cookie_jar_t *jar)
 {
@@ -298,14 +395,24 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
     mgr->obj = obj;
     mgr->creds = NULL;
     mgr->jar = jar;
-    mgr->conn = NULL;
+    vlc_list_init(&mgr->conns);
+    mgr->conn_count = 0;
+    mgr->hits = 0;
+    mgr->misses = 0;
     return mgr;
 }
 
 void vlc_http_mgr_destroy(struct vlc_http_mgr *mgr)
 {
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
+    struct vlc_http_mgr_conn *entry;
+
+    if (mgr->hits + mgr->misses > 0)
+        vlc_http_dbg(mgr->logger, "connection pool: %u hit(s), %u miss(es)",
+                     mgr->hits, mgr->misses);
+
+    vlc_list_foreach(entry, &mgr->conns, node)
+        vlc_http_mgr_release(mgr, entry);
+    assert(mgr->conn_count == 0);
     if (mgr->creds != NULL)
         vlc_tls_ClientDelete(mgr->creds);
     free(mgr);
@@ -57,6 +57,19 @@ struct vlc_http_msg *vlc_http_mgr_request(struct vlc_http_mgr *mgr, bool https,
 
 struct vlc_http_cookie_jar_t *vlc_http_mgr_get_jar(struct vlc_http_mgr *);
 
+/**
+ * Gets connection pool statistics
+ *
+ * Connections are kept alive per scheme, host and port, and reused by later
+ * idempotent requests to the same origin.
+ *
+ * @param mgr HTTP connection manager
+ * @param hits number of requests sent over a reused connection [OUT]
+ * @param misses number of requests which needed a new connection [OUT]
+ */
+void vlc_http_mgr_get_stats(const struct vlc_http_mgr *mgr,
+                            unsigned *restrict hits, unsigned *restrict misses);
+
 /**
  * Creates an HTTP connection manager
  *
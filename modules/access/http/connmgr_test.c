@@ -0,0 +1,319 @@
+/*****************************************************************************
+ * connmgr_test.c: HTTP connection manager tests
+ *****************************************************************************
+ * Copyright (C) 2025 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#undef NDEBUG
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_network.h>
+#include <vlc_tls.h>
+#include "transport.h"
+#include "conn.h"
+#include "connmgr.h"
+#include "message.h"
+
+const char vlc_module_name[] = "test_http_connmgr";
+
+static unsigned connects = 0;
+static unsigned closes = 0;
+static struct vlc_tls dummy_tls;
+
+struct fake_conn
+{
+    struct vlc_http_conn conn;
+    bool h2;
+    bool broken;
+    bool released;
+    unsigned streams;
+};
+
+struct fake_stream
+{
+    struct vlc_http_stream stream;
+    struct fake_conn *conn;
+};
+
+static struct fake_conn *last_conn;
+
+static void fake_conn_destroy(struct fake_conn *conn)
+{
+    closes++;
+    free(conn);
+}
+
+static struct vlc_http_msg *stream_read_headers(struct vlc_http_stream *s)
+{
+    struct vlc_http_msg *m = vlc_http_resp_create(200);
+    assert(m != NULL);
+    vlc_http_msg_attach(m, s);
+    return m;
+}
+
+static void stream_close(struct vlc_http_stream *s, bool abort)
+{
+    struct fake_stream *fs = container_of(s, struct fake_stream, stream);
+    struct fake_conn *conn = fs->conn;
+
+    assert(conn->streams > 0);
+    conn->streams--;
+    free(fs);
+
+    if (conn->released && conn->streams == 0)
+        fake_conn_destroy(conn);
+    (void) abort;
+}
+
+static const struct vlc_http_stream_cbs stream_callbacks =
+{
+    stream_read_headers,
+    NULL,
+    NULL,
+    stream_close,
+};
+
+static struct vlc_http_stream *conn_stream_open(struct vlc_http_conn *c,
+                                                const struct vlc_http_msg *req,
+                                                bool has_data)
+{
+    struct fake_conn *conn = container_of(c, struct fake_conn, conn);
+
+    /* HTTP/1 carries one stream at a time */
+    if (conn->broken || (!conn->h2 && conn->streams > 0))
+        return NULL;
+
+    struct fake_stream *fs = malloc(sizeof (*fs));
+    assert(fs != NULL);
+    fs->stream.cbs = &stream_callbacks;
+    fs->conn = conn;
+    conn->streams++;
+    (void) req; (void) has_data;
+    return &fs->stream;
+}
+
+static void conn_release(struct vlc_http_conn *c)
+{
+    struct fake_conn *conn = container_of(c, struct fake_conn, conn);
+
+    assert(!conn->released);
+    conn->released = true;
+    if (conn->streams == 0)
+        fake_conn_destroy(conn);
+}
+
+static const struct vlc_http_conn_cbs conn_callbacks =
+{
+    conn_stream_open,
+    conn_release,
+};
+
+static struct vlc_http_conn *fake_conn_create(bool h2)
+{
+    struct fake_conn *conn = malloc(sizeof (*conn));
+    assert(conn != NULL);
+
+    conn->conn.cbs = &conn_callbacks;
+    conn->conn.tls = NULL;
+    conn->h2 = h2;
+    conn->broken = false;
+    conn->released = false;
+    conn->streams = 0;
+    connects++;
+    last_conn = conn;
+    return &conn->conn;
+}
+
+/* Test doubles for the transports */
+struct vlc_http_conn *vlc_h1_conn_create(void *ctx, struct vlc_tls *tls,
+                                         bool proxy)
+{
+    assert(tls == &dummy_tls);
+    (void) ctx; (void) proxy;
+    return fake_conn_create(false);
+}
+
+struct vlc_http_conn *vlc_h2_conn_create(void *ctx, struct vlc_tls *tls)
+{
+    assert(tls == &dummy_tls);
+    (void) ctx;
+    return fake_conn_create(true);
+}
+
+struct vlc_http_stream *vlc_h1_request(void *ctx, const char *hostname,
+                                       unsigned port, bool proxy,
+                                       const struct vlc_http_msg *req,
+                                       bool idempotent, bool has_data,
+                                       struct vlc_http_conn **restrict connp)
+{
+    struct vlc_http_conn *conn = fake_conn_create(false);
+
+    assert(port != 0);
+    assert(!proxy);
+    (void) ctx; (void) hostname; (void) idempotent;
+    *connp = conn;
+    return vlc_http_stream_open(conn, req, has_data);
+}
+
+struct vlc_tls *vlc_https_connect_proxy(void *ctx,
+                                        struct vlc_tls_client *creds,
+                                        const char *name, unsigned port,
+                                        bool *restrict two, const char *proxy)
+{
+    (void) ctx; (void) creds; (void) name; (void) port; (void) two;
+    (void) proxy;
+    assert(!"unexpected proxy");
+    return NULL;
+}
+
+vlc_tls_client_t *vlc_tls_ClientCreate(vlc_object_t *obj)
+{
+    (void) obj;
+    return (vlc_tls_client_t *)&dummy_tls;
+}
+
+void vlc_tls_ClientDelete(vlc_tls_client_t *crd)
+{
+    assert(crd == (vlc_tls_client_t *)&dummy_tls);
+}
+
+vlc_tls_t *vlc_tls_SocketOpenTLS(vlc_tls_client_t *crd, const char *hostname,
+                                 unsigned port, const char *service,
+                                 const char *const *alpn, char **alp)
+{
+    /* Servers named h2.* negotiate HTTP/2 */
+    *alp = strdup(strncmp(hostname, "h2.", 3) ? alpn[1] : alpn[0]);
+    (void) crd; (void) port; (void) service;
+    return &dummy_tls;
+}
+
+char *vlc_getProxyUrl(const char *url)
+{
+    (void) url;
+    return NULL;
+}
+
+static struct vlc_http_mgr *mgr;
+
+static struct vlc_http_msg *request(bool https, const char *host,
+                                    unsigned port, bool idempotent)
+{
+    struct vlc_http_msg *req = vlc_http_req_create("GET", https ? "https"
+                                                   : "http", host, "/");
+    assert(req != NULL);
+
+    struct vlc_http_msg *resp = vlc_http_mgr_request(mgr, https, host, port,
+                                                     req, idempotent, false);
+    vlc_http_msg_destroy(req);
+    return resp;
+}
+
+static void request_done(bool https, const char *host, unsigned port)
+{
+    struct vlc_http_msg *resp = request(https, host, port, true);
+    assert(resp != NULL);
+    vlc_http_msg_destroy(resp);
+}
+
+static void check_stats(unsigned hits, unsigned misses)
+{
+    unsigned h, m;
+
+    vlc_http_mgr_get_stats(mgr, &h, &m);
+    assert(h == hits);
+    assert(m == misses);
+}
+
+int main(void)
+{
+    struct vlc_object_t obj = { .logger = NULL };
+    struct vlc_http_msg *m1, *m2;
+
+    mgr = vlc_http_mgr_create(&obj, NULL);
+    assert(mgr != NULL);
+
+    /* Alternating origins keep their own connection */
+    for (unsigned i = 0; i < 3; i++)
+    {
+        request_done(false, "www.example.com", 0);
+        request_done(false, "cdn.example.com", 0);
+    }
+    assert(connects == 2 && closes == 0);
+    check_stats(4, 2);
+
+    /* Default and explicit port are the same origin, but not another port */
+    request_done(false, "www.example.com", 80);
+    request_done(false, "www.example.com", 8080);
+    assert(connects == 3);
+    check_stats(5, 3);
+
+    /* Scheme is part of the origin */
+    request_done(true, "www.example.com", 0);
+    request_done(true, "www.example.com", 443);
+    assert(connects == 4);
+    check_stats(6, 4);
+
+    /* Non-idempotent requests always use a new connection */
+    m1 = request(false, "www.example.com", 0, false);
+    assert(m1 != NULL);
+    vlc_http_msg_destroy(m1);
+    assert(connects == 5);
+    check_stats(6, 5);
+
+    /* Concurrent streams share an HTTP/2 connection */
+    m1 = request(true, "h2.example.com", 0, true);
+    m2 = request(true, "h2.example.com", 0, true);
+    assert(m1 != NULL && m2 != NULL);
+    assert(connects == 6);
+    check_stats(7, 6);
+    vlc_http_msg_destroy(m1);
+    vlc_http_msg_destroy(m2);
+
+    /* Reset connections are replaced */
+    last_conn->broken = true;
+    unsigned closed = closes;
+    request_done(true, "h2.example.com", 0);
+    assert(connects == 7 && closes == closed + 1);
+    check_stats(7, 7);
+
+    /* The least recently used connection is evicted when the pool is full */
+    static const char *const hosts[] = {
+        "a.example.com", "b.example.com", "c.example.com", "d.example.com",
+        "e.example.com", "f.example.com", "g.example.com", "h.example.com",
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(hosts); i++)
+        request_done(false, hosts[i], 0);
+    assert(connects == 15);
+    closed = closes;
+    request_done(false, hosts[0], 0);
+    assert(closes == closed);
+    request_done(false, "cdn.example.com", 0);
+    assert(connects == 16 && closes == closed + 1);
+
+    vlc_http_mgr_destroy(mgr);
+    assert(closes == connects);
+    return 0;
+}
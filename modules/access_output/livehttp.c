@@ -31,6 +31,7 @@
 #endif
 
 #include <sys/types.h>
+#include <stdatomic.h>
 #include <time.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -45,6 +46,7 @@
 #include <vlc_fs.h>
 #include <vlc_strings.h>
 #include <vlc_charset.h>
+#include <vlc_queue.h>
 
 #include <gcrypt.h>
 #include <vlc_gcrypt.h>
@@ -174,6 +176,23 @@ typedef struct output_segment
     uint8_t aes_ivs[16];
 } output_segment_t;
 
+/* Segment operations queued for the writer thread, in segment order */
+#define LIVEHTTP_MAX_PENDING_SEGMENTS 4
+
+enum
+{
+    SEGMENT_OPEN,
+    SEGMENT_CLOSE,
+};
+
+typedef struct segment_job
+{
+    struct segment_job *next;
+    int i_type;
+    block_t *p_data;
+    bool b_isend;
+} segment_job_t;
+
 typedef struct
 {
     char *psz_cursegPath;
@@ -196,20 +215,31 @@ typedef struct
     bool b_splitanywhere;
     bool b_caching;
     bool b_generate_iv;
-    bool b_segment_has_data;
+    bool b_segment_open;
     uint8_t aes_ivs[16];
     gcry_cipher_hd_t aes_ctx;
     char *key_uri;
     uint8_t stuffing_bytes[16];
     ssize_t stuffing_size;
     vlc_array_t segments_t;
+
+    /* Writer thread: segment files, encryption and index publication */
+    vlc_thread_t writer;
+    vlc_queue_t jobs;
+    vlc_sem_t segments_room; /* bounds the segments waiting to be written */
+    bool b_writer_dead;
+    atomic_bool b_writer_error;
 } sout_access_out_sys_t;
 
 static int LoadCryptFile( sout_access_out_t *p_access);
 static int CryptSetup( sout_access_out_t *p_access, char *keyfile );
 static int CheckSegmentChange( sout_access_out_t *p_access, block_t *p_buffer );
-static ssize_t writeSegment( sout_access_out_t *p_access );
+static ssize_t writeSegment( sout_access_out_t *p_access, block_t *output );
 static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys );
+static void closeCurrentSegment( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys, bool b_isend );
+static void *WriterThread( void *data );
+static int QueueSegmentJob( sout_access_out_sys_t *p_sys, int i_type,
+                            block_t *p_data, bool b_isend );
 /*****************************************************************************
  * Open: open the file
  *****************************************************************************/
@@ -247,7 +277,7 @@ static int Open( vlc_object_t *p_this )
     p_sys->b_ratecontrol = var_GetBool( p_access, SOUT_CFG_PREFIX "ratecontrol") ;
     p_sys->b_caching = var_GetBool( p_access, SOUT_CFG_PREFIX "caching") ;
     p_sys->b_generate_iv = var_GetBool( p_access, SOUT_CFG_PREFIX "generate-iv") ;
-    p_sys->b_segment_has_data = false;
+    p_sys->b_segment_open = false;
 
     vlc_array_init( &p_sys->segments_t );
 
@@ -300,6 +330,25 @@ static int Open( vlc_object_t *p_this )
     p_sys->i_segment = p_sys->i_initial_segment-1;
     p_sys->psz_cursegPath = NULL;
 
+    vlc_queue_Init( &p_sys->jobs, offsetof(segment_job_t, next) );
+    vlc_sem_init( &p_sys->segments_room, LIVEHTTP_MAX_PENDING_SEGMENTS );
+    p_sys->b_writer_dead = false;
+    atomic_init( &p_sys->b_writer_error, false );
+
+    if( vlc_clone( &p_sys->writer, WriterThread, p_access ) )
+    {
+        if( p_sys->key_uri )
+        {
+            gcry_cipher_close( p_sys->aes_ctx );
+            free( p_sys->key_uri );
+        }
+        free( p_sys->psz_keyfile );
+        free( p_sys->psz_indexUrl );
+        free( p_sys->psz_indexPath );
+        free( p_sys );
+        return VLC_ENOMEM;
+    }
+
     p_access->pf_write = Write;
     p_access->pf_control = Control;
 
@@ -785,17 +834,14 @@ static void Close( vlc_object_t * p_this )
         p_sys->ongoing_segment_end = &p_sys->ongoing_segment;
     }
 
-    ssize_t writevalue = writeSegment( p_access );
-    msg_Dbg( p_access, "Writing.. %zd", writevalue );
-    if( unlikely( writevalue < 0 ) )
-    {
-        if( p_sys->full_segments )
-            block_ChainRelease( p_sys->full_segments );
-        if( p_sys->ongoing_segment )
-            block_ChainRelease( p_sys->ongoing_segment );
-    }
+    if( QueueSegmentJob( p_sys, SEGMENT_CLOSE, p_sys->full_segments, true ) )
+        block_ChainRelease( p_sys->full_segments );
+    p_sys->full_segments = NULL;
+    p_sys->full_segments_end = &p_sys->full_segments;
 
-    closeCurrentSegment( p_access, p_sys, true );
+    /* Let the writer publish all pending segments before leaving */
+    vlc_queue_Kill( &p_sys->jobs, &p_sys->b_writer_dead );
+    vlc_join( p_sys->writer, NULL );
 
     if( p_sys->key_uri )
     {
@@ -899,9 +945,33 @@ static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t
     p_sys->psz_cursegPath = strdup(segment->psz_filename);
     p_sys->i_handle = fd;
     p_sys->i_segment = i_newseg;
-    p_sys->b_segment_has_data = false;
     return fd;
 }
+/*****************************************************************************
+ * QueueSegmentJob: hand a segment operation over to the writer thread
+ *****************************************************************************
+ * Only a few complete segments may wait for the writer: if the storage is
+ * slower than the stream, the muxer blocks here rather than piling up
+ * segments in memory.
+ *****************************************************************************/
+static int QueueSegmentJob( sout_access_out_sys_t *p_sys, int i_type,
+                            block_t *p_data, bool b_isend )
+{
+    segment_job_t *job = malloc( sizeof( *job ) );
+    if( unlikely( job == NULL ) )
+        return -1;
+
+    if( i_type == SEGMENT_CLOSE )
+        vlc_sem_wait( &p_sys->segments_room );
+
+    job->next = NULL;
+    job->i_type = i_type;
+    job->p_data = p_data;
+    job->b_isend = b_isend;
+    vlc_queue_Enqueue( &p_sys->jobs, job );
+    return 0;
+}
+
 /*****************************************************************************
  * CheckSegmentChange: Check if segment needs to be closed and new opened
  *****************************************************************************/
@@ -916,35 +986,86 @@ static int CheckSegmentChange( sout_access_out_t *p_access, block_t *p_buffer )
     block_ChainProperties( p_sys->full_segments, NULL, NULL, &current_length );
     block_ChainProperties( p_sys->ongoing_segment, NULL, NULL, &ongoing_length );
 
-    if( p_sys->i_handle > 0 &&
+    if( p_sys->b_segment_open &&
        (( p_buffer->i_length + current_length + ongoing_length ) >= p_sys->segment_max_length ) )
     {
-        writevalue = writeSegment( p_access );
-        if( unlikely( writevalue < 0 ) )
-        {
-            block_ChainRelease ( p_buffer );
+        size_t i_size;
+        block_ChainProperties( p_sys->full_segments, NULL, &i_size, NULL );
+
+        if( QueueSegmentJob( p_sys, SEGMENT_CLOSE, p_sys->full_segments, false ) )
             return -1;
-        }
-        closeCurrentSegment( p_access, p_sys, false );
-        return writevalue;
+        p_sys->full_segments = NULL;
+        p_sys->full_segments_end = &p_sys->full_segments;
+        p_sys->b_segment_open = false;
+        return i_size;
     }
 
-    if ( unlikely( p_sys->i_handle < 0 ) )
+    if ( unlikely( !p_sys->b_segment_open ) )
     {
-        if ( openNextFile( p_access, p_sys ) < 0 )
-           return -1;
+        if( QueueSegmentJob( p_sys, SEGMENT_OPEN, NULL, false ) )
+            return -1;
+        p_sys->b_segment_open = true;
     }
     return writevalue;
 }
 
-static ssize_t writeSegment( sout_access_out_t *p_access )
+/*****************************************************************************
+ * WriterThread: open, encrypt, write and close segments, publish the index
+ *****************************************************************************
+ * All segment file and index accesses happen here, so that a slow storage
+ * does not stall the muxer. Jobs are processed in queuing order, hence
+ * segments and playlist updates are published in order.
+ *****************************************************************************/
+static void *WriterThread( void *data )
 {
+    sout_access_out_t *p_access = data;
     sout_access_out_sys_t *p_sys = p_access->p_sys;
-    msg_Dbg( p_access, "Writing all full segments" );
+    segment_job_t *job;
 
-    block_t *output = p_sys->full_segments;
-    p_sys->full_segments = NULL;
-    p_sys->full_segments_end = &p_sys->full_segments;
+    vlc_thread_set_name( "vlc-livehttp" );
+
+    while( ( job = vlc_queue_DequeueKillable( &p_sys->jobs,
+                                              &p_sys->b_writer_dead ) ) != NULL )
+    {
+        switch( job->i_type )
+        {
+            case SEGMENT_OPEN:
+                if( openNextFile( p_access, p_sys ) < 0 )
+                    atomic_store_explicit( &p_sys->b_writer_error, true,
+                                           memory_order_relaxed );
+                break;
+
+            case SEGMENT_CLOSE:
+                if( p_sys->i_handle < 0 )
+                {
+                    /* Segment could not be opened */
+                    block_ChainRelease( job->p_data );
+                    break;
+                }
+                if( writeSegment( p_access, job->p_data ) < 0 )
+                {
+                    msg_Err( p_access, "cannot write segment %"PRIu32,
+                             p_sys->i_segment );
+                    atomic_store_explicit( &p_sys->b_writer_error, true,
+                                           memory_order_relaxed );
+                }
+                closeCurrentSegment( p_access, p_sys, job->b_isend );
+                break;
+
+            default:
+                vlc_assert_unreachable();
+        }
+        if( job->i_type == SEGMENT_CLOSE )
+            vlc_sem_post( &p_sys->segments_room );
+        free( job );
+    }
+    return NULL;
+}
+
+static ssize_t writeSegment( sout_access_out_t *p_access, block_t *output )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    msg_Dbg( p_access, "Writing all full segments" );
 
     vlc_tick_t current_length = 0;
     block_ChainProperties( output, NULL, NULL, &current_length );
@@ -979,6 +1100,7 @@ static ssize_t writeSegment( sout_access_out_t *p_access )
             if( err )
             {
                 msg_Err( p_access, "Encryption failure: %s ", gpg_strerror(err) );
+                block_ChainRelease( output );
                 return -1;
             }
             encrypted=true;
@@ -990,6 +1112,7 @@ static ssize_t writeSegment( sout_access_out_t *p_access )
         {
            if ( errno == EINTR )
               continue;
+           block_ChainRelease( output );
            return -1;
         }
 
@@ -1029,13 +1152,13 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
             block_ChainLastAppend( &p_sys->full_segments_end, p_sys->ongoing_segment );
             p_sys->ongoing_segment = NULL;
             p_sys->ongoing_segment_end = &p_sys->ongoing_segment;
-            p_sys->b_segment_has_data = true;
         }
 
         ssize_t ret = CheckSegmentChange( p_access, p_buffer );
         if( ret < 0 )
         {
             msg_Err( p_access, "Error in write loop");
+            block_ChainRelease( p_buffer );
             return ret;
         }
         i_write += ret;
@@ -1046,5 +1169,12 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
         p_buffer = p_temp;
     }
 
+    if( atomic_exchange_explicit( &p_sys->b_writer_error, false,
+                                  memory_order_relaxed ) )
+    {
+        msg_Err( p_access, "Error in segment writer" );
+        return -1;
+    }
+
     return i_write;
 }
@@ -24,14 +24,53 @@
 
 #include <srt_common.h>
 
+#include <stdatomic.h>
+
 #include <vlc_interrupt.h>
 #include <vlc_fs.h>
 #include <vlc_plugin.h>
 #include <vlc_sout.h>
 #include <vlc_block.h>
 #include <vlc_block_helper.h>
+#include <vlc_list.h>
 #include <vlc_network.h>
 
+/* Listener mode parameter names */
+#define SRT_PARAM_MAX_CALLERS                 "max-callers"
+#define SRT_PARAM_CALLER_BACKLOG              "caller-backlog"
+#define SRT_PARAM_CALLER_OVERFLOW             "caller-overflow"
+
+#define SRT_DEFAULT_CALLER_BACKLOG 2048
+/* Pending connections the listening socket queues */
+#define SRT_LISTEN_BACKLOG 16
+/* The listener thread checks for termination at this period (ms) */
+#define SRT_LISTENER_POLL_TIMEOUT 100
+#define SRT_CALLER_STATS_INTERVAL VLC_TICK_FROM_SEC(10)
+
+/* What to do with a caller lagging more than its backlog */
+enum srt_overflow {
+    SRT_OVERFLOW_DROP,
+    SRT_OVERFLOW_DISCONNECT,
+};
+static const int srt_overflow_values[] = { SRT_OVERFLOW_DROP,
+        SRT_OVERFLOW_DISCONNECT, };
+static const char * const srt_overflow_names[] = {
+        N_( "Drop the oldest packets" ), N_( "Disconnect the caller" ), };
+
+typedef struct
+{
+    SRTSOCKET     sock;
+    char          psz_addr[NI_MAXNUMERICHOST + 8];
+    /* Sequence number of the next packet to send */
+    uint64_t      i_next;
+
+    uint64_t      i_sent_packets;
+    uint64_t      i_sent_bytes;
+    uint64_t      i_dropped_packets;
+
+    struct vlc_list node;
+} srt_caller_t;
+
 typedef struct
 {
     SRTSOCKET     sock;
@@ -40,6 +79,28 @@ typedef struct
     vlc_mutex_t   lock;
     size_t        i_payload_size;
     block_bytestream_t block_stream;
+
+    /* Listener mode: the muxed stream is cut once into packets, kept in a
+     * ring shared by all the callers. Each caller sends from its own
+     * position, the packets it still has to send being its queue. */
+    bool          b_listener;
+    struct
+    {
+        uint8_t  *p_data;
+        size_t   *pi_sizes;
+        size_t    i_count;
+        /* Slot size: the payload size when the ring was allocated, even if
+         * the listening socket is set up again later */
+        size_t    i_stride;
+        /* Sequence number of the next packet written */
+        uint64_t  i_head;
+    } ring;
+    struct vlc_list callers;
+    unsigned      i_callers;
+    unsigned      i_max_callers;
+    int           i_overflow;
+    atomic_bool   b_closing;
+    vlc_thread_t  listener;
 } sout_access_out_sys_t;
 
 static void srt_wait_interrupted(void *p_data)
@@ -86,6 +147,7 @@ static bool srt_schedule_reconnect(sout_access_out_t *p_access)
     }, *res = NULL;
 
     sout_access_out_sys_t *p_sys = p_access->p_sys;
+    SRTSOCKET sock = SRT_INVALID_SOCK;
     bool failed = false;
 
     i_dst_port = SRT_DEFAULT_PORT;
@@ -96,6 +158,11 @@ static bool srt_schedule_reconnect(sout_access_out_t *p_access)
         goto out;
     }
 
+    /* URL parameters are parsed from the whole path below */
+    char *psz_query = strchr( psz_dst_addr, '?' );
+    if ( psz_query != NULL )
+        *psz_query = '\0';
+
     if ( psz_parser[0] == '[' )
         psz_parser = strchr( psz_parser, ']' );
 
@@ -106,7 +173,13 @@ static bool srt_schedule_reconnect(sout_access_out_t *p_access)
         i_dst_port = atoi( psz_parser );
     }
 
-    stat = vlc_getaddrinfo( psz_dst_addr, i_dst_port, &hints, &res );
+    if ( p_sys->b_listener )
+        hints.ai_flags = AI_PASSIVE;
+
+    /* Listen on all the interfaces if no address is given */
+    stat = vlc_getaddrinfo( p_sys->b_listener && psz_dst_addr[0] == '\0'
+                            ? NULL : psz_dst_addr,
+                            i_dst_port, &hints, &res );
     if ( stat )
     {
         msg_Err( p_access, "Cannot resolve [%s]:%d (reason: %s)",
@@ -118,15 +191,20 @@ static bool srt_schedule_reconnect(sout_access_out_t *p_access)
         goto out;
     }
 
-    /* Always start with a fresh socket */
+    /* Always start with a fresh socket. The old one is released first, so
+     * that a listener can bind the same address again. */
+    vlc_mutex_lock( &p_sys->lock );
     if ( p_sys->sock != SRT_INVALID_SOCK )
     {
         srt_epoll_remove_usock( p_sys->i_poll_id, p_sys->sock );
         srt_close( p_sys->sock );
+        p_sys->sock = SRT_INVALID_SOCK;
     }
+    vlc_mutex_unlock( &p_sys->lock );
 
-    p_sys->sock = srt_create_socket( );
-    if ( p_sys->sock == SRT_INVALID_SOCK )
+    /* The new socket is only published once set up */
+    sock = srt_create_socket( );
+    if ( sock == SRT_INVALID_SOCK )
     {
         msg_Err( p_access, "Failed to open socket." );
         failed = true;
@@ -134,7 +212,7 @@ static bool srt_schedule_reconnect(sout_access_out_t *p_access)
     }
 
     if (psz_dst_addr) {
-        url = strdup( psz_dst_addr );
+        url = strdup( p_access->psz_path );
         if (srt_parse_url( url, &params )) {
             if (params.latency != -1)
                 i_latency = params.latency;
@@ -154,42 +232,42 @@ static bool srt_schedule_reconnect(sout_access_out_t *p_access)
     }
 
     /* Make SRT non-blocking */
-    srt_setsockopt( p_sys->sock, 0, SRTO_SNDSYN,
+    srt_setsockopt( sock, 0, SRTO_SNDSYN,
         &(bool) { false }, sizeof( bool ) );
-    srt_setsockopt( p_sys->sock, 0, SRTO_RCVSYN,
+    srt_setsockopt( sock, 0, SRTO_RCVSYN,
         &(bool) { false }, sizeof( bool ) );
 
     /* Make sure TSBPD mode is enable (SRT mode) */
-    srt_setsockopt( p_sys->sock, 0, SRTO_TSBPDMODE,
+    srt_setsockopt( sock, 0, SRTO_TSBPDMODE,
         &(int) { 1 }, sizeof( int ) );
 
     /* This is an access_out so it is always a sender */
-    srt_setsockopt( p_sys->sock, 0, SRTO_SENDER,
+    srt_setsockopt( sock, 0, SRTO_SENDER,
         &(int) { 1 }, sizeof( int ) );
 
     /* Set latency */
-    srt_set_socket_option( access_obj, SRT_PARAM_LATENCY, p_sys->sock,
+    srt_set_socket_option( access_obj, SRT_PARAM_LATENCY, sock,
             SRTO_LATENCY, &i_latency, sizeof(i_latency) );
 
     /* set passphrase */
     if (psz_passphrase != NULL && psz_passphrase[0] != '\0') {
         int i_key_length = var_InheritInteger( access_obj, SRT_PARAM_KEY_LENGTH );
 
-        srt_set_socket_option( access_obj, SRT_PARAM_KEY_LENGTH, p_sys->sock,
+        srt_set_socket_option( access_obj, SRT_PARAM_KEY_LENGTH, sock,
                 SRTO_PBKEYLEN, &i_key_length, sizeof(i_key_length) );
 
-        srt_set_socket_option( access_obj, SRT_PARAM_PASSPHRASE, p_sys->sock,
+        srt_set_socket_option( access_obj, SRT_PARAM_PASSPHRASE, sock,
                 SRTO_PASSPHRASE, psz_passphrase, strlen(psz_passphrase) );
     }
 
     /* set streamid */
     if (psz_streamid != NULL && psz_streamid[0] != '\0') {
-        srt_set_socket_option( access_obj, SRT_PARAM_STREAMID, p_sys->sock,
+        srt_set_socket_option( access_obj, SRT_PARAM_STREAMID, sock,
                 SRTO_STREAMID, psz_streamid, strlen(psz_streamid) );
     }
 
     /* set maximum payload size */
-    stat = srt_set_socket_option( access_obj, SRT_PARAM_PAYLOAD_SIZE, p_sys->sock,
+    stat = srt_set_socket_option( access_obj, SRT_PARAM_PAYLOAD_SIZE, sock,
             SRTO_PAYLOADSIZE, &i_payload_size, sizeof(i_payload_size) );
     if ( stat == SRT_ERROR )
     {
@@ -198,23 +276,48 @@ static bool srt_schedule_reconnect(sout_access_out_t *p_access)
         failed = true;
         goto out;
     }
-    p_sys->i_payload_size = i_payload_size;
 
     /* set maximum bandwidth limit*/
     srt_set_socket_option( access_obj, SRT_PARAM_BANDWIDTH_OVERHEAD_LIMIT,
-            p_sys->sock, SRTO_OHEADBW, &i_max_bandwidth_limit,
+            sock, SRTO_OHEADBW, &i_max_bandwidth_limit,
             sizeof(i_max_bandwidth_limit) );
 
-    srt_setsockopt( p_sys->sock, 0, SRTO_SENDER, &(int) { 1 }, sizeof(int) );
+    srt_setsockopt( sock, 0, SRTO_SENDER, &(int) { 1 }, sizeof(int) );
+
+    if ( p_sys->b_listener )
+    {
+        /* Accepted sockets inherit the options set above */
+        if ( res->ai_family == AF_INET6 )
+            srt_setsockopt( sock, 0, SRTO_IPV6ONLY,
+                &(int) { 0 }, sizeof( int ) );
+        srt_setsockopt( sock, 0, SRTO_REUSEADDR,
+            &(int) { 1 }, sizeof( int ) );
+
+        msg_Dbg( p_access, "Listen for SRT callers (address: %s, port: %d).",
+            psz_dst_addr, i_dst_port );
+
+        if ( srt_bind( sock, res->ai_addr, res->ai_addrlen ) == SRT_ERROR
+          || srt_listen( sock, SRT_LISTEN_BACKLOG ) == SRT_ERROR )
+        {
+            msg_Err( p_access, "Failed to listen (reason: %s)",
+                     srt_getlasterror_str() );
+            failed = true;
+            goto out;
+        }
+
+        srt_epoll_add_usock( p_sys->i_poll_id, sock,
+            &(int) { SRT_EPOLL_ERR | SRT_EPOLL_IN });
+        goto out;
+    }
 
-    srt_epoll_add_usock( p_sys->i_poll_id, p_sys->sock,
+    srt_epoll_add_usock( p_sys->i_poll_id, sock,
         &(int) { SRT_EPOLL_ERR | SRT_EPOLL_OUT });
 
     /* Schedule a connect */
     msg_Dbg( p_access, "Schedule SRT connect (dest address: %s, port: %d).",
         psz_dst_addr, i_dst_port );
 
-    stat = srt_connect( p_sys->sock, res->ai_addr, res->ai_addrlen );
+    stat = srt_connect( sock, res->ai_addr, res->ai_addrlen );
     if ( stat == SRT_ERROR )
     {
         msg_Err( p_access, "Failed to connect to server (reason: %s)",
@@ -223,11 +326,17 @@ static bool srt_schedule_reconnect(sout_access_out_t *p_access)
     }
 
 out:
-    if (failed && p_sys->sock != SRT_INVALID_SOCK)
+    if (failed && sock != SRT_INVALID_SOCK)
     {
-        srt_epoll_remove_usock( p_sys->i_poll_id, p_sys->sock );
-        srt_close(p_sys->sock);
-        p_sys->sock = SRT_INVALID_SOCK;
+        srt_epoll_remove_usock( p_sys->i_poll_id, sock );
+        srt_close(sock);
+    }
+    else if (!failed)
+    {
+        vlc_mutex_lock( &p_sys->lock );
+        p_sys->sock = sock;
+        p_sys->i_payload_size = i_payload_size;
+        vlc_mutex_unlock( &p_sys->lock );
     }
 
     if (passphrase_needs_free)
@@ -366,6 +475,263 @@ out:
     return i_len;
 }
 
+static void srt_caller_LogStats( sout_access_out_t *p_access,
+                                 const srt_caller_t *p_caller )
+{
+    SRT_TRACEBSTATS perf;
+
+    if ( srt_bistats( p_caller->sock, &perf, 0, 1 ) == SRT_ERROR )
+        memset( &perf, 0, sizeof( perf ) );
+
+    msg_Dbg( p_access, "caller %s: %"PRIu64" packets (%"PRIu64" bytes) sent, "
+             "%"PRIu64" dropped, %d retransmitted, %d lost, "
+             "RTT %.1f ms, %.2f Mb/s", p_caller->psz_addr,
+             p_caller->i_sent_packets, p_caller->i_sent_bytes,
+             p_caller->i_dropped_packets, perf.pktRetransTotal,
+             perf.pktSndLossTotal, perf.msRTT, perf.mbpsSendRate );
+}
+
+static void srt_caller_Delete( sout_access_out_t *p_access,
+                               srt_caller_t *p_caller )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+
+    srt_caller_LogStats( p_access, p_caller );
+    srt_close( p_caller->sock );
+
+    vlc_list_remove( &p_caller->node );
+    p_sys->i_callers--;
+    msg_Info( p_access, "caller %s disconnected (%u callers)",
+              p_caller->psz_addr, p_sys->i_callers );
+    free( p_caller );
+}
+
+/* Sends the packets the caller did not get yet, without blocking: what the
+ * SRT send buffer can't take is kept for the next write. Returns false if
+ * the caller must be disconnected. */
+static bool srt_caller_Send( sout_access_out_t *p_access,
+                             srt_caller_t *p_caller )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+
+    switch( srt_getsockstate( p_caller->sock ) )
+    {
+        case SRTS_CONNECTED:
+            break;
+        case SRTS_BROKEN:
+        case SRTS_NONEXIST:
+        case SRTS_CLOSED:
+            return false;
+        default:
+            return true;
+    }
+
+    if ( p_sys->ring.i_head - p_caller->i_next > p_sys->ring.i_count )
+    {
+        if ( p_sys->i_overflow == SRT_OVERFLOW_DISCONNECT )
+        {
+            msg_Warn( p_access, "caller %s is too slow", p_caller->psz_addr );
+            return false;
+        }
+
+        const uint64_t i_oldest = p_sys->ring.i_head - p_sys->ring.i_count;
+        p_caller->i_dropped_packets += i_oldest - p_caller->i_next;
+        p_caller->i_next = i_oldest;
+    }
+
+    while ( p_caller->i_next < p_sys->ring.i_head )
+    {
+        const size_t i_slot = p_caller->i_next % p_sys->ring.i_count;
+        const size_t i_size = p_sys->ring.pi_sizes[i_slot];
+
+        if ( srt_sendmsg2( p_caller->sock,
+                (char *)&p_sys->ring.p_data[i_slot * p_sys->ring.i_stride],
+                i_size, NULL ) == SRT_ERROR )
+        {
+            if ( srt_getlasterror( NULL ) == SRT_EASYNCSND )
+                break;
+
+            msg_Warn( p_access, "caller %s send error: %s",
+                      p_caller->psz_addr, srt_getlasterror_str() );
+            return false;
+        }
+
+        p_caller->i_next++;
+        p_caller->i_sent_packets++;
+        p_caller->i_sent_bytes += i_size;
+    }
+    return true;
+}
+
+static ssize_t WriteListener( sout_access_out_t *p_access, block_t *p_buffer )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    ssize_t i_len = 0;
+
+    if ( p_buffer == NULL )
+        return 0;
+    block_BytestreamPush( &p_sys->block_stream, p_buffer );
+
+    vlc_mutex_lock( &p_sys->lock );
+
+    while ( true )
+    {
+        size_t chunk_size =
+            __MIN( block_BytestreamRemaining( &p_sys->block_stream ),
+                   p_sys->ring.i_stride );
+        if ( chunk_size == 0 )
+            break;
+
+        const size_t i_slot = p_sys->ring.i_head % p_sys->ring.i_count;
+        if ( block_GetBytes( &p_sys->block_stream,
+                &p_sys->ring.p_data[i_slot * p_sys->ring.i_stride],
+                chunk_size ) != VLC_SUCCESS )
+            break;
+        p_sys->ring.pi_sizes[i_slot] = chunk_size;
+        p_sys->ring.i_head++;
+        i_len += chunk_size;
+
+        /* A slow or broken caller never holds the others back */
+        srt_caller_t *p_caller;
+        vlc_list_foreach( p_caller, &p_sys->callers, node )
+        {
+            if ( !srt_caller_Send( p_access, p_caller ) )
+                srt_caller_Delete( p_access, p_caller );
+        }
+    }
+
+    vlc_mutex_unlock( &p_sys->lock );
+
+    block_BytestreamEmpty( &p_sys->block_stream );
+    return i_len;
+}
+
+static void srt_listener_Accept( sout_access_out_t *p_access )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    vlc_sockaddr addr;
+    int addrlen = sizeof( addr.ss );
+
+    SRTSOCKET sock = srt_accept( p_sys->sock, &addr.sa, &addrlen );
+    if ( sock == SRT_INVALID_SOCK )
+        return;
+
+    srt_caller_t *p_caller = malloc( sizeof( *p_caller ) );
+    if ( unlikely( p_caller == NULL ) )
+    {
+        srt_close( sock );
+        return;
+    }
+
+    char psz_host[NI_MAXNUMERICHOST];
+    int i_port;
+    if ( vlc_getnameinfo( &addr.sa, addrlen, psz_host, sizeof( psz_host ),
+                          &i_port, NI_NUMERICHOST ) )
+        strcpy( p_caller->psz_addr, "?" );
+    else
+        snprintf( p_caller->psz_addr, sizeof( p_caller->psz_addr ),
+                  "%s:%d", psz_host, i_port );
+
+    p_caller->sock = sock;
+    p_caller->i_sent_packets = 0;
+    p_caller->i_sent_bytes = 0;
+    p_caller->i_dropped_packets = 0;
+
+    srt_setsockopt( sock, 0, SRTO_SNDSYN, &(bool) { false }, sizeof( bool ) );
+
+    vlc_mutex_lock( &p_sys->lock );
+    if ( p_sys->i_max_callers != 0 && p_sys->i_callers >= p_sys->i_max_callers )
+    {
+        vlc_mutex_unlock( &p_sys->lock );
+        msg_Warn( p_access, "rejecting caller %s: too many callers",
+                  p_caller->psz_addr );
+        srt_close( sock );
+        free( p_caller );
+        return;
+    }
+
+    /* Start from the live edge */
+    p_caller->i_next = p_sys->ring.i_head;
+    vlc_list_append( &p_caller->node, &p_sys->callers );
+    p_sys->i_callers++;
+    msg_Info( p_access, "caller %s connected (%u callers)",
+              p_caller->psz_addr, p_sys->i_callers );
+    vlc_mutex_unlock( &p_sys->lock );
+}
+
+static void *ListenerThread( void *data )
+{
+    sout_access_out_t *p_access = data;
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    vlc_tick_t i_next_stats = vlc_tick_now() + SRT_CALLER_STATS_INTERVAL;
+
+    vlc_thread_set_name( "vlc-srt-listen" );
+
+    while ( !atomic_load( &p_sys->b_closing ) )
+    {
+        SRTSOCKET ready[1];
+        int readycnt = 1;
+
+        if ( p_sys->sock == SRT_INVALID_SOCK )
+        {
+            /* The last rebind failed: retry at the poll period rather than
+             * spinning on an empty poll set. */
+            vlc_tick_sleep( VLC_TICK_FROM_MS( SRT_LISTENER_POLL_TIMEOUT ) );
+            if ( !atomic_load( &p_sys->b_closing )
+              && srt_schedule_reconnect( p_access ) )
+                msg_Info( p_access, "listening again for SRT callers" );
+        }
+        else if ( srt_epoll_wait( p_sys->i_poll_id, &ready[0], &readycnt,
+                    0, 0, SRT_LISTENER_POLL_TIMEOUT, NULL, 0, NULL, 0 ) >= 0
+               && readycnt > 0 )
+        {
+            switch( srt_getsockstate( p_sys->sock ) )
+            {
+                case SRTS_LISTENING:
+                    srt_listener_Accept( p_access );
+                    break;
+                case SRTS_BROKEN:
+                case SRTS_NONEXIST:
+                case SRTS_CLOSED:
+                    /* SRT_EPOLL_ERR stays signaled on a broken listening
+                     * socket: rebind it, connected callers are unaffected. */
+                    msg_Err( p_access, "listening socket failed (reason: %s)",
+                             srt_getlasterror_str() );
+                    if ( !srt_schedule_reconnect( p_access ) )
+                        msg_Err( p_access, "Failed to listen again, retrying" );
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if ( vlc_tick_now() >= i_next_stats )
+        {
+            srt_caller_t *p_caller;
+
+            vlc_mutex_lock( &p_sys->lock );
+            vlc_list_foreach( p_caller, &p_sys->callers, node )
+                srt_caller_LogStats( p_access, p_caller );
+            vlc_mutex_unlock( &p_sys->lock );
+            i_next_stats += SRT_CALLER_STATS_INTERVAL;
+        }
+    }
+    return NULL;
+}
+
+static bool srt_is_listener( sout_access_out_t *p_access )
+{
+    if ( var_InheritInteger( p_access, SRT_PARAM_MODE ) == SRT_MODE_LISTENER )
+        return true;
+
+    srt_params_t params;
+    char *url = strdup( p_access->psz_path );
+    bool b_listener = url != NULL && srt_parse_url( url, &params )
+                   && params.mode == SRT_MODE_LISTENER;
+    free( url );
+    return b_listener;
+}
+
 static int Control( sout_access_out_t *p_access, int i_query, va_list args )
 {
     VLC_UNUSED( p_access );
@@ -406,8 +772,10 @@ static int Open( vlc_object_t *p_this )
 
     srt_startup();
 
+    p_sys->sock = SRT_INVALID_SOCK;
     vlc_mutex_init( &p_sys->lock );
     block_BytestreamInit( &p_sys->block_stream );
+    p_sys->b_listener = srt_is_listener( p_access );
 
     p_access->p_sys = p_sys;
 
@@ -427,13 +795,42 @@ static int Open( vlc_object_t *p_this )
         goto failed;
     }
 
-    p_access->pf_write = Write;
+    if ( p_sys->b_listener )
+    {
+        p_sys->ring.i_count =
+            var_InheritInteger( p_access, SRT_PARAM_CALLER_BACKLOG );
+        p_sys->ring.i_head = 0;
+        p_sys->ring.i_stride = p_sys->i_payload_size;
+        p_sys->ring.p_data = vlc_alloc( p_sys->ring.i_count,
+                                        p_sys->ring.i_stride );
+        p_sys->ring.pi_sizes = vlc_alloc( p_sys->ring.i_count,
+                                          sizeof( *p_sys->ring.pi_sizes ) );
+        vlc_list_init( &p_sys->callers );
+        p_sys->i_callers = 0;
+        p_sys->i_max_callers =
+            var_InheritInteger( p_access, SRT_PARAM_MAX_CALLERS );
+        p_sys->i_overflow =
+            var_InheritInteger( p_access, SRT_PARAM_CALLER_OVERFLOW );
+        atomic_init( &p_sys->b_closing, false );
+
+        if ( p_sys->ring.p_data == NULL || p_sys->ring.pi_sizes == NULL
+          || vlc_clone( &p_sys->listener, ListenerThread, p_access ) )
+        {
+            free( p_sys->ring.p_data );
+            free( p_sys->ring.pi_sizes );
+            goto failed;
+        }
+
+        p_access->pf_write = WriteListener;
+    }
+    else
+        p_access->pf_write = Write;
     p_access->pf_control = Control;
 
     return VLC_SUCCESS;
 
 failed:
-    if ( p_sys->sock != -1 ) srt_close( p_sys->sock );
+    if ( p_sys->sock != SRT_INVALID_SOCK ) srt_close( p_sys->sock );
     if ( p_sys->i_poll_id != -1 ) srt_epoll_release( p_sys->i_poll_id );
 
     return VLC_EGENERIC;
@@ -444,6 +841,18 @@ static void Close( vlc_object_t * p_this )
     sout_access_out_t     *p_access = (sout_access_out_t*)p_this;
     sout_access_out_sys_t *p_sys = p_access->p_sys;
 
+    if ( p_sys->b_listener )
+    {
+        atomic_store( &p_sys->b_closing, true );
+        vlc_join( p_sys->listener, NULL );
+
+        srt_caller_t *p_caller;
+        vlc_list_foreach( p_caller, &p_sys->callers, node )
+            srt_caller_Delete( p_access, p_caller );
+        free( p_sys->ring.p_data );
+        free( p_sys->ring.pi_sizes );
+    }
+
     srt_epoll_remove_usock( p_sys->i_poll_id, p_sys->sock );
     srt_close( p_sys->sock );
     srt_epoll_release( p_sys->i_poll_id );
@@ -478,6 +887,20 @@ vlc_module_begin()
     add_string(SRT_PARAM_STREAMID, "",
             N_(" SRT Stream ID"), NULL)
     change_safe()
+    add_integer( SRT_PARAM_MODE, SRT_DEFAULT_MODE,
+            SRT_MODE_TEXT, NULL )
+    change_integer_list( srt_mode_values, srt_mode_names )
+    add_integer_with_range( SRT_PARAM_MAX_CALLERS, 0, 0, 1000,
+            N_( "Maximum number of callers in listener mode (0 = unlimited)" ),
+            NULL )
+    add_integer_with_range( SRT_PARAM_CALLER_BACKLOG,
+            SRT_DEFAULT_CALLER_BACKLOG, 16, 65536,
+            N_( "Packets queued for each caller in listener mode" ),
+            N_( "Packets sent to the slowest callers are kept up to this "
+                "count, beyond which the overflow policy applies." ) )
+    add_integer( SRT_PARAM_CALLER_OVERFLOW, SRT_OVERFLOW_DROP,
+            N_( "Caller queue overflow policy" ), NULL )
+    change_integer_list( srt_overflow_values, srt_overflow_names )
 
     set_capability( "sout access", 0 )
     add_shortcut( "srt" )
@@ -934,6 +934,32 @@ static int Statistics(struct cli_client *cl, const char *const *args,
                    item->p_stats->i_lost_abuffers);
         cli_printf(cl, "|");
 
+        /* Sout */
+        if (item->p_stats->i_sent_packets > 0
+         || item->p_stats->i_sout_muxed_blocks > 0)
+        {
+            cli_printf(cl, "%s", _("+-[Streaming]"));
+            cli_printf(cl, _("| queued blocks    :    %5"PRIu64" (peak %"PRIu64")"),
+                       item->p_stats->i_sout_fifo_blocks,
+                       item->p_stats->i_sout_fifo_peak);
+            cli_printf(cl, _("| mux wait         :   %6"PRId64" ms (max %"PRId64" ms)"),
+                       MS_FROM_VLC_TICK(item->p_stats->i_sout_mux_wait),
+                       MS_FROM_VLC_TICK(item->p_stats->i_sout_mux_wait_max));
+            cli_printf(cl, _("| dropped / late   :    %5"PRIu64" / %"PRIu64),
+                       item->p_stats->i_sout_dropped,
+                       item->p_stats->i_sout_late);
+            cli_printf(cl, _("| packets sent     :    %5"PRIu64),
+                       item->p_stats->i_sent_packets);
+            cli_printf(cl, _("| bytes sent       : %8.0f KiB"),
+                       (float)(item->p_stats->i_sent_bytes) / 1024.f);
+            cli_printf(cl, _("| sending bitrate  :   %6.0f kb/s"),
+                       (float)(item->p_stats->f_send_bitrate) * 8000.f);
+            cli_printf(cl, _("| write latency    :   %6"PRId64" ms (max %"PRId64" ms)"),
+                       MS_FROM_VLC_TICK(item->p_stats->i_sout_write_latency),
+                       MS_FROM_VLC_TICK(item->p_stats->i_sout_write_latency_max));
+            cli_printf(cl, "|");
+        }
+
         vlc_mutex_unlock(&item->lock);
         cli_printf(cl,  "+----[ end of statistical info ]" );
     }
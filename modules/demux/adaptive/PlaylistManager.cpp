@@ -85,6 +85,11 @@ PlaylistManager::PlaylistManager( demux_t *p_demux_,
     cached.playlistEnd = 0;
     cached.playlistLength = 0;
     cached.lastupdate = 0;
+    catchup.b_enabled = false;
+    catchup.lowestlatency = VLC_TICK_INVALID;
+    catchup.lastmeasure = VLC_TICK_INVALID;
+    catchup.windowstart = VLC_TICK_INVALID;
+    catchup.rate = 1.0;
 }
 
 PlaylistManager::~PlaylistManager   ()
@@ -160,6 +165,9 @@ bool PlaylistManager::init(bool b_preparsing)
 
     if(b_preparsing)
         preparsePlaylist();
+    else
+        catchup.b_enabled = playlist->isLive() &&
+                            bufferingLogic->isLowLatency(playlist);
     updateControlsPosition();
 
     return true;
@@ -489,6 +497,7 @@ int PlaylistManager::doDemux(vlc_tick_t increment)
     vlc_mutex_unlock(&demux.lock);
 
     updateControlsPosition();
+    updateRateCorrection();
 
     switch(status)
     {
@@ -577,6 +586,7 @@ int PlaylistManager::doControl(int i_query, va_list args)
                 cached.lastupdate = 0;
                 if(b_pause)
                 {
+                    setRateCorrection(1.0);
                     setLivePause(true);
                     pause_start = now;
                     msg_Dbg(p_demux,"Buffering and playback paused. No timeshift support.");
@@ -653,6 +663,12 @@ int PlaylistManager::doControl(int i_query, va_list args)
                 return VLC_EGENERIC;
             }
 
+            /* moved away from the live edge on purpose */
+            vlc_mutex_lock(&demux.lock);
+            catchup.b_enabled = false;
+            vlc_mutex_unlock(&demux.lock);
+            setRateCorrection(1.0);
+
             demux.pcr_syncpoint = TimestampSynchronizationPoint::RandomAccess;
             demux.times = Times();
             demux.firsttimes = Times();
@@ -675,6 +691,12 @@ int PlaylistManager::doControl(int i_query, va_list args)
                 return VLC_EGENERIC;
             }
 
+            /* moved away from the live edge on purpose */
+            vlc_mutex_lock(&demux.lock);
+            catchup.b_enabled = false;
+            vlc_mutex_unlock(&demux.lock);
+            setRateCorrection(1.0);
+
             vlc_mutex_locker locker(&cached.lock);
             demux.pcr_syncpoint = TimestampSynchronizationPoint::RandomAccess;
             demux.times = Times();
@@ -731,6 +753,8 @@ void PlaylistManager::Run()
         AbstractStream::BufferingStatus i_return = bufferize(pcr, i_min_buffering,
                                                              i_max_buffering, i_target_buffering);
 
+        updateLiveLatency(pcr);
+
         if(i_return != AbstractStream::BufferingStatus::Lessthanmin)
         {
             vlc_tick_t i_deadline = vlc_tick_now();
@@ -855,6 +879,97 @@ void PlaylistManager::updateControlsPosition()
                             startTimes.segment.demux, cached.f_position));
 }
 
+#define CATCHUP_MEASURE_INTERVAL VLC_TICK_FROM_MS(250)
+#define CATCHUP_TOLERANCE        VLC_TICK_FROM_MS(500)
+#define CATCHUP_DEFAULT_MAX_RATE 1.05
+void PlaylistManager::updateLiveLatency(const Times &pcr)
+{
+    const vlc_tick_t now = vlc_tick_now();
+    vlc_mutex_lock(&demux.lock);
+    if(!catchup.b_enabled || pcr.continuous == VLC_TICK_INVALID ||
+       (catchup.lastmeasure != VLC_TICK_INVALID &&
+        now - catchup.lastmeasure < CATCHUP_MEASURE_INTERVAL))
+    {
+        vlc_mutex_unlock(&demux.lock);
+        return;
+    }
+    catchup.lastmeasure = now;
+    vlc_mutex_unlock(&demux.lock);
+
+    /* Distance to the live edge at demuxer output: what the server
+     * has ahead of our downloads, plus what is demuxed but not sent */
+    vlc_tick_t demuxed = VLC_TICK_INVALID;
+    for(const AbstractStream *st : streams)
+    {
+        if(st->isValid() && !st->isDisabled() && st->isSelected())
+        {
+            const vlc_tick_t d = st->getDemuxedAmount(pcr);
+            if(demuxed == VLC_TICK_INVALID || d < demuxed)
+                demuxed = d;
+        }
+    }
+    if(demuxed == VLC_TICK_INVALID)
+        return;
+    const vlc_tick_t latency = getMinAheadTime() + demuxed;
+
+    /* Availability is segment granular, and over estimates until the
+     * next one gets announced. Only the lowest value is meaningful. */
+    vlc_mutex_locker locker(&demux.lock);
+    if(catchup.lowestlatency == VLC_TICK_INVALID || latency < catchup.lowestlatency)
+        catchup.lowestlatency = latency;
+}
+
+void PlaylistManager::updateRateCorrection()
+{
+    const vlc_tick_t now = vlc_tick_now();
+    const vlc_tick_t window = std::max(playlist->maxSegmentDuration,
+                                       AbstractBufferingLogic::BUFFERING_LOWEST_LIMIT);
+    vlc_tick_t latency;
+    {
+        vlc_mutex_locker locker(&demux.lock);
+        if(!catchup.b_enabled)
+            return;
+        if(catchup.windowstart == VLC_TICK_INVALID)
+            catchup.windowstart = now;
+        if(now - catchup.windowstart < window)
+            return;
+        latency = catchup.lowestlatency;
+        catchup.lowestlatency = VLC_TICK_INVALID;
+        catchup.windowstart = now;
+    }
+    if(latency == VLC_TICK_INVALID)
+        return;
+
+    const vlc_tick_t target = bufferingLogic->getLiveDelay(playlist);
+    const double maxrate = playlist->maxPlaybackRate > 1.0 ? playlist->maxPlaybackRate
+                                                           : CATCHUP_DEFAULT_MAX_RATE;
+    double rate = catchup.rate;
+    if(latency > target + CATCHUP_TOLERANCE)
+        rate = maxrate;
+    else if(latency < target - CATCHUP_TOLERANCE)
+        rate = playlist->minPlaybackRate;
+    else if((rate > 1.0 && latency <= target) ||
+            (rate < 1.0 && latency >= target))
+        rate = 1.0;
+
+    if(rate != catchup.rate)
+        msg_Dbg(p_demux, "live latency %" PRId64 "ms, target %" PRId64 "ms, rate %.2f",
+                MS_FROM_VLC_TICK(latency), MS_FROM_VLC_TICK(target), rate);
+    setRateCorrection(rate);
+}
+
+void PlaylistManager::setRateCorrection(double rate)
+{
+    if(rate == catchup.rate)
+        return;
+    if(es_out_Control(p_demux->out, ES_OUT_SET_RATE_CORRECTION, rate) != VLC_SUCCESS)
+    {
+        /* only possible when timeshifted, stay on the user rate */
+        rate = 1.0;
+    }
+    catchup.rate = rate;
+}
+
 AbstractAdaptationLogic *PlaylistManager::createLogic(AbstractAdaptationLogic::LogicType type, AbstractConnectionManager *conn)
 {
     vlc_object_t *obj = VLC_OBJECT(p_demux);
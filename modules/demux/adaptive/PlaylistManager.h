@@ -97,6 +97,9 @@ namespace adaptive
             void unsetPeriod();
 
             void updateControlsPosition();
+            void updateLiveLatency(const Times &);
+            void updateRateCorrection();
+            void setRateCorrection(double);
 
             /* local factories */
             virtual AbstractAdaptationLogic *createLogic(AbstractAdaptationLogic::LogicType,
@@ -129,6 +132,16 @@ namespace adaptive
                 vlc_cond_t  cond;
             } demux;
 
+            /* live edge catch-up, shared with demux/buffering under demux.lock */
+            struct
+            {
+                bool        b_enabled;
+                vlc_tick_t  lowestlatency;
+                vlc_tick_t  lastmeasure;
+                vlc_tick_t  windowstart;
+                double      rate;
+            } catchup;
+
             /* buffering process */
             time_t                               nextPlaylistupdate;
             int                                  failedupdates;
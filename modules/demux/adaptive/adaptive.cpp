@@ -81,6 +81,10 @@ static void Close   (vlc_object_t *);
 #define ADAPT_ACCESS_TEXT N_("Use regular HTTP modules")
 #define ADAPT_ACCESS_LONGTEXT N_("Connect using HTTP access instead of custom HTTP code")
 
+#define ADAPT_CACHESIZE_TEXT N_("Segments cache size (MiB)")
+#define ADAPT_CACHESIZE_LONGTEXT N_("Memory used to keep already downloaded segments " \
+                                    "for seeking back. 0 disables the cache.")
+
 #define ADAPT_LOWLATENCY_TEXT N_("Low latency")
 #define ADAPT_LOWLATENCY_LONGTEXT N_("Overrides low latency parameters")
 
@@ -141,6 +145,8 @@ vlc_module_begin ()
         add_integer( "adaptive-maxbuffer",
                      MS_FROM_VLC_TICK(AbstractBufferingLogic::DEFAULT_MAX_BUFFERING),
                      ADAPT_MAXBUFFER_TEXT, nullptr )
+        add_integer_with_range( "adaptive-cachesize", 16, 0, 1024,
+                                ADAPT_CACHESIZE_TEXT, ADAPT_CACHESIZE_LONGTEXT )
         add_integer( "adaptive-lowlatency", -1, ADAPT_LOWLATENCY_TEXT, ADAPT_LOWLATENCY_LONGTEXT )
             change_integer_list(rgi_latency, ppsz_latency)
         set_callbacks( Open, Close )
@@ -157,6 +157,8 @@ HTTPChunkSource::HTTPChunkSource(const std::string& url, AbstractConnectionManag
 {
     prepared = false;
     eof = false;
+    expiryTime = VLC_TICK_INVALID;
+    cacheStorable = false;
     sourceid = id;
     setUseAccess(access);
     setIdentifier(url, range);
@@ -268,10 +270,7 @@ StorageID HTTPChunkSource::makeStorageID(const std::string &s, const BytesRange
 const std::string & HTTPChunkSource::getContentType() const
 {
     mutex_locker locker {lock};
-    if(connection)
-        return connection->getContentType();
-    else
-        return EmptyStr;
+    return contentType;
 }
 
 void HTTPChunkSource::setIdentifier(const std::string &s, const BytesRange &r)
@@ -301,8 +300,10 @@ bool HTTPChunkSource::prepare()
                 break;
         }
 
-        requeststatus = connection->request(connparams.getPath(), bytesRange);
-        if(requeststatus != RequestStatus::Success)
+        requeststatus = connection->request(connparams.getPath(), bytesRange,
+                                            conditions);
+        if(requeststatus != RequestStatus::Success &&
+           requeststatus != RequestStatus::NotModified)
         {
             if(requeststatus == RequestStatus::Redirection)
             {
@@ -320,6 +321,12 @@ bool HTTPChunkSource::prepare()
         contentLength = connection->getContentLength();
         prepared = true;
         responseTime = vlc_tick_now();
+        const vlc_tick_t lifetime = connection->getCacheLifetime();
+        expiryTime = (lifetime == VLC_TICK_MAX) ? VLC_TICK_MAX
+                                                : responseTime + lifetime;
+        cacheStorable = connection->isCacheStorable();
+        cacheValidators = connection->getCacheValidators();
+        contentType = connection->getContentType();
         return true;
     }
 
@@ -341,10 +348,12 @@ HTTPChunkBufferedSource::HTTPChunkBufferedSource(const std::string& url, Abstrac
     buffered     (0)
 {
     done = false;
+    complete = false;
     eof = false;
     held = false;
     p_read = nullptr;
     inblockreadoffset = 0;
+    stale = nullptr;
 }
 
 HTTPChunkBufferedSource::~HTTPChunkBufferedSource()
@@ -352,19 +361,50 @@ HTTPChunkBufferedSource::~HTTPChunkBufferedSource()
     /* cancel ourself if in queue */
     connManager->cancel(this);
 
-    mutex_locker locker {lock};
-    done = true;
-    while(held) /* wait release if not in queue but currently downloaded */
-        avail.wait(lock);
-
-    if(p_head)
     {
-        block_ChainRelease(p_head);
-        p_head = nullptr;
-        p_read = nullptr;
-        pp_tail = &p_head;
+        mutex_locker locker {lock};
+        done = true;
+        while(held) /* wait release if not in queue but currently downloaded */
+            avail.wait(lock);
+
+        if(p_head)
+        {
+            block_ChainRelease(p_head);
+            p_head = nullptr;
+            p_read = nullptr;
+            pp_tail = &p_head;
+        }
+        buffered = 0;
     }
-    buffered = 0;
+
+    delete stale;
+}
+
+void HTTPChunkBufferedSource::revalidate(HTTPChunkBufferedSource *s)
+{
+    stale = s;
+    conditions = s->cacheValidators;
+}
+
+/* The server confirmed the stored copy: take its data as ours */
+void HTTPChunkBufferedSource::reuseStale()
+{
+    p_head = stale->p_head;
+    pp_tail = p_head ? stale->pp_tail : &p_head;
+    buffered = stale->buffered;
+    stale->p_head = nullptr;
+    stale->pp_tail = &stale->p_head;
+    stale->buffered = 0;
+
+    p_read = p_head;
+    inblockreadoffset = 0;
+    contentLength = buffered;
+    if(cacheValidators.isEmpty())
+        cacheValidators = stale->cacheValidators;
+    contentType = stale->contentType;
+    requeststatus = RequestStatus::Success;
+    done = true;
+    downloadEndTime = vlc_tick_now();
 }
 
 bool HTTPChunkBufferedSource::isDone() const
@@ -398,6 +438,21 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
             return;
         }
 
+        if(stale)
+        {
+            if(requeststatus == RequestStatus::NotModified)
+            {
+                reuseStale();
+                avail.signal();
+                return;
+            }
+            /* The stored copy is outdated */
+            block_ChainRelease(stale->p_head);
+            stale->p_head = nullptr;
+            stale->pp_tail = &stale->p_head;
+            stale->buffered = 0;
+        }
+
         if(readsize < HTTPChunkSource::CHUNK_SIZE)
             readsize = HTTPChunkSource::CHUNK_SIZE;
 
@@ -469,6 +524,17 @@ bool HTTPChunkBufferedSource::hasMoreData() const
 
 void HTTPChunkBufferedSource::recycle()
 {
+    {
+        mutex_locker locker {lock};
+        complete = done && buffered && buffered == contentLength;
+        eof = done && p_head == nullptr;
+        /* Stored data does not need to keep the connection busy */
+        if(done && !held && connection)
+        {
+            connection->setUsed(false);
+            connection = nullptr;
+        }
+    }
     p_read = p_head;
     inblockreadoffset = 0;
     consumed = 0;
@@ -154,6 +154,11 @@ namespace adaptive
                 vlc_tick_t          requestStartTime;
                 vlc_tick_t          responseTime;
                 vlc_tick_t          downloadEndTime;
+                vlc_tick_t          expiryTime; /* for caching */
+                bool                cacheStorable;
+                CacheValidators     cacheValidators;
+                CacheValidators     conditions; /* conditional request */
+                std::string         contentType;
 
             private:
                 bool init(const std::string &);
@@ -180,14 +185,18 @@ namespace adaptive
                 bool               isDone() const;
                 void               hold();
                 void               release();
+                void               revalidate(HTTPChunkBufferedSource *);
 
             private:
+                void               reuseStale();
+                HTTPChunkBufferedSource *stale; /* stored copy being revalidated */
                 block_t            *p_head; /* read cache buffer */
                 block_t           **pp_tail;
                 const block_t      *p_read;
                 size_t              inblockreadoffset;
                 size_t              buffered; /* read cache size */
                 bool                done;
+                bool                complete; /* done with all announced content */
                 bool                eof;
                 vlc::threads::condition_variable avail;
                 bool                held;
@@ -32,12 +32,21 @@ namespace adaptive
         enum class RequestStatus
         {
             Success,
+            NotModified,
             Redirection,
             Unauthorized,
             NotFound,
             GenericError,
         };
 
+        /* Response identifiers used for conditional requests */
+        struct CacheValidators
+        {
+            std::string etag;
+            std::string lastModified;
+            bool isEmpty() const { return etag.empty() && lastModified.empty(); }
+        };
+
         class BackendPrefInterface
         {
             /* Design Hack for now to force fallback on regular access
@@ -48,6 +48,8 @@ AbstractConnection::AbstractConnection(vlc_object_t *p_object_)
     available = true;
     bytesRead = 0;
     contentLength = 0;
+    cacheLifetime = VLC_TICK_MAX;
+    cacheStorable = true;
 }
 
 AbstractConnection::~AbstractConnection()
@@ -85,6 +87,21 @@ const ConnectionParams & AbstractConnection::getRedirection() const
     return locationparams;
 }
 
+vlc_tick_t AbstractConnection::getCacheLifetime() const
+{
+    return cacheLifetime;
+}
+
+bool AbstractConnection::isCacheStorable() const
+{
+    return cacheStorable;
+}
+
+const CacheValidators & AbstractConnection::getCacheValidators() const
+{
+    return cacheValidators;
+}
+
 class adaptive::http::LibVLCHTTPSource : public adaptive::BlockStreamInterface
 {
      public:
@@ -133,6 +150,14 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::BlockStreamInterface
         {
             vlc_http_msg_add_header(req, "Accept-Encoding", "deflate, gzip");
             vlc_http_msg_add_header(req, "Cache-Control", "no-cache");
+            if(!conditions.etag.empty() &&
+               vlc_http_msg_add_header(req, "If-None-Match", "%s",
+                                       conditions.etag.c_str()))
+                return -1;
+            if(!conditions.lastModified.empty() &&
+               vlc_http_msg_add_header(req, "If-Modified-Since", "%s",
+                                       conditions.lastModified.c_str()))
+                return -1;
             if(range.isValid())
             {
                 if(range.getEndByte() > 0)
@@ -189,6 +214,7 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::BlockStreamInterface
         size_t totalRead;
         struct vlc_http_mgr *http_mgr;
         BytesRange range;
+        CacheValidators conditions;
         struct vlc_http_resource *http_res;
         std::optional<std::string> username;
         std::optional<std::string> password;
@@ -225,8 +251,46 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::BlockStreamInterface
             return vlc_http_msg_get_size(http_res->response);
         }
 
+        /* no-cache responses can be stored, but must be revalidated before
+         * any reuse, as with an expired max-age */
+        vlc_tick_t getCacheLifetime() const
+        {
+            const struct vlc_http_msg *resp = http_res->response;
+            if(vlc_http_msg_get_token(resp, "Cache-Control", "no-cache"))
+                return 0;
+
+            const char *s = vlc_http_msg_get_token(resp, "Cache-Control", "max-age");
+            if(s)
+            {
+                s += strlen("max-age");
+                s += strspn(s, " \t");
+                if(*s == '=')
+                    return VLC_TICK_FROM_SEC(strtoul(s + 1, nullptr, 10));
+            }
+            return VLC_TICK_MAX;
+        }
+
+        bool isCacheStorable() const
+        {
+            return !vlc_http_msg_get_token(http_res->response,
+                                           "Cache-Control", "no-store");
+        }
+
+        CacheValidators getCacheValidators() const
+        {
+            CacheValidators validators;
+            const char *s = getResponseHeader("ETag");
+            if(s)
+                validators.etag = s;
+            s = getResponseHeader("Last-Modified");
+            if(s)
+                validators.lastModified = s;
+            return validators;
+        }
+
         int create(const ConnectionParams &params,const std::string &ua,
-                   const std::string &ref, const BytesRange &range)
+                   const std::string &ref, const BytesRange &range,
+                   const CacheValidators &conditions)
         {
             auto *tpl = static_cast<struct restuple *>(
                 std::malloc(sizeof(struct restuple)));
@@ -235,6 +299,7 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::BlockStreamInterface
 
             tpl->source = this;
             this->range = range;
+            this->conditions = conditions;
             this->lastparams = params;
             if (vlc_http_res_init(&tpl->resource, &this->callbacks, http_mgr,
                                   params.getUrl().c_str(),
@@ -305,6 +370,9 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::BlockStreamInterface
             if (status >= 400)
                 return RequestStatus::GenericError;
 
+            if (status == 304 && !conditions.isEmpty())
+                return RequestStatus::NotModified;
+
             char *psz_redir = vlc_http_res_get_redirect(http_res);
             if (psz_redir)
             {
@@ -388,6 +456,9 @@ void LibVLCHTTPConnection::reset()
     contentType = std::string();
     bytesRead = 0;
     contentLength = 0;
+    cacheLifetime = VLC_TICK_MAX;
+    cacheStorable = true;
+    cacheValidators = CacheValidators();
 }
 
 bool LibVLCHTTPConnection::canReuse(const ConnectionParams &params_) const
@@ -400,7 +471,8 @@ bool LibVLCHTTPConnection::canReuse(const ConnectionParams &params_) const
 }
 
 RequestStatus LibVLCHTTPConnection::request(const std::string &path,
-                                            const BytesRange &range)
+                                            const BytesRange &range,
+                                            const CacheValidators &conditions)
 {
     if(!source->isInitialized())
         return RequestStatus::GenericError;
@@ -416,7 +488,7 @@ RequestStatus LibVLCHTTPConnection::request(const std::string &path,
     else
         msg_Dbg(p_object, "Retrieving %s", params.getUrl().c_str());
 
-    if(source->create(params, useragent,referer, range))
+    if(source->create(params, useragent,referer, range, conditions))
         return RequestStatus::GenericError;
 
     /* Set credentials from URL. Deprecated warning will follow */
@@ -433,7 +505,15 @@ RequestStatus LibVLCHTTPConnection::request(const std::string &path,
         return RequestStatus::GenericError;
 
     RequestStatus status = source->connect();
-    if (status != RequestStatus::Success)
+    if (status == RequestStatus::NotModified)
+    {
+        /* Headers refresh the stored response, which has no body there */
+        cacheLifetime = source->getCacheLifetime();
+        cacheStorable = source->isCacheStorable();
+        cacheValidators = source->getCacheValidators();
+        return status;
+    }
+    else if (status != RequestStatus::Success)
     {
         if (status == RequestStatus::Redirection)
             locationparams = source->getFinalLocation();
@@ -446,6 +526,9 @@ RequestStatus LibVLCHTTPConnection::request(const std::string &path,
         return RequestStatus::GenericError;
 
     contentLength = source->getSize();
+    cacheLifetime = source->getCacheLifetime();
+    cacheStorable = source->isCacheStorable();
+    cacheValidators = source->getCacheValidators();
 
     const char *s = source->getResponseHeader("Content-Type");
     if(s)
@@ -513,7 +596,8 @@ bool StreamUrlConnection::canReuse(const ConnectionParams &params_) const
 }
 
 RequestStatus StreamUrlConnection::request(const std::string &path,
-                                           const BytesRange &range)
+                                           const BytesRange &range,
+                                           const CacheValidators &)
 {
     reset();
 
@@ -28,6 +28,7 @@
 #include "ConnectionParams.hpp"
 #include "BytesRange.hpp"
 #include <vlc_common.h>
+#include <vlc_tick.h>
 #include <string>
 
 namespace adaptive
@@ -53,13 +54,17 @@ namespace adaptive
                 virtual bool    canReuse     (const ConnectionParams &) const = 0;
 
                 virtual RequestStatus request(const std::string& path,
-                                              const BytesRange & = BytesRange()) = 0;
+                                              const BytesRange & = BytesRange(),
+                                              const CacheValidators & = CacheValidators()) = 0;
                 virtual ssize_t read        (void *p_buffer, size_t len) = 0;
 
                 virtual size_t  getContentLength() const;
                 virtual size_t  getBytesRead() const;
                 virtual const std::string & getContentType() const;
                 virtual const ConnectionParams &getRedirection() const;
+                virtual vlc_tick_t getCacheLifetime() const;
+                virtual bool    isCacheStorable() const;
+                virtual const CacheValidators & getCacheValidators() const;
                 virtual void    setUsed( bool ) = 0;
 
             protected:
@@ -71,6 +76,9 @@ namespace adaptive
                 std::string        contentType;
                 BytesRange         bytesRange;
                 size_t             bytesRead;
+                vlc_tick_t         cacheLifetime; /* 0 if stale on arrival */
+                bool               cacheStorable;
+                CacheValidators    cacheValidators;
         };
 
        class LibVLCHTTPSource;
@@ -82,7 +90,8 @@ namespace adaptive
                virtual ~LibVLCHTTPConnection();
                bool    canReuse     (const ConnectionParams &) const override;
                RequestStatus request(const std::string& path,
-                                     const BytesRange & = BytesRange()) override;
+                                     const BytesRange & = BytesRange(),
+                                     const CacheValidators & = CacheValidators()) override;
                ssize_t read         (void *p_buffer, size_t len) override;
                void    setUsed      ( bool ) override;
 
@@ -104,7 +113,8 @@ namespace adaptive
                 bool    canReuse     (const ConnectionParams &) const override;
 
                 RequestStatus request(const std::string& path,
-                                      const BytesRange & = BytesRange()) override;
+                                      const BytesRange & = BytesRange(),
+                                      const CacheValidators & = CacheValidators()) override;
                 ssize_t read        (void *p_buffer, size_t len) override;
 
                 void    setUsed( bool ) override;
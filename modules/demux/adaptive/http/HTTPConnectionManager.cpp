@@ -81,22 +81,16 @@ HTTPConnectionManager::HTTPConnectionManager    (vlc_object_t *p_object_)
     downloaderhp = new Downloader();
     downloader->start();
     downloaderhp->start();
-    cache_total = 0;
-    cache_max = 1 << 19;
+    cache.total = 0;
+    cache.max = 1 << 19;
+    segmentsCache.total = 0;
+    segmentsCache.max = (size_t) var_InheritInteger(p_object, "adaptive-cachesize") << 20;
 }
 
 HTTPConnectionManager::~HTTPConnectionManager   ()
 {
-    while(!cache.empty())
-    {
-        HTTPChunkBufferedSource *purged = cache.back();
-        cache.pop_back();
-        assert(cache_total >= purged->contentLength);
-        cache_total -= purged->contentLength;
-        CacheDebug(msg_Dbg(p_object, "Cache DEL '%s' usage %zu bytes",
-                            purged->getStorageID().c_str(), cache_total));
-        deleteSource(purged);
-    }
+    cachePurge(cache, 0);
+    cachePurge(segmentsCache, 0);
     delete downloader;
     delete downloaderhp;
     this->closeAllConnections();
@@ -168,73 +162,122 @@ AbstractConnection * HTTPConnectionManager::getConnection(ConnectionParams &para
     return conn;
 }
 
+HTTPChunkBufferedSource * HTTPConnectionManager::cacheGet(SourcesCache &c,
+                                                          const StorageID &storageid)
+{
+    for(auto it = c.sources.begin(); it != c.sources.end(); ++it)
+    {
+        HTTPChunkBufferedSource *s = *it;
+        if(s->getStorageID() != storageid)
+            continue;
+
+        c.sources.erase(it);
+        assert(c.total >= s->contentLength);
+        c.total -= s->contentLength;
+        CacheDebug(msg_Dbg(p_object, "Cache GET '%s' usage %zu bytes",
+                           storageid.c_str(), c.total));
+        return s;
+    }
+    return nullptr;
+}
+
+bool HTTPConnectionManager::cachePut(SourcesCache &c, HTTPChunkBufferedSource *buf)
+{
+    if(buf->getStorageID().empty() ||
+       !buf->contentLength || buf->contentLength >= c.max)
+        return false;
+
+    cachePurge(c, c.max - buf->contentLength);
+    c.sources.push_front(buf);
+    c.total += buf->contentLength;
+    CacheDebug(msg_Dbg(p_object, "Cache PUT '%s' usage %zu bytes",
+                       buf->getStorageID().c_str(), c.total));
+    return true;
+}
+
+void HTTPConnectionManager::cachePurge(SourcesCache &c, size_t limit)
+{
+    /* Evict least recently used until usage fits */
+    while(c.total > limit)
+    {
+        HTTPChunkBufferedSource *purged = c.sources.back();
+        c.sources.pop_back();
+        assert(c.total >= purged->contentLength);
+        c.total -= purged->contentLength;
+        CacheDebug(msg_Dbg(p_object, "Cache DEL '%s' usage %zu bytes",
+                           purged->getStorageID().c_str(), c.total));
+        deleteSource(purged);
+    }
+}
+
 AbstractChunkSource *HTTPConnectionManager::makeSource(const std::string &url,
                                                        const ID &id, ChunkType type,
                                                        const BytesRange &range)
 {
     StorageID storageid = HTTPChunkSource::makeStorageID(url, range);
+    HTTPChunkBufferedSource *cached = nullptr;
     switch(type)
     {
         case ChunkType::Init:
         case ChunkType::Index:
-            for(HTTPChunkBufferedSource *s : cache)
+            cached = cacheGet(cache, storageid);
+            break;
+        case ChunkType::Segment:
+            /* Already downloaded data, ie. when seeking back */
+            cached = cacheGet(segmentsCache, storageid);
+            if(cached && cached->expiryTime <= vlc_tick_now())
             {
-                if(s->getStorageID() == storageid)
+                /* Stale: the server has to confirm it first */
+                if(cached->cacheValidators.isEmpty())
                 {
-                    cache.remove(s);
-                    assert(cache_total >= s->contentLength);
-                    cache_total -= s->contentLength;
-                    CacheDebug(msg_Dbg(p_object, "Cache GET '%s' usage %zu bytes",
-                                       storageid.c_str(), cache_total));
-                    return s;
+                    deleteSource(cached);
+                    cached = nullptr;
+                    break;
                 }
+                HTTPChunkBufferedSource *source =
+                        new HTTPChunkBufferedSource(url, this, id, type, range);
+                source->revalidate(cached);
+                return source;
             }
-            // fallthrough
-        case ChunkType::Segment:
+            break;
         case ChunkType::Key:
         case ChunkType::Playlist:
         default:
-            return new HTTPChunkBufferedSource(url, this, id, type, range);
+            break;
     }
+    if(cached)
+        return cached;
+    return new HTTPChunkBufferedSource(url, this, id, type, range);
 }
 
 void HTTPConnectionManager::recycleSource(AbstractChunkSource *source)
 {
-    bool b_cacheable;
-    switch(source->getChunkType())
-    {
-        case ChunkType::Index:
-        case ChunkType::Init:
-            b_cacheable = true;
-            break;
-        case ChunkType::Key:
-        case ChunkType::Playlist:
-        case ChunkType::Segment:
-        default:
-            b_cacheable = false;
-            break;
-    }
-
     HTTPChunkBufferedSource *buf = dynamic_cast<HTTPChunkBufferedSource *>(source);
-    if(buf && b_cacheable && !buf->getStorageID().empty() &&
-       buf->contentLength && buf->contentLength < cache_max)
+    bool b_cached = false;
+    if(buf)
     {
-        while(cache_max < cache_total + buf->contentLength)
+        switch(source->getChunkType())
         {
-            HTTPChunkBufferedSource *purged = cache.back();
-            cache.pop_back();
-            assert(cache_total >= purged->contentLength);
-            cache_total -= purged->contentLength;
-            CacheDebug(msg_Dbg(p_object, "Cache DEL '%s' usage %zu bytes",
-                               purged->getStorageID().c_str(), cache_total));
-            deleteSource(purged);
+            case ChunkType::Index:
+            case ChunkType::Init:
+                b_cached = cachePut(cache, buf);
+                break;
+            case ChunkType::Segment:
+                /* Partial data would be served as a whole segment, and
+                 * expired responses can only be reused once revalidated */
+                if(buf->complete && buf->cacheStorable &&
+                   (buf->expiryTime > vlc_tick_now() ||
+                    !buf->cacheValidators.isEmpty()))
+                    b_cached = cachePut(segmentsCache, buf);
+                break;
+            case ChunkType::Key:
+            case ChunkType::Playlist:
+            default:
+                break;
         }
-        cache.push_front(buf);
-        cache_total += buf->contentLength;
-        CacheDebug(msg_Dbg(p_object, "Cache PUT '%s' usage %zu bytes",
-                           buf->getStorageID().c_str(), cache_total));
     }
-    else
+
+    if(!b_cached)
         deleteSource(source);
 }
 
@@ -46,6 +46,7 @@ namespace adaptive
         class AbstractChunkSource;
         class HTTPChunkBufferedSource;
         enum class ChunkType;
+        using StorageID = std::string;
 
         class AbstractConnectionManager : public IDownloadRateObserver
         {
@@ -105,9 +106,19 @@ namespace adaptive
                 bool                                                localAllowed;
                 AbstractConnection * reuseConnection(ConnectionParams &);
                 Downloader * getDownloadQueue(const AbstractChunkSource *) const;
-                std::list<HTTPChunkBufferedSource *> cache;
-                size_t cache_total;
-                size_t cache_max;
+
+                /* Completed sources kept for reuse, most recent first */
+                struct SourcesCache
+                {
+                    std::list<HTTPChunkBufferedSource *> sources;
+                    size_t total;
+                    size_t max;
+                };
+                HTTPChunkBufferedSource * cacheGet(SourcesCache &, const StorageID &);
+                bool cachePut(SourcesCache &, HTTPChunkBufferedSource *);
+                void cachePurge(SourcesCache &, size_t);
+                SourcesCache cache; /* init and index */
+                SourcesCache segmentsCache;
         };
     }
 }
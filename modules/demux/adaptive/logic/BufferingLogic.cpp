@@ -53,6 +53,11 @@ void AbstractBufferingLogic::setLowDelay(bool b)
     userLowLatency = b;
 }
 
+bool AbstractBufferingLogic::isLowLatency(const BasePlaylist *p) const
+{
+    return userLowLatency.value_or(p->isLowLatency());
+}
+
 void AbstractBufferingLogic::setUserMinBuffering(vlc_tick_t v)
 {
     userMinBuffering = v;
@@ -128,7 +133,7 @@ vlc_tick_t DefaultBufferingLogic::getMaxBuffering(const BasePlaylist *p) const
 vlc_tick_t DefaultBufferingLogic::getLiveDelay(const BasePlaylist *p) const
 {
     if(isLowLatency(p))
-        return getMinBuffering(p);
+        return std::max(p->targetLatency, getMinBuffering(p));
     vlc_tick_t delay = userLiveDelay ? userLiveDelay
                                      : DEFAULT_LIVE_BUFFERING;
     if(p->suggestedPresentationDelay)
@@ -271,7 +276,9 @@ uint64_t DefaultBufferingLogic::getLiveStartSegmentNumber(BaseRepresentation *re
                 start = startnumber;
             }
 
-            const uint64_t max_safety_offset = playbacktime - minavailtime / duration;
+            /* in low latency, the live delay already is the only margin */
+            const uint64_t max_safety_offset = isLowLatency(playlist)
+                                             ? 0 : playbacktime - minavailtime / duration;
             const uint64_t safety_offset = std::min((uint64_t)SAFETY_BUFFERING_EDGE_OFFSET,
                                                     max_safety_offset);
             if(startnumber + safety_offset <= start)
@@ -384,8 +391,3 @@ vlc_tick_t DefaultBufferingLogic::getBufferingOffset(const BasePlaylist *p) cons
 {
     return p->isLive() ? getLiveDelay(p) : getMaxBuffering(p);
 }
-
-bool DefaultBufferingLogic::isLowLatency(const BasePlaylist *p) const
-{
-    return userLowLatency.value_or(p->isLowLatency());
-}
@@ -48,6 +48,9 @@ BasePlaylist::BasePlaylist (vlc_object_t *p_object_) :
     timeShiftBufferDepth = 0;
     suggestedPresentationDelay = 0;
     presentationStartOffset = 0;
+    targetLatency = 0;
+    minPlaybackRate = 1.0;
+    maxPlaybackRate = 1.0;
     b_needsUpdates = true;
 }
 
@@ -74,6 +74,9 @@ namespace adaptive
                 vlc_tick_t                   timeShiftBufferDepth;
                 vlc_tick_t                   suggestedPresentationDelay;
                 vlc_tick_t                   presentationStartOffset;
+                vlc_tick_t                   targetLatency;
+                double                       minPlaybackRate;
+                double                       maxPlaybackRate;
 
             protected:
                 vlc_object_t                       *p_object;
@@ -30,6 +30,7 @@
 #include "SegmentInformation.hpp"
 #include "SegmentTimeline.h"
 
+#include <algorithm>
 #include <limits>
 #include <cassert>
 
@@ -41,6 +42,7 @@ SegmentList::SegmentList( SegmentInformation *parent_, bool b_relative ):
 {
     totalLength = 0;
     b_relative_mediatimes = b_relative;
+    windowStart = std::numeric_limits<uint64_t>::max();
 }
 SegmentList::~SegmentList()
 {
@@ -101,19 +103,48 @@ void SegmentList::updateWith(AbstractMultipleSegmentBaseType *updated_,
 
     b_restamp = b_relative_mediatimes;
 
+    const uint64_t oldest = std::min(updated->windowStart,
+                                     updated->segments.front()->getSequenceNumber());
+
     if(!b_restamp || segments.empty())
     {
+        Segment *prevSegment = nullptr;
         if(!segments.empty())
-            pruneBySegmentNumber(std::numeric_limits<uint64_t>::max());
-        assert(segments.empty());
+        {
+            /* keep the part of the window the update did not list */
+            pruneBySegmentNumber(oldest);
+            const uint64_t first = updated->segments.front()->getSequenceNumber();
+            while(!segments.empty() && segments.back()->getSequenceNumber() >= first)
+            {
+                totalLength -= segments.back()->duration;
+                delete segments.back();
+                segments.pop_back();
+            }
+            if(!segments.empty())
+                prevSegment = segments.back();
+        }
         for(auto seg : updated->segments)
+        {
+            if(prevSegment)
+            {
+                seg->startTime = prevSegment->startTime + prevSegment->duration;
+                prevSegment = seg;
+            }
             addSegment(seg);
+        }
         updated->segments.clear();
     }
     else
     {
-        const Segment * prevSegment = segments.back();
-        const uint64_t oldest = updated->segments.front()->getSequenceNumber();
+        Segment * prevSegment = segments.back();
+
+        /* the last segment might have been listed while still growing */
+        const Segment *known = updated->getMediaSegment(prevSegment->getSequenceNumber());
+        if(known && known->duration > prevSegment->duration)
+        {
+            totalLength += known->duration - prevSegment->duration;
+            prevSegment->duration = known->duration;
+        }
 
         /* filter out known segments from the update */
         updated->pruneBySegmentNumber(prevSegment->getSequenceNumber() + 1);
@@ -168,6 +199,11 @@ void SegmentList::pruneBySegmentNumber(uint64_t tobelownum)
     }
 }
 
+void SegmentList::setWindowStart(uint64_t start)
+{
+    windowStart = start;
+}
+
 bool SegmentList::getPlaybackTimeDurationBySegmentNumber(uint64_t number,
                                                          vlc_tick_t *time, vlc_tick_t *dur) const
 {
@@ -49,6 +49,7 @@ namespace adaptive
                 void                    pruneByPlaybackTime(vlc_tick_t);
                 stime_t                 getTotalLength() const;
                 bool                    hasRelativeMediaTimes() const;
+                void                    setWindowStart(uint64_t);
 
                 vlc_tick_t  getMinAheadTime(uint64_t) const override;
                 Segment * getMediaSegment(uint64_t pos) const override;
@@ -64,6 +65,7 @@ namespace adaptive
                 std::vector<Segment *>  segments;
                 stime_t totalLength;
                 bool b_relative_mediatimes;
+                uint64_t windowStart; /* when only the end of the window is listed */
         };
     }
 }
@@ -105,6 +105,10 @@ uint64_t SegmentTemplate::getLiveTemplateNumber(vlc_tick_t playbacktime, bool ab
                     parentSegmentInformation->getPlaylist()->availabilityStartTime;
             streamstart += parentSegmentInformation->getPeriodStart();
             playbacktime -= streamstart;
+            /* Segments are available availabilityTimeOffset before their
+             * end, whether or not playback is low latency. A large offset
+             * makes the segment being produced requestable. */
+            playbacktime += inheritAvailabilityTimeOffset();
         }
         stime_t elapsed = timescale.ToScaled(playbacktime) - dur;
         if(elapsed > 0)
@@ -43,24 +43,27 @@ SegmentTimeline::SegmentTimeline(AbstractMultipleSegmentBaseType *parent_)
 
 SegmentTimeline::~SegmentTimeline()
 {
-    std::list<Element *>::iterator it;
-    for(it = elements.begin(); it != elements.end(); ++it)
-        delete *it;
 }
 
 void SegmentTimeline::addElement(uint64_t number, stime_t d, uint64_t r, stime_t t)
 {
-    Element *element = new (std::nothrow) Element(number, d, r, t);
-    if(element)
-    {
-        if(!elements.empty() && !t)
-        {
-            const Element *el = elements.back();
-            element->t = el->t + (el->d * (el->r + 1));
-        }
-        elements.push_back(element);
-        totalLength += (d * (r + 1));
-    }
+    if(!elements.empty() && !t)
+        t = elements.back().end();
+    elements.emplace_back(number, d, r, t);
+    totalLength += (d * (r + 1));
+}
+
+SegmentTimeline::Elements::const_iterator SegmentTimeline::findByNumber(uint64_t number) const
+{
+    Elements::const_iterator it =
+        std::upper_bound(elements.begin(), elements.end(), number,
+                         [](uint64_t n, const Element &el) { return n < el.number; });
+    if(it == elements.begin())
+        return elements.end();
+    --it;
+    if(number > it->number + it->r)
+        return elements.end();
+    return it;
 }
 
 stime_t SegmentTimeline::getMinAheadScaledTime(uint64_t number) const
@@ -72,16 +75,16 @@ stime_t SegmentTimeline::getMinAheadScaledTime(uint64_t number) const
        maxElementNumber() < number)
         return 0;
 
-    std::list<Element *>::const_reverse_iterator it;
+    Elements::const_reverse_iterator it;
     for(it = elements.rbegin(); it != elements.rend(); ++it)
     {
-        const Element *el = *it;
-        if(number > el->number + el->r)
+        const Element &el = *it;
+        if(number > el.number + el.r)
             break;
-        else if(number < el->number)
-            totalscaledtime += (el->d * (el->r + 1));
+        else if(number < el.number)
+            totalscaledtime += (el.d * (el.r + 1));
         else /* within repeat range */
-            totalscaledtime += el->d * (el->number + el->r - number);
+            totalscaledtime += el.d * (el.number + el.r - number);
     }
 
     return totalscaledtime;
@@ -89,53 +92,33 @@ stime_t SegmentTimeline::getMinAheadScaledTime(uint64_t number) const
 
 uint64_t SegmentTimeline::getElementNumberByScaledPlaybackTime(stime_t scaled) const
 {
-    const Element *prevel = nullptr;
-    std::list<Element *>::const_iterator it;
-
     if(!elements.size())
         return 0;
 
-    for(it = elements.begin(); it != elements.end(); ++it)
-    {
-        const Element *el = *it;
-        if(scaled >= el->t)
-        {
-            if((uint64_t)scaled < el->t + (el->d * (el->r + 1)))
-                return el->number + (scaled - el->t) / el->d;
-        }
-        /* might have been discontinuity */
-        else
-        {
-            if(prevel) /* > prev but < current */
-                return prevel->number + prevel->r;
-            else /* << first of the list */
-                return el->number;
-        }
-        prevel = el;
-    }
+    Elements::const_iterator it =
+        std::upper_bound(elements.begin(), elements.end(), scaled,
+                         [](stime_t t, const Element &el) { return t < el.t; });
+    /* << first of the list */
+    if(it == elements.begin())
+        return it->number;
 
-    /* time is >> any of the list */
-    return prevel->number + prevel->r;
+    const Element &el = *(--it);
+    if(el.contains(scaled))
+        return el.number + (scaled - el.t) / el.d;
+
+    /* might have been discontinuity, or time is >> any of the list */
+    return el.number + el.r;
 }
 
 bool SegmentTimeline::getScaledPlaybackTimeDurationBySegmentNumber(uint64_t number,
                                                                    stime_t *time, stime_t *duration) const
 {
-    std::list<Element *>::const_iterator it;
-    for(it = elements.begin(); it != elements.end(); ++it)
-    {
-        const Element *el = *it;
-        if(number >= el->number)
-        {
-            if(number <= el->number + el->r)
-            {
-                *time = el->t + el->d * (number - el->number);
-                *duration = el->d;
-                return true;
-            }
-        }
-    }
-    return false;
+    Elements::const_iterator it = findByNumber(number);
+    if(it == elements.end())
+        return false;
+    *time = it->t + it->d * (number - it->number);
+    *duration = it->d;
+    return true;
 }
 
 stime_t SegmentTimeline::getScaledPlaybackTimeByElementNumber(uint64_t number) const
@@ -155,30 +138,23 @@ uint64_t SegmentTimeline::maxElementNumber() const
     if(elements.empty())
         return 0;
 
-    const Element *e = elements.back();
-    return e->number + e->r;
+    const Element &e = elements.back();
+    return e.number + e.r;
 }
 
 uint64_t SegmentTimeline::minElementNumber() const
 {
     if(elements.empty())
         return 0;
-    return elements.front()->number;
+    return elements.front().number;
 }
 
 uint64_t SegmentTimeline::getElementIndexBySequence(uint64_t number) const
 {
-    std::list<Element *>::const_iterator it;
-    for(it = elements.begin(); it != elements.end(); ++it)
-    {
-        const Element *el = *it;
-        if(number >= el->number)
-        {
-            if(number <= el->number + el->r)
-                return std::distance(elements.begin(), it);
-        }
-    }
-    return std::numeric_limits<uint64_t>::max();
+    Elements::const_iterator it = findByNumber(number);
+    if(it == elements.end())
+        return std::numeric_limits<uint64_t>::max();
+    return std::distance(elements.begin(), it);
 }
 
 void SegmentTimeline::pruneByPlaybackTime(vlc_tick_t time)
@@ -193,27 +169,26 @@ size_t SegmentTimeline::pruneBySequenceNumber(uint64_t number)
     size_t prunednow = 0;
     while(elements.size())
     {
-        Element *el = elements.front();
-        if(el->number >= number)
+        Element &el = elements.front();
+        if(el.number >= number)
         {
             break;
         }
-        else if(el->number + el->r >= number)
+        else if(el.number + el.r >= number)
         {
-            uint64_t count = number - el->number;
-            el->number += count;
-            el->t += count * el->d;
-            el->r -= count;
+            uint64_t count = number - el.number;
+            el.number += count;
+            el.t += count * el.d;
+            el.r -= count;
             prunednow += count;
-            totalLength -= count * el->d;
+            totalLength -= count * el.d;
             break;
         }
         else
         {
-            prunednow += el->r + 1;
+            prunednow += el.r + 1;
+            totalLength -= (el.d * (el.r + 1));
             elements.pop_front();
-            totalLength -= (el->d * (el->r + 1));
-            delete el;
         }
     }
 
@@ -224,40 +199,38 @@ void SegmentTimeline::updateWith(SegmentTimeline &other)
 {
     if(elements.empty())
     {
-        while(other.elements.size())
-        {
-            elements.push_back(other.elements.front());
-            other.elements.pop_front();
-        }
+        elements.swap(other.elements);
+        totalLength = other.totalLength;
+        other.totalLength = 0;
         return;
     }
 
-    Element *last = elements.back();
-    while(other.elements.size())
+    /* A refreshed manifest repeats most of the window we already have:
+     * skip straight to the entries starting at or after our last one. */
+    Element *last = &elements.back();
+    Elements::const_iterator it =
+        std::lower_bound(other.elements.cbegin(), other.elements.cend(), last->t,
+                         [](const Element &el, stime_t t) { return el.t < t; });
+    for(; it != other.elements.cend(); ++it)
     {
-        Element *el = other.elements.front();
-        other.elements.pop_front();
-
-        if(last->contains(el->t)) /* Same element, but prev could have been middle of repeat */
+        const Element &el = *it;
+        if(last->contains(el.t)) /* Same element, but prev could have been middle of repeat */
         {
-            const uint64_t count = (el->t - last->t) / last->d;
+            const uint64_t count = (el.t - last->t) / last->d;
             totalLength -= (last->d * (last->r + 1));
-            last->r = std::max(last->r, el->r + count);
+            last->r = std::max(last->r, el.r + count);
             totalLength += (last->d * (last->r + 1));
-            delete el;
-        }
-        else if(el->t < last->t)
-        {
-            delete el;
         }
         else /* Did not exist in previous list */
         {
-            totalLength += (el->d * (el->r + 1));
-            elements.push_back(el);
-            el->number = last->number + last->r + 1;
-            last = el;
+            totalLength += (el.d * (el.r + 1));
+            elements.emplace_back(last->number + last->r + 1, el.d, el.r, el.t);
+            last = &elements.back();
         }
     }
+
+    other.elements.clear();
+    other.totalLength = 0;
 }
 
 void SegmentTimeline::debug(vlc_object_t *obj, int indent) const
@@ -266,9 +239,9 @@ void SegmentTimeline::debug(vlc_object_t *obj, int indent) const
     ss << std::string(indent, ' ') << "Timeline";
     msg_Dbg(obj, "%s", ss.str().c_str());
 
-    std::list<Element *>::const_iterator it;
+    Elements::const_iterator it;
     for(it = elements.begin(); it != elements.end(); ++it)
-        (*it)->debug(obj, indent + 1);
+        it->debug(obj, indent + 1);
 }
 
 SegmentTimeline::Element::Element(uint64_t number_, stime_t d_, uint64_t r_, stime_t t_)
@@ -281,11 +254,16 @@ SegmentTimeline::Element::Element(uint64_t number_, stime_t d_, uint64_t r_, sti
 
 bool SegmentTimeline::Element::contains(stime_t time) const
 {
-    if(time >= t && time < t + (stime_t)(r + 1) * d)
+    if(time >= t && time < end())
         return true;
     return false;
 }
 
+stime_t SegmentTimeline::Element::end() const
+{
+    return t + (stime_t)(r + 1) * d;
+}
+
 void SegmentTimeline::Element::debug(vlc_object_t *obj, int indent) const
 {
     std::stringstream ss;
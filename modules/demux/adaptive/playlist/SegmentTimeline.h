@@ -26,7 +26,7 @@
 #include "Inheritables.hpp"
 
 #include <vlc_common.h>
-#include <list>
+#include <deque>
 
 namespace adaptive
 {
@@ -36,8 +36,6 @@ namespace adaptive
 
         class SegmentTimeline : public AttrsNode
         {
-            class Element;
-
             public:
                 SegmentTimeline(AbstractMultipleSegmentBaseType *);
                 virtual ~SegmentTimeline();
@@ -56,21 +54,27 @@ namespace adaptive
                 void debug(vlc_object_t *, int = 0) const;
 
             private:
-                std::list<Element *> elements;
-                stime_t totalLength;
-                AbstractMultipleSegmentBaseType *parent;
-
+                /* One S entry, with its repeats. Elements are stored by value
+                 * and sorted by both number and time, so that lookups on
+                 * long DVR windows are logarithmic. */
                 class Element
                 {
                     public:
                         Element(uint64_t, stime_t, uint64_t, stime_t);
                         void debug(vlc_object_t *, int = 0) const;
                         bool contains(stime_t) const;
+                        stime_t  end() const;
                         stime_t  t;
                         stime_t  d;
                         uint64_t r;
                         uint64_t number;
                 };
+
+                using Elements = std::deque<Element>;
+                Elements::const_iterator findByNumber(uint64_t) const;
+                Elements elements;
+                stime_t totalLength;
+                AbstractMultipleSegmentBaseType *parent;
         };
     }
 }
@@ -144,6 +144,13 @@ int BufferingLogic_test()
         Expect(bufferinglogic.getMinBuffering(playlist) >= DefaultBufferingLogic::BUFFERING_LOWEST_LIMIT);
         Expect(bufferinglogic.getLiveDelay(playlist) >= DefaultBufferingLogic::BUFFERING_LOWEST_LIMIT);
 
+        /* latency target from the playlist */
+        playlist->targetLatency = DefaultBufferingLogic::BUFFERING_LOWEST_LIMIT * 2;
+        Expect(bufferinglogic.getLiveDelay(playlist) == playlist->targetLatency);
+        playlist->targetLatency = DefaultBufferingLogic::BUFFERING_LOWEST_LIMIT / 2;
+        Expect(bufferinglogic.getLiveDelay(playlist) == DefaultBufferingLogic::BUFFERING_LOWEST_LIMIT);
+        playlist->targetLatency = 0;
+
         playlist->b_lowlatency = false;
         Expect(bufferinglogic.getStartSegmentNumber(rep) == number);
 
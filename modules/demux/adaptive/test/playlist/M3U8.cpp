@@ -585,5 +585,71 @@ int M3U8Playlist_test()
     }
 
 
+    /* Manifest 7 */
+    const char manifest7[] =
+        "#EXTM3U\n"
+        "#EXT-X-TARGETDURATION:4\n"
+        "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=1.0,CAN-SKIP-UNTIL=24.0\n"
+        "#EXT-X-PART-INF:PART-TARGET=0.5\n"
+        "#EXT-X-MEDIA-SEQUENCE:10\n"
+        "#EXTINF:4,\n"
+        "foobar10.mp4\n"
+        "#EXT-X-PART:DURATION=0.5,URI=\"foobar11.mp4\",BYTERANGE=\"1000@0\",INDEPENDENT=YES\n"
+        "#EXT-X-PART:DURATION=0.5,URI=\"foobar11.mp4\",BYTERANGE=\"2000\"\n"
+        "#EXTINF:1,\n"
+        "foobar11.mp4\n"
+        "#EXT-X-PART:DURATION=0.5,URI=\"foobar12.0.mp4\",INDEPENDENT=YES\n"
+        "#EXT-X-PART:DURATION=0.5,URI=\"foobar12.1.mp4\",GAP=YES\n"
+        "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"foobar12.2.mp4\"\n";
+
+    m3u = ParseM3U8(obj, manifest7, sizeof(manifest7));
+    try
+    {
+        Expect(m3u);
+        Expect(m3u->isLive() == true);
+        Expect(m3u->isLowLatency() == true);
+        HLSRepresentation *rep = dynamic_cast<HLSRepresentation *>(
+                    m3u->getFirstPeriod()->getAdaptationSets().front()->
+                    getRepresentations().front());
+        Expect(rep);
+        Expect(rep->getProfile()->getStartSegmentNumber() == 10);
+        Expect(rep->getPlaylistUpdateUrl().find("_HLS_msn=12&_HLS_part=2") != std::string::npos);
+
+        HLSSegment *seg = dynamic_cast<HLSSegment *>(rep->getMediaSegment(11));
+        Expect(seg);
+        Expect(seg->getPartialSegment());
+        Expect(seg->getPartialSegment()->isComplete());
+        HLSPart part;
+        Expect(seg->getPartialSegment()->getPart(1, &part));
+        Expect(part.range.getStartByte() == 1000);
+        Expect(part.range.getEndByte() == 2999);
+        Expect(!seg->getPartialSegment()->getPart(2, &part));
+
+        /* segment still being produced */
+        seg = dynamic_cast<HLSSegment *>(rep->getMediaSegment(12));
+        Expect(seg);
+        Expect(seg->startTime == (stime_t) vlc_tick_from_sec(5));
+        Expect(seg->duration == (stime_t) vlc_tick_from_sec(1));
+        Expect(seg->getPartialSegment());
+        Expect(!seg->getPartialSegment()->isComplete());
+        Expect(seg->getPartialSegment()->getPart(0, &part));
+        Expect(part.independent);
+        Expect(seg->getPartialSegment()->getPart(1, &part));
+        Expect(part.gap);
+        Expect(seg->getPartialSegment()->getPart(2, &part));
+        Expect(part.url.find("foobar12.2.mp4") != std::string::npos);
+        Expect(!seg->getPartialSegment()->getPart(3, &part));
+        Expect(seg->getPartialSegment()->getReloadUrl(3).find("_HLS_msn=12&_HLS_part=3") !=
+               std::string::npos);
+
+        delete m3u;
+    }
+    catch (...)
+    {
+        delete m3u;
+        return 1;
+    }
+
+
     return 0;
 }
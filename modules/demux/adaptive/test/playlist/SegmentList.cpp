@@ -233,6 +233,66 @@ int SegmentList_test() try
     segmentList.reset();
     segmentList2.reset();
 
+    /* delta update, only listing the end of the window */
+    segmentList = std::make_unique<SegmentList>(nullptr, true);
+    segmentList->addAttribute(new TimescaleAttr(timescale));
+    for(int i=0; i<5; i++)
+    {
+        seg = std::make_unique<Segment>(nullptr);
+        seg->setSequenceNumber(123 + i);
+        seg->startTime = START + 100 * i;
+        seg->duration = 100;
+        segmentList->addSegment(seg.release());
+    }
+    segmentList2 = std::make_unique<SegmentList>(nullptr, true);
+    segmentList2->setWindowStart(124);
+    for(int i=3; i<6; i++)
+    {
+        seg = std::make_unique<Segment>(nullptr);
+        seg->setSequenceNumber(123 + i);
+        seg->startTime = 100 * (i - 3);
+        seg->duration = 100;
+        segmentList2->addSegment(seg.release());
+    }
+    segmentList->updateWith(segmentList2.get());
+    Expect(segmentList->getStartSegmentNumber() == 124);
+    Expect(segmentList->getSegments().size() == 5);
+    Expect(segmentList->getSegments().back()->getSequenceNumber() == 128);
+    Expect(segmentList->getSegments().back()->startTime == START + 100 * 5);
+    Expect(segmentList->getTotalLength() == 100 * 5);
+
+    segmentList.reset();
+    segmentList2.reset();
+
+    /* last segment still growing when listed */
+    segmentList = std::make_unique<SegmentList>(nullptr, true);
+    segmentList->addAttribute(new TimescaleAttr(timescale));
+    for(int i=0; i<2; i++)
+    {
+        seg = std::make_unique<Segment>(nullptr);
+        seg->setSequenceNumber(123 + i);
+        seg->startTime = START + 100 * i;
+        seg->duration = i ? 40 : 100;
+        segmentList->addSegment(seg.release());
+    }
+    segmentList2 = std::make_unique<SegmentList>(nullptr, true);
+    for(int i=1; i<3; i++)
+    {
+        seg = std::make_unique<Segment>(nullptr);
+        seg->setSequenceNumber(123 + i);
+        seg->startTime = 100 * i;
+        seg->duration = 100;
+        segmentList2->addSegment(seg.release());
+    }
+    segmentList->updateWith(segmentList2.get());
+    Expect(segmentList->getSegments().size() == 2);
+    Expect(segmentList->getSegments().at(0)->duration == 100);
+    Expect(segmentList->getSegments().at(1)->startTime == START + 100 * 2);
+    Expect(segmentList->getTotalLength() == 100 * 2);
+
+    segmentList.reset();
+    segmentList2.reset();
+
     /* Tricky now, check timelined */
     segmentList = std::make_unique<SegmentList>(nullptr);
     segmentList->addAttribute(new TimescaleAttr(timescale));
@@ -96,6 +96,14 @@ int SegmentTemplate_test()
         Expect(templ->getLiveTemplateNumber(now + timescale.ToTime(100) * 2 + 1, true) ==
                templ->getStartSegmentNumber() + 1);
 
+        /* segment being produced is announced availabilityTimeOffset earlier */
+        const vlc_tick_t inprogress = now + timescale.ToTime(100 + 20);
+        Expect(templ->getLiveTemplateNumber(inprogress, true) == templ->getStartSegmentNumber());
+        set->addAttribute(new AvailabilityTimeOffsetAttr(timescale.ToTime(90)));
+        Expect(templ->getLiveTemplateNumber(inprogress, true) ==
+               templ->getStartSegmentNumber() + 1);
+        set->replaceAttribute(new AvailabilityTimeOffsetAttr(0));
+
         /* reset */
         pl->availabilityStartTime = 0;
         pl->availabilityEndTime = 0;
@@ -172,6 +172,29 @@ int Timeline_test()
 
         delete timeline;
         delete timeline2;
+        timeline2 = nullptr;
+
+        /* Long window refreshed with a slid and extended one */
+        timeline = new SegmentTimeline(nullptr);
+        for(uint64_t i = 0; i < 10000; i++)
+            timeline->addElement(1 + i, 100 + (i % 2), 0, 0);
+        Expect(timeline->maxElementNumber() == 10000);
+        Expect(timeline->getTotalLength() == 10000 * 100 + 5000);
+        Expect(timeline->getElementIndexBySequence(5001) == 5000);
+        Expect(timeline->getScaledPlaybackTimeByElementNumber(5001) == 5000 * 100 + 2500);
+        Expect(timeline->getElementNumberByScaledPlaybackTime(5000 * 100 + 2500 + 50) == 5001);
+
+        timeline2 = new SegmentTimeline(nullptr);
+        for(uint64_t i = 100; i < 10010; i++)
+            timeline2->addElement(1 + i, 100 + (i % 2), 0, i * 100 + i / 2);
+        timeline->updateWith(*timeline2);
+        Expect(timeline->minElementNumber() == 1);
+        Expect(timeline->maxElementNumber() == 10010);
+        Expect(timeline->getTotalLength() == 10010 * 100 + 5005);
+        Expect(timeline->getScaledPlaybackTimeByElementNumber(10010) == 10009 * 100 + 10009 / 2);
+
+        delete timeline;
+        delete timeline2;
 
     } catch (...) {
         delete timeline;
@@ -98,6 +98,7 @@ MPD * IsoffMainParser::parse()
     {
         parseMPDAttributes(mpd, root);
         parseProgramInformation(DOMHelper::getFirstChildElementByName(root, "ProgramInformation", getDASHNamespace()), mpd);
+        parseServiceDescription(DOMHelper::getFirstChildElementByName(root, "ServiceDescription", getDASHNamespace()), mpd);
         parseMPDBaseUrl(mpd, root);
         parsePeriods(mpd, root);
         mpd->addAttribute(new StartnumberAttr(1));
@@ -524,7 +525,21 @@ void IsoffMainParser::parseTimeline(Node *node, AbstractMultipleSegmentBaseType
     SegmentTimeline *timeline = new (std::nothrow) SegmentTimeline(base);
     if(timeline)
     {
-        std::vector<Node *> elements = DOMHelper::getElementByTagName(node, "S", getDASHNamespace(), false);
+        /* Templates address segments by number and time only, so
+         * contiguous S entries of the same duration can be stored as a
+         * single repeated one. Lists map each entry to its own URL. */
+        const bool coalesce = dynamic_cast<SegmentTemplate *>(base) != nullptr;
+        struct
+        {
+            uint64_t number;
+            stime_t d;
+            int64_t r;
+            stime_t t;
+            bool has_t;
+        } pending = {};
+        bool b_pending = false;
+
+        std::vector<Node *> elements = DOMHelper::getChildElementByTagName(node, "S", getDASHNamespace());
         std::vector<Node *>::const_iterator it;
         for(it = elements.begin(); it != elements.end(); ++it)
         {
@@ -539,16 +554,30 @@ void IsoffMainParser::parseTimeline(Node *node, AbstractMultipleSegmentBaseType
                 if(r < 0)
                     r = std::numeric_limits<unsigned>::max();
             }
+            const bool has_t = s->hasAttribute("t");
+            const stime_t t = has_t ? Integer<stime_t>(s->getAttributeValue("t")) : 0;
 
-            if(s->hasAttribute("t"))
+            if(b_pending && coalesce && d == pending.d &&
+               pending.r < std::numeric_limits<unsigned>::max() &&
+               (!has_t || (pending.has_t && t == pending.t + pending.d * (pending.r + 1))))
+            {
+                pending.r += 1 + r;
+            }
+            else
             {
-                stime_t t = Integer<stime_t>(s->getAttributeValue("t"));
-                timeline->addElement(number, d, r, t);
+                if(b_pending)
+                    timeline->addElement(pending.number, pending.d, pending.r,
+                                         pending.has_t ? pending.t : 0);
+                pending = { number, d, r, t, has_t };
+                b_pending = true;
             }
-            else timeline->addElement(number, d, r);
 
             number += (1 + r);
         }
+
+        if(b_pending)
+            timeline->addElement(pending.number, pending.d, pending.r,
+                                 pending.has_t ? pending.t : 0);
         //base->setSegmentTimeline(timeline);
         base->addAttribute(timeline);
     }
@@ -581,6 +610,37 @@ void IsoffMainParser::parseProgramInformation(Node * node, MPD *mpd)
     }
 }
 
+void IsoffMainParser::parseServiceDescription(Node *node, MPD *mpd)
+{
+    if(!node)
+        return;
+
+    Node *child = DOMHelper::getFirstChildElementByName(node, "Latency", getDASHNamespace());
+    if(child && child->hasAttribute("target"))
+    {
+        /* in milliseconds, relative to the wall clock */
+        uint64_t target = Integer<uint64_t>(child->getAttributeValue("target"));
+        mpd->targetLatency = VLC_TICK_FROM_MS(target);
+    }
+
+    child = DOMHelper::getFirstChildElementByName(node, "PlaybackRate", getDASHNamespace());
+    if(child)
+    {
+        if(child->hasAttribute("min"))
+        {
+            double rate = Integer<double>(child->getAttributeValue("min"));
+            if(rate > 0.0 && rate <= 1.0)
+                mpd->minPlaybackRate = rate;
+        }
+        if(child->hasAttribute("max"))
+        {
+            double rate = Integer<double>(child->getAttributeValue("max"));
+            if(rate >= 1.0)
+                mpd->maxPlaybackRate = rate;
+        }
+    }
+}
+
 Profile IsoffMainParser::getProfile() const
 {
     Profile res(Profile::Name::Unknown);
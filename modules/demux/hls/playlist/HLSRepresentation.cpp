@@ -44,6 +44,12 @@ HLSRepresentation::HLSRepresentation  ( BaseAdaptationSet *set ) :
     updateFailureCount = 0;
     lastUpdateTime = 0;
     targetDuration = 0;
+    partTarget = 0;
+    partHoldBack = 0;
+    canSkipUntil = 0;
+    b_canBlockReload = false;
+    reloadSequence = 0;
+    reloadPart = 0;
     streamFormat = StreamFormat::Type::Unknown;
     channels = 0;
 }
@@ -62,6 +68,11 @@ bool HLSRepresentation::isLive() const
     return b_live;
 }
 
+bool HLSRepresentation::isLowLatency() const
+{
+    return partTarget != 0;
+}
+
 bool HLSRepresentation::initialized() const
 {
     return b_loaded;
@@ -87,6 +98,25 @@ Url HLSRepresentation::getPlaylistUrl() const
     }
 }
 
+std::string HLSRepresentation::getPlaylistUpdateUrl() const
+{
+    std::string url = getPlaylistUrl().toString();
+    if(!b_loaded || !b_live || !b_canBlockReload || updateFailureCount)
+        return url;
+
+    /* Blocking reload: the server answers once the next part or segment is there */
+    url += (url.find('?') == std::string::npos) ? '?' : '&';
+    url += "_HLS_msn=" + std::to_string(reloadSequence);
+    if(partTarget)
+        url += "&_HLS_part=" + std::to_string(reloadPart);
+
+    /* Delta updates only apply to a playlist younger than half the skip boundary */
+    if(canSkipUntil && vlc_tick_now() - lastUpdateTime < canSkipUntil / 2)
+        url += "&_HLS_skip=YES";
+
+    return url;
+}
+
 void HLSRepresentation::debug(vlc_object_t *obj, int indent) const
 {
     BaseRepresentation::debug(obj, indent);
@@ -129,7 +159,19 @@ bool HLSRepresentation::needsUpdate(uint64_t number) const
         return false;
     if(!b_loaded)
         return true;
-    if(isLive())
+    if(isLive() && b_canBlockReload && !updateFailureCount)
+    {
+        /* No polling, as the server holds the reload until there is something
+         * new, but only stay ahead up to the holdback */
+        if(number == std::numeric_limits<uint64_t>::max())
+            return true;
+
+        vlc_tick_t holdback = partHoldBack;
+        if(!holdback)
+            holdback = 3 * (partTarget ? partTarget : vlc_tick_from_sec(targetDuration));
+        return getMinAheadTime(number) < holdback;
+    }
+    else if(isLive())
     {
         const vlc_tick_t now = vlc_tick_now();
         const vlc_tick_t elapsed = now - lastUpdateTime;
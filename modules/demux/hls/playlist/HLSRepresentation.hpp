@@ -45,7 +45,9 @@ namespace hls
 
                 void setPlaylistUrl(const std::string &);
                 Url getPlaylistUrl() const;
+                std::string getPlaylistUpdateUrl() const;
                 bool isLive() const;
+                bool isLowLatency() const;
                 bool initialized() const;
                 void scheduleNextUpdate(uint64_t, bool) override;
                 bool needsUpdate(uint64_t) const override;
@@ -61,6 +63,13 @@ namespace hls
             protected:
                 time_t targetDuration;
                 Url playlistUrl;
+                /* Low-Latency HLS */
+                vlc_tick_t partTarget;
+                vlc_tick_t partHoldBack;
+                vlc_tick_t canSkipUntil;
+                bool b_canBlockReload;
+                uint64_t reloadSequence;
+                size_t reloadPart;
 
             private:
                 static const unsigned MAX_UPDATE_FAILED_UPDATE_COUNT = 3;
@@ -22,11 +22,245 @@
 #endif
 
 #include "HLSSegment.hpp"
+#include "Parser.hpp"
 #include "../../adaptive/playlist/BaseRepresentation.h"
+#include "../../adaptive/playlist/BaseAdaptationSet.h"
+#include "../../adaptive/playlist/BasePlaylist.hpp"
+#include "../../adaptive/playlist/SegmentChunk.hpp"
+#include "../../adaptive/http/Chunk.h"
+#include "../../adaptive/http/HTTPConnectionManager.h"
+#include "../../adaptive/SharedResources.hpp"
+
+#include <vlc_block.h>
 
 
 using namespace hls::playlist;
 
+HLSPart::HLSPart()
+{
+    duration = 0;
+    independent = false;
+    gap = false;
+}
+
+HLSPartialSegment::HLSPartialSegment(const std::string &url, uint64_t seq)
+{
+    playlistUrl = url;
+    sequence = seq;
+    b_hint = false;
+    b_complete = false;
+}
+
+void HLSPartialSegment::update(const std::vector<HLSPart> &updated,
+                               const HLSPart *updatedhint, bool complete)
+{
+    vlc::threads::mutex_locker locker {lock};
+    /* Parts are only appended, never removed, until the segment completes */
+    if(updated.size() >= parts.size())
+        parts = updated;
+    b_hint = (updatedhint != nullptr);
+    if(b_hint)
+        hint = *updatedhint;
+    b_complete |= complete;
+}
+
+void HLSPartialSegment::updateWith(const HLSPartialSegment &updated)
+{
+    std::vector<HLSPart> updatedparts;
+    HLSPart updatedhint;
+    bool b_updatedhint, b_updatedcomplete;
+    {
+        vlc::threads::mutex_locker locker {updated.lock};
+        updatedparts = updated.parts;
+        updatedhint = updated.hint;
+        b_updatedhint = updated.b_hint;
+        b_updatedcomplete = updated.b_complete;
+    }
+    update(updatedparts, b_updatedhint ? &updatedhint : nullptr, b_updatedcomplete);
+}
+
+bool HLSPartialSegment::getPart(size_t index, HLSPart *part) const
+{
+    vlc::threads::mutex_locker locker {lock};
+    if(index < parts.size())
+        *part = parts[index];
+    else if(index == parts.size() && b_hint && !b_complete)
+        *part = hint;
+    else
+        return false;
+    return true;
+}
+
+bool HLSPartialSegment::isComplete() const
+{
+    vlc::threads::mutex_locker locker {lock};
+    return b_complete;
+}
+
+uint64_t HLSPartialSegment::getSequenceNumber() const
+{
+    return sequence;
+}
+
+const std::string & HLSPartialSegment::getPlaylistUrl() const
+{
+    return playlistUrl;
+}
+
+vlc_tick_t HLSPartialSegment::getDuration() const
+{
+    vlc::threads::mutex_locker locker {lock};
+    vlc_tick_t duration = 0;
+    for(const HLSPart &part : parts)
+        duration += part.duration;
+    return duration;
+}
+
+std::string HLSPartialSegment::getReloadUrl(size_t part) const
+{
+    std::string url = playlistUrl;
+    url += (url.find('?') == std::string::npos) ? '?' : '&';
+    url += "_HLS_msn=" + std::to_string(sequence);
+    url += "&_HLS_part=" + std::to_string(part);
+    return url;
+}
+
+namespace
+{
+    /* Reads the parts of a partial segment in sequence, as they are
+     * published, blocking on playlist reloads until the segment completes */
+    class HLSPartsChunkSource : public AbstractChunkSource
+    {
+        public:
+            HLSPartsChunkSource(vlc_object_t *obj, SharedResources *res,
+                                const ID &id_,
+                                const std::shared_ptr<HLSPartialSegment> &p)
+                : AbstractChunkSource(ChunkType::Segment),
+                  p_obj(obj), resources(res), id(id_), partial(p)
+            {
+                current = nullptr;
+                next = 0;
+                consumed = 0;
+                eof = false;
+            }
+
+            virtual ~HLSPartsChunkSource()
+            {
+                if(current)
+                    current->recycle();
+            }
+
+            block_t * readBlock() override
+            {
+                return doRead(0, true);
+            }
+
+            block_t * read(size_t size) override
+            {
+                return doRead(size, false);
+            }
+
+            bool hasMoreData() const override
+            {
+                return !eof;
+            }
+
+            size_t getBytesRead() const override
+            {
+                return consumed;
+            }
+
+            const std::string & getContentType() const override
+            {
+                return contentType;
+            }
+
+            void recycle() override
+            {
+                delete this;
+            }
+
+        private:
+            static const unsigned MAX_RELOADS_WITHOUT_PART = 3;
+
+            block_t * doRead(size_t size, bool b_block)
+            {
+                while(!eof)
+                {
+                    if(!current && !openNextPart())
+                        break;
+
+                    block_t *block = b_block ? current->readBlock()
+                                             : current->read(size);
+                    if(block)
+                    {
+                        if(contentType.empty())
+                            contentType = current->getContentType();
+                        consumed += block->i_buffer;
+                        return block;
+                    }
+
+                    requeststatus = current->getRequestStatus();
+                    current->recycle();
+                    current = nullptr;
+                    if(requeststatus != RequestStatus::Success)
+                        eof = true;
+                }
+                return nullptr;
+            }
+
+            bool openNextPart()
+            {
+                HLSPart part;
+                unsigned reloads = 0;
+                for(;;)
+                {
+                    if(partial->getPart(next, &part))
+                    {
+                        next++;
+                        if(part.gap)
+                            continue;
+                        break;
+                    }
+                    if(partial->isComplete() || reloads++ == MAX_RELOADS_WITHOUT_PART)
+                    {
+                        eof = true;
+                        return false;
+                    }
+                    /* Blocks until the server has the next part */
+                    M3U8Parser parser(resources);
+                    if(!parser.updatePartialSegment(p_obj, partial->getReloadUrl(next),
+                                                    partial.get()))
+                    {
+                        eof = true;
+                        return false;
+                    }
+                }
+
+                AbstractConnectionManager *connManager = resources->getConnManager();
+                current = connManager->makeSource(part.url, id, ChunkType::Segment,
+                                                  part.range);
+                if(!current)
+                {
+                    eof = true;
+                    return false;
+                }
+                connManager->start(current);
+                return true;
+            }
+
+            vlc_object_t *p_obj;
+            SharedResources *resources;
+            ID id;
+            std::shared_ptr<HLSPartialSegment> partial;
+            AbstractChunkSource *current;
+            std::string contentType;
+            size_t next;
+            size_t consumed;
+            bool eof;
+    };
+}
+
 HLSSegment::HLSSegment( ICanonicalUrl *parent, uint64_t seq ) :
     Segment( parent )
 {
@@ -37,6 +271,39 @@ HLSSegment::~HLSSegment()
 {
 }
 
+const std::shared_ptr<HLSPartialSegment> & HLSSegment::getPartialSegment() const
+{
+    return partial;
+}
+
+SegmentChunk* HLSSegment::toChunk(SharedResources *res, size_t index, BaseRepresentation *rep)
+{
+    if(!partial || (partial->isComplete() && !sourceUrl.empty()))
+        return Segment::toChunk(res, index, rep);
+
+    AbstractChunkSource *source = new (std::nothrow)
+            HLSPartsChunkSource(rep->getPlaylist()->getVLCObject(), res,
+                                rep->getAdaptationSet()->getID(), partial);
+    if(!source)
+        return nullptr;
+
+    SegmentChunk *chunk = createChunk(source, rep);
+    if(!chunk)
+    {
+        source->recycle();
+        return nullptr;
+    }
+    chunk->sequence = index;
+    chunk->discontinuity = discontinuity;
+    chunk->discontinuitySequenceNumber = getDiscontinuitySequenceNumber();
+    if(!prepareChunk(res, chunk, rep))
+    {
+        delete chunk;
+        return nullptr;
+    }
+    return chunk;
+}
+
 bool HLSSegment::prepareChunk(SharedResources *res, SegmentChunk *chunk, BaseRepresentation *rep)
 {
     if(encryption.method == CommonEncryption::Method::AES_128)
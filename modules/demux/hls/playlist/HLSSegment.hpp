@@ -22,6 +22,13 @@
 
 #include "../../adaptive/playlist/Segment.h"
 #include "../../adaptive/encryption/CommonEncryption.hpp"
+#include "../../adaptive/http/BytesRange.hpp"
+
+#include <vlc_threads.h>
+#include <vlc_cxx_helpers.hpp>
+
+#include <memory>
+#include <vector>
 
 namespace hls
 {
@@ -30,6 +37,44 @@ namespace hls
         using namespace adaptive;
         using namespace adaptive::playlist;
         using namespace adaptive::encryption;
+        using namespace adaptive::http;
+
+        class HLSPart
+        {
+            public:
+                HLSPart();
+                std::string url;
+                BytesRange range;
+                vlc_tick_t duration;
+                bool independent;
+                bool gap;
+        };
+
+        /* Low-Latency HLS parts of a segment still being produced.
+         * Shared between the playlist, which updates it on reload, and
+         * the chunk reading it, which can also reload it on its own. */
+        class HLSPartialSegment
+        {
+            public:
+                HLSPartialSegment(const std::string &, uint64_t);
+                void update(const std::vector<HLSPart> &, const HLSPart *, bool);
+                void updateWith(const HLSPartialSegment &);
+                bool getPart(size_t, HLSPart *) const;
+                bool isComplete() const;
+                uint64_t getSequenceNumber() const;
+                const std::string & getPlaylistUrl() const;
+                std::string getReloadUrl(size_t) const;
+                vlc_tick_t getDuration() const;
+
+            private:
+                mutable vlc::threads::mutex lock;
+                std::string playlistUrl;
+                uint64_t sequence;
+                std::vector<HLSPart> parts;
+                HLSPart hint;
+                bool b_hint;
+                bool b_complete;
+        };
 
         class HLSSegment : public Segment
         {
@@ -38,10 +83,14 @@ namespace hls
             public:
                 HLSSegment( ICanonicalUrl *parent, uint64_t sequence );
                 virtual ~HLSSegment();
+                SegmentChunk* toChunk(SharedResources *, size_t,
+                                      BaseRepresentation *) override;
+                const std::shared_ptr<HLSPartialSegment> & getPartialSegment() const;
 
             protected:
                 bool prepareChunk(SharedResources *, SegmentChunk *,
                                   BaseRepresentation *) override;
+                std::shared_ptr<HLSPartialSegment> partial;
         };
     }
 }
@@ -225,7 +225,7 @@ void M3U8Parser::fillAdaptsetFromMediainfo(const AttributesTag *mediatag,
 
 bool M3U8Parser::appendSegmentsFromPlaylistURI(vlc_object_t *p_obj, HLSRepresentation *rep)
 {
-    block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, rep->getPlaylistUrl().toString());
+    block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, rep->getPlaylistUpdateUrl());
     if(p_block)
     {
         stream_t *substream = vlc_stream_MemoryNew(p_obj, p_block->p_buffer, p_block->i_buffer, true);
@@ -279,6 +279,142 @@ static bool parseEncryption(const AttributesTag *keytag, const Url &playlistUrl,
     }
 }
 
+static std::string resolvePartUrl(const std::string &uri, const std::string &playlistUrl)
+{
+    Url url(uri);
+    if(!url.hasScheme())
+        url.prepend(Helper::getDirectoryPath(playlistUrl).append("/"));
+    return url.toString();
+}
+
+static bool parsePart(const AttributesTag *parttag, const std::string &playlistUrl,
+                      const std::vector<HLSPart> &parts, HLSPart *part)
+{
+    const Attribute *uriAttr = parttag->getAttributeByName("URI");
+    const Attribute *durAttr = parttag->getAttributeByName("DURATION");
+    if(!uriAttr || !durAttr)
+        return false;
+
+    part->url = resolvePartUrl(uriAttr->quotedString(), playlistUrl);
+    part->duration = vlc_tick_from_sec(durAttr->floatingPoint());
+
+    const Attribute *attr = parttag->getAttributeByName("INDEPENDENT");
+    part->independent = attr && attr->value == "YES";
+    attr = parttag->getAttributeByName("GAP");
+    part->gap = attr && attr->value == "YES";
+
+    attr = parttag->getAttributeByName("BYTERANGE");
+    if(attr)
+    {
+        const ByteRange range = attr->unescapeQuotes().getByteRange();
+        std::size_t offset = 0;
+        /* without offset, follows the previous part of the same resource */
+        if(range.first.has_value())
+            offset = *range.first;
+        else if(!parts.empty() && parts.back().url == part->url &&
+                parts.back().range.isValid() && parts.back().range.getEndByte())
+            offset = parts.back().range.getEndByte() + 1;
+        if(range.second)
+            part->range = BytesRange(offset, offset + range.second - 1);
+    }
+    return true;
+}
+
+static bool parsePreloadHint(const AttributesTag *hinttag, const std::string &playlistUrl,
+                             HLSPart *part)
+{
+    const Attribute *typeAttr = hinttag->getAttributeByName("TYPE");
+    const Attribute *uriAttr = hinttag->getAttributeByName("URI");
+    if(!typeAttr || typeAttr->value != "PART" || !uriAttr)
+        return false;
+
+    part->url = resolvePartUrl(uriAttr->quotedString(), playlistUrl);
+
+    const Attribute *startAttr = hinttag->getAttributeByName("BYTERANGE-START");
+    if(startAttr)
+    {
+        const Attribute *lengthAttr = hinttag->getAttributeByName("BYTERANGE-LENGTH");
+        std::size_t start = startAttr->decimal();
+        std::size_t length = lengthAttr ? lengthAttr->decimal() : 0;
+        /* open ended range until the end of the part */
+        part->range = BytesRange(start, length ? start + length - 1 : 0);
+    }
+    return true;
+}
+
+bool M3U8Parser::updatePartialSegment(vlc_object_t *p_obj, const std::string &url,
+                                      HLSPartialSegment *partial)
+{
+    block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, url);
+    if(!p_block)
+        return false;
+
+    stream_t *substream = vlc_stream_MemoryNew(p_obj, p_block->p_buffer, p_block->i_buffer, true);
+    if(!substream)
+    {
+        block_Release(p_block);
+        return false;
+    }
+
+    std::list<Tag *> tagslist = parseEntries(substream);
+    vlc_stream_Delete(substream);
+    block_Release(p_block);
+
+    const uint64_t wanted = partial->getSequenceNumber();
+    const std::string &playlistUrl = partial->getPlaylistUrl();
+    uint64_t sequenceNumber = 0;
+    std::vector<HLSPart> parts;
+    HLSPart hint;
+    bool b_hint = false;
+
+    for(const Tag *tag : tagslist)
+    {
+        switch(tag->getType())
+        {
+            case SingleValueTag::EXTXMEDIASEQUENCE:
+                sequenceNumber = static_cast<const SingleValueTag*>(tag)->getValue().decimal();
+                break;
+
+            case AttributesTag::EXTXSKIP:
+            {
+                const Attribute *skipAttr = static_cast<const AttributesTag *>(tag)->
+                                                getAttributeByName("SKIPPED-SEGMENTS");
+                if(skipAttr)
+                    sequenceNumber += skipAttr->decimal();
+                break;
+            }
+
+            case AttributesTag::EXTXPART:
+            {
+                HLSPart part;
+                if(sequenceNumber == wanted &&
+                   parsePart(static_cast<const AttributesTag *>(tag), playlistUrl, parts, &part))
+                    parts.push_back(part);
+                break;
+            }
+
+            case AttributesTag::EXTXPRELOADHINT:
+                if(sequenceNumber == wanted)
+                    b_hint = parsePreloadHint(static_cast<const AttributesTag *>(tag),
+                                              playlistUrl, &hint);
+                break;
+
+            case SingleValueTag::URI:
+                if(!static_cast<const SingleValueTag *>(tag)->getValue().value.empty())
+                    sequenceNumber++;
+                break;
+
+            default:
+                break;
+        }
+    }
+    releaseTagsList(tagslist);
+
+    /* the playlist moved past our segment: no more parts to come */
+    partial->update(parts, b_hint ? &hint : nullptr, sequenceNumber > wanted);
+    return true;
+}
+
 void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std::list<Tag *> &tagslist)
 {
     bool b_pdt = tagslist.cend() != std::find_if(tagslist.cbegin(), tagslist.cend(),
@@ -290,6 +426,10 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
 
     rep->b_loaded = true;
     rep->b_live = !b_vod;
+    rep->b_canBlockReload = false;
+    rep->canSkipUntil = 0;
+    rep->partHoldBack = 0;
+    rep->partTarget = 0;
 
     vlc_tick_t totalduration = 0;
     vlc_tick_t nzStartTime = 0;
@@ -301,6 +441,10 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
     const SingleValueTag *ctx_byterange = nullptr;
     CommonEncryption encryption;
     const ValuesListTag *ctx_extinf = nullptr;
+    const std::string playlistUrl = rep->getPlaylistUrl().toString();
+    std::vector<HLSPart> ctx_parts;
+    HLSPart ctx_hint;
+    bool b_hint = false;
 
     std::list<HLSSegment *> segmentstoappend;
 
@@ -360,6 +504,15 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
 
                 segmentstoappend.push_back(segment);
 
+                if(!ctx_parts.empty())
+                {
+                    segment->partial = std::make_shared<HLSPartialSegment>(playlistUrl,
+                                                                           segment->getSequenceNumber());
+                    segment->partial->update(ctx_parts, nullptr, true);
+                    ctx_parts.clear();
+                }
+                b_hint = false;
+
                 if(ctx_byterange)
                 {
                     ByteRange range = ctx_byterange->getValue().getByteRange();
@@ -441,6 +594,56 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
                 discontinuitySequence = static_cast<const SingleValueTag *>(tag)->getValue().decimal();
                 break;
 
+            case AttributesTag::EXTXSERVERCONTROL:
+            {
+                const AttributesTag *controltag = static_cast<const AttributesTag *>(tag);
+                const Attribute *attr = controltag->getAttributeByName("CAN-BLOCK-RELOAD");
+                rep->b_canBlockReload = attr && attr->value == "YES";
+                attr = controltag->getAttributeByName("CAN-SKIP-UNTIL");
+                if(attr)
+                    rep->canSkipUntil = vlc_tick_from_sec(attr->floatingPoint());
+                attr = controltag->getAttributeByName("PART-HOLD-BACK");
+                if(attr)
+                    rep->partHoldBack = vlc_tick_from_sec(attr->floatingPoint());
+            }
+            break;
+
+            case AttributesTag::EXTXPARTINF:
+            {
+                const Attribute *attr = static_cast<const AttributesTag *>(tag)->
+                                            getAttributeByName("PART-TARGET");
+                if(attr)
+                    rep->partTarget = vlc_tick_from_sec(attr->floatingPoint());
+            }
+            break;
+
+            case AttributesTag::EXTXSKIP:
+            {
+                /* Delta update: the oldest segments of the window were left out */
+                const Attribute *attr = static_cast<const AttributesTag *>(tag)->
+                                            getAttributeByName("SKIPPED-SEGMENTS");
+                if(attr)
+                {
+                    segmentList->setWindowStart(sequenceNumber);
+                    sequenceNumber += attr->decimal();
+                }
+            }
+            break;
+
+            case AttributesTag::EXTXPART:
+            {
+                HLSPart part;
+                if(parsePart(static_cast<const AttributesTag *>(tag), playlistUrl,
+                             ctx_parts, &part))
+                    ctx_parts.push_back(part);
+            }
+            break;
+
+            case AttributesTag::EXTXPRELOADHINT:
+                b_hint = parsePreloadHint(static_cast<const AttributesTag *>(tag),
+                                          playlistUrl, &ctx_hint);
+                break;
+
             case Tag::EXTXDISCONTINUITY:
                 discontinuity = true;
                 discontinuitySequence++;
@@ -451,6 +654,51 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
         }
     }
 
+    /* Parts after the last segment belong to the one being produced.
+     * It can only be played if the server holds reloads until the next part. */
+    rep->reloadSequence = sequenceNumber;
+    rep->reloadPart = 0;
+    if(!b_vod && rep->b_canBlockReload && !ctx_parts.empty())
+    {
+        HLSSegment *segment = new (std::nothrow) HLSSegment(rep, sequenceNumber);
+        if(segment)
+        {
+            segment->partial = std::make_shared<HLSPartialSegment>(playlistUrl, sequenceNumber);
+            segment->partial->update(ctx_parts, b_hint ? &ctx_hint : nullptr, false);
+            const vlc_tick_t nzDuration = segment->partial->getDuration();
+            segment->duration = timescale.ToScaled(nzDuration);
+            segment->startTime = timescale.ToScaled(nzStartTime);
+            totalduration += nzDuration;
+            if(absReferenceTime != VLC_TICK_INVALID)
+                segment->setDisplayTime(absReferenceTime);
+            segment->setDiscontinuitySequenceNumber(discontinuitySequence);
+            segment->discontinuity = discontinuity;
+            if(encryption.method != CommonEncryption::Method::None)
+                segment->setEncryption(encryption);
+            segmentstoappend.push_back(segment);
+            rep->reloadPart = ctx_parts.size();
+        }
+    }
+
+    /* Segments we are maybe already reading parts of must share their state
+     * with the updated ones, so the reads can complete */
+    const SegmentList *currentList = rep->inheritSegmentList();
+    if(currentList)
+    {
+        for(HLSSegment *seg : segmentstoappend)
+        {
+            if(!seg->partial)
+                continue;
+            HLSSegment *cur = dynamic_cast<HLSSegment *>(
+                        currentList->getMediaSegment(seg->getSequenceNumber()));
+            if(cur && cur->partial && !cur->partial->isComplete())
+            {
+                cur->partial->updateWith(*seg->partial);
+                seg->partial = cur->partial;
+            }
+        }
+    }
+
     for(HLSSegment *seg : segmentstoappend)
         segmentList->addSegment(seg);
     segmentstoappend.clear();
@@ -50,6 +50,7 @@ namespace hls
         class AttributesTag;
         class Tag;
         class HLSRepresentation;
+        class HLSPartialSegment;
 
         class M3U8Parser
         {
@@ -59,6 +60,8 @@ namespace hls
 
                 M3U8 *             parse  (vlc_object_t *p_obj, stream_t *p_stream, const std::string &);
                 bool appendSegmentsFromPlaylistURI(vlc_object_t *, HLSRepresentation *);
+                bool updatePartialSegment(vlc_object_t *, const std::string &,
+                                          HLSPartialSegment *);
 
             private:
                 HLSRepresentation * createRepresentation(BaseAdaptationSet *, const AttributesTag *);
@@ -101,6 +101,11 @@ namespace hls
                     EXTXSTART,
                     EXTXSTREAMINF,
                     EXTXSESSIONKEY,
+                    EXTXPART,
+                    EXTXPARTINF,
+                    EXTXPRELOADHINT,
+                    EXTXSERVERCONTROL,
+                    EXTXSKIP,
                 };
                 AttributesTag(int, const std::string &);
                 virtual ~AttributesTag();
@@ -117,7 +122,7 @@ namespace hls
             public:
                 enum
                 {
-                    EXTINF = 30
+                    EXTINF = 40
                 };
                 ValuesListTag(int, const std::string &);
                 virtual ~ValuesListTag();
@@ -632,6 +632,20 @@ static int vlclua_input_item_stats( lua_State *L )
         STATS_INT( lost_pictures )
         STATS_INT( played_abuffers )
         STATS_INT( lost_abuffers )
+        STATS_INT( sout_fifo_blocks )
+        STATS_INT( sout_fifo_bytes )
+        STATS_INT( sout_fifo_peak )
+        STATS_INT( sout_muxed_blocks )
+        STATS_INT( sout_mux_wait )
+        STATS_INT( sout_mux_wait_max )
+        STATS_INT( sent_packets )
+        STATS_INT( sent_bytes )
+        STATS_FLOAT( send_bitrate )
+        STATS_INT( sout_write_latency )
+        STATS_INT( sout_write_latency_max )
+        STATS_INT( sout_write_errors )
+        STATS_INT( sout_dropped )
+        STATS_INT( sout_late )
 #undef STATS_INT
 #undef STATS_FLOAT
     }
@@ -537,7 +537,7 @@ static int Mux      ( sout_mux_t *p_mux )
             if( p_data->i_length < 0 )
             {
                 msg_Warn( p_mux, "argg length < 0 l" );
-                block_Release( p_data );
+                sout_MuxDropBlock( p_mux, p_data, false );
                 p_data = p_next;
                 continue;
             }
@@ -58,6 +58,11 @@
     "\"Fast Start\" files are optimized for downloads and allow the user " \
     "to start previewing the file while it is downloading.")
 
+#define FRAGDURATION_TEXT N_("Fragment duration (ms)")
+#define FRAGDURATION_LONGTEXT N_(\
+    "Maximum duration of the fragments of fragmented and streamable MP4. " \
+    "Fragments are cut earlier to start on a keyframe whenever possible.")
+
 static int  Open   (vlc_object_t *);
 static void Close  (vlc_object_t *);
 static void CloseFrag  (vlc_object_t *);
@@ -80,6 +85,8 @@ add_submodule ()
     set_subcategory(SUBCAT_SOUT_MUX)
     set_shortname("MP4 Frag")
     add_shortcut("mp4frag", "mp4stream")
+    add_integer_with_range(SOUT_CFG_PREFIX "frag-duration", 1500, 100, 60000,
+                           FRAGDURATION_TEXT, FRAGDURATION_LONGTEXT)
     set_capability("sout mux", 0)
     set_callbacks(Open, CloseFrag)
 
@@ -89,7 +96,7 @@ vlc_module_end ()
  * Exported prototypes
  *****************************************************************************/
 static const char *const ppsz_sout_options[] = {
-    "faststart", NULL
+    "faststart", "frag-duration", NULL
 };
 
 static int Control(sout_mux_t *, int, va_list);
@@ -173,6 +180,7 @@ typedef struct
 
 
     /* mp4frag */
+    vlc_tick_t     i_fragment_length;
     vlc_tick_t     i_written_duration;
     uint32_t       i_mfhd_sequence;
 } sout_mux_sys_t;
@@ -317,6 +325,8 @@ static int Open(vlc_object_t *p_this)
     p_sys->i_written_duration= 0;
     p_sys->i_start_dts = VLC_TICK_INVALID;
     p_sys->i_mfhd_sequence = 1;
+    p_sys->i_fragment_length = VLC_TICK_FROM_MS(
+                var_GetInteger(p_mux, SOUT_CFG_PREFIX "frag-duration"));
 
     p_mux->p_sys        = p_sys;
     p_mux->pf_control   = Control;
@@ -957,8 +967,6 @@ static void box_send(sout_mux_t *p_mux,  bo_t *box)
 /***************************************************************************
     MP4 Live submodule
 ****************************************************************************/
-#define FRAGMENT_LENGTH  VLC_TICK_FROM_MS(1500)
-
 #define ENQUEUE_ENTRY(object, entry) \
     do {\
         if (object.p_last)\
@@ -1234,9 +1242,6 @@ static bo_t *GetMoofBox(sout_mux_t *p_mux, size_t *pi_mdat_total_size,
         bo_set_32be(moof, i_fixupoffset, bo_size(moof) + 8);
     }
 
-    /* set iframe flag, so the streaming server always starts from moof */
-    moof->b->i_flags |= BLOCK_FLAG_TYPE_I;
-
     return moof;
 }
 
@@ -1266,7 +1271,10 @@ static void WriteFragmentMDAT(sout_mux_t *p_mux, size_t i_total_size)
             p_sys->i_pos += p_entry->p_block->i_buffer;
             p_stream->i_written_duration += p_entry->p_block->i_length;
 
-            p_entry->p_block->i_flags &= ~BLOCK_FLAG_TYPE_I; // clear flag for http stream
+            /* Only the moof carries the frame type (see SetMoofProperties):
+             * the http output and the HLS segmenter would otherwise see a
+             * join point in the middle of the mdat. */
+            p_entry->p_block->i_flags &= ~BLOCK_FLAG_TYPE_MASK;
             sout_AccessOutWrite(p_mux->p_access, p_entry->p_block);
 
             p_stream->towrite.p_first = p_entry->p_next;
@@ -1340,11 +1348,41 @@ static void FlushHeader(sout_mux_t *p_mux)
     p_sys->b_header_sent = true;
 }
 
+/* Sets the moof frame type and length from the samples GetMoofBox queued:
+ * the streaming server or segmenter can only start from fragments where all
+ * keyframed tracks start with a keyframe, and the length is the duration
+ * of the fragment. */
+static void SetMoofProperties(sout_mux_t *p_mux, block_t *p_moof)
+{
+    sout_mux_sys_t *p_sys = (sout_mux_sys_t*) p_mux->p_sys;
+    bool b_independent = true;
+    vlc_tick_t i_length = 0;
+
+    for (unsigned int i = 0; i < p_sys->i_nb_streams; i++)
+    {
+        const mp4_stream_t *p_stream = p_sys->pp_streams[i];
+        const mp4_fragentry_t *p_entry = p_stream->towrite.p_first;
+        if (!p_entry)
+            continue;
+
+        if (p_stream->b_hasiframes && !(p_entry->p_block->i_flags & BLOCK_FLAG_TYPE_I))
+            b_independent = false;
+
+        vlc_tick_t i_stream_length = 0;
+        for (; p_entry; p_entry = p_entry->p_next)
+            i_stream_length += p_entry->p_block->i_length;
+        i_length = __MAX(i_length, i_stream_length);
+    }
+
+    p_moof->i_flags |= b_independent ? BLOCK_FLAG_TYPE_I : BLOCK_FLAG_TYPE_PB;
+    p_moof->i_length = i_length;
+}
+
 static void WriteFragments(sout_mux_t *p_mux, bool b_flush)
 {
     sout_mux_sys_t *p_sys = (sout_mux_sys_t*) p_mux->p_sys;
     bo_t *moof = NULL;
-    vlc_tick_t i_barrier_time = p_sys->i_written_duration + FRAGMENT_LENGTH;
+    vlc_tick_t i_barrier_time = p_sys->i_written_duration + p_sys->i_fragment_length;
     size_t i_mdat_size = 0;
     bool b_has_samples = false;
 
@@ -1395,7 +1433,7 @@ static void WriteFragments(sout_mux_t *p_mux, bool b_flush)
     {
         msg_Dbg(p_mux, "writing moof @ %"PRId64, p_sys->i_pos);
         p_sys->i_pos += bo_size(moof);
-        assert(moof->b->i_flags & BLOCK_FLAG_TYPE_I); /* http sout */
+        SetMoofProperties(p_mux, moof->b);
         box_send(p_mux, moof);
         msg_Dbg(p_mux, "writing mdat @ %"PRId64, p_sys->i_pos);
         WriteFragmentMDAT(p_mux, i_mdat_size);
@@ -1543,7 +1581,7 @@ static int MuxFrag(sout_mux_t *p_mux)
         p_stream->p_held_entry = NULL;
 
         if (p_stream->b_hasiframes && (p_heldblock->i_flags & BLOCK_FLAG_TYPE_I) &&
-            mp4mux_track_GetDuration(p_stream->tinfo) - p_sys->i_written_duration < FRAGMENT_LENGTH)
+            mp4mux_track_GetDuration(p_stream->tinfo) - p_sys->i_written_duration < p_sys->i_fragment_length)
         {
             /* Flag the last iframe time, we'll use it as boundary so it will start
                next fragment */
@@ -1596,7 +1634,7 @@ static int MuxFrag(sout_mux_t *p_mux)
     p_sys->i_written_duration = i_min_written_duration;
 
     /* we have prerolled enough to know all streams, and have enough date to create a fragment */
-    if (p_stream->read.p_first && p_sys->i_read_duration - p_sys->i_written_duration >= FRAGMENT_LENGTH)
+    if (p_stream->read.p_first && p_sys->i_read_duration - p_sys->i_written_duration >= p_sys->i_fragment_length)
         WriteFragments(p_mux, false);
 
     return VLC_SUCCESS;
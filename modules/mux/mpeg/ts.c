@@ -1252,7 +1252,7 @@ static int MuxStreams( sout_mux_t *p_mux )
         if( p_data->i_dts == VLC_TICK_INVALID )
         {
             msg_Err( p_mux, "non dated packet dropped" );
-            block_Release( p_data );
+            sout_MuxDropBlock( p_mux, p_data, false );
             continue;
         }
 
@@ -1287,7 +1287,7 @@ static int MuxStreams( sout_mux_t *p_mux )
                       p_stream->ts.i_pid, (char *) &p_input->fmt.i_codec,
                       p_data->i_dts, p_stream->state.i_pes_dts,
                       p_pcr_stream->state.i_pes_dts );
-            block_Release( p_data );
+            sout_MuxDropBlock( p_mux, p_data, true );
 
             BufferChainClean( &p_stream->state.chain_pes );
             p_stream->state.i_pes_dts = 0;
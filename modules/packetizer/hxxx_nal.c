@@ -47,7 +47,7 @@ block_t *hxxx_AnnexB_to_xVC( block_t *p_block, uint8_t i_nal_length_size )
     unsigned i_list = 16;
     struct nalmoves_e
     {
-        const uint8_t *p; /* start of prefixed nal */
+        size_t   pos; /* offset of prefixed nal */
         uint8_t  prefix; /* startcode length */
         size_t   move; /* move offset */
     } *p_list = NULL;
@@ -74,12 +74,12 @@ block_t *hxxx_AnnexB_to_xVC( block_t *p_block, uint8_t i_nal_length_size )
         {
             if( i_bitflow & 0x08 ) /* three zero prefixed 1 */
             {
-                p_list[i_nalcount].p = &p_buf[-3];
+                p_list[i_nalcount].pos = &p_buf[-3] - p_block->p_buffer;
                 p_list[i_nalcount].prefix = 4;
             }
             else /* two zero prefixed 1 */
             {
-                p_list[i_nalcount].p = &p_buf[-2];
+                p_list[i_nalcount].pos = &p_buf[-2] - p_block->p_buffer;
                 p_list[i_nalcount].prefix = 3;
             }
             i_move += (size_t) i_nal_length_size - p_list[i_nalcount].prefix;
@@ -108,7 +108,13 @@ block_t *hxxx_AnnexB_to_xVC( block_t *p_block, uint8_t i_nal_length_size )
         block_t *p_newblock = block_Realloc( p_block, p_list[0].move, p_block->i_buffer );
         if( unlikely(!p_newblock) )
             goto error;
-        p_block = p_newblock;
+        /* The start code is replaced in place */
+        p_block = block_Writable( p_newblock );
+        if( unlikely(!p_block) )
+        {
+            free( p_list );
+            return NULL;
+        }
         hxxx_WritePrefix( i_nal_length_size, p_block->p_buffer , i_payload );
         free( p_list );
         return p_block;
@@ -135,6 +141,13 @@ block_t *hxxx_AnnexB_to_xVC( block_t *p_block, uint8_t i_nal_length_size )
     }
     else
     {
+        /* Start codes are replaced in place */
+        p_block = block_Writable( p_block );
+        if( unlikely(!p_block) )
+        {
+            free( p_list );
+            return NULL;
+        }
         p_source = p_dest = p_block->p_buffer;
         p_sourceend = &p_block->p_buffer[p_block->i_buffer];
     }
@@ -145,13 +158,13 @@ block_t *hxxx_AnnexB_to_xVC( block_t *p_block, uint8_t i_nal_length_size )
     /* Do reverse order moves, so we never overlap when growing only */
     for( unsigned i=i_nalcount; i!=0; i-- )
     {
-        const uint8_t *p_readstart = p_list[i - 1].p;
+        const uint8_t *p_readstart = &p_source[p_list[i - 1].pos];
         uint32_t i_payload = p_sourceend - p_readstart - p_list[i - 1].prefix;
-        size_t offset = p_list[i - 1].p - p_source + p_list[i - 1].prefix + p_list[i - 1].move;
+        size_t offset = p_list[i - 1].pos + p_list[i - 1].prefix + p_list[i - 1].move;
 //        printf(" move offset %ld, length = %ld  prefix %ld move %ld\n", p_readstart - p_source, i_payload, p_list[i - 1].prefix, p_list[i-1].move);
 
         /* move in same / copy between buffers */
-        memmove( &p_dest[ offset ], &p_list[i - 1].p[ p_list[i - 1].prefix ], i_payload );
+        memmove( &p_dest[ offset ], &p_readstart[ p_list[i - 1].prefix ], i_payload );
 
         hxxx_WritePrefix( i_nal_length_size, &p_dest[ offset - i_nal_length_size ] , i_payload );
 
@@ -34,6 +34,12 @@
 #include <vlc_stream.h>
 #include <vlc_fs.h>
 #include <vlc_interrupt.h>
+#include <vlc_tick.h>
+
+/* Smallest upstream read request */
+#define PREFETCH_READ_MIN (64 << 10)
+/* Shortest interval over which the consumption rate is measured */
+#define PREFETCH_RATE_WINDOW VLC_TICK_FROM_MS(100)
 
 struct stream_ctrl
 {
@@ -73,8 +79,19 @@ typedef struct
     uint64_t     stream_offset;
     size_t       buffer_length;
     size_t       buffer_size;
+    size_t       buffer_max;
     char        *buffer;
     size_t       seek_threshold;
+    size_t       seek_threshold_min;
+    size_t       read_size;
+
+    /* Statistics for buffer and read sizing */
+    vlc_tick_t   latency; /**< average upstream read duration */
+    uint64_t     throughput; /**< average upstream read speed (bytes/s) */
+    uint64_t     rate; /**< average consumption rate (bytes/s) */
+    uint64_t     rate_bytes;
+    vlc_tick_t   rate_date;
+    bool         starved;
 
     struct stream_ctrl *controls;
 } stream_sys_t;
@@ -86,12 +103,118 @@ static ssize_t ThreadRead(stream_t *stream, void *buf, size_t length)
     vlc_mutex_unlock(&sys->lock);
     assert(length > 0);
 
+    vlc_tick_t start = vlc_tick_now();
     ssize_t val = vlc_stream_ReadPartial(stream->s, buf, length);
+    vlc_tick_t duration = vlc_tick_now() - start;
 
     vlc_mutex_lock(&sys->lock);
+
+    if (val > 0)
+    {   /* Update the upstream statistics (exponential moving averages) */
+        if (duration <= 0)
+            duration = 1;
+
+        uint64_t throughput = val * CLOCK_FREQ / duration;
+
+        if (sys->latency == 0)
+        {
+            sys->latency = duration;
+            sys->throughput = throughput;
+        }
+        else
+        {
+            sys->latency = (7 * sys->latency + duration) / 8;
+            sys->throughput = (7 * sys->throughput + throughput) / 8;
+        }
+    }
     return val;
 }
 
+static int ThreadResize(stream_t *stream, size_t size)
+{
+    stream_sys_t *sys = stream->p_sys;
+
+    assert(size >= sys->buffer_length);
+
+    char *buf = malloc(size);
+    if (unlikely(buf == NULL))
+        return -1;
+
+    /* The circular buffer layout depends on its size: move buffered data to
+     * its new position piecewise. */
+    for (size_t done = 0; done < sys->buffer_length;)
+    {
+        uint64_t pos = sys->buffer_offset + done;
+        size_t from = pos % sys->buffer_size;
+        size_t to = pos % size;
+        size_t len = sys->buffer_length - done;
+
+        if (len > sys->buffer_size - from)
+            len = sys->buffer_size - from;
+        if (len > size - to)
+            len = size - to;
+
+        memcpy(buf + to, sys->buffer + from, len);
+        done += len;
+    }
+
+    free(sys->buffer);
+    sys->buffer = buf;
+    sys->buffer_size = size;
+    return 0;
+}
+
+/**
+ * Adjusts the buffer size, read size and seek threshold.
+ *
+ * Reads are sized so that they cover the data consumed during two upstream
+ * read delays, and the buffer is kept at least four reads large. The buffer
+ * also doubles whenever the reader ran out of data while upstream is faster
+ * than the reader on average. The buffer never shrinks.
+ */
+static void ThreadAdapt(stream_t *stream)
+{
+    stream_sys_t *sys = stream->p_sys;
+    uint64_t want = sys->rate * sys->latency * 2 / CLOCK_FREQ;
+
+    if (sys->buffer_size < sys->buffer_max)
+    {
+        uint64_t size = sys->buffer_size;
+
+        if (sys->starved && sys->throughput > sys->rate)
+            size *= 2; /* a larger buffer can absorb upstream delays */
+        if (size < want * 4)
+            size = want * 4;
+        if (size > sys->buffer_max)
+            size = sys->buffer_max;
+
+        if (size > sys->buffer_size)
+        {
+            if (ThreadResize(stream, size) == 0)
+                msg_Dbg(stream, "buffer grown to %zu bytes", sys->buffer_size);
+            else
+                sys->buffer_max = sys->buffer_size;
+        }
+    }
+    sys->starved = false;
+
+    if (want > sys->buffer_size / 4)
+        want = sys->buffer_size / 4;
+    if (want < PREFETCH_READ_MIN)
+        want = PREFETCH_READ_MIN;
+    sys->read_size = want;
+
+    /* Skip forward by reading rather than seeking, if reading the data is
+     * expected to take less time than an upstream request. */
+    uint64_t threshold = sys->throughput * sys->latency / CLOCK_FREQ;
+
+    if (threshold > sys->buffer_size)
+        threshold = sys->buffer_size;
+    if (threshold < sys->seek_threshold_min)
+        threshold = sys->seek_threshold_min;
+    sys->seek_threshold = threshold;
+}
+
 static int ThreadSeek(stream_t *stream, uint64_t seek_offset)
 {
     stream_sys_t *sys = stream->p_sys;
@@ -221,6 +344,7 @@ static void *Thread(void *data)
             continue;
         }
 
+        ThreadAdapt(stream);
         assert(sys->buffer_size >= sys->buffer_length);
 
         size_t len = sys->buffer_size - sys->buffer_length;
@@ -234,11 +358,16 @@ static void *Thread(void *data)
 
             /* Discard some historical data to make room. */
             len = history > sys->buffer_length ? sys->buffer_length : history;
+            if (len > sys->read_size)
+                len = sys->read_size;
 
             sys->buffer_offset += len;
             sys->buffer_length -= len;
         }
 
+        if (len > sys->read_size)
+            len = sys->read_size;
+
         size_t offset = (sys->buffer_offset + sys->buffer_length)
                         % sys->buffer_size;
          /* Do not step past the sharp edge of the circular buffer */
@@ -276,6 +405,8 @@ static int Seek(stream_t *stream, uint64_t offset)
     vlc_mutex_lock(&sys->lock);
     sys->stream_offset = offset;
     sys->error = false;
+    /* Waiting for data after a seek is no sign of starvation */
+    sys->rate_date = VLC_TICK_INVALID;
     vlc_cond_signal(&sys->wait_space);
     vlc_mutex_unlock(&sys->lock);
     return 0;
@@ -324,6 +455,9 @@ static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
             return 0;
         }
 
+        if (sys->rate_date != VLC_TICK_INVALID && sys->rate > 0)
+            sys->starved = true; /* reader caught up with the buffer */
+
         vlc_interrupt_forward_start(sys->interrupt, data);
         vlc_cond_wait(&sys->wait_data, &sys->lock);
         vlc_interrupt_forward_stop(data);
@@ -338,6 +472,25 @@ static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
 
     memcpy(buf, sys->buffer + offset, copy);
     sys->stream_offset += copy;
+
+    /* Update the consumption rate (exponential moving average) */
+    vlc_tick_t now = vlc_tick_now();
+
+    if (sys->rate_date == VLC_TICK_INVALID)
+    {
+        sys->rate_date = now;
+        sys->rate_bytes = 0;
+    }
+    sys->rate_bytes += copy;
+
+    if (now - sys->rate_date >= PREFETCH_RATE_WINDOW)
+    {
+        uint64_t rate = sys->rate_bytes * CLOCK_FREQ / (now - sys->rate_date);
+
+        sys->rate = (sys->rate > 0) ? (3 * sys->rate + rate) / 4 : rate;
+        sys->rate_date = now;
+        sys->rate_bytes = 0;
+    }
     vlc_cond_signal(&sys->wait_space);
     vlc_mutex_unlock(&sys->lock);
     return copy;
@@ -394,6 +547,7 @@ static int Control(stream_t *stream, int query, va_list args)
 
             vlc_mutex_lock(&sys->lock);
             sys->paused = paused;
+            sys->rate_date = VLC_TICK_INVALID;
             vlc_cond_signal(&sys->wait_space);
             vlc_mutex_unlock (&sys->lock);
             break;
@@ -471,14 +625,29 @@ static int Open(vlc_object_t *obj)
     sys->stream_offset = 0;
     sys->buffer_length = 0;
     sys->buffer_size = var_InheritInteger(obj, "prefetch-buffer-size") << 10u;
+    sys->buffer_max = var_InheritInteger(obj, "prefetch-buffer-max-size")
+                      << 10u;
     sys->seek_threshold = var_InheritInteger(obj, "prefetch-seek-threshold");
+    sys->seek_threshold_min = sys->seek_threshold;
+    sys->read_size = sys->buffer_size;
+    sys->latency = 0;
+    sys->throughput = 0;
+    sys->rate = 0;
+    sys->rate_bytes = 0;
+    sys->rate_date = VLC_TICK_INVALID;
+    sys->starved = false;
     sys->controls = NULL;
 
+    if (sys->buffer_max < sys->buffer_size)
+        sys->buffer_max = sys->buffer_size;
+
     uint64_t size = stream_Size(stream->s);
     if (size > 0)
     {   /* No point allocating a buffer larger than the source stream */
         if (sys->buffer_size > size)
             sys->buffer_size = size;
+        if (sys->buffer_max > size)
+            sys->buffer_max = size;
     }
 
     sys->buffer = malloc(sys->buffer_size);
@@ -501,7 +670,8 @@ static int Open(vlc_object_t *obj)
         goto error;
     }
 
-    msg_Dbg(stream, "using %zu bytes buffer", sys->buffer_size);
+    msg_Dbg(stream, "using %zu bytes buffer (up to %zu bytes)",
+            sys->buffer_size, sys->buffer_max);
     stream->pf_read = Read;
     stream->pf_seek = Seek;
     stream->pf_control = Control;
@@ -550,10 +720,14 @@ vlc_module_begin()
     set_callbacks(Open, Close)
 
     add_integer("prefetch-buffer-size", 1 << 14, N_("Buffer size"),
-                N_("Prefetch buffer size (KiB)"))
+                N_("Initial prefetch buffer size (KiB)"))
         change_integer_range(4, 1 << 20)
+    add_integer("prefetch-buffer-max-size", 1 << 16, N_("Maximum buffer size"),
+                N_("The prefetch buffer grows up to this size (KiB) if the "
+                   "data is consumed faster than it can be fetched."))
+        change_integer_range(4, 1 << 22)
     add_obsolete_integer("prefetch-read-size") /* since 4.0.0 */
     add_integer("prefetch-seek-threshold", 1 << 14, N_("Seek threshold"),
-                N_("Prefetch forward seek threshold (bytes)"))
+                N_("Minimum prefetch forward seek threshold (bytes)"))
         change_integer_range(0, UINT64_C(1) << 60)
 vlc_module_end()
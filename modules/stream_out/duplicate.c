@@ -457,7 +457,8 @@ static int Send( sout_stream_t *p_stream, void *_id, vlc_frame_t *frame )
     vlc_vector_foreach_ref( dup_id, &id->dup_ids )
     {
         const bool is_last = dup_id == vlc_vector_last_ref( &id->dup_ids );
-        vlc_frame_t *to_send = (is_last) ? frame : vlc_frame_Duplicate( frame );
+        /* Branches share the payload, copied only if one modifies it */
+        vlc_frame_t *to_send = (is_last) ? frame : vlc_frame_Share( frame );
         if ( unlikely(to_send == NULL) )
         {
             vlc_frame_Release( frame );
@@ -0,0 +1,843 @@
+/*****************************************************************************
+ * fanout.c: shared input fan-out stream output
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * The "fanout" stream output publishes the packetized elementary streams of
+ * an input under a name. Any number of "fanout://<name>" inputs can then
+ * subscribe to them, each with its own stream output chain. The source is
+ * read, demuxed and packetized only once; frame payloads are shared (see
+ * block_Share()) rather than copied between the subscribers.
+ *
+ * Subscribers are independent: a paused subscriber drops the frames it
+ * misses, and a subscriber falling too far behind loses frames instead of
+ * holding back the source or the other subscribers. Video frames since the
+ * last key frame are kept, so that late subscribers start cleanly.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <stdatomic.h>
+
+#include <vlc_common.h>
+#include <vlc_arrays.h>
+#include <vlc_atomic.h>
+#include <vlc_block.h>
+#include <vlc_configuration.h>
+#include <vlc_demux.h>
+#include <vlc_list.h>
+#include <vlc_plugin.h>
+#include <vlc_sout.h>
+
+/*****************************************************************************
+ * Module descriptor
+ *****************************************************************************/
+#define NAME_TEXT N_("Name")
+#define NAME_LONGTEXT N_( \
+    "Name under which the elementary streams are published. Subscribers " \
+    "open the fanout://<name> MRL." )
+
+#define QUEUE_TEXT N_("Subscriber queue size")
+#define QUEUE_LONGTEXT N_( \
+    "Maximum amount of data (in KiB) queued for a subscriber that does not " \
+    "keep up. Further frames are dropped for that subscriber only." )
+
+static int  OpenOut( vlc_object_t * );
+static int  OpenIn( vlc_object_t * );
+static void CloseIn( vlc_object_t * );
+
+#define SOUT_CFG_PREFIX "sout-fanout-"
+
+vlc_module_begin ()
+    set_shortname( N_("Fan-out") )
+    set_description( N_("Shared input fan-out stream output") )
+    set_capability( "sout output", 50 )
+    add_shortcut( "fanout" )
+    /* Only usable with VLM. No category so not in gui preferences
+    set_subcategory( SUBCAT_SOUT_STREAM )*/
+    add_string( SOUT_CFG_PREFIX "name", "default", NAME_TEXT, NAME_LONGTEXT )
+    set_callback( OpenOut )
+
+    add_submodule ()
+    set_description( N_("Shared input fan-out subscriber") )
+    set_capability( "access", 0 )
+    add_shortcut( "fanout" )
+    add_integer( "fanout-queue-size", 32768, QUEUE_TEXT, QUEUE_LONGTEXT )
+        change_integer_range( 64, 1 << 22 )
+    set_callbacks( OpenIn, CloseIn )
+vlc_module_end ()
+
+static const char *const ppsz_sout_options[] = {
+    "name", NULL
+};
+
+/*****************************************************************************
+ * Shared state
+ *****************************************************************************/
+typedef struct
+{
+    vlc_atomic_rc_t rc;
+    es_format_t fmt;
+    bool keyframes; /**< key frames are flagged */
+} fanout_es_t;
+
+/** Frame kept for late subscribers */
+typedef struct
+{
+    struct vlc_list node;
+    fanout_es_t *es;
+    block_t *block;
+} fanout_backlog_t;
+
+/* Maximum size of the frames kept for late subscribers */
+#define FANOUT_BACKLOG_MAX (16 << 20)
+
+enum
+{
+    FANOUT_ES_ADD,
+    FANOUT_ES_DEL,
+    FANOUT_DATA,
+    FANOUT_PCR,
+    FANOUT_EOS,
+};
+
+typedef struct fanout_event
+{
+    struct fanout_event *next;
+    int type;
+    fanout_es_t *es;
+    union
+    {
+        block_t *block;
+        vlc_tick_t pcr;
+    };
+} fanout_event_t;
+
+typedef struct
+{
+    struct vlc_list node;
+    vlc_mutex_t lock; /**< protects the event queue */
+    vlc_cond_t wait;
+    fanout_event_t *first;
+    fanout_event_t **lastp;
+    atomic_size_t queued; /**< bytes of data queued */
+    size_t queue_max;
+    bool paused;
+
+    int i_resync;
+    fanout_es_t **resync; /**< video ES waiting for a key frame */
+} fanout_subscriber_t;
+
+typedef struct
+{
+    char *var;
+    unsigned refs;
+    bool ended;
+
+    int i_es;
+    fanout_es_t **es;
+    struct vlc_list subscribers;
+
+    struct vlc_list backlog;
+    size_t backlog_size;
+    bool backlog_valid; /**< backlog starts with a key frame */
+} fanout_hub_t;
+
+/* Protects all hubs and the subscriber lists */
+static vlc_mutex_t lock = VLC_STATIC_MUTEX;
+
+static fanout_hub_t *HubAcquire( vlc_object_t *obj, const char *name )
+{
+    vlc_object_t *vlc = VLC_OBJECT(vlc_object_instance(obj));
+    char *var;
+
+    vlc_mutex_assert( &lock );
+
+    if( asprintf( &var, "fanout-hub-%s", name ) == -1 )
+        return NULL;
+
+    fanout_hub_t *hub = var_GetAddress( vlc, var );
+    if( hub != NULL )
+    {
+        free( var );
+        hub->refs++;
+        return hub;
+    }
+
+    hub = malloc( sizeof( *hub ) );
+    if( unlikely(hub == NULL) )
+    {
+        free( var );
+        return NULL;
+    }
+
+    hub->var = var;
+    hub->refs = 1;
+    hub->ended = false;
+    TAB_INIT( hub->i_es, hub->es );
+    vlc_list_init( &hub->subscribers );
+    vlc_list_init( &hub->backlog );
+    hub->backlog_size = 0;
+    hub->backlog_valid = false;
+
+    var_Create( vlc, var, VLC_VAR_ADDRESS );
+    var_SetAddress( vlc, var, hub );
+    return hub;
+}
+
+static void HubRelease( vlc_object_t *obj, fanout_hub_t *hub )
+{
+    vlc_mutex_assert( &lock );
+
+    if( --hub->refs > 0 )
+        return;
+
+    assert( hub->i_es == 0 );
+    assert( vlc_list_is_empty( &hub->subscribers ) );
+    assert( vlc_list_is_empty( &hub->backlog ) );
+    var_Destroy( VLC_OBJECT(vlc_object_instance(obj)), hub->var );
+    TAB_CLEAN( hub->i_es, hub->es );
+    free( hub->var );
+    free( hub );
+}
+
+static void EsRelease( fanout_es_t *es )
+{
+    if( vlc_atomic_rc_dec( &es->rc ) )
+    {
+        es_format_Clean( &es->fmt );
+        free( es );
+    }
+}
+
+static void BacklogRemove( fanout_hub_t *hub, const fanout_es_t *es )
+{
+    fanout_backlog_t *entry;
+
+    vlc_list_foreach( entry, &hub->backlog, node )
+    {
+        if( es != NULL && entry->es != es )
+            continue;
+
+        hub->backlog_size -= entry->block->i_buffer;
+        vlc_list_remove( &entry->node );
+        block_Release( entry->block );
+        free( entry );
+    }
+}
+
+static void BacklogAppend( fanout_hub_t *hub, fanout_es_t *es,
+                           block_t *block )
+{
+    if( es->fmt.i_cat == VIDEO_ES && (block->i_flags & BLOCK_FLAG_TYPE_I) )
+    {   /* Start over from the new key frame */
+        BacklogRemove( hub, NULL );
+        hub->backlog_valid = true;
+    }
+
+    if( !hub->backlog_valid )
+        return;
+
+    if( hub->backlog_size + block->i_buffer > FANOUT_BACKLOG_MAX )
+    {   /* Too long group of pictures: wait for the next key frame */
+        BacklogRemove( hub, NULL );
+        hub->backlog_valid = false;
+        return;
+    }
+
+    fanout_backlog_t *entry = malloc( sizeof( *entry ) );
+    block_t *shared = block_Share( block );
+    if( unlikely(entry == NULL || shared == NULL) )
+    {
+        free( entry );
+        if( shared != NULL )
+            block_Release( shared );
+        BacklogRemove( hub, NULL );
+        hub->backlog_valid = false;
+        return;
+    }
+
+    entry->es = es;
+    entry->block = shared;
+    vlc_list_append( &entry->node, &hub->backlog );
+    hub->backlog_size += block->i_buffer;
+}
+
+static void SubscriberEnqueue( fanout_subscriber_t *sub, fanout_event_t *ev )
+{
+    vlc_mutex_lock( &sub->lock );
+    *sub->lastp = ev;
+    sub->lastp = &ev->next;
+    vlc_cond_signal( &sub->wait );
+    vlc_mutex_unlock( &sub->lock );
+}
+
+static void SubscriberPost( fanout_subscriber_t *sub, int type,
+                            fanout_es_t *es )
+{
+    fanout_event_t *ev = malloc( sizeof( *ev ) );
+    if( unlikely(ev == NULL) )
+        return;
+
+    ev->next = NULL;
+    ev->type = type;
+    ev->es = es;
+    if( es != NULL )
+        vlc_atomic_rc_inc( &es->rc ); /* released by the subscriber */
+    SubscriberEnqueue( sub, ev );
+}
+
+static void SubscriberPostPCR( fanout_subscriber_t *sub, vlc_tick_t pcr )
+{
+    fanout_event_t *ev = malloc( sizeof( *ev ) );
+    if( unlikely(ev == NULL) )
+        return;
+
+    ev->next = NULL;
+    ev->type = FANOUT_PCR;
+    ev->es = NULL;
+    ev->pcr = pcr;
+    SubscriberEnqueue( sub, ev );
+}
+
+static void SubscriberPostData( fanout_subscriber_t *sub, fanout_es_t *es,
+                                block_t *block )
+{
+    size_t size = block->i_buffer;
+    size_t queued = atomic_load_explicit( &sub->queued, memory_order_relaxed );
+    int idx;
+
+    vlc_mutex_assert( &lock );
+    TAB_FIND( sub->i_resync, sub->resync, es, idx );
+
+    if( queued + size > sub->queue_max )
+    {   /* Lost video frame: resume that ES on its next key frame */
+        if( idx < 0 && es->fmt.i_cat == VIDEO_ES && es->keyframes )
+            TAB_APPEND( sub->i_resync, sub->resync, es );
+        return;
+    }
+
+    if( idx >= 0 )
+    {
+        if( !(block->i_flags & BLOCK_FLAG_TYPE_I) )
+            return;
+        TAB_ERASE( sub->i_resync, sub->resync, idx );
+    }
+
+    fanout_event_t *ev = malloc( sizeof( *ev ) );
+    if( unlikely(ev == NULL) )
+        return;
+
+    ev->block = block_Share( block );
+    if( unlikely(ev->block == NULL) )
+    {
+        free( ev );
+        return;
+    }
+
+    ev->next = NULL;
+    ev->type = FANOUT_DATA;
+    ev->es = es;
+    vlc_atomic_rc_inc( &es->rc );
+    atomic_fetch_add_explicit( &sub->queued, size, memory_order_relaxed );
+    SubscriberEnqueue( sub, ev );
+}
+
+/* Wait for a key frame on every video ES, e.g. after frames were skipped */
+static void SubscriberResync( fanout_subscriber_t *sub,
+                              const fanout_hub_t *hub )
+{
+    vlc_mutex_assert( &lock );
+    TAB_CLEAN( sub->i_resync, sub->resync );
+
+    for( int i = 0; i < hub->i_es; i++ )
+        if( hub->es[i]->fmt.i_cat == VIDEO_ES && hub->es[i]->keyframes )
+            TAB_APPEND( sub->i_resync, sub->resync, hub->es[i] );
+}
+
+/*****************************************************************************
+ * Publisher (stream output)
+ *****************************************************************************/
+typedef struct
+{
+    fanout_hub_t *hub;
+} out_sys_t;
+
+static void *AddOut( sout_stream_t *p_stream, const es_format_t *p_fmt,
+                     const char *es_id )
+{
+    out_sys_t *p_sys = p_stream->p_sys;
+    fanout_es_t *es = malloc( sizeof( *es ) );
+
+    VLC_UNUSED(es_id);
+    if( unlikely(es == NULL) )
+        return NULL;
+
+    vlc_atomic_rc_init( &es->rc );
+    es->keyframes = false;
+    if( es_format_Copy( &es->fmt, p_fmt ) != VLC_SUCCESS )
+    {
+        free( es );
+        return NULL;
+    }
+
+    msg_Dbg( p_stream, "publishing codec=%4.4s id=%d",
+             (char *)&p_fmt->i_codec, p_fmt->i_id );
+
+    vlc_mutex_lock( &lock );
+    TAB_APPEND( p_sys->hub->i_es, p_sys->hub->es, es );
+
+    fanout_subscriber_t *sub;
+    vlc_list_foreach( sub, &p_sys->hub->subscribers, node )
+        SubscriberPost( sub, FANOUT_ES_ADD, es );
+    vlc_mutex_unlock( &lock );
+    return es;
+}
+
+static void DelOut( sout_stream_t *p_stream, void *id )
+{
+    out_sys_t *p_sys = p_stream->p_sys;
+    fanout_es_t *es = id;
+
+    vlc_mutex_lock( &lock );
+    TAB_REMOVE( p_sys->hub->i_es, p_sys->hub->es, es );
+    BacklogRemove( p_sys->hub, es );
+
+    fanout_subscriber_t *sub;
+    vlc_list_foreach( sub, &p_sys->hub->subscribers, node )
+    {
+        TAB_REMOVE( sub->i_resync, sub->resync, es );
+        SubscriberPost( sub, FANOUT_ES_DEL, es );
+    }
+    vlc_mutex_unlock( &lock );
+
+    EsRelease( es );
+}
+
+static int SendOut( sout_stream_t *p_stream, void *id, block_t *p_buffer )
+{
+    out_sys_t *p_sys = p_stream->p_sys;
+    fanout_es_t *es = id;
+
+    while( p_buffer != NULL )
+    {
+        block_t *p_next = p_buffer->p_next;
+
+        p_buffer->p_next = NULL;
+
+        vlc_mutex_lock( &lock );
+        if( p_buffer->i_flags & BLOCK_FLAG_TYPE_I )
+            es->keyframes = true;
+
+        fanout_subscriber_t *sub;
+        vlc_list_foreach( sub, &p_sys->hub->subscribers, node )
+            if( !sub->paused )
+                SubscriberPostData( sub, es, p_buffer );
+        BacklogAppend( p_sys->hub, es, p_buffer );
+        vlc_mutex_unlock( &lock );
+
+        block_Release( p_buffer );
+        p_buffer = p_next;
+    }
+
+    return VLC_SUCCESS;
+}
+
+static void SetPCROut( sout_stream_t *p_stream, vlc_tick_t pcr )
+{
+    out_sys_t *p_sys = p_stream->p_sys;
+
+    vlc_mutex_lock( &lock );
+    fanout_subscriber_t *sub;
+    vlc_list_foreach( sub, &p_sys->hub->subscribers, node )
+        if( !sub->paused )
+            SubscriberPostPCR( sub, pcr );
+    vlc_mutex_unlock( &lock );
+}
+
+static int ControlOut( sout_stream_t *p_stream, int query, va_list args )
+{
+    (void) p_stream;
+
+    switch( query )
+    {
+        case SOUT_STREAM_IS_SYNCHRONOUS:
+            *va_arg( args, bool * ) = true;
+            break;
+
+        default:
+            return VLC_EGENERIC;
+    }
+
+    return VLC_SUCCESS;
+}
+
+static void CloseOut( sout_stream_t *p_stream )
+{
+    out_sys_t *p_sys = p_stream->p_sys;
+
+    vlc_mutex_lock( &lock );
+    p_sys->hub->ended = true;
+    BacklogRemove( p_sys->hub, NULL );
+    p_sys->hub->backlog_valid = false;
+
+    fanout_subscriber_t *sub;
+    vlc_list_foreach( sub, &p_sys->hub->subscribers, node )
+        SubscriberPost( sub, FANOUT_EOS, NULL );
+
+    HubRelease( VLC_OBJECT(p_stream), p_sys->hub );
+    vlc_mutex_unlock( &lock );
+    free( p_sys );
+}
+
+static const struct sout_stream_operations ops_out = {
+    .add = AddOut,
+    .del = DelOut,
+    .send = SendOut,
+    .control = ControlOut,
+    .set_pcr = SetPCROut,
+    .close = CloseOut,
+};
+
+static int OpenOut( vlc_object_t *p_this )
+{
+    sout_stream_t *p_stream = (sout_stream_t *)p_this;
+
+    config_ChainParse( p_stream, SOUT_CFG_PREFIX, ppsz_sout_options,
+                       p_stream->p_cfg );
+
+    out_sys_t *p_sys = malloc( sizeof( *p_sys ) );
+    if( unlikely(p_sys == NULL) )
+        return VLC_ENOMEM;
+
+    char *psz_name = var_GetNonEmptyString( p_stream, SOUT_CFG_PREFIX "name" );
+    if( psz_name == NULL )
+    {
+        msg_Err( p_stream, "missing fan-out name" );
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
+    vlc_mutex_lock( &lock );
+    p_sys->hub = HubAcquire( p_this, psz_name );
+    if( p_sys->hub != NULL && p_sys->hub->ended )
+    {   /* Restarted publisher: subscribers have been told about the end */
+        msg_Err( p_stream, "fan-out \"%s\" already ended", psz_name );
+        HubRelease( p_this, p_sys->hub );
+        p_sys->hub = NULL;
+    }
+    vlc_mutex_unlock( &lock );
+    free( psz_name );
+
+    if( p_sys->hub == NULL )
+    {
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
+    p_stream->p_sys = p_sys;
+    p_stream->ops = &ops_out;
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * Subscriber (access demux)
+ *****************************************************************************/
+typedef struct
+{
+    fanout_es_t *es;
+    es_out_id_t *id;
+} in_es_t;
+
+typedef struct
+{
+    fanout_hub_t *hub;
+    fanout_subscriber_t sub;
+    vlc_tick_t pts_delay;
+
+    int i_es;
+    in_es_t **es;
+} in_sys_t;
+
+static in_es_t *InEsGet( in_sys_t *p_sys, const fanout_es_t *es )
+{
+    for( int i = 0; i < p_sys->i_es; i++ )
+        if( p_sys->es[i]->es == es )
+            return p_sys->es[i];
+    return NULL;
+}
+
+static void EventRelease( fanout_subscriber_t *sub, fanout_event_t *ev )
+{
+    if( ev->type == FANOUT_DATA )
+    {
+        atomic_fetch_sub_explicit( &sub->queued, ev->block->i_buffer,
+                                   memory_order_relaxed );
+        block_Release( ev->block );
+    }
+    if( ev->es != NULL )
+        EsRelease( ev->es );
+    free( ev );
+}
+
+static int HandleEvent( demux_t *p_demux, fanout_event_t *ev )
+{
+    in_sys_t *p_sys = p_demux->p_sys;
+    in_es_t *in;
+    int ret = VLC_DEMUXER_SUCCESS;
+
+    switch( ev->type )
+    {
+        case FANOUT_ES_ADD:
+            in = malloc( sizeof( *in ) );
+            if( unlikely(in == NULL) )
+                break;
+            in->es = ev->es;
+            in->id = es_out_Add( p_demux->out, &ev->es->fmt );
+            if( in->id == NULL )
+            {
+                free( in );
+                break;
+            }
+            TAB_APPEND( p_sys->i_es, p_sys->es, in );
+            ev->es = NULL; /* reference moved to in */
+            break;
+
+        case FANOUT_ES_DEL:
+            in = InEsGet( p_sys, ev->es );
+            if( in == NULL )
+                break;
+            es_out_Del( p_demux->out, in->id );
+            TAB_REMOVE( p_sys->i_es, p_sys->es, in );
+            EsRelease( in->es );
+            free( in );
+            break;
+
+        case FANOUT_DATA:
+            atomic_fetch_sub_explicit( &p_sys->sub.queued,
+                                       ev->block->i_buffer,
+                                       memory_order_relaxed );
+            in = InEsGet( p_sys, ev->es );
+            if( in != NULL )
+                es_out_Send( p_demux->out, in->id, ev->block );
+            else
+                block_Release( ev->block );
+            break;
+
+        case FANOUT_PCR:
+            es_out_SetPCR( p_demux->out, ev->pcr );
+            break;
+
+        case FANOUT_EOS:
+            msg_Dbg( p_demux, "end of published stream" );
+            ret = VLC_DEMUXER_EOF;
+            break;
+    }
+
+    if( ev->es != NULL )
+        EsRelease( ev->es );
+    free( ev );
+    return ret;
+}
+
+static int Demux( demux_t *p_demux )
+{
+    in_sys_t *p_sys = p_demux->p_sys;
+    fanout_subscriber_t *sub = &p_sys->sub;
+    vlc_tick_t deadline = vlc_tick_now() + VLC_TICK_FROM_MS(100);
+    fanout_event_t *ev;
+
+    vlc_mutex_lock( &sub->lock );
+    while( sub->first == NULL )
+        if( vlc_cond_timedwait( &sub->wait, &sub->lock, deadline ) )
+            break;
+    ev = sub->first;
+    sub->first = NULL;
+    sub->lastp = &sub->first;
+    vlc_mutex_unlock( &sub->lock );
+
+    int ret = VLC_DEMUXER_SUCCESS;
+
+    while( ev != NULL )
+    {
+        fanout_event_t *next = ev->next;
+
+        if( ret == VLC_DEMUXER_SUCCESS )
+            ret = HandleEvent( p_demux, ev );
+        else
+            EventRelease( &p_sys->sub, ev );
+        ev = next;
+    }
+    return ret;
+}
+
+static void Flush( in_sys_t *p_sys )
+{
+    fanout_subscriber_t *sub = &p_sys->sub;
+    fanout_event_t **pp = &sub->first;
+
+    vlc_mutex_lock( &sub->lock );
+    /* Keep the elementary stream events, drop the rest */
+    while( *pp != NULL )
+    {
+        fanout_event_t *cur = *pp;
+
+        if( cur->type == FANOUT_DATA || cur->type == FANOUT_PCR )
+        {
+            *pp = cur->next;
+            EventRelease( sub, cur );
+        }
+        else
+        {
+            pp = &cur->next;
+        }
+    }
+    sub->lastp = pp;
+    vlc_mutex_unlock( &sub->lock );
+}
+
+static int Control( demux_t *p_demux, int query, va_list args )
+{
+    in_sys_t *p_sys = p_demux->p_sys;
+
+    switch( query )
+    {
+        case DEMUX_CAN_PAUSE:
+            *va_arg( args, bool * ) = true;
+            break;
+
+        case DEMUX_CAN_SEEK:
+        case DEMUX_CAN_CONTROL_PACE:
+            *va_arg( args, bool * ) = false;
+            break;
+
+        case DEMUX_SET_PAUSE_STATE:
+        {
+            bool paused = va_arg( args, int );
+
+            vlc_mutex_lock( &lock );
+            p_sys->sub.paused = paused;
+            if( !paused )
+                SubscriberResync( &p_sys->sub, p_sys->hub );
+            vlc_mutex_unlock( &lock );
+
+            if( paused )
+                Flush( p_sys );
+            break;
+        }
+
+        case DEMUX_GET_PTS_DELAY:
+            *va_arg( args, vlc_tick_t * ) = p_sys->pts_delay;
+            break;
+
+        default:
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
+static int OpenIn( vlc_object_t *p_this )
+{
+    demux_t *p_demux = (demux_t *)p_this;
+
+    if( p_demux->out == NULL || p_demux->psz_location == NULL
+     || p_demux->psz_location[0] == '\0' )
+        return VLC_EGENERIC;
+
+    in_sys_t *p_sys = malloc( sizeof( *p_sys ) );
+    if( unlikely(p_sys == NULL) )
+        return VLC_ENOMEM;
+
+    vlc_mutex_init( &p_sys->sub.lock );
+    vlc_cond_init( &p_sys->sub.wait );
+    p_sys->sub.first = NULL;
+    p_sys->sub.lastp = &p_sys->sub.first;
+    atomic_init( &p_sys->sub.queued, 0 );
+    p_sys->sub.queue_max =
+        var_InheritInteger( p_demux, "fanout-queue-size" ) << 10;
+    p_sys->sub.paused = false;
+    TAB_INIT( p_sys->sub.i_resync, p_sys->sub.resync );
+    p_sys->pts_delay =
+        VLC_TICK_FROM_MS( var_InheritInteger( p_demux, "live-caching" ) );
+    TAB_INIT( p_sys->i_es, p_sys->es );
+
+    vlc_mutex_lock( &lock );
+    p_sys->hub = HubAcquire( p_this, p_demux->psz_location );
+    if( p_sys->hub != NULL )
+    {
+        vlc_list_append( &p_sys->sub.node, &p_sys->hub->subscribers );
+
+        /* Late subscribers get the elementary streams published so far */
+        for( int i = 0; i < p_sys->hub->i_es; i++ )
+            SubscriberPost( &p_sys->sub, FANOUT_ES_ADD, p_sys->hub->es[i] );
+
+        fanout_backlog_t *entry;
+        vlc_list_foreach( entry, &p_sys->hub->backlog, node )
+            SubscriberPostData( &p_sys->sub, entry->es, entry->block );
+        if( p_sys->hub->ended )
+            SubscriberPost( &p_sys->sub, FANOUT_EOS, NULL );
+    }
+    vlc_mutex_unlock( &lock );
+
+    if( p_sys->hub == NULL )
+    {
+        free( p_sys );
+        return VLC_ENOMEM;
+    }
+
+    msg_Dbg( p_demux, "subscribed to fan-out \"%s\"", p_demux->psz_location );
+    p_demux->p_sys = p_sys;
+    p_demux->pf_demux = Demux;
+    p_demux->pf_control = Control;
+    return VLC_SUCCESS;
+}
+
+static void CloseIn( vlc_object_t *p_this )
+{
+    demux_t *p_demux = (demux_t *)p_this;
+    in_sys_t *p_sys = p_demux->p_sys;
+
+    vlc_mutex_lock( &lock );
+    vlc_list_remove( &p_sys->sub.node );
+    HubRelease( p_this, p_sys->hub );
+    vlc_mutex_unlock( &lock );
+
+    TAB_CLEAN( p_sys->sub.i_resync, p_sys->sub.resync );
+
+    fanout_event_t *ev = p_sys->sub.first;
+    while( ev != NULL )
+    {
+        fanout_event_t *next = ev->next;
+
+        EventRelease( &p_sys->sub, ev );
+        ev = next;
+    }
+
+    for( int i = 0; i < p_sys->i_es; i++ )
+    {
+        es_out_Del( p_demux->out, p_sys->es[i]->id );
+        EsRelease( p_sys->es[i]->es );
+        free( p_sys->es[i] );
+    }
+    TAB_CLEAN( p_sys->i_es, p_sys->es );
+    free( p_sys );
+}
@@ -399,65 +399,10 @@ error:
     return NULL;
 }
 
-static struct hls_storage *
-GeneratePlaylistManifest(const hls_playlist_t *playlist)
-{
-    struct vlc_memstream out;
-    vlc_memstream_open(&out);
-
-#define MANIFEST_ADD_TAG(fmt, ...)                                             \
-    do                                                                         \
-    {                                                                          \
-        if (vlc_memstream_printf(&out, fmt "\n", ##__VA_ARGS__) < 0)           \
-            goto error;                                                        \
-    } while (0)
-
-    MANIFEST_ADD_TAG("#EXTM3U");
-    const double seg_duration =
-        secf_from_vlc_tick(playlist->config->segment_length);
-    MANIFEST_ADD_TAG("#EXT-X-TARGETDURATION:%.0f", seg_duration);
-    // First version adding CMAF fragments support.
-    MANIFEST_ADD_TAG("#EXT-X-VERSION:7");
-
-    const bool will_destroy_segments = playlist->config->max_segments == 0;
-    if (playlist->ended)
-        MANIFEST_ADD_TAG("#EXT-X-PLAYLIST-TYPE:VOD");
-    else if (!will_destroy_segments)
-        MANIFEST_ADD_TAG("#EXT-X-PLAYLIST-TYPE:EVENT");
-
-    const hls_segment_t *first_seg = hls_segment_GetFirst(&playlist->segments);
-    MANIFEST_ADD_TAG("#EXT-X-MEDIA-SEQUENCE:%u",
-                     (first_seg == NULL) ? 0u : first_seg->id);
-
-    const hls_segment_t *segment;
-    hls_segment_queue_Foreach_const(&playlist->segments, segment)
-    {
-        MANIFEST_ADD_TAG("#EXTINF:%.2f,", secf_from_vlc_tick(segment->length));
-        MANIFEST_ADD_TAG("%s", segment->url);
-    }
-
-    if (playlist->ended)
-        MANIFEST_ADD_TAG("#EXT-X-ENDLIST");
-
-#undef MANIFEST_ADD_TAG
-
-    if (vlc_memstream_close(&out) != 0)
-        return NULL;
-
-    const struct hls_storage_config storage_config = {
-        .name = playlist->name, .mime = "application/vnd.apple.mpegurl"};
-    return hls_storage_FromBytes(
-        out.ptr, out.length, &storage_config, playlist->config);
-error:
-    if (vlc_memstream_close(&out) != 0)
-        return NULL;
-    free(out.ptr);
-    return NULL;
-}
-
 static int UpdatePlaylistManifest(hls_playlist_t *playlist)
 {
-    struct hls_storage *new_manifest = GeneratePlaylistManifest(playlist);
+    struct hls_storage *new_manifest = hls_segment_queue_GenerateManifest(
+        &playlist->segments, playlist->name, playlist->ended);
     if (unlikely(new_manifest == NULL))
         return VLC_EGENERIC;
 
@@ -542,26 +487,102 @@ static hls_block_chain_t ExtractSubtitleSegment(hls_block_chain_t *muxed_output,
     return segment;
 }
 
-static hls_block_chain_t ExtractSegment(hls_playlist_t *playlist)
+static inline bool IsFragmentHeader(const block_t *block)
+{
+    /* The fragmented MP4 muxer only flags the moof boxes with a frame type. */
+    return block->i_flags & BLOCK_FLAG_TYPE_MASK;
+}
+
+static hls_block_chain_t
+ExtractFragmentedSegment(hls_block_chain_t *muxed_output,
+                         vlc_tick_t max_segment_length,
+                         size_t *fragment_count)
+{
+    hls_block_chain_t segment = {.begin = muxed_output->begin};
+
+    /* Segments are made of whole fragments and start, if possible, with an
+     * independent one. */
+    vlc_tick_t length = 0;
+    size_t count = 0;
+    block_t *prev = NULL;
+    block_t *segment_end = NULL;
+    for (block_t *it = muxed_output->begin; it != NULL; it = it->p_next)
+    {
+        if (IsFragmentHeader(it))
+        {
+            if (prev != NULL && (it->i_flags & BLOCK_FLAG_TYPE_I) &&
+                length <= max_segment_length)
+            {
+                segment_end = prev;
+                segment.length = length;
+                *fragment_count = count;
+            }
+            if (prev != NULL && length >= max_segment_length)
+            {
+                if (segment_end == NULL)
+                {
+                    segment_end = prev;
+                    segment.length = length;
+                    *fragment_count = count;
+                }
+                break;
+            }
+            length += it->i_length;
+            ++count;
+        }
+        prev = it;
+    }
+
+    if (segment_end != NULL)
+    {
+        muxed_output->begin = segment_end->p_next;
+        segment_end->p_next = NULL;
+        muxed_output->length -= segment.length;
+    }
+    else
+    {
+        segment.length = muxed_output->length;
+        *fragment_count = count;
+        hls_block_chain_Reset(muxed_output);
+    }
+    return segment;
+}
+
+static hls_block_chain_t ExtractSegment(hls_playlist_t *playlist,
+                                        size_t *fragment_count)
 {
     const vlc_tick_t seglen = playlist->config->segment_length;
-    if (playlist->type == HLS_PLAYLIST_TYPE_WEBVTT)
-        return ExtractSubtitleSegment(&playlist->muxed_output, seglen);
-    return ExtractCommonSegment(&playlist->muxed_output, seglen);
+    *fragment_count = 0;
+    switch (playlist->type)
+    {
+        case HLS_PLAYLIST_TYPE_WEBVTT:
+            return ExtractSubtitleSegment(&playlist->muxed_output, seglen);
+        case HLS_PLAYLIST_TYPE_FMP4:
+            return ExtractFragmentedSegment(
+                &playlist->muxed_output, seglen, fragment_count);
+        default:
+            return ExtractCommonSegment(&playlist->muxed_output, seglen);
+    }
 }
 
-static bool IsSegmentSelfDecodable(const hls_block_chain_t *segment)
+static bool IsSegmentSelfDecodable(enum hls_playlist_type type,
+                                   const hls_block_chain_t *segment)
 {
     if (segment->begin == NULL)
         return false;
 
+    /* The initialization section of fragmented MP4 is stored apart, the
+     * first moof tells whether the fragment starts with a keyframe. */
+    if (type == HLS_PLAYLIST_TYPE_FMP4)
+        return segment->begin->i_flags & BLOCK_FLAG_TYPE_I;
     return segment->begin->i_flags & BLOCK_FLAG_HEADER;
 }
 
 static int ExtractAndAddSegment(hls_playlist_t *playlist,
                                 sout_stream_sys_t *sys)
 {
-    hls_block_chain_t segment = ExtractSegment(playlist);
+    size_t fragment_count;
+    hls_block_chain_t segment = ExtractSegment(playlist, &fragment_count);
 
     if (hls_config_IsMemStorageEnabled(&sys->config) &&
         hls_segment_queue_IsAtMaxCapacity(&playlist->segments))
@@ -572,10 +593,10 @@ static int ExtractAndAddSegment(hls_playlist_t *playlist,
             hls_storage_GetSize(to_be_removed->storage);
     }
 
-    const bool self_decodable = IsSegmentSelfDecodable(&segment);
+    const bool self_decodable = IsSegmentSelfDecodable(playlist->type, &segment);
     const vlc_tick_t length = segment.length;
     const int status = hls_segment_queue_NewSegment(
-        &playlist->segments, segment.begin, segment.length);
+        &playlist->segments, segment.begin, segment.length, fragment_count);
     if (unlikely(status != VLC_SUCCESS))
     {
         vlc_error(playlist->logger,
@@ -620,10 +641,90 @@ static bool IsSegmentReady(enum hls_playlist_type type,
     if( type == HLS_PLAYLIST_TYPE_WEBVTT)
         return buffer->begin != buffer->last_header;
 
+    /* The last fragment is still being written, don't count it. */
+    if (type == HLS_PLAYLIST_TYPE_FMP4)
+        return buffer->last_header != NULL &&
+               buffer->length - buffer->last_header->i_length >= seglen;
+
     /* Only consider full segments as ready for now. */
     return buffer->length >= seglen;
 }
 
+/**
+ * Publish the last complete fragment of the muxed output as a partial
+ * segment.
+ */
+static int PublishPart(hls_playlist_t *playlist)
+{
+    const block_t *fragment = playlist->muxed_output.last_header;
+
+    block_t *content = NULL;
+    block_t **last = &content;
+    for (const block_t *it = fragment; it != NULL; it = it->p_next)
+    {
+        block_t *copy = block_Duplicate(it);
+        if (unlikely(copy == NULL))
+        {
+            block_ChainRelease(content);
+            return VLC_ENOMEM;
+        }
+        block_ChainLastAppend(&last, copy);
+    }
+
+    const int status =
+        hls_segment_queue_NewPart(&playlist->segments,
+                                  content,
+                                  fragment->i_length,
+                                  fragment->i_flags & BLOCK_FLAG_TYPE_I);
+    if (unlikely(status != VLC_SUCCESS))
+        return status;
+    return UpdatePlaylistManifest(playlist);
+}
+
+/**
+ * The fragmented MP4 muxer outputs the initialization section first, then
+ * each fragment as a moof followed by its samples. The moof carries the
+ * length of the whole fragment and is tracked as the chain last header.
+ */
+static int AppendFragmentedOutput(hls_playlist_t *playlist, block_t *block)
+{
+    hls_block_chain_t *output = &playlist->muxed_output;
+    while (block != NULL)
+    {
+        block_t *next = block->p_next;
+        block->p_next = NULL;
+
+        int status = VLC_SUCCESS;
+        if (block->i_flags & BLOCK_FLAG_HEADER)
+        {
+            status = hls_segment_queue_SetInit(&playlist->segments, block);
+            if (status == VLC_SUCCESS)
+                status = UpdatePlaylistManifest(playlist);
+            block = NULL;
+        }
+        else if (IsFragmentHeader(block))
+        {
+            /* A new fragment completes the previous one. */
+            if (output->last_header != NULL &&
+                playlist->config->part_length != 0)
+                status = PublishPart(playlist);
+            output->length += block->i_length;
+            output->last_header = block;
+        }
+
+        if (block != NULL)
+            block_ChainLastAppend(&output->end, block);
+
+        if (status != VLC_SUCCESS)
+        {
+            block_ChainRelease(next);
+            return status;
+        }
+        block = next;
+    }
+    return VLC_SUCCESS;
+}
+
 static ssize_t AccessOutWrite(sout_access_out_t *access, block_t *block)
 {
     sout_stream_sys_t *sys = access->p_sys;
@@ -652,7 +753,12 @@ static ssize_t AccessOutWrite(sout_access_out_t *access, block_t *block)
     hls_playlists_foreach(it)
     {
         /* Append the muxed output to the playlist tied to this access call. */
-        if (it->access == access)
+        if (it->access == access && it->type == HLS_PLAYLIST_TYPE_FMP4)
+        {
+            if (AppendFragmentedOutput(it, block) != VLC_SUCCESS)
+                return -1;
+        }
+        else if (it->access == access)
         {
             block_ChainLastAppend(&it->muxed_output.end, block);
             it->muxed_output.length += length;
@@ -728,6 +834,21 @@ static sout_mux_t *CreatePlaylistMuxer(sout_access_out_t *access,
     {
         case HLS_PLAYLIST_TYPE_TS:
             return sout_MuxNew(access, "ts{use-key-frames}");
+        case HLS_PLAYLIST_TYPE_FMP4:
+        {
+            /* Each fragment is published as a part when they are enabled. */
+            if (config->part_length == 0)
+                return sout_MuxNew(access, "mp4stream");
+
+            char *mux;
+            if (asprintf(&mux,
+                         "mp4stream{frag-duration=%" PRId64 "}",
+                         MS_FROM_VLC_TICK(config->part_length)) == -1)
+                return NULL;
+            sout_mux_t *ret = sout_MuxNew(access, mux);
+            free(mux);
+            return ret;
+        }
         case HLS_PLAYLIST_TYPE_WEBVTT:
             return CreateSubtitleSegmenter(access, config);
     }
@@ -862,19 +983,20 @@ Add(sout_stream_t *stream, const es_format_t *fmt, const char *es_id)
     // Either retrieve the already created playlist from the map or create it.
     struct hls_variant_stream_map *map =
         hls_variant_map_FromESID(&sys->variant_stream_maps, es_id);
+    const enum hls_playlist_type type =
+        sys->config.cmaf ? HLS_PLAYLIST_TYPE_FMP4 : HLS_PLAYLIST_TYPE_TS;
     hls_playlist_t *playlist;
     if (map != NULL)
     {
         playlist = map->playlist_ref;
         if (playlist == NULL)
-            playlist = AddPlaylist(stream, HLS_PLAYLIST_TYPE_TS, &sys->variant_playlists);
+            playlist = AddPlaylist(stream, type, &sys->variant_playlists);
     }
     else if (fmt->i_cat == SPU_ES)
         playlist = AddPlaylist(
             stream, HLS_PLAYLIST_TYPE_WEBVTT, &sys->media_playlists);
     else
-        playlist =
-            AddPlaylist(stream, HLS_PLAYLIST_TYPE_TS, &sys->media_playlists);
+        playlist = AddPlaylist(stream, type, &sys->media_playlists);
 
     if (playlist == NULL)
         return NULL;
@@ -1049,11 +1171,13 @@ static int Open(vlc_object_t *this)
     stream->p_sys = sys;
 
     static const char *const options[] = {"base-url",
+                                          "cmaf",
                                           "host-http",
                                           "max-memory",
                                           "num-seg",
                                           "out-dir",
                                           "pace",
+                                          "part-len",
                                           "seg-len",
                                           "variants",
                                           NULL};
@@ -1069,10 +1193,30 @@ static int Open(vlc_object_t *this)
         VLC_TICK_FROM_SEC(var_GetInteger(stream, SOUT_CFG_PREFIX "seg-len"));
     sys->config.max_memory =
         BYTES_FROM_KB(var_GetInteger(stream, SOUT_CFG_PREFIX "max-memory"));
+    sys->config.cmaf = var_GetBool(stream, SOUT_CFG_PREFIX "cmaf");
+    sys->config.part_length =
+        VLC_TICK_FROM_MS(var_GetInteger(stream, SOUT_CFG_PREFIX "part-len"));
 
     int status = VLC_EINVAL;
 
     vlc_vector_init(&sys->variant_stream_maps);
+
+    if (sys->config.part_length != 0)
+    {
+        if (sys->config.part_length >= sys->config.segment_length)
+        {
+            msg_Err(stream,
+                    "The part length must be shorter than the segment length");
+            goto variant_error;
+        }
+        if (!sys->config.cmaf)
+        {
+            msg_Warn(stream,
+                     "Partial segments require CMAF segments, enabling "
+                     "\"" SOUT_CFG_PREFIX "cmaf\"");
+            sys->config.cmaf = true;
+        }
+    }
     char *variants = var_GetNonEmptyString(stream, SOUT_CFG_PREFIX "variants");
     if (variants == NULL)
     {
@@ -1153,6 +1297,10 @@ variant_error:
 #define VARIANTS_TEXT                                                          \
     N_("Map that group ES string IDs into variant streams (mandatory)")
 #define BASEURL_TEXT N_("Base of the URL")
+#define CMAF_LONGTEXT                                                          \
+    N_("Produce CMAF (fragmented MP4) segments sharing an initialization "    \
+       "section instead of MPEG-TS segments")
+#define CMAF_TEXT N_("Produce CMAF segments")
 #define HOSTHTTP_LONGTEXT                                                      \
     N_("The internal HTTP server will share the HLS output. This is "          \
        "unadvised for the common use case where an external HTTP server "      \
@@ -1173,6 +1321,11 @@ variant_error:
 #define PACE_LONGTEXT                                                          \
     N_("Enable input pacing, the media will play at playback rate")
 #define PACE_TEXT N_("Enable pacing")
+#define PARTLEN_LONGTEXT                                                       \
+    N_("Length in milliseconds of the Low-Latency HLS partial segments "      \
+       "published while a segment is being built. Partial segments require "  \
+       "CMAF segments. 0 disables them")
+#define PARTLEN_TEXT N_("Partial segment length (ms)")
 #define SEGLEN_LONGTEXT N_("Length of segments in seconds")
 #define SEGLEN_TEXT N_("Segment length (sec)")
 
@@ -1191,6 +1344,9 @@ vlc_module_begin()
     add_integer(SOUT_CFG_PREFIX "num-seg", 0, NUMSEG_TEXT, NUMSEG_TEXT)
     add_string(SOUT_CFG_PREFIX "out-dir", NULL, OUTDIR_TEXT, OUTDIR_LONGTEXT)
     add_bool(SOUT_CFG_PREFIX "pace", false, PACE_TEXT, PACE_LONGTEXT)
+    add_bool(SOUT_CFG_PREFIX "cmaf", false, CMAF_TEXT, CMAF_LONGTEXT)
+    add_integer_with_range(SOUT_CFG_PREFIX "part-len", 0, 0, 10000,
+                           PARTLEN_TEXT, PARTLEN_LONGTEXT)
     add_integer(SOUT_CFG_PREFIX "seg-len", 4, SEGLEN_TEXT, SEGLEN_LONGTEXT)
 
     set_callback(Open)
@@ -23,6 +23,7 @@
 enum hls_playlist_type
 {
     HLS_PLAYLIST_TYPE_TS,
+    HLS_PLAYLIST_TYPE_FMP4,
     HLS_PLAYLIST_TYPE_WEBVTT,
 };
 
@@ -34,6 +35,10 @@ struct hls_config
     bool pace;
     vlc_tick_t segment_length;
     size_t max_memory;
+    /** Produce CMAF (fragmented MP4) segments instead of MPEG-TS. */
+    bool cmaf;
+    /** Length of the LL-HLS partial segments, 0 when disabled. */
+    vlc_tick_t part_length;
 };
 
 #define BYTES_FROM_KB(x) ((x) * 1000)
@@ -25,19 +25,45 @@
 
 #include <vlc_common.h>
 
+#include <vlc_block.h>
 #include <vlc_httpd.h>
 #include <vlc_list.h>
+#include <vlc_memstream.h>
 #include <vlc_tick.h>
 
 #include "hls.h"
 #include "segments.h"
 #include "storage.h"
 
+/**
+ * Parts are only advertised for the last segments, as recommended by
+ * RFC 8216bis section 6.2.2.
+ */
+#define HLS_PART_SEGMENTS 3
+
+static void hls_part_Destroy(hls_part_t *part)
+{
+    if (part->http_url != NULL)
+        httpd_UrlDelete(part->http_url);
+    hls_storage_Destroy(part->storage);
+    free(part->url);
+    free(part);
+}
+
+static void hls_parts_Clear(struct vlc_list *parts)
+{
+    hls_part_t *it;
+    vlc_list_foreach (it, parts, priv_node)
+        hls_part_Destroy(it);
+    vlc_list_init(parts);
+}
+
 static void hls_segment_Destroy(hls_segment_t *segment)
 {
     if (segment->http_url != NULL)
         httpd_UrlDelete(segment->http_url);
     hls_storage_Destroy(segment->storage);
+    hls_parts_Clear(&segment->parts);
     free(segment->url);
     free(segment);
 }
@@ -49,6 +75,8 @@ hls_segment_queue_GetFileExtension(enum hls_playlist_type type)
     {
         case HLS_PLAYLIST_TYPE_TS:
             return "ts";
+        case HLS_PLAYLIST_TYPE_FMP4:
+            return "m4s";
         case HLS_PLAYLIST_TYPE_WEBVTT:
             return "vtt";
         default:
@@ -56,6 +84,59 @@ hls_segment_queue_GetFileExtension(enum hls_playlist_type type)
     }
 }
 
+static const char *hls_segment_queue_GetMime(enum hls_playlist_type type)
+{
+    switch (type)
+    {
+        case HLS_PLAYLIST_TYPE_TS:
+            return "video/MP2T";
+        case HLS_PLAYLIST_TYPE_FMP4:
+            return "video/mp4";
+        case HLS_PLAYLIST_TYPE_WEBVTT:
+            return "text/vtt";
+        default:
+            vlc_assert_unreachable();
+    }
+}
+
+/**
+ * Store the content and expose it on the HTTP host if there's one.
+ */
+static int hls_segment_queue_Publish(const hls_segment_queue_t *queue,
+                                     const char *url,
+                                     const char *mime,
+                                     block_t *content,
+                                     struct hls_storage **storage,
+                                     httpd_url_t **http_url)
+{
+    const struct hls_storage_config storage_conf = {
+        .name = url + strlen(queue->hls_config->base_url) + 1,
+        .mime = mime,
+    };
+    *storage = hls_storage_FromBlocks(content, &storage_conf, queue->hls_config);
+    if (unlikely(*storage == NULL))
+        return VLC_ENOMEM;
+
+    if (queue->httpd_ref == NULL)
+    {
+        *http_url = NULL;
+        return VLC_SUCCESS;
+    }
+
+    *http_url = httpd_UrlNew(queue->httpd_ref, url, NULL, NULL);
+    if (*http_url == NULL)
+    {
+        hls_storage_Destroy(*storage);
+        return VLC_ENOMEM;
+    }
+
+    httpd_UrlCatch(*http_url,
+                   HTTPD_MSG_GET,
+                   queue->httpd_callback,
+                   (httpd_callback_sys_t *)*storage);
+    return VLC_SUCCESS;
+}
+
 void hls_segment_queue_Init(hls_segment_queue_t *queue,
                             const struct hls_segment_queue_config *config,
                             const struct hls_config *hls_config)
@@ -66,11 +147,20 @@ void hls_segment_queue_Init(hls_segment_queue_t *queue,
     queue->httpd_ref = config->httpd_ref;
     queue->httpd_callback = config->httpd_callback;
 
+    queue->type = config->playlist_type;
     queue->file_extension =
         hls_segment_queue_GetFileExtension(config->playlist_type);
+    queue->mime = hls_segment_queue_GetMime(config->playlist_type);
 
     queue->hls_config = hls_config;
 
+    queue->init_url = NULL;
+    queue->init = NULL;
+    queue->http_init = NULL;
+
+    queue->total_parts = 0;
+    vlc_list_init(&queue->pending_parts);
+
     vlc_list_init(&queue->segments);
 }
 
@@ -78,11 +168,20 @@ void hls_segment_queue_Clear(hls_segment_queue_t *queue)
 {
     hls_segment_t *it;
     hls_segment_queue_Foreach(queue, it) { hls_segment_Destroy(it); }
+
+    hls_parts_Clear(&queue->pending_parts);
+
+    if (queue->http_init != NULL)
+        httpd_UrlDelete(queue->http_init);
+    if (queue->init != NULL)
+        hls_storage_Destroy(queue->init);
+    free(queue->init_url);
 }
 
 int hls_segment_queue_NewSegment(hls_segment_queue_t *queue,
                                  block_t *content,
-                                 vlc_tick_t length)
+                                 vlc_tick_t length,
+                                 size_t part_count)
 {
     hls_segment_t *segment = malloc(sizeof(*segment));
     if (unlikely(segment == NULL))
@@ -90,6 +189,7 @@ int hls_segment_queue_NewSegment(hls_segment_queue_t *queue,
 
     segment->id = queue->total_segments;
     segment->length = length;
+    vlc_list_init(&segment->parts);
 
     if (asprintf(&segment->url,
                  "%s/playlist-%u-%u.%s",
@@ -98,33 +198,32 @@ int hls_segment_queue_NewSegment(hls_segment_queue_t *queue,
                  segment->id,
                  queue->file_extension) == -1)
     {
-        segment->url = NULL;
-        goto nomem;
+        free(segment);
+        return VLC_ENOMEM;
     }
 
-    const struct hls_storage_config storage_conf = {
-        .name = segment->url + strlen(queue->hls_config->base_url) + 1,
-        .mime = "video/MP2T",
-    };
-    segment->storage =
-        hls_storage_FromBlocks(content, &storage_conf, queue->hls_config);
-    if (unlikely(segment->storage == NULL))
-        goto nomem;
-
-    if (queue->httpd_ref != NULL)
+    if (hls_segment_queue_Publish(queue,
+                                  segment->url,
+                                  queue->mime,
+                                  content,
+                                  &segment->storage,
+                                  &segment->http_url) != VLC_SUCCESS)
     {
-        segment->http_url =
-            httpd_UrlNew(queue->httpd_ref, segment->url, NULL, NULL);
-        if (segment->http_url == NULL)
-            goto nomem;
+        free(segment->url);
+        free(segment);
+        return VLC_ENOMEM;
+    }
 
-        httpd_UrlCatch(segment->http_url,
-                       HTTPD_MSG_GET,
-                       queue->httpd_callback,
-                       (httpd_callback_sys_t *)segment->storage);
+    /* The segment takes over the parts it is made of. */
+    for (size_t i = 0; i < part_count; ++i)
+    {
+        hls_part_t *part = vlc_list_first_entry_or_null(
+            &queue->pending_parts, hls_part_t, priv_node);
+        if (part == NULL)
+            break;
+        vlc_list_remove(&part->priv_node);
+        vlc_list_append(&part->priv_node, &segment->parts);
     }
-    else
-        segment->http_url = NULL;
 
     if (hls_segment_queue_IsAtMaxCapacity(queue))
     {
@@ -136,11 +235,187 @@ int hls_segment_queue_NewSegment(hls_segment_queue_t *queue,
 
     ++queue->total_segments;
     vlc_list_append(&segment->priv_node, &queue->segments);
+
+    unsigned int count = 0;
+    hls_segment_t *it;
+    vlc_list_reverse_foreach (it, &queue->segments, priv_node)
+    {
+        if (++count > HLS_PART_SEGMENTS)
+        {
+            hls_parts_Clear(&it->parts);
+            break;
+        }
+    }
     return VLC_SUCCESS;
-nomem:
-    if (segment->storage != NULL)
-        hls_storage_Destroy(segment->storage);
-    free(segment->url);
-    free(segment);
-    return VLC_ENOMEM;
+}
+
+int hls_segment_queue_NewPart(hls_segment_queue_t *queue,
+                              block_t *content,
+                              vlc_tick_t length,
+                              bool independent)
+{
+    hls_part_t *part = malloc(sizeof(*part));
+    if (unlikely(part == NULL))
+    {
+        block_ChainRelease(content);
+        return VLC_ENOMEM;
+    }
+
+    part->length = length;
+    part->independent = independent;
+
+    if (asprintf(&part->url,
+                 "%s/playlist-%u-part-%u.%s",
+                 queue->hls_config->base_url,
+                 queue->playlist_id,
+                 queue->total_parts,
+                 queue->file_extension) == -1)
+    {
+        block_ChainRelease(content);
+        free(part);
+        return VLC_ENOMEM;
+    }
+
+    if (hls_segment_queue_Publish(queue,
+                                  part->url,
+                                  queue->mime,
+                                  content,
+                                  &part->storage,
+                                  &part->http_url) != VLC_SUCCESS)
+    {
+        free(part->url);
+        free(part);
+        return VLC_ENOMEM;
+    }
+
+    ++queue->total_parts;
+    vlc_list_append(&part->priv_node, &queue->pending_parts);
+    return VLC_SUCCESS;
+}
+
+int hls_segment_queue_SetInit(hls_segment_queue_t *queue, block_t *content)
+{
+    if (queue->init_url == NULL &&
+        asprintf(&queue->init_url,
+                 "%s/playlist-%u-init.mp4",
+                 queue->hls_config->base_url,
+                 queue->playlist_id) == -1)
+    {
+        queue->init_url = NULL;
+        block_ChainRelease(content);
+        return VLC_ENOMEM;
+    }
+
+    if (queue->http_init != NULL)
+        httpd_UrlDelete(queue->http_init);
+    if (queue->init != NULL)
+        hls_storage_Destroy(queue->init);
+
+    const int status = hls_segment_queue_Publish(queue,
+                                                 queue->init_url,
+                                                 "video/mp4",
+                                                 content,
+                                                 &queue->init,
+                                                 &queue->http_init);
+    if (status != VLC_SUCCESS)
+    {
+        queue->init = NULL;
+        queue->http_init = NULL;
+    }
+    return status;
+}
+
+struct hls_storage *
+hls_segment_queue_GenerateManifest(const hls_segment_queue_t *queue,
+                                   const char *name,
+                                   bool ended)
+{
+    struct vlc_memstream out;
+    vlc_memstream_open(&out);
+
+#define MANIFEST_ADD_TAG(fmt, ...)                                             \
+    do                                                                         \
+    {                                                                          \
+        if (vlc_memstream_printf(&out, fmt "\n", ##__VA_ARGS__) < 0)           \
+            goto error;                                                        \
+    } while (0)
+
+    MANIFEST_ADD_TAG("#EXTM3U");
+    const double seg_duration =
+        secf_from_vlc_tick(queue->hls_config->segment_length);
+    MANIFEST_ADD_TAG("#EXT-X-TARGETDURATION:%.0f", seg_duration);
+    // First version adding CMAF fragments support.
+    MANIFEST_ADD_TAG("#EXT-X-VERSION:7");
+
+    /* Parts are of no use once the playlist ended. */
+    const bool has_parts = queue->type == HLS_PLAYLIST_TYPE_FMP4 &&
+                           queue->hls_config->part_length != 0 &&
+                           !ended;
+    if (has_parts)
+    {
+        /* Blocking playlist reloads are not advertised: the built-in HTTP
+         * server has to answer from its own thread, clients will poll. */
+        const double part_duration =
+            secf_from_vlc_tick(queue->hls_config->part_length);
+        MANIFEST_ADD_TAG("#EXT-X-SERVER-CONTROL:PART-HOLD-BACK=%.3f",
+                         3 * part_duration);
+        MANIFEST_ADD_TAG("#EXT-X-PART-INF:PART-TARGET=%.3f", part_duration);
+    }
+
+    const bool will_destroy_segments = queue->hls_config->max_segments != 0;
+    if (ended)
+        MANIFEST_ADD_TAG("#EXT-X-PLAYLIST-TYPE:VOD");
+    else if (!will_destroy_segments)
+        MANIFEST_ADD_TAG("#EXT-X-PLAYLIST-TYPE:EVENT");
+
+    const hls_segment_t *first_seg = hls_segment_GetFirst(queue);
+    MANIFEST_ADD_TAG("#EXT-X-MEDIA-SEQUENCE:%u",
+                     (first_seg == NULL) ? 0u : first_seg->id);
+
+    if (queue->init != NULL)
+        MANIFEST_ADD_TAG("#EXT-X-MAP:URI=\"%s\"", queue->init_url);
+
+#define MANIFEST_ADD_PART(part)                                                \
+    MANIFEST_ADD_TAG("#EXT-X-PART:DURATION=%.3f,URI=\"%s\"%s",                 \
+                     secf_from_vlc_tick((part)->length),                       \
+                     (part)->url,                                              \
+                     (part)->independent ? ",INDEPENDENT=YES" : "")
+
+    const hls_part_t *part;
+    const hls_segment_t *segment;
+    hls_segment_queue_Foreach_const(queue, segment)
+    {
+        if (has_parts)
+        {
+            hls_segment_Foreach_part_const(segment, part)
+                MANIFEST_ADD_PART(part);
+        }
+        MANIFEST_ADD_TAG("#EXTINF:%.2f,", secf_from_vlc_tick(segment->length));
+        MANIFEST_ADD_TAG("%s", segment->url);
+    }
+
+    if (has_parts)
+    {
+        hls_segment_queue_Foreach_pending_part_const(queue, part)
+            MANIFEST_ADD_PART(part);
+    }
+
+    if (ended)
+        MANIFEST_ADD_TAG("#EXT-X-ENDLIST");
+
+#undef MANIFEST_ADD_PART
+#undef MANIFEST_ADD_TAG
+
+    if (vlc_memstream_close(&out) != 0)
+        return NULL;
+
+    const struct hls_storage_config storage_config = {
+        .name = name, .mime = "application/vnd.apple.mpegurl"};
+    return hls_storage_FromBytes(
+        out.ptr, out.length, &storage_config, queue->hls_config);
+error:
+    if (vlc_memstream_close(&out) != 0)
+        return NULL;
+    free(out.ptr);
+    return NULL;
 }
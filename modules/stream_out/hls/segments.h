@@ -23,6 +23,23 @@
 struct hls_storage;
 struct hls_config;
 
+/**
+ * Represent one partial segment (EXT-X-PART) of a low latency playlist.
+ */
+typedef struct hls_part
+{
+    char *url;
+    vlc_tick_t length;
+    /** The part starts with a synchronization frame. */
+    bool independent;
+
+    struct hls_storage *storage;
+
+    httpd_url_t *http_url;
+
+    struct vlc_list priv_node;
+} hls_part_t;
+
 typedef struct hls_segment
 {
     char *url;
@@ -33,6 +50,12 @@ typedef struct hls_segment
 
     httpd_url_t *http_url;
 
+    /**
+     * Partial segments the segment is made of. Only the most recent segments
+     * keep them.
+     */
+    struct vlc_list parts;
+
     struct vlc_list priv_node;
 } hls_segment_t;
 
@@ -48,15 +71,29 @@ struct hls_segment_queue_config
 typedef struct
 {
     unsigned int playlist_id;
+    enum hls_playlist_type type;
     unsigned int total_segments;
 
     httpd_host_t *httpd_ref;
     httpd_callback_t httpd_callback;
 
     const char *file_extension;
+    const char *mime;
 
     const struct hls_config *hls_config;
 
+    /**
+     * Media initialization section (EXT-X-MAP), NULL until received or if the
+     * segments are self-initializing.
+     */
+    char *init_url;
+    struct hls_storage *init;
+    httpd_url_t *http_init;
+
+    unsigned int total_parts;
+    /** Parts of the segment currently being built. */
+    struct vlc_list pending_parts;
+
     struct vlc_list segments;
 } hls_segment_queue_t;
 
@@ -64,6 +101,10 @@ typedef struct
     vlc_list_foreach (it, &(queue)->segments, priv_node)
 #define hls_segment_queue_Foreach_const(queue, it)                             \
     vlc_list_foreach_const (it, &(queue)->segments, priv_node)
+#define hls_segment_queue_Foreach_pending_part_const(queue, it)                \
+    vlc_list_foreach_const (it, &(queue)->pending_parts, priv_node)
+#define hls_segment_Foreach_part_const(segment, it)                            \
+    vlc_list_foreach_const (it, &(segment)->parts, priv_node)
 #define hls_segment_GetFirst(queue)                                            \
     vlc_list_first_entry_or_null(&(queue)->segments, hls_segment_t, priv_node);
 
@@ -80,13 +121,55 @@ void hls_segment_queue_Clear(hls_segment_queue_t *);
  *
  * \param content A chain of block containing segment's data.
  * \param length The media time size of the segment.
+ * \param part_count Number of pending parts the segment data is made of.
  *
  * \retval VLC_SUCCESS on success.
  * \retval VLC_ENOMEM on internal allocation failure.
  */
 int hls_segment_queue_NewSegment(hls_segment_queue_t *,
                                  block_t *content,
-                                 vlc_tick_t length);
+                                 vlc_tick_t length,
+                                 size_t part_count);
+
+/**
+ * Add a new part to the segment currently being built.
+ *
+ * \param content A chain of block containing a copy of the part's data.
+ * \param length The media time size of the part.
+ * \param independent Whether the part starts with a synchronization frame.
+ *
+ * \retval VLC_SUCCESS on success.
+ * \retval VLC_ENOMEM on internal allocation failure.
+ */
+int hls_segment_queue_NewPart(hls_segment_queue_t *,
+                              block_t *content,
+                              vlc_tick_t length,
+                              bool independent);
+
+/**
+ * Set the media initialization section shared by all the segments.
+ *
+ * \param content A chain of block containing the section's data.
+ *
+ * \retval VLC_SUCCESS on success.
+ * \retval VLC_ENOMEM on internal allocation failure.
+ */
+int hls_segment_queue_SetInit(hls_segment_queue_t *, block_t *content);
+
+/**
+ * Generate the media playlist manifest (RFC 8216 section 4.3.3) listing the
+ * queue content.
+ *
+ * \param name Storage name of the manifest.
+ * \param ended Whether the playlist ended, no segment will be added anymore.
+ *
+ * \return The manifest storage, to be destroyed with \ref hls_storage_Destroy.
+ * \retval NULL on allocation failure.
+ */
+struct hls_storage *
+hls_segment_queue_GenerateManifest(const hls_segment_queue_t *,
+                                   const char *name,
+                                   bool ended);
 
 static inline bool
 hls_segment_queue_IsAtMaxCapacity(const hls_segment_queue_t *queue)
@@ -43,7 +43,6 @@
 #include <vlc_url.h>
 #include <vlc_network.h>
 #include <vlc_fs.h>
-#include <vlc_queue.h>
 #include <vlc_rand.h>
 #include <vlc_memstream.h>
 #ifdef HAVE_SRTP
@@ -258,7 +257,7 @@ static void  MuxDel( sout_stream_t *, void * );
 static int   MuxSend( sout_stream_t *, void *, block_t * );
 
 static sout_access_out_t *GrabberCreate( sout_stream_t *p_sout );
-static void* ThreadSend( void * );
+static void *ThreadSend( void * );
 static void *rtp_listen_thread( void * );
 
 static void SDPHandleUrl( sout_stream_t *, const char * );
@@ -311,6 +310,20 @@ typedef struct
     vlc_mutex_t      lock_es;
     int              i_es;
     sout_stream_id_sys_t **es;
+
+    /* Packet scheduler, shared by all the ES */
+    struct {
+        vlc_mutex_t   lock;
+        vlc_cond_t    wait;
+        vlc_cond_t    done;
+        vlc_thread_t  thread;
+        bool          running;
+        bool          closing;
+        int           idc;
+        sout_stream_id_sys_t **idv;
+        /* ES whose packets are being sent outside of the lock */
+        sout_stream_id_sys_t *busy;
+    } send;
 } sout_stream_sys_t;
 
 typedef struct rtp_sink_t
@@ -344,10 +357,11 @@ struct sout_stream_id_sys_t
 #endif
 
     /* Packets sinks */
-    vlc_thread_t      thread;
     vlc_mutex_t       lock_sink;
-    vlc_queue_t       queue;
-    bool              dead;
+    /* Packets waiting for their sending time, protected by the scheduler
+     * lock */
+    block_t          *send_first;
+    block_t         **send_last;
     int               sinkc;
     rtp_sink_t       *sinkv;
     rtsp_stream_id_t *rtsp_id;
@@ -518,6 +532,14 @@ static int Open( vlc_object_t *p_this )
     vlc_mutex_init( &p_sys->lock_sdp );
     vlc_mutex_init( &p_sys->lock_ts );
     vlc_mutex_init( &p_sys->lock_es );
+    vlc_mutex_init( &p_sys->send.lock );
+    vlc_cond_init( &p_sys->send.wait );
+    vlc_cond_init( &p_sys->send.done );
+    p_sys->send.running = false;
+    p_sys->send.closing = false;
+    p_sys->send.idc = 0;
+    p_sys->send.idv = NULL;
+    p_sys->send.busy = NULL;
 
     psz = var_GetNonEmptyString( p_stream, SOUT_CFG_PREFIX "mux" );
     if( psz != NULL )
@@ -622,6 +644,17 @@ static void Close( sout_stream_t *p_stream )
     if( p_sys->rtsp != NULL )
         RtspUnsetup( p_sys->rtsp );
 
+    if( p_sys->send.running )
+    {
+        vlc_mutex_lock( &p_sys->send.lock );
+        p_sys->send.closing = true;
+        vlc_cond_signal( &p_sys->send.wait );
+        vlc_mutex_unlock( &p_sys->send.lock );
+        vlc_join( p_sys->send.thread, NULL );
+    }
+    assert( p_sys->send.idc == 0 );
+    free( p_sys->send.idv );
+
     if( p_sys->p_httpd_file )
         httpd_FileDelete( p_sys->p_httpd_file );
 
@@ -943,8 +976,8 @@ static void *Add( sout_stream_t *p_stream, const es_format_t *p_fmt, const char
     id->sinkc = 0;
     id->sinkv = NULL;
     id->rtsp_id = NULL;
-    vlc_queue_Init(&id->queue, offsetof (block_t, p_next));
-    id->dead = true;
+    id->send_first = NULL;
+    id->send_last = &id->send_first;
     id->listen.fd = NULL;
 
     id->b_first_packet = true;
@@ -1126,12 +1159,19 @@ static void *Add( sout_stream_t *p_stream, const es_format_t *p_fmt, const char
         id->rtsp_id = RtspAddId( p_sys->rtsp, id, GetDWBE( id->ssrc ),
                                  id->rtp_fmt.clock_rate, mcast_fd );
 
-    id->dead = false;
-    if( vlc_clone( &id->thread, ThreadSend, id ) )
+    vlc_mutex_lock( &p_sys->send.lock );
+    if( !p_sys->send.running )
     {
-        id->dead = true;
-        goto error;
+        p_sys->send.running =
+            !vlc_clone( &p_sys->send.thread, ThreadSend, p_stream );
+        if( !p_sys->send.running )
+        {
+            vlc_mutex_unlock( &p_sys->send.lock );
+            goto error;
+        }
     }
+    TAB_APPEND( p_sys->send.idc, p_sys->send.idv, id );
+    vlc_mutex_unlock( &p_sys->send.lock );
 
     /* Update p_sys context */
     vlc_mutex_lock( &p_sys->lock_es );
@@ -1167,11 +1207,14 @@ static void Del( sout_stream_t *p_stream, void *_id )
     TAB_REMOVE( p_sys->i_es, p_sys->es, id );
     vlc_mutex_unlock( &p_sys->lock_es );
 
-    if (!id->dead)
-    {
-        vlc_queue_Kill(&id->queue, &id->dead);
-        vlc_join( id->thread, NULL );
-     }
+    /* Once removed, the scheduler does not send for this ES anymore */
+    vlc_mutex_lock( &p_sys->send.lock );
+    TAB_REMOVE( p_sys->send.idc, p_sys->send.idv, id );
+    while( p_sys->send.busy == id )
+        vlc_cond_wait( &p_sys->send.done, &p_sys->send.lock );
+    block_ChainRelease( id->send_first );
+    vlc_mutex_unlock( &p_sys->send.lock );
+
     free( id->rtp_fmt.fmtp );
 
     if( id->rtsp_id )
@@ -1339,10 +1382,6 @@ static int  HttpCallback( httpd_file_sys_t *p_args,
 /****************************************************************************
  * RTP send
  ****************************************************************************/
-static void* ThreadSend( void *data )
-{
-    vlc_thread_set_name("vlc-rt-send");
-
 #ifdef _WIN32
 # undef ENOBUFS
 # define ENOBUFS      WSAENOBUFS
@@ -1351,70 +1390,178 @@ static void* ThreadSend( void *data )
 # undef EWOULDBLOCK
 # define EWOULDBLOCK  WSAEWOULDBLOCK
 #endif
-    sout_stream_id_sys_t *id = data;
-    vlc_tick_t i_caching = id->i_caching;
-    block_t *out;
 
-    while ((out = vlc_queue_DequeueKillable(&id->queue, &id->dead)) != NULL)
+/* Packets due within this delay are sent together */
+#define RTP_SEND_SLACK VLC_TICK_FROM_MS(2)
+/* Maximum number of packets sent to a sink in one system call */
+#define RTP_SEND_BATCH 64
+
+static vlc_tick_t rtp_send_date( const sout_stream_id_sys_t *id,
+                                 const block_t *out )
+{
+    return out->i_dts + id->i_caching;
+}
+
+/**
+ * Sends packets to one sink.
+ * @return false if the connection is broken
+ */
+static bool rtp_sink_send( int fd, block_t *const *pktv, unsigned pktc )
+{
+    unsigned i = 0;
+
+    while( i < pktc )
     {
-#ifdef HAVE_SRTP
-        if( id->srtp )
-        {   /* FIXME: this is awfully inefficient */
-            size_t len = out->i_buffer;
-            out = block_Realloc( out, 0, len + 10 );
-            out->i_buffer = len;
-
-            int val = srtp_send( id->srtp, out->p_buffer, &len, len + 10 );
-            if( val )
-            {
-                msg_Dbg( id->p_stream, "SRTP sending error: %s",
-                         vlc_strerror_c(val) );
-                block_Release( out );
-                continue;
-            }
-            out->i_buffer = len;
+#ifdef HAVE_SENDMMSG
+        struct mmsghdr msgv[RTP_SEND_BATCH];
+        struct iovec iov[RTP_SEND_BATCH];
+        unsigned n = pktc - i;
+
+        for( unsigned j = 0; j < n; j++ )
+        {
+            iov[j].iov_base = pktv[i + j]->p_buffer;
+            iov[j].iov_len = pktv[i + j]->i_buffer;
+            msgv[j].msg_hdr = (struct msghdr) {
+                .msg_iov = &iov[j],
+                .msg_iovlen = 1,
+            };
         }
-#endif
-        vlc_tick_wait (out->i_dts + i_caching);
 
-        ssize_t len = out->i_buffer;
+        int val = sendmmsg( fd, msgv, n, 0 );
+        if( val > 0 )
+        {
+            i += val;
+            continue;
+        }
+#else
+        if( send( fd, pktv[i]->p_buffer, pktv[i]->i_buffer, 0 ) != -1 )
+        {
+            i++;
+            continue;
+        }
+#endif
+        if( net_errno != EAGAIN
+#if (EAGAIN != EWOULDBLOCK)
+         && net_errno != EWOULDBLOCK
+#endif
+         && net_errno != ENOBUFS && net_errno != ENOMEM )
+        {
+            int type;
+            getsockopt( fd, SOL_SOCKET, SO_TYPE,
+                        &type, &(socklen_t){ sizeof(type) });
+            if( type != SOCK_DGRAM )
+                return false; /* Broken connection */
+
+            /* ICMP soft error: ignore and retry */
+            send( fd, pktv[i]->p_buffer, pktv[i]->i_buffer, 0 );
+        }
+        i++; /* The packet is lost */
+    }
+    return true;
+}
 
-        vlc_mutex_lock( &id->lock_sink );
-        unsigned deadc = 0; /* How many dead sockets? */
-        int deadv[id->sinkc ? id->sinkc : 1]; /* Dead sockets list */
+/** Sends a batch of packets of an ES to all its sinks */
+static void rtp_send_packets( sout_stream_id_sys_t *id,
+                              block_t *const *pktv, unsigned pktc )
+{
+    vlc_mutex_lock( &id->lock_sink );
+    unsigned deadc = 0; /* How many dead sockets? */
+    int deadv[id->sinkc ? id->sinkc : 1]; /* Dead sockets list */
 
-        for( int i = 0; i < id->sinkc; i++ )
-        {
+    for( int i = 0; i < id->sinkc; i++ )
+    {
 #ifdef HAVE_SRTP
-            if( !id->srtp ) /* FIXME: SRTCP support */
+        if( !id->srtp ) /* FIXME: SRTCP support */
 #endif
-                SendRTCP( id->sinkv[i].rtcp, out );
+            for( unsigned j = 0; j < pktc; j++ )
+                SendRTCP( id->sinkv[i].rtcp, pktv[j] );
+
+        if( !rtp_sink_send( id->sinkv[i].rtp_fd, pktv, pktc ) )
+            deadv[deadc++] = id->sinkv[i].rtp_fd;
+    }
+    id->i_seq_sent_next = ntohs(((uint16_t *) pktv[pktc - 1]->p_buffer)[1]) + 1;
+    vlc_mutex_unlock( &id->lock_sink );
+
+    for( unsigned i = 0; i < deadc; i++ )
+    {
+        msg_Dbg( id->p_stream, "removing socket %d", deadv[i] );
+        rtp_del_sink( id, deadv[i] );
+    }
+}
+
+/* This thread paces the packets of all the ES, instead of one thread
+ * sleeping before each packet of every ES. */
+static void *ThreadSend( void *data )
+{
+    vlc_thread_set_name("vlc-rtp-send");
+
+    sout_stream_t *p_stream = data;
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    /* Where to resume, so that a busy ES does not starve the next ones */
+    int first = 0;
 
-            if( send( id->sinkv[i].rtp_fd, out->p_buffer, len, 0 ) == -1
-             && net_errno != EAGAIN && net_errno != EWOULDBLOCK
-             && net_errno != ENOBUFS && net_errno != ENOMEM )
+    vlc_mutex_lock( &p_sys->send.lock );
+    while( !p_sys->send.closing )
+    {
+        vlc_tick_t now = vlc_tick_now();
+        vlc_tick_t deadline = VLC_TICK_MAX;
+        bool sent = false;
+
+        for( int n = 0; n < p_sys->send.idc && !sent; n++ )
+        {
+            int i = (first + n) % p_sys->send.idc;
+            sout_stream_id_sys_t *id = p_sys->send.idv[i];
+            block_t *pktv[RTP_SEND_BATCH];
+            unsigned pktc = 0;
+
+            /* Packets of an ES are queued in sending order */
+            while( id->send_first != NULL && pktc < RTP_SEND_BATCH
+                && rtp_send_date( id, id->send_first ) <= now + RTP_SEND_SLACK )
             {
-                int type;
-                getsockopt( id->sinkv[i].rtp_fd, SOL_SOCKET, SO_TYPE,
-                            &type, &(socklen_t){ sizeof(type) });
-                if( type == SOCK_DGRAM )
-                    /* ICMP soft error: ignore and retry */
-                    send( id->sinkv[i].rtp_fd, out->p_buffer, len, 0 );
-                else
-                    /* Broken connection */
-                    deadv[deadc++] = id->sinkv[i].rtp_fd;
+                block_t *out = id->send_first;
+
+                id->send_first = out->p_next;
+                out->p_next = NULL;
+                pktv[pktc++] = out;
             }
-        }
-        id->i_seq_sent_next = ntohs(((uint16_t *) out->p_buffer)[1]) + 1;
-        vlc_mutex_unlock( &id->lock_sink );
-        block_Release( out );
+            if( id->send_first == NULL )
+                id->send_last = &id->send_first;
 
-        for( unsigned i = 0; i < deadc; i++ )
-        {
-            msg_Dbg( id->p_stream, "removing socket %d", deadv[i] );
-            rtp_del_sink( id, deadv[i] );
+            if( pktc > 0 )
+            {
+                /* Do not block the packetizers during socket I/O. The ES
+                 * list may change meanwhile, so scan again afterwards. */
+                p_sys->send.busy = id;
+                vlc_mutex_unlock( &p_sys->send.lock );
+
+                rtp_send_packets( id, pktv, pktc );
+                for( unsigned j = 0; j < pktc; j++ )
+                    block_Release( pktv[j] );
+
+                vlc_mutex_lock( &p_sys->send.lock );
+                p_sys->send.busy = NULL;
+                vlc_cond_broadcast( &p_sys->send.done );
+                first = i + 1;
+                sent = true;
+            }
+            else if( id->send_first != NULL )
+            {
+                vlc_tick_t date = rtp_send_date( id, id->send_first );
+                if( date < deadline )
+                    deadline = date;
+            }
         }
+
+        if( sent )
+            continue;
+        if( deadline == VLC_TICK_MAX )
+            vlc_cond_wait( &p_sys->send.wait, &p_sys->send.lock );
+        else if( deadline > now + RTP_SEND_SLACK )
+            vlc_cond_timedwait( &p_sys->send.wait, &p_sys->send.lock,
+                                deadline );
     }
+    vlc_mutex_unlock( &p_sys->send.lock );
     return NULL;
 }
 
@@ -1576,7 +1723,35 @@ uint16_t rtp_get_extended_sequence( sout_stream_id_sys_t *id )
 
 void rtp_packetize_send( sout_stream_id_sys_t *id, block_t *out )
 {
-    vlc_queue_Enqueue(&id->queue, out);
+    sout_stream_sys_t *p_sys = id->p_stream->p_sys;
+
+#ifdef HAVE_SRTP
+    /* Keys are per ES: packets are encrypted once for all the sinks */
+    if( id->srtp )
+    {   /* FIXME: this is awfully inefficient */
+        size_t len = out->i_buffer;
+        out = block_Realloc( out, 0, len + 10 );
+        out->i_buffer = len;
+
+        int val = srtp_send( id->srtp, out->p_buffer, &len, len + 10 );
+        if( val )
+        {
+            msg_Dbg( id->p_stream, "SRTP sending error: %s",
+                     vlc_strerror_c(val) );
+            block_Release( out );
+            return;
+        }
+        out->i_buffer = len;
+    }
+#endif
+
+    vlc_mutex_lock( &p_sys->send.lock );
+    /* The scheduler only needs to wake up early for the first packet */
+    if( id->send_first == NULL )
+        vlc_cond_signal( &p_sys->send.wait );
+    *id->send_last = out;
+    id->send_last = &out->p_next;
+    vlc_mutex_unlock( &p_sys->send.lock );
 }
 
 /**
@@ -51,24 +51,111 @@ static const int pi_channels_maps[] =
 };
 
 
+static block_t *audio_in_Pop( transcode_encoder_t *p_enc )
+{
+    block_t *p_block = p_enc->p_audio_in;
+    if( p_block != NULL )
+    {
+        p_enc->p_audio_in = p_block->p_next;
+        if( p_enc->p_audio_in == NULL )
+            p_enc->pp_audio_in_last = &p_enc->p_audio_in;
+        p_block->p_next = NULL;
+    }
+    return p_block;
+}
+
+static void* AudioEncoderThread( void *obj )
+{
+    vlc_thread_set_name("vlc-aencoder");
+
+    transcode_encoder_t *p_enc = obj;
+    block_t *p_in = NULL;
+    int canc = vlc_savecancel ();
+    block_t *p_block = NULL;
+
+    vlc_mutex_lock( &p_enc->lock_out );
+
+    for( ;; )
+    {
+        while( !p_enc->b_abort &&
+               (p_in = audio_in_Pop( p_enc )) == NULL )
+            vlc_cond_wait( &p_enc->cond, &p_enc->lock_out );
+
+        if( p_in )
+        {
+            vlc_sem_post( &p_enc->pool_has_room );
+
+            /* release lock while encoding */
+            vlc_mutex_unlock( &p_enc->lock_out );
+            p_block = vlc_encoder_EncodeAudio( p_enc->p_encoder, p_in );
+            block_Release( p_in );
+            vlc_mutex_lock( &p_enc->lock_out );
+
+            block_ChainAppend( &p_enc->p_buffers, p_block );
+        }
+
+        if( p_enc->b_abort )
+            break;
+    }
+
+    /*Encode what we have in the buffer on closing*/
+    while( (p_in = audio_in_Pop( p_enc )) != NULL )
+    {
+        vlc_sem_post( &p_enc->pool_has_room );
+        p_block = vlc_encoder_EncodeAudio( p_enc->p_encoder, p_in );
+        block_Release( p_in );
+        block_ChainAppend( &p_enc->p_buffers, p_block );
+    }
+
+    /*Now flush encoder*/
+    do {
+        p_block = vlc_encoder_EncodeAudio( p_enc->p_encoder, NULL );
+        block_ChainAppend( &p_enc->p_buffers, p_block );
+    } while( p_block );
+
+    vlc_mutex_unlock( &p_enc->lock_out );
+
+    vlc_restorecancel (canc);
+
+    return NULL;
+}
+
 int transcode_encoder_audio_open( transcode_encoder_t *p_enc,
                                   const transcode_encoder_config_t *p_cfg )
 {
+    p_enc->p_encoder->i_threads = p_cfg->audio.threads.i_count;
     p_enc->p_encoder->p_cfg = p_cfg->p_config_chain;
     p_enc->p_encoder->fmt_out.i_codec = p_cfg->i_codec;
     p_enc->p_encoder->ops = NULL;
 
     p_enc->p_encoder->p_module = module_need( p_enc->p_encoder, "audio encoder",
                                               p_cfg->psz_name, true );
+    if( !p_enc->p_encoder->p_module )
+        return VLC_EGENERIC;
+
+    assert( p_enc->p_encoder->ops != NULL );
+    p_enc->p_encoder->fmt_out.i_codec =
+            vlc_fourcc_GetCodec( AUDIO_ES, p_enc->p_encoder->fmt_out.i_codec );
+
+    vlc_sem_init( &p_enc->pool_has_room, p_cfg->audio.threads.pool_size );
+    vlc_cond_init( &p_enc->cond );
+    p_enc->p_buffers = NULL;
+    p_enc->b_abort = false;
 
-    if( p_enc->p_encoder->p_module )
+    if( p_cfg->audio.threads.i_count > 0 )
     {
-        assert( p_enc->p_encoder->ops != NULL );
-        p_enc->p_encoder->fmt_out.i_codec =
-                vlc_fourcc_GetCodec( AUDIO_ES, p_enc->p_encoder->fmt_out.i_codec );
+        if( vlc_clone( &p_enc->thread, AudioEncoderThread, p_enc ) )
+        {
+            if (p_enc->p_encoder->ops->close)
+                p_enc->p_encoder->ops->close(p_enc->p_encoder);
+            module_unneed( p_enc->p_encoder, p_enc->p_encoder->p_module );
+            p_enc->p_encoder->p_module = NULL;
+            return VLC_EGENERIC;
+        }
+        p_enc->b_threaded = true;
     }
 
-    return ( p_enc->p_encoder->p_module ) ? VLC_SUCCESS: VLC_EGENERIC;
+    return VLC_SUCCESS;
 }
 
 static int encoder_audio_configure( const transcode_encoder_config_t *p_cfg,
@@ -190,15 +277,52 @@ int transcode_encoder_audio_test( encoder_t *p_encoder,
 
 block_t * transcode_encoder_audio_encode( transcode_encoder_t *p_enc, block_t *p_block )
 {
-    return vlc_encoder_EncodeAudio( p_enc->p_encoder, p_block );
+    if( !p_enc->b_threaded )
+        return vlc_encoder_EncodeAudio( p_enc->p_encoder, p_block );
+
+    /* The caller keeps its reference, hand a shared one to the thread */
+    block_t *p_in = block_Share( p_block );
+    if( unlikely(p_in == NULL) )
+        return NULL;
+
+    vlc_sem_wait( &p_enc->pool_has_room );
+    vlc_mutex_lock( &p_enc->lock_out );
+    *p_enc->pp_audio_in_last = p_in;
+    p_enc->pp_audio_in_last = &p_in->p_next;
+    vlc_cond_signal( &p_enc->cond );
+    /* Hand back what the thread encoded so far */
+    block_t *p_blocks = p_enc->p_buffers;
+    p_enc->p_buffers = NULL;
+    vlc_mutex_unlock( &p_enc->lock_out );
+    return p_blocks;
+}
+
+void transcode_encoder_audio_stop( transcode_encoder_t *p_enc )
+{
+    if( p_enc->b_threaded && !p_enc->b_abort )
+    {
+        vlc_mutex_lock( &p_enc->lock_out );
+        p_enc->b_abort = true;
+        vlc_cond_signal( &p_enc->cond );
+        vlc_mutex_unlock( &p_enc->lock_out );
+        vlc_join( p_enc->thread, NULL );
+    }
 }
 
 int transcode_encoder_audio_drain( transcode_encoder_t *p_enc, block_t **out )
 {
-    block_t *p_block;
-    do {
-        p_block = transcode_encoder_audio_encode( p_enc, NULL );
-        block_ChainAppend( out, p_block );
-    } while( p_block );
+    if( !p_enc->b_threaded )
+    {
+        block_t *p_block;
+        do {
+            p_block = transcode_encoder_audio_encode( p_enc, NULL );
+            block_ChainAppend( out, p_block );
+        } while( p_block );
+    }
+    else
+    {
+        transcode_encoder_audio_stop( p_enc );
+        block_ChainAppend( out, transcode_encoder_get_output_async( p_enc ) );
+    }
     return VLC_SUCCESS;
 }
@@ -54,6 +54,11 @@ void transcode_encoder_delete( transcode_encoder_t *p_enc )
 
             picture_fifo_Delete( p_enc->pp_pics );
         }
+        else if( p_enc->p_encoder->fmt_in.i_cat == AUDIO_ES )
+        {
+            transcode_encoder_audio_stop( p_enc );
+            block_ChainRelease( p_enc->p_buffers );
+        }
 
         vlc_encoder_Destroy( p_enc->p_encoder );
     }
@@ -109,6 +114,11 @@ transcode_encoder_t * transcode_encoder_new( encoder_t *p_encoder,
             }
             vlc_mutex_init( &p_enc->lock_out );
             break;
+        case AUDIO_ES:
+            p_enc->p_audio_in = NULL;
+            p_enc->pp_audio_in_last = &p_enc->p_audio_in;
+            vlc_mutex_init( &p_enc->lock_out );
+            break;
         default:
             break;
     }
@@ -187,6 +197,8 @@ void transcode_encoder_close( transcode_encoder_t *p_enc )
 
     if( p_enc->p_encoder->fmt_in.i_cat == VIDEO_ES )
         transcode_encoder_video_stop( p_enc );
+    else if( p_enc->p_encoder->fmt_in.i_cat == AUDIO_ES )
+        transcode_encoder_audio_stop( p_enc );
 
     if( p_enc->p_encoder->ops != NULL && p_enc->p_encoder->ops->close != NULL )
     {
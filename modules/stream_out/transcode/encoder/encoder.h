@@ -50,6 +50,11 @@ typedef struct
             unsigned int    i_bitrate;
             uint32_t        i_sample_rate;
             uint32_t        i_channels;
+            struct
+            {
+                unsigned int i_count;
+                uint32_t     pool_size;
+            } threads;
         } audio;
         struct
         {
@@ -25,7 +25,9 @@ struct transcode_encoder_t
     vlc_mutex_t     lock_out;
     bool            b_abort;
     picture_fifo_t *pp_pics;
-    vlc_sem_t       picture_pool_has_room;
+    block_t         *p_audio_in;    /* audio blocks waiting for the thread */
+    block_t        **pp_audio_in_last;
+    vlc_sem_t       pool_has_room;  /* bounds the queued pictures/blocks */
     vlc_cond_t      cond;
 
     /* output buffers */
@@ -41,6 +43,7 @@ int transcode_encoder_spu_open( transcode_encoder_t *p_enc,
                                 const transcode_encoder_config_t *p_cfg );
 
 void transcode_encoder_video_stop( transcode_encoder_t *p_enc );
+void transcode_encoder_audio_stop( transcode_encoder_t *p_enc );
 
 block_t * transcode_encoder_video_encode( transcode_encoder_t *p_enc, picture_t *p_pic );
 block_t * transcode_encoder_audio_encode( transcode_encoder_t *p_enc, block_t *p_block );
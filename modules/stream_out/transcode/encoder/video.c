@@ -316,7 +316,7 @@ static void* EncoderThread( void *obj )
         while( !p_enc->b_abort &&
                (p_pic = picture_fifo_LockPop( p_enc->pp_pics )) == NULL )
             vlc_cond_wait( &p_enc->cond, &p_enc->lock_out );
-        vlc_sem_post( &p_enc->picture_pool_has_room );
+        vlc_sem_post( &p_enc->pool_has_room );
 
         if( p_pic )
         {
@@ -336,7 +336,7 @@ static void* EncoderThread( void *obj )
     /*Encode what we have in the buffer on closing*/
     while( (p_pic = picture_fifo_LockPop( p_enc->pp_pics )) != NULL )
     {
-        vlc_sem_post( &p_enc->picture_pool_has_room );
+        vlc_sem_post( &p_enc->pool_has_room );
         p_block = vlc_encoder_EncodeVideo( p_enc->p_encoder, p_pic );
         picture_Release( p_pic );
         block_ChainAppend( &p_enc->p_buffers, p_block );
@@ -412,7 +412,7 @@ int transcode_encoder_video_open( transcode_encoder_t *p_enc,
     p_enc->p_encoder->fmt_out.i_codec =
         vlc_fourcc_GetCodec( VIDEO_ES, p_enc->p_encoder->fmt_out.i_codec );
 
-    vlc_sem_init( &p_enc->picture_pool_has_room, p_cfg->video.threads.pool_size );
+    vlc_sem_init( &p_enc->pool_has_room, p_cfg->video.threads.pool_size );
     vlc_cond_init( &p_enc->cond );
     p_enc->p_buffers = NULL;
     p_enc->b_abort = false;
@@ -440,13 +440,16 @@ block_t * transcode_encoder_video_encode( transcode_encoder_t *p_enc, picture_t
         return vlc_encoder_EncodeVideo( p_enc->p_encoder, p_pic );
     }
 
-    vlc_sem_wait( &p_enc->picture_pool_has_room );
+    vlc_sem_wait( &p_enc->pool_has_room );
     vlc_mutex_lock( &p_enc->lock_out );
     picture_Hold( p_pic );
     picture_fifo_Lock( p_enc->pp_pics );
     picture_fifo_Push( p_enc->pp_pics, p_pic );
     picture_fifo_Unlock( p_enc->pp_pics );
     vlc_cond_signal( &p_enc->cond );
+    /* Hand back what the thread encoded so far */
+    block_t *p_blocks = p_enc->p_buffers;
+    p_enc->p_buffers = NULL;
     vlc_mutex_unlock( &p_enc->lock_out );
-    return NULL;
+    return p_blocks;
 }
@@ -32,6 +32,7 @@
 #endif
 
 #include <vlc_common.h>
+#include <vlc_charset.h>
 #include <vlc_configuration.h>
 #include <vlc_plugin.h>
 #include <vlc_sout.h>
@@ -80,6 +81,12 @@
 #define VFILTER_LONGTEXT N_( \
     "Video filters will be applied to the video streams (after overlays " \
     "are applied). You can enter a colon-separated list of filters." )
+#define RENDITION_TEXT N_("Video rendition")
+#define RENDITION_LONGTEXT N_( \
+    "Additional video output encoded from the same decoded pictures, " \
+    "eg: {width=640,vb=800}. Accepts width, height, maxwidth, maxheight, " \
+    "scale, vb and venc. Sizes are relative to the main video output, " \
+    "which should be the largest one. Can be repeated." )
 
 #define AENC_TEXT N_("Audio encoder")
 #define AENC_LONGTEXT N_( \
@@ -125,6 +132,10 @@
 #define THREADS_TEXT N_("Number of threads")
 #define THREADS_LONGTEXT N_( \
     "Number of threads used for the transcoding." )
+#define ATHREADS_TEXT N_("Number of audio encoder threads")
+#define ATHREADS_LONGTEXT N_( \
+    "Runs each audio encoder on its own thread, overlapping with the " \
+    "decoding and filtering of the following frames (0 encodes inline)." )
 #define HP_TEXT N_("High priority")
 #define HP_LONGTEXT N_( \
     "Runs the optional encoder thread at the OUTPUT priority instead of " \
@@ -186,6 +197,8 @@ vlc_module_begin ()
                  MAXHEIGHT_LONGTEXT )
     add_module_list(SOUT_CFG_PREFIX "vfilter", "video filter", NULL,
                     VFILTER_TEXT, VFILTER_LONGTEXT)
+    add_string( SOUT_CFG_PREFIX "rendition", NULL, RENDITION_TEXT,
+                RENDITION_LONGTEXT )
 
     set_section( N_("Audio"), NULL )
     add_module(SOUT_CFG_PREFIX "aenc", "audio encoder", "none",
@@ -218,6 +231,9 @@ vlc_module_begin ()
     add_integer( SOUT_CFG_PREFIX "threads", 0, THREADS_TEXT,
                  THREADS_LONGTEXT )
         change_integer_range( 0, 32 )
+    add_integer( SOUT_CFG_PREFIX "athreads", 0, ATHREADS_TEXT,
+                 ATHREADS_LONGTEXT )
+        change_integer_range( 0, 32 )
     add_integer( SOUT_CFG_PREFIX "pool-size", 10, POOL_TEXT, POOL_LONGTEXT )
         change_integer_range( 1, 1000 )
     add_obsolete_bool( SOUT_CFG_PREFIX "high-priority" ) // Since 4.0.0
@@ -232,7 +248,7 @@ static const char *const ppsz_sout_options[] = {
     "deinterlace-module", "threads", "aenc", "acodec", "ab", "alang",
     "afilter", "samplerate", "channels", "senc", "scodec", "soverlay",
     "sfilter", "high-priority", "maxwidth", "maxheight", "pool-size",
-    "forward-pcr", NULL
+    "forward-pcr", "rendition", "athreads", NULL
 };
 
 /*****************************************************************************
@@ -272,6 +288,9 @@ static void SetAudioEncoderConfig( sout_stream_t *p_stream, transcode_encoder_co
     p_cfg->audio.i_sample_rate = var_GetInteger( p_stream, SOUT_CFG_PREFIX "samplerate" );
     p_cfg->audio.i_channels = var_GetInteger( p_stream, SOUT_CFG_PREFIX "channels" );
 
+    p_cfg->audio.threads.i_count = var_GetInteger( p_stream, SOUT_CFG_PREFIX "athreads" );
+    p_cfg->audio.threads.pool_size = var_GetInteger( p_stream, SOUT_CFG_PREFIX "pool-size" );
+
     if( p_cfg->i_codec )
     {
         if( ( p_cfg->i_codec == VLC_CODEC_MP3 ||
@@ -332,6 +351,101 @@ static void SetVideoEncoderConfig( sout_stream_t *p_stream, transcode_encoder_co
     p_cfg->video.threads.pool_size = var_GetInteger( p_stream, SOUT_CFG_PREFIX "pool-size" );
 }
 
+static void SetVideoRenditionConfig( sout_stream_t *p_stream,
+                                     const transcode_encoder_config_t *p_main,
+                                     transcode_encoder_config_t *p_cfg,
+                                     const char *psz_options )
+{
+    /* Same codec, encoder, frame rate and GOP settings as the main output so
+     * that every rendition gets its key frames on the same pictures */
+    p_cfg->i_codec = p_main->i_codec;
+    p_cfg->video = p_main->video;
+    p_cfg->video.f_scale = 0;
+    p_cfg->video.i_width = p_cfg->video.i_maxwidth = 0;
+    p_cfg->video.i_height = p_cfg->video.i_maxheight = 0;
+    if( p_main->psz_name )
+    {
+        p_cfg->psz_name = strdup( p_main->psz_name );
+        p_cfg->p_config_chain = config_ChainDuplicate( p_main->p_config_chain );
+    }
+    if( p_main->psz_lang )
+        p_cfg->psz_lang = strdup( p_main->psz_lang );
+
+    char *psz_chain, *psz_name;
+    config_chain_t *p_options = NULL;
+    if( asprintf( &psz_chain, "rendition{%s}", psz_options ) == -1 )
+        return;
+    free( config_ChainCreate( &psz_name, &p_options, psz_chain ) );
+    free( psz_name );
+    free( psz_chain );
+
+    for( const config_chain_t *p = p_options; p != NULL; p = p->p_next )
+    {
+        if( p->psz_value == NULL )
+            continue;
+
+        if( !strcmp( p->psz_name, "width" ) )
+            p_cfg->video.i_width = atoi( p->psz_value );
+        else if( !strcmp( p->psz_name, "height" ) )
+            p_cfg->video.i_height = atoi( p->psz_value );
+        else if( !strcmp( p->psz_name, "maxwidth" ) )
+            p_cfg->video.i_maxwidth = atoi( p->psz_value );
+        else if( !strcmp( p->psz_name, "maxheight" ) )
+            p_cfg->video.i_maxheight = atoi( p->psz_value );
+        else if( !strcmp( p->psz_name, "scale" ) )
+            p_cfg->video.f_scale = vlc_atof_c( p->psz_value );
+        else if( !strcmp( p->psz_name, "vb" ) )
+        {
+            p_cfg->video.i_bitrate = atoi( p->psz_value );
+            if( p_cfg->video.i_bitrate < 16000 )
+                p_cfg->video.i_bitrate *= 1000;
+        }
+        else if( !strcmp( p->psz_name, "venc" ) )
+        {
+            free( p_cfg->psz_name );
+            config_ChainDestroy( p_cfg->p_config_chain );
+            free( config_ChainCreate( &p_cfg->psz_name,
+                                      &p_cfg->p_config_chain, p->psz_value ) );
+        }
+        else
+            msg_Warn( p_stream, "unknown rendition option `%s'", p->psz_name );
+    }
+    config_ChainDestroy( p_options );
+
+    msg_Dbg( p_stream, "rendition %dx%d scaling: %f %dkb/s",
+             p_cfg->video.i_width, p_cfg->video.i_height,
+             p_cfg->video.f_scale, p_cfg->video.i_bitrate / 1000 );
+}
+
+static void SetVideoRenditionsConfig( sout_stream_t *p_stream,
+                                      sout_stream_sys_t *p_sys )
+{
+    /* The option can be repeated, so walk the chain rather than the
+     * variable which only holds the last value */
+    size_t i_count = 0;
+    for( const config_chain_t *p = p_stream->p_cfg; p != NULL; p = p->p_next )
+        if( !strcmp( p->psz_name, "rendition" ) && p->psz_value )
+            i_count++;
+
+    if( i_count == 0 || !p_sys->venc_cfg.i_codec )
+        return;
+
+    p_sys->renditions_cfg = vlc_alloc( i_count, sizeof(*p_sys->renditions_cfg) );
+    if( unlikely(p_sys->renditions_cfg == NULL) )
+        return;
+
+    for( const config_chain_t *p = p_stream->p_cfg; p != NULL; p = p->p_next )
+    {
+        if( strcmp( p->psz_name, "rendition" ) || !p->psz_value )
+            continue;
+
+        transcode_encoder_config_t *p_cfg =
+            &p_sys->renditions_cfg[p_sys->i_renditions++];
+        transcode_encoder_config_init( p_cfg );
+        SetVideoRenditionConfig( p_stream, &p_sys->venc_cfg, p_cfg, p->psz_value );
+    }
+}
+
 static void SetSPUEncoderConfig( sout_stream_t *p_stream, transcode_encoder_config_t *p_cfg )
 {
     char *psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "senc" );
@@ -460,6 +574,8 @@ static int Open( vlc_object_t *p_this )
                  p_sys->venc_cfg.video.i_bitrate / 1000 );
     }
 
+    SetVideoRenditionsConfig( p_stream, p_sys );
+
     /* Video Filter Parameters */
     sout_filters_config_init( &p_sys->vfilters_cfg );
 
@@ -516,6 +632,9 @@ static void Close( sout_stream_t *p_stream )
     sout_stream_sys_t   *p_sys = p_stream->p_sys;
 
     transcode_encoder_config_clean( &p_sys->venc_cfg );
+    for( size_t i = 0; i < p_sys->i_renditions; i++ )
+        transcode_encoder_config_clean( &p_sys->renditions_cfg[i] );
+    free( p_sys->renditions_cfg );
     sout_filters_config_clean( &p_sys->vfilters_cfg );
 
     transcode_encoder_config_clean( &p_sys->aenc_cfg );
@@ -754,6 +873,10 @@ static void Del( sout_stream_t *p_stream, void *_id )
             if(!id->b_error)
                 Send( p_stream, id, NULL );
             dec_Delete( id->p_decoder );
+            for( size_t i = 0; i < id->i_renditions; i++ )
+                if( id->renditions[i].downstream_id )
+                    sout_StreamIdDel( p_stream->p_next,
+                                      id->renditions[i].downstream_id );
             vlc_mutex_lock( &p_sys->lock );
             if( id == p_sys->id_video )
                 p_sys->id_video = NULL;
@@ -779,6 +902,38 @@ static void Del( sout_stream_t *p_stream, void *_id )
     DeleteSoutStreamID( id );
 }
 
+static void SendRenditions( sout_stream_t *p_stream, sout_stream_id_sys_t *id )
+{
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->renditions[i];
+
+        vlc_fifo_Lock( id->output_fifo );
+        block_t *p_out = r->p_out;
+        r->p_out = NULL;
+        vlc_fifo_Unlock( id->output_fifo );
+
+        if( r->downstream_id == NULL )
+        {
+            block_ChainRelease( p_out );
+            continue;
+        }
+
+        for( block_t *it = p_out; it != NULL; )
+        {
+            block_t *next = it->p_next;
+            it->p_next = NULL;
+
+            if( sout_StreamIdSend( p_stream->p_next, r->downstream_id, it ) != VLC_SUCCESS )
+            {
+                block_ChainRelease( next );
+                break;
+            }
+            it = next;
+        }
+    }
+}
+
 static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
 {
     sout_stream_id_sys_t *id = (sout_stream_id_sys_t *)_id;
@@ -810,6 +965,14 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
         }
     }
 
+    /* Decoders may modify their input in place */
+    if( p_buffer != NULL )
+    {
+        p_buffer = block_Writable( p_buffer );
+        if( unlikely(p_buffer == NULL) )
+            return VLC_ENOMEM;
+    }
+
     int i_ret;
     switch( id->p_decoder->fmt_in->i_cat )
     {
@@ -862,6 +1025,9 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
         it = next;
     }
 
+    if( id->p_decoder->fmt_in->i_cat == VIDEO_ES )
+        SendRenditions( p_stream, id );
+
     if (i_ret != VLC_SUCCESS)
         id->b_error = true;
 
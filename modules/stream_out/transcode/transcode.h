@@ -43,6 +43,17 @@ void sout_filters_config_clean( sout_filters_config_t *p_cfg )
 
 typedef struct sout_stream_id_sys_t sout_stream_id_sys_t;
 
+/* Extra video output encoded from the pictures of the main video encoder */
+typedef struct
+{
+    const transcode_encoder_config_t *p_enccfg;
+    transcode_encoder_t *encoder;
+    filter_chain_t      *p_conv; /**< scaler from the main encoder input */
+    void                *downstream_id;
+    char                *psz_es_id;
+    block_t             *p_out; /**< encoded blocks, protected by output_fifo */
+} transcode_rendition_t;
+
 typedef struct
 {
     bool                  b_soverlay;
@@ -54,6 +65,8 @@ typedef struct
     /* Video */
     transcode_encoder_config_t venc_cfg;
     sout_filters_config_t vfilters_cfg;
+    transcode_encoder_config_t *renditions_cfg;
+    size_t                     i_renditions;
 
     /* SPU */
     transcode_encoder_config_t senc_cfg;
@@ -134,6 +147,8 @@ struct sout_stream_id_sys_t
              spu_t           *p_spu;
              vlc_decoder_device *dec_dev;
              vlc_video_context *enc_vctx_in;
+             transcode_rendition_t *renditions;
+             size_t           i_renditions;
          };
          struct
          {
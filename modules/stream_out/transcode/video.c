@@ -114,6 +114,68 @@ static int transcode_video_filters_init( sout_stream_t *p_stream,
                                          const es_format_t *p_dst,
                                          sout_stream_id_sys_t *id );
 
+static void transcode_video_rendition_close( transcode_rendition_t *r )
+{
+    transcode_remove_filters( &r->p_conv );
+    if( r->encoder )
+    {
+        transcode_encoder_delete( r->encoder );
+        r->encoder = NULL;
+    }
+}
+
+static int transcode_video_rendition_open( sout_stream_t *p_stream,
+                                           sout_stream_id_sys_t *id,
+                                           transcode_rendition_t *r,
+                                           const es_format_t *p_src,
+                                           vlc_video_context *vctx )
+{
+    if( r->encoder == NULL )
+    {
+        struct encoder_owner *p_enc_owner =
+           (struct encoder_owner *)sout_EncoderCreate( VLC_OBJECT(p_stream), sizeof(struct encoder_owner) );
+        if( unlikely(p_enc_owner == NULL) )
+            return VLC_ENOMEM;
+
+        r->encoder = transcode_encoder_new( &p_enc_owner->enc, p_src );
+        if( !r->encoder )
+            return VLC_ENOMEM;
+
+        p_enc_owner->id = id;
+        p_enc_owner->enc.cbs = &encoder_video_transcode_cbs;
+
+        transcode_encoder_video_configure( VLC_OBJECT(p_stream),
+                   &id->p_decoder->fmt_out.video,
+                   r->p_enccfg,
+                   &p_src->video,
+                   vctx,
+                   r->encoder );
+
+        if( transcode_encoder_open( r->encoder, r->p_enccfg ) != VLC_SUCCESS )
+            return VLC_EGENERIC;
+    }
+
+    /* Scale down from the main encoder input */
+    const es_format_t *encoder_fmt = transcode_encoder_format_in( r->encoder );
+
+    transcode_remove_filters( &r->p_conv );
+    if( !video_format_IsSimilar( &encoder_fmt->video, &p_src->video ) )
+    {
+        filter_owner_t chain_owner = {
+           .video = &transcode_filter_video_cbs,
+           .sys = id,
+        };
+
+        r->p_conv = filter_chain_NewVideo( p_stream, false, &chain_owner );
+        if( !r->p_conv )
+            return VLC_ENOMEM;
+        filter_chain_Reset( r->p_conv, p_src, vctx, encoder_fmt );
+        if( filter_chain_AppendConverter( r->p_conv, NULL ) != VLC_SUCCESS )
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
 static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vctx )
 {
     struct decoder_owner *p_owner = dec_get_owner( p_dec );
@@ -217,6 +279,24 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
          if( filter_chain_AppendConverter( id->p_final_conv_static, NULL ) != VLC_SUCCESS )
              goto error;
     }
+
+    if( id->p_final_conv_static )
+        enc_vctx = filter_chain_GetVideoCtxOut( id->p_final_conv_static );
+
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->renditions[i];
+        if( r->p_enccfg == NULL )
+            continue;
+
+        if( transcode_video_rendition_open( p_owner->p_stream, id, r,
+                                            encoder_fmt, enc_vctx ) != VLC_SUCCESS )
+        {
+            msg_Err( p_dec, "cannot set up rendition %zu, dropping it", i );
+            transcode_video_rendition_close( r );
+            r->p_enccfg = NULL;
+        }
+    }
     vlc_mutex_unlock(&id->fifo.lock);
 
     if( !id->downstream_id )
@@ -225,6 +305,24 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
                                              id->p_decoder->fmt_in,
                                              transcode_encoder_format_out( id->encoder ),
                                              id->es_id );
+
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->renditions[i];
+        if( r->encoder == NULL || r->downstream_id )
+            continue;
+
+        if( asprintf( &r->psz_es_id, "%s/rendition-%zu", id->es_id, i ) == -1 )
+        {
+            r->psz_es_id = NULL;
+            continue;
+        }
+        r->downstream_id =
+            id->pf_transcode_downstream_add( p_owner->p_stream,
+                                             id->p_decoder->fmt_in,
+                                             transcode_encoder_format_out( r->encoder ),
+                                             r->psz_es_id );
+    }
     msg_Info( p_dec, "video format update succeed" );
 
 end:
@@ -321,6 +419,20 @@ int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
         es_format_Copy( &id->decoder_out, &id->p_decoder->fmt_out );
     }
 
+    /* Renditions share the decoder and filters, their encoders are created
+     * along with the main one */
+    const sout_stream_sys_t *p_sys = p_stream->p_sys;
+    if( p_sys->i_renditions > 0 )
+    {
+        id->renditions = calloc( p_sys->i_renditions, sizeof(*id->renditions) );
+        if( id->renditions != NULL )
+        {
+            id->i_renditions = p_sys->i_renditions;
+            for( size_t i = 0; i < id->i_renditions; i++ )
+                id->renditions[i].p_enccfg = &p_sys->renditions_cfg[i];
+        }
+    }
+
     return VLC_SUCCESS;
 }
 
@@ -401,6 +513,9 @@ void transcode_video_flush( sout_stream_id_sys_t *id )
         filter_chain_VideoFlush( id->p_uf_chain );
     if ( id->p_final_conv_static != NULL )
         filter_chain_VideoFlush( id->p_final_conv_static );
+    for( size_t i = 0; i < id->i_renditions; i++ )
+        if( id->renditions[i].p_conv != NULL )
+            filter_chain_VideoFlush( id->renditions[i].p_conv );
 }
 
 void transcode_video_clean( sout_stream_id_sys_t *id )
@@ -409,6 +524,15 @@ void transcode_video_clean( sout_stream_id_sys_t *id )
     if ( id->encoder )
         transcode_encoder_delete( id->encoder );
 
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->renditions[i];
+        transcode_video_rendition_close( r );
+        block_ChainRelease( r->p_out );
+        free( r->psz_es_id );
+    }
+    free( id->renditions );
+
     es_format_Clean( &id->decoder_out );
 
     /* Close filters */
@@ -473,6 +597,10 @@ static picture_t * RenderSubpictures( sout_stream_id_sys_t *id, picture_t *p_pic
     /* Overlay subpicture */
     if( p_subpic )
     {
+        if( unlikely( !id->p_spu_blender ) )
+            id->p_spu_blender = filter_NewBlend( VLC_OBJECT( id->p_spu ), &fmt );
+
+        bool b_blent = false;
         if( filter_chain_IsEmpty( id->p_f_chain ) )
         {
             /* We can't modify the picture, we need to duplicate it,
@@ -480,14 +608,18 @@ static picture_t * RenderSubpictures( sout_stream_id_sys_t *id, picture_t *p_pic
             picture_t *p_tmp = video_new_buffer_encoder( id->encoder );
             if( likely( p_tmp ) )
             {
-                picture_Copy( p_tmp, p_pic );
+                /* blend while copying */
+                if( likely( id->p_spu_blender ) )
+                    picture_CopyBlendSubpicture( p_tmp, p_pic,
+                                                 id->p_spu_blender, p_subpic );
+                else
+                    picture_Copy( p_tmp, p_pic );
                 picture_Release( p_pic );
                 p_pic = p_tmp;
+                b_blent = true;
             }
         }
-        if( unlikely( !id->p_spu_blender ) )
-            id->p_spu_blender = filter_NewBlend( VLC_OBJECT( id->p_spu ), &fmt );
-        if( likely( id->p_spu_blender ) )
+        if( !b_blent && likely( id->p_spu_blender ) )
             picture_BlendSubpicture( p_pic, id->p_spu_blender, p_subpic );
         vlc_render_subpicture_Delete( p_subpic );
     }
@@ -508,6 +640,32 @@ static void tag_last_block_with_flag( block_t **out, int i_flag )
     }
 }
 
+static void transcode_video_renditions_encode( sout_stream_id_sys_t *id,
+                                               picture_t *p_pic )
+{
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->renditions[i];
+        if( r->encoder == NULL )
+            continue;
+
+        picture_t *p_in = picture_Hold( p_pic );
+        if( r->p_conv )
+            p_in = filter_chain_VideoFilter( r->p_conv, p_in );
+        if( !p_in )
+            continue;
+
+        block_t *p_encoded = transcode_encoder_encode( r->encoder, p_in );
+        picture_Release( p_in );
+        if( p_encoded )
+        {
+            vlc_fifo_Lock( id->output_fifo );
+            block_ChainAppend( &r->p_out, p_encoded );
+            vlc_fifo_Unlock( id->output_fifo );
+        }
+    }
+}
+
 static int transcode_process_picture( sout_stream_id_sys_t *id,
                                       picture_t *p_pic, block_t **out)
 {
@@ -544,6 +702,9 @@ static int transcode_process_picture( sout_stream_id_sys_t *id,
 
             if( p_in )
             {
+                /* Every rendition encodes the very same picture */
+                transcode_video_renditions_encode( id, p_in );
+
                 /* If a packetizer is used, multiple blocks might be returned, in w */
                 block_t *p_encoded = transcode_encoder_encode( id->encoder, p_in );
                 picture_Release( p_in );
@@ -574,7 +735,9 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
         return VLC_SUCCESS;
 
     vlc_fifo_Lock( id->output_fifo );
-    if( unlikely( !id->b_error && in == NULL ) && transcode_encoder_opened( id->encoder ) )
+    bool b_drain = unlikely( !id->b_error && in == NULL ) &&
+                   transcode_encoder_opened( id->encoder );
+    if( b_drain )
     {
         msg_Dbg( p_stream, "Draining thread and waiting for that");
         if( transcode_encoder_drain( id->encoder, out ) == VLC_SUCCESS )
@@ -590,6 +753,22 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
     }
     vlc_fifo_Unlock( id->output_fifo );
 
+    /* Renditions are drained outside of the fifo lock, which only protects
+     * their output chain. */
+    for( size_t i = 0; b_drain && i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->renditions[i];
+        if( r->encoder == NULL )
+            continue;
+
+        block_t *p_drained = NULL;
+        transcode_encoder_drain( r->encoder, &p_drained );
+
+        vlc_fifo_Lock( id->output_fifo );
+        block_ChainAppend( &r->p_out, p_drained );
+        vlc_fifo_Unlock( id->output_fifo );
+    }
+
     if( b_eos )
         tag_last_block_with_flag( out, BLOCK_FLAG_END_OF_SEQUENCE );
 
@@ -41,12 +41,14 @@
 #include <vlc_subpicture.h>
 #include <vlc_text_style.h>                                   /* text_style_t*/
 #include <vlc_charset.h>
+#include <vlc_memstream.h>
 
 #include <assert.h>
 
 #include "platform_fonts.h"
 #include "freetype.h"
 #include "text_layout.h"
+#include "lru.h"
 #include "blend/rgb.h"
 #include "blend/yuv.h"
 
@@ -87,6 +89,9 @@ static void Destroy( filter_t * );
 #define SHADOW_DISTANCE_TEXT N_("Shadow distance")
 #define CACHE_SIZE_TEXT N_("Cache size")
 #define CACHE_SIZE_LONGTEXT N_("Cache size in kBytes")
+#define RENDER_CACHE_TEXT N_("Rendered text cache")
+#define RENDER_CACHE_LONGTEXT N_("Number of rendered text regions kept " \
+  "for reuse when the same text is rendered again (0 to disable).")
 
 #define TEXT_DIRECTION_TEXT N_("Text direction")
 #define TEXT_DIRECTION_LONGTEXT N_("Paragraph base direction for the Unicode bi-directional algorithm.")
@@ -184,6 +189,9 @@ vlc_module_begin ()
     add_integer_with_range( "freetype-cache-size", 200, 25, (UINT32_MAX >> 10),
                             CACHE_SIZE_TEXT, CACHE_SIZE_LONGTEXT )
         change_safe()
+    add_integer_with_range( "freetype-render-cache", 8, 0, 256,
+                            RENDER_CACHE_TEXT, RENDER_CACHE_LONGTEXT )
+        change_safe()
 
     add_obsolete_integer( "freetype-fontsize" ) /* since 4.0.0 */
     add_obsolete_integer( "freetype-rel-fontsize" ) /* since 4.0.0 */
@@ -918,6 +926,134 @@ static size_t SegmentsToTextAndStyles( filter_t *p_filter, const text_segment_t
     return i_nb_char;
 }
 
+/*****************************************************************************
+ * Rendered regions cache
+ *****************************************************************************
+ * The key captures everything Render() output depends on: the segments and
+ * their styles, the region parameters, the output size and the renderer
+ * live state (scale, default and forced styles, outline thickness).
+ *****************************************************************************/
+static void RenderCacheKeyString( struct vlc_memstream *ms, const char *psz )
+{
+    if( psz )
+        vlc_memstream_printf( ms, "%zu:%s", strlen( psz ), psz );
+    else
+        vlc_memstream_putc( ms, '-' );
+}
+
+static void RenderCacheKeyStyle( struct vlc_memstream *ms,
+                                 const text_style_t *p_style )
+{
+    if( !p_style )
+    {
+        vlc_memstream_puts( ms, "{}" );
+        return;
+    }
+    vlc_memstream_putc( ms, '{' );
+    RenderCacheKeyString( ms, p_style->psz_fontname );
+    RenderCacheKeyString( ms, p_style->psz_monofontname );
+    vlc_memstream_printf( ms, "%"PRIu16",%"PRIu16",%a,%d,%"PRIx32",%"PRIu8",%d,"
+                          "%"PRIx32",%"PRIu8",%d,%"PRIx32",%"PRIu8",%d,"
+                          "%"PRIx32",%"PRIu8",%d}",
+                          p_style->i_features, p_style->i_style_flags,
+                          p_style->f_font_relsize, p_style->i_font_size,
+                          p_style->i_font_color, p_style->i_font_alpha,
+                          p_style->i_spacing,
+                          p_style->i_outline_color, p_style->i_outline_alpha,
+                          p_style->i_outline_width,
+                          p_style->i_shadow_color, p_style->i_shadow_alpha,
+                          p_style->i_shadow_width,
+                          p_style->i_background_color,
+                          p_style->i_background_alpha,
+                          (int) p_style->e_wrapinfo );
+}
+
+static char *RenderCacheKey( filter_t *p_filter,
+                             const subpicture_region_t *p_region_in,
+                             const vlc_fourcc_t *p_chroma_list )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const video_format_t *p_fmt_out = &p_filter->fmt_out.video;
+    const video_format_t *p_fmt = &p_region_in->fmt;
+    struct vlc_memstream ms;
+
+    if( vlc_memstream_open( &ms ) )
+        return NULL;
+
+    vlc_memstream_printf( &ms, "%ux%u,%d,%d,%d,%4.4s|",
+                          p_fmt_out->i_visible_width,
+                          p_fmt_out->i_visible_height,
+                          p_sys->i_scale, p_sys->i_font_default_size,
+                          p_sys->i_outline_thickness,
+                          (const char *) &p_sys->i_forced_chroma );
+    for( ; p_chroma_list && *p_chroma_list; p_chroma_list++ )
+        vlc_memstream_printf( &ms, "%4.4s", (const char *) p_chroma_list );
+    vlc_memstream_putc( &ms, '|' );
+    RenderCacheKeyStyle( &ms, p_sys->p_default_style );
+    RenderCacheKeyStyle( &ms, p_sys->p_forced_style );
+
+    vlc_memstream_printf( &ms, "|%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%u:%u|",
+                          p_region_in->text_flags,
+                          p_region_in->i_max_width, p_region_in->i_max_height,
+                          p_region_in->i_x, p_region_in->i_y,
+                          p_region_in->i_align, p_region_in->i_alpha,
+                          p_region_in->b_absolute, p_region_in->b_in_window,
+                          (int) p_fmt->transfer, (int) p_fmt->primaries,
+                          (int) p_fmt->space, (int) p_fmt->color_range,
+                          p_fmt->i_sar_num, p_fmt->i_sar_den );
+    for( size_t i = 0; i < ARRAY_SIZE(p_fmt->mastering.primaries); i++ )
+        vlc_memstream_printf( &ms, "%"PRIx16",", p_fmt->mastering.primaries[i] );
+    vlc_memstream_printf( &ms, "%"PRIx16",%"PRIx16",%"PRIx32",%"PRIx32,
+                          p_fmt->mastering.white_point[0],
+                          p_fmt->mastering.white_point[1],
+                          p_fmt->mastering.max_luminance,
+                          p_fmt->mastering.min_luminance );
+
+    for( const text_segment_t *s = p_region_in->p_text; s; s = s->p_next )
+    {
+        vlc_memstream_putc( &ms, '[' );
+        RenderCacheKeyString( &ms, s->psz_text );
+        RenderCacheKeyStyle( &ms, s->style );
+        for( const text_segment_ruby_t *r = s->p_ruby; r; r = r->p_next )
+        {
+            vlc_memstream_putc( &ms, 'r' );
+            RenderCacheKeyString( &ms, r->psz_base );
+            RenderCacheKeyString( &ms, r->psz_rt );
+        }
+        vlc_memstream_putc( &ms, ']' );
+    }
+
+    if( vlc_memstream_close( &ms ) )
+        return NULL;
+    return ms.ptr;
+}
+
+/* Returns a new region sharing the picture of a rendered one. The pictures
+ * are never written once rendered, so they can be referenced by any number
+ * of regions. */
+static subpicture_region_t *RenderCacheShare( const subpicture_region_t *p_src )
+{
+    subpicture_region_t *p_region = subpicture_region_ForPicture( p_src->p_picture );
+    if( unlikely(p_region == NULL) )
+        return NULL;
+
+    video_format_Clean( &p_region->fmt );
+    video_format_Copy( &p_region->fmt, &p_src->fmt );
+    p_region->i_x = p_src->i_x;
+    p_region->i_y = p_src->i_y;
+    p_region->i_alpha = p_src->i_alpha;
+    p_region->i_align = p_src->i_align;
+    p_region->b_absolute = p_src->b_absolute;
+    p_region->b_in_window = p_src->b_in_window;
+    return p_region;
+}
+
+static void RenderCacheRelease( void *priv, void *value )
+{
+    VLC_UNUSED( priv );
+    subpicture_region_Delete( value );
+}
+
 /**
  * This function renders a text subpicture region into another one.
  * It also calculates the size needed for this string, and renders the
@@ -948,6 +1084,19 @@ static subpicture_region_t *Render( filter_t *p_filter,
         p_sys->i_font_default_size = i_font_default_size;
     }
 
+    char *psz_key = NULL;
+    if( p_sys->render_cache )
+    {
+        psz_key = RenderCacheKey( p_filter, p_region_in, p_chroma_list );
+        const subpicture_region_t *p_cached =
+            psz_key ? vlc_lru_Get( p_sys->render_cache, psz_key ) : NULL;
+        if( p_cached )
+        {
+            free( psz_key );
+            return RenderCacheShare( p_cached );
+        }
+    }
+
     layout_text_block_t text_block = { 0 };
     text_block.b_balanced = (p_region_in->text_flags & VLC_SUBPIC_TEXT_FLAG_TEXT_NOT_BALANCED) == 0;
     text_block.b_grid = b_grid;
@@ -957,6 +1106,7 @@ static subpicture_region_t *Render( filter_t *p_filter,
     {
         free( text_block.pp_styles );
         free( text_block.p_uchars );
+        free( psz_key );
         return NULL;
     }
 
@@ -1154,8 +1304,16 @@ static subpicture_region_t *Render( filter_t *p_filter,
 
     if (region == NULL)
         msg_Warn( p_filter, "no output chroma supported for rendering" );
+    /* YUVP pictures are excluded: the vout may patch their palette */
+    else if( psz_key && region->fmt.i_chroma != VLC_CODEC_YUVP )
+    {
+        subpicture_region_t *p_cached = RenderCacheShare( region );
+        if( p_cached )
+            vlc_lru_Insert( p_sys->render_cache, psz_key, p_cached );
+    }
 
 done:
+    free( psz_key );
     FreeLines( text_block.p_laid );
 
     free( text_block.p_uchars );
@@ -1204,6 +1362,16 @@ static int Create( filter_t *p_filter )
     if( !p_sys->ftcache )
         goto error;
 
+    unsigned i_render_cache = var_InheritInteger( p_filter, "freetype-render-cache" );
+    if( i_render_cache > 0 )
+    {
+        /* The LRU evicts once it holds max entries: keep one more slot */
+        p_sys->render_cache = vlc_lru_New( i_render_cache + 1,
+                                           RenderCacheRelease, NULL );
+        if( !p_sys->render_cache )
+            goto error;
+    }
+
     p_sys->i_scale = 100;
 
     /* default style to apply to incomplete segments styles */
@@ -1270,6 +1438,9 @@ static void Destroy( filter_t *p_filter )
         DumpFamilies( p_sys->fs );
 #endif
 
+    if( p_sys->render_cache )
+        vlc_lru_Release( p_sys->render_cache );
+
     if( p_sys->ftcache )
         vlc_ftcache_Delete( p_sys->ftcache );
 
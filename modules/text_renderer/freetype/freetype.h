@@ -112,6 +112,7 @@ typedef struct
 
     vlc_font_select_t *fs;
     vlc_ftcache_t     *ftcache;
+    struct vlc_lru    *render_cache; /* rendered regions, keyed by text/style/size */
 
 } filter_sys_t;
 
@@ -32,8 +32,13 @@
 #include <vlc_common.h>
 #include <vlc_picture.h>
 #include <vlc_cpu.h>
+#include <vlc_executor.h>
 #include <assert.h>
 
+#ifdef HAVE_AVX2_INTRINSICS
+# include <immintrin.h>
+#endif
+
 #include "copy.h"
 static void CopyPlane(uint8_t *dst, size_t dst_pitch,
                       const uint8_t *src, size_t src_pitch,
@@ -51,7 +56,23 @@ static void CopyPlane(uint8_t *dst, size_t dst_pitch,
 #define ASSERT_3PLANES ASSERT_2PLANES; \
     ASSERT_PLANE(2)
 
-int CopyInitCache(copy_cache_t *cache, unsigned width)
+/* Pictures are only split in slices of at least that many bytes of luma, so
+ * that waking up the workers does not cost more than it saves. */
+#define COPY_SLICE_MIN_SIZE (1 << 20)
+#define COPY_MAX_THREADS    8
+
+struct copy_slice
+{
+    struct vlc_runnable runnable;
+    copy_cache_t cache;
+
+    const struct copy_job *job;
+    picture_t dst;
+    const uint8_t *src[3];
+    unsigned height;
+};
+
+static int CopyInitBuffer(copy_cache_t *cache, unsigned width)
 {
 #ifdef CAN_COMPILE_SSE2
     cache->size = __MAX((width + 0x3f) & ~ 0x3f, 16384);
@@ -64,7 +85,7 @@ int CopyInitCache(copy_cache_t *cache, unsigned width)
     return VLC_SUCCESS;
 }
 
-void CopyCleanCache(copy_cache_t *cache)
+static void CopyCleanBuffer(copy_cache_t *cache)
 {
 #ifdef CAN_COMPILE_SSE2
     aligned_free(cache->buffer);
@@ -75,6 +96,63 @@ void CopyCleanCache(copy_cache_t *cache)
 #endif
 }
 
+int CopyInitCache(copy_cache_t *cache, unsigned width)
+{
+    cache->executor = NULL;
+    cache->slices = NULL;
+    cache->slice_count = 0;
+    return CopyInitBuffer(cache, width);
+}
+
+int CopyInitCacheThreads(copy_cache_t *cache, unsigned width, unsigned threads)
+{
+    if (CopyInitCache(cache, width))
+        return VLC_EGENERIC;
+
+    if (threads == 0)
+        threads = vlc_GetCPUCount();
+    threads = __MIN(threads, COPY_MAX_THREADS);
+    if (threads < 2)
+        return VLC_SUCCESS;
+
+    cache->slices = calloc(threads, sizeof (*cache->slices));
+    if (unlikely(cache->slices == NULL))
+        goto error;
+
+    /* The calling thread copies the first slice with the main buffer */
+#ifdef CAN_COMPILE_SSE2
+    cache->slices[0].cache.buffer = cache->buffer;
+    cache->slices[0].cache.size = cache->size;
+#endif
+    for (cache->slice_count = 1; cache->slice_count < threads;
+         cache->slice_count++)
+        if (CopyInitCache(&cache->slices[cache->slice_count].cache, width))
+            goto error;
+
+    cache->executor = vlc_executor_New(threads - 1);
+    if (cache->executor == NULL)
+        goto error;
+    return VLC_SUCCESS;
+
+error:
+    CopyCleanCache(cache);
+    return VLC_EGENERIC;
+}
+
+void CopyCleanCache(copy_cache_t *cache)
+{
+    if (cache->executor != NULL)
+        vlc_executor_Delete(cache->executor);
+    for (unsigned i = 1; i < cache->slice_count; i++)
+        CopyCleanBuffer(&cache->slices[i].cache);
+    free(cache->slices);
+    cache->executor = NULL;
+    cache->slices = NULL;
+    cache->slice_count = 0;
+
+    CopyCleanBuffer(cache);
+}
+
 #ifdef CAN_COMPILE_SSE2
 /* Copy 16/64 bytes from srcp to dstp loading data with the SSE>=2 instruction
  * load and storing data with the SSE>=2 instruction store.
@@ -121,6 +199,10 @@ void CopyCleanCache(copy_cache_t *cache)
 #define COPY64(dstp, srcp, load, store) \
     COPY64_S(dstp, srcp, load, store, "")
 
+#if defined(COPY_TEST_NOOPTIM) || defined(COPY_TEST_NOAVX2)
+# undef vlc_CPU_AVX2
+# define vlc_CPU_AVX2() (0)
+#endif
 #ifdef COPY_TEST_NOOPTIM
 # undef vlc_CPU_SSE4_1
 # define vlc_CPU_SSE4_1() (0)
@@ -460,6 +542,161 @@ static void SSE_SplitUV(uint8_t *dstu, size_t dstu_pitch,
 #undef LOAD64
 }
 
+#ifdef HAVE_AVX2_INTRINSICS
+/* AVX2 variants of the above, handling 128 bytes per iteration. The copy from
+ * the cache and the split write to the destination with unaligned stores,
+ * that cost next to nothing on AVX2 capable CPUs. */
+
+VLC_AVX2
+static inline __m256i AVX2_Shift(__m256i v, int bitshift)
+{
+    if (bitshift > 0)
+        return _mm256_srli_epi16(v, bitshift);
+    if (bitshift < 0)
+        return _mm256_slli_epi16(v, -bitshift);
+    return v;
+}
+
+VLC_AVX2
+static void AVX2_CopyFromUswc(uint8_t *dst, size_t dst_pitch,
+                              const uint8_t *src, size_t src_pitch,
+                              unsigned width, unsigned height, int bitshift)
+{
+    _mm_mfence();
+
+    for (unsigned y = 0; y < height; y++) {
+        const unsigned unaligned = (-(uintptr_t)src) & 0x1f;
+        unsigned x = 0;
+
+        if (unaligned && width >= 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)src);
+            _mm256_storeu_si256((__m256i *)dst, AVX2_Shift(v, bitshift));
+            x = unaligned;
+        }
+        for (; x + 127 < width; x += 128) {
+            const __m256i *in = (const __m256i *)&src[x];
+            __m256i *out = (__m256i *)&dst[x];
+            __m256i v0 = _mm256_stream_load_si256(in + 0);
+            __m256i v1 = _mm256_stream_load_si256(in + 1);
+            __m256i v2 = _mm256_stream_load_si256(in + 2);
+            __m256i v3 = _mm256_stream_load_si256(in + 3);
+
+            _mm256_storeu_si256(out + 0, AVX2_Shift(v0, bitshift));
+            _mm256_storeu_si256(out + 1, AVX2_Shift(v1, bitshift));
+            _mm256_storeu_si256(out + 2, AVX2_Shift(v2, bitshift));
+            _mm256_storeu_si256(out + 3, AVX2_Shift(v3, bitshift));
+        }
+        for (; x + 31 < width; x += 32) {
+            __m256i v = _mm256_stream_load_si256((const __m256i *)&src[x]);
+            _mm256_storeu_si256((__m256i *)&dst[x], AVX2_Shift(v, bitshift));
+        }
+        if (x < width)
+            CopyPlane(&dst[x], dst_pitch - x, &src[x], src_pitch - x, 1, bitshift);
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+
+    _mm_mfence();
+}
+
+VLC_AVX2
+static void AVX2_Copy2d(uint8_t *dst, size_t dst_pitch,
+                        const uint8_t *src, size_t src_pitch,
+                        unsigned width, unsigned height)
+{
+#define AVX2_COPY128(store) do { \
+    const __m256i *in = (const __m256i *)&src[x]; \
+    __m256i *out = (__m256i *)&dst[x]; \
+    __m256i v0 = _mm256_loadu_si256(in + 0); \
+    __m256i v1 = _mm256_loadu_si256(in + 1); \
+    __m256i v2 = _mm256_loadu_si256(in + 2); \
+    __m256i v3 = _mm256_loadu_si256(in + 3); \
+    store(out + 0, v0); \
+    store(out + 1, v1); \
+    store(out + 2, v2); \
+    store(out + 3, v3); \
+} while (0)
+
+    for (unsigned y = 0; y < height; y++) {
+        unsigned x = 0;
+
+        if (((uintptr_t)dst & 0x1f) == 0) {
+            for (; x + 127 < width; x += 128)
+                AVX2_COPY128(_mm256_stream_si256);
+        } else {
+            for (; x + 127 < width; x += 128)
+                AVX2_COPY128(_mm256_storeu_si256);
+        }
+
+        for (; x < width; x++)
+            dst[x] = src[x];
+
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+#undef AVX2_COPY128
+
+    _mm_sfence();
+}
+
+VLC_AVX2
+static void AVX2_SplitUV(uint8_t *dstu, size_t dstu_pitch,
+                         uint8_t *dstv, size_t dstv_pitch,
+                         const uint8_t *src, size_t src_pitch,
+                         unsigned width, unsigned height, uint8_t pixel_size)
+{
+    assert(pixel_size == 1 || pixel_size == 2);
+
+    const __m256i mask = pixel_size == 1 ? _mm256_set1_epi16(0x00ff)
+                                         : _mm256_set1_epi32(0xffff);
+
+    for (unsigned y = 0; y < height; y++) {
+        unsigned x = 0;
+
+        for (; x + 31 < width; x += 32) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)&src[2*x]);
+            __m256i b = _mm256_loadu_si256((const __m256i *)&src[2*x+32]);
+            __m256i u, v;
+
+            if (pixel_size == 1) {
+                u = _mm256_packus_epi16(_mm256_and_si256(a, mask),
+                                        _mm256_and_si256(b, mask));
+                v = _mm256_packus_epi16(_mm256_srli_epi16(a, 8),
+                                        _mm256_srli_epi16(b, 8));
+            } else {
+                u = _mm256_packus_epi32(_mm256_and_si256(a, mask),
+                                        _mm256_and_si256(b, mask));
+                v = _mm256_packus_epi32(_mm256_srli_epi32(a, 16),
+                                        _mm256_srli_epi32(b, 16));
+            }
+            /* Packing works within each 128-bit lane: put the qwords of a
+             * before those of b */
+            _mm256_storeu_si256((__m256i *)&dstu[x],
+                                _mm256_permute4x64_epi64(u, 0xd8));
+            _mm256_storeu_si256((__m256i *)&dstv[x],
+                                _mm256_permute4x64_epi64(v, 0xd8));
+        }
+
+        if (pixel_size == 1) {
+            for (; x < width; x++) {
+                dstu[x] = src[2*x+0];
+                dstv[x] = src[2*x+1];
+            }
+        } else {
+            for (; x < width; x += 2) {
+                dstu[x] = src[2*x+0];
+                dstu[x+1] = src[2*x+1];
+                dstv[x] = src[2*x+2];
+                dstv[x+1] = src[2*x+3];
+            }
+        }
+        src  += src_pitch;
+        dstu += dstu_pitch;
+        dstv += dstv_pitch;
+    }
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
 static void SSE_CopyPlane(uint8_t *dst, size_t dst_pitch,
                           const uint8_t *src, size_t src_pitch,
                           uint8_t *cache, size_t cache_size,
@@ -479,11 +716,21 @@ static void SSE_CopyPlane(uint8_t *dst, size_t dst_pitch,
     for (unsigned y = 0; y < height; y += hstep) {
         const unsigned hblock =  __MIN(hstep, height - y);
 
-        /* Copy a bunch of line into our cache */
-        CopyFromUswc(cache, w16, src, src_pitch, cache_width, hblock, bitshift);
+#ifdef HAVE_AVX2_INTRINSICS
+        if (vlc_CPU_AVX2()) {
+            AVX2_CopyFromUswc(cache, w16, src, src_pitch, cache_width, hblock,
+                              bitshift);
+            AVX2_Copy2d(dst, dst_pitch, cache, w16, copy_pitch, hblock);
+        } else
+#endif
+        {
+            /* Copy a bunch of line into our cache */
+            CopyFromUswc(cache, w16, src, src_pitch, cache_width, hblock,
+                         bitshift);
 
-        /* Copy from our cache to the destination */
-        Copy2d(dst, dst_pitch, cache, w16, copy_pitch, hblock);
+            /* Copy from our cache to the destination */
+            Copy2d(dst, dst_pitch, cache, w16, copy_pitch, hblock);
+        }
 
         /* */
         src += src_pitch * hblock;
@@ -542,12 +789,23 @@ static void SSE_SplitPlanes(uint8_t *dstu, size_t dstu_pitch,
     for (unsigned y = 0; y < height; y += hstep) {
         const unsigned hblock =  __MIN(hstep, height - y);
 
-        /* Copy a bunch of line into our cache */
-        CopyFromUswc(cache, w16, src, src_pitch, cache_width, hblock, bitshift);
+#ifdef HAVE_AVX2_INTRINSICS
+        if (vlc_CPU_AVX2()) {
+            AVX2_CopyFromUswc(cache, w16, src, src_pitch, cache_width, hblock,
+                              bitshift);
+            AVX2_SplitUV(dstu, dstu_pitch, dstv, dstv_pitch,
+                         cache, w16, copy_pitch, hblock, pixel_size);
+        } else
+#endif
+        {
+            /* Copy a bunch of line into our cache */
+            CopyFromUswc(cache, w16, src, src_pitch, cache_width, hblock,
+                         bitshift);
 
-        /* Copy from our cache to the destination */
-        SSE_SplitUV(dstu, dstu_pitch, dstv, dstv_pitch,
-                    cache, w16, copy_pitch, hblock, pixel_size);
+            /* Copy from our cache to the destination */
+            SSE_SplitUV(dstu, dstu_pitch, dstv, dstv_pitch,
+                        cache, w16, copy_pitch, hblock, pixel_size);
+        }
 
         /* */
         src  += src_pitch  * hblock;
@@ -641,12 +899,117 @@ static void CopyPlane(uint8_t *dst, size_t dst_pitch,
     }
 }
 
+struct copy_job
+{
+    void (*copy)(picture_t *, const uint8_t *[], const size_t [], unsigned,
+                 int, const copy_cache_t *);
+    picture_t *dst;
+    const uint8_t **src;
+    const size_t *src_pitch;
+    unsigned src_planes;
+    int bitshift;
+};
+
+static void CopySlice(void *data)
+{
+    struct copy_slice *slice = data;
+    const struct copy_job *job = slice->job;
+
+    job->copy(&slice->dst, slice->src, job->src_pitch, slice->height,
+              job->bitshift, &slice->cache);
+}
+
+/* Splits the copy in horizontal slices run on the cache worker threads. The
+ * slices have an even number of lines so that 4:2:0 chroma planes are split
+ * at the same place as the luma plane. Returns false if the picture is too
+ * small to be worth it, in which case nothing is copied. */
+static bool CopySlices(const copy_cache_t *cache, const struct copy_job *job,
+                       unsigned height)
+{
+    if (cache->executor == NULL)
+        return false;
+
+    size_t size = job->src_pitch[0] * height;
+    unsigned count = __MIN(cache->slice_count, size / COPY_SLICE_MIN_SIZE);
+    if (count < 2)
+        return false;
+
+    const unsigned lines = ((height + count - 1) / count + 1) & ~1;
+    unsigned y = 0;
+
+    for (count = 0; y < height; count++)
+    {
+        struct copy_slice *slice = &cache->slices[count];
+        const unsigned n = __MIN(lines, height - y);
+
+        slice->job = job;
+        slice->height = n;
+        slice->dst.format = job->dst->format;
+        slice->dst.i_planes = job->dst->i_planes;
+        for (int i = 0; i < job->dst->i_planes; i++)
+        {
+            slice->dst.p[i] = job->dst->p[i];
+            slice->dst.p[i].p_pixels += (i ? y / 2 : y) * job->dst->p[i].i_pitch;
+        }
+        for (unsigned i = 0; i < job->src_planes; i++)
+            slice->src[i] = job->src[i] + (i ? y / 2 : y) * job->src_pitch[i];
+
+        slice->runnable.run = CopySlice;
+        slice->runnable.userdata = slice;
+        if (count > 0)
+            vlc_executor_Submit(cache->executor, &slice->runnable);
+        y += n;
+    }
+
+    CopySlice(&cache->slices[0]);
+    vlc_executor_WaitIdle(cache->executor);
+    return true;
+}
+
+#define COPY_SLICES(func, planes, shift) do { \
+    const struct copy_job job = { func, dst, src, src_pitch, planes, shift }; \
+    if (CopySlices(cache, &job, height)) \
+        return; \
+} while (0)
+
+/* Adapts 8-bit copy functions to the copy_job prototype */
+#define COPY_SLICE_WRAPPER(name) \
+static void name##_Slice(picture_t *dst, const uint8_t *src[], \
+                         const size_t src_pitch[], unsigned height, \
+                         int bitshift, const copy_cache_t *cache) \
+{ \
+    assert(bitshift == 0); \
+    name(dst, src, src_pitch, height, cache); \
+}
+
+COPY_SLICE_WRAPPER(Copy420_SP_to_SP)
+COPY_SLICE_WRAPPER(Copy420_SP_to_P)
+COPY_SLICE_WRAPPER(Copy420_P_to_SP)
+COPY_SLICE_WRAPPER(Copy420_P_to_P)
+
+static void CopyPacked_Slice(picture_t *dst, const uint8_t *src[],
+                             const size_t src_pitch[], unsigned height,
+                             int bitshift, const copy_cache_t *cache)
+{
+    assert(bitshift == 0);
+    CopyPacked(dst, src[0], src_pitch[0], height, cache);
+}
+
 void CopyPacked(picture_t *dst, const uint8_t *src, const size_t src_pitch,
                 unsigned height, const copy_cache_t *cache)
 {
     assert(dst);
     assert(src); assert(src_pitch);
     assert(height);
+    {
+        const uint8_t *planes[1] = { src };
+        const size_t pitches[1] = { src_pitch };
+        const struct copy_job job = {
+            CopyPacked_Slice, dst, planes, pitches, 1, 0
+        };
+        if (CopySlices(cache, &job, height))
+            return;
+    }
 
 #ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSE4_1())
@@ -664,6 +1027,7 @@ void Copy420_SP_to_SP(picture_t *dst, const uint8_t *src[static 2],
                       const copy_cache_t *cache)
 {
     ASSERT_2PLANES;
+    COPY_SLICES(Copy420_SP_to_SP_Slice, 2, 0);
 #ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSE2())
         return SSE_Copy420_SP_to_SP(dst, src, src_pitch, height, cache);
@@ -741,6 +1105,7 @@ void Copy420_SP_to_P(picture_t *dst, const uint8_t *src[static 2],
                      const copy_cache_t *cache)
 {
     ASSERT_2PLANES;
+    COPY_SLICES(Copy420_SP_to_P_Slice, 2, 0);
 #ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSE2())
         return SSE_Copy420_SP_to_P(dst, src, src_pitch, height, 1, 0, cache);
@@ -761,6 +1126,7 @@ void Copy420_16_SP_to_P(picture_t *dst, const uint8_t *src[static 2],
 {
     ASSERT_2PLANES;
     assert(bitshift >= -6 && bitshift <= 6 && (bitshift % 2 == 0));
+    COPY_SLICES(Copy420_16_SP_to_P, 2, bitshift);
 
 #ifdef CAN_COMPILE_SSE3
     if (vlc_CPU_SSSE3())
@@ -817,6 +1183,7 @@ void Copy420_P_to_SP(picture_t *dst, const uint8_t *src[static 3],
                      const copy_cache_t *cache)
 {
     ASSERT_3PLANES;
+    COPY_SLICES(Copy420_P_to_SP_Slice, 3, 0);
 #ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSE2())
         return SSE_Copy420_P_to_SP(dst, src, src_pitch, height, 1, 0, cache);
@@ -848,6 +1215,7 @@ void Copy420_16_P_to_SP(picture_t *dst, const uint8_t *src[static 3],
 {
     ASSERT_3PLANES;
     assert(bitshift >= -6 && bitshift <= 6 && (bitshift % 2 == 0));
+    COPY_SLICES(Copy420_16_P_to_SP, 3, bitshift);
 #ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSSE3())
         return SSE_Copy420_P_to_SP(dst, src, src_pitch, height, 2, bitshift, cache);
@@ -882,6 +1250,7 @@ void Copy420_P_to_P(picture_t *dst, const uint8_t *src[static 3],
                     const copy_cache_t *cache)
 {
     ASSERT_3PLANES;
+    COPY_SLICES(Copy420_P_to_P_Slice, 3, 0);
 #ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSE2())
         return SSE_Copy420_P_to_P(dst, src, src_pitch, height, cache);
@@ -1105,6 +1474,85 @@ cleanup:
     return NULL;
 }
 
+static void pic_fill_planes(picture_t *pic, const uint8_t *planes[3],
+                            size_t pitches[3])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        planes[i] = pic->p[i].p_pixels;
+        pitches[i] = pic->p[i].i_pitch;
+    }
+}
+
+static void test_conv(const struct test_dst *test_dst, picture_t *dst,
+                      picture_t *src, const copy_cache_t *cache)
+{
+    const uint8_t *src_planes[3];
+    size_t src_pitches[3];
+
+    pic_fill_planes(src, src_planes, src_pitches);
+    if (test_dst->bitshift == 0)
+        test_dst->conv(dst, src_planes, src_pitches,
+                       src->format.i_visible_height, cache);
+    else
+        test_dst->conv16(dst, src_planes, src_pitches,
+                         src->format.i_visible_height, test_dst->bitshift,
+                         cache);
+}
+
+/* Reports the throughput of each conversion, in bytes of source read */
+static void bench(unsigned threads)
+{
+    for (size_t i = 0; i < NB_CONVS; ++i)
+    {
+        const struct test_conv *conv = &convs[i];
+        const vlc_chroma_description_t *src_dsc =
+            vlc_fourcc_GetChromaDescription(conv->src_chroma);
+        video_format_t fmt;
+
+        video_format_Init(&fmt, 0);
+        video_format_Setup(&fmt, conv->src_chroma, 3840, 2160, 3840, 2160,
+                           1, 1);
+        picture_t *src = picture_NewFromFormat(&fmt);
+        assert(src);
+
+        size_t size = 0;
+        for (int p = 0; p < src->i_planes; p++)
+            size += src->p[p].i_visible_pitch * src->p[p].i_visible_lines;
+
+        copy_cache_t cache;
+        int ret = CopyInitCacheThreads(&cache, src->format.i_width
+                                       * src_dsc->pixel_size, threads);
+        assert(ret == VLC_SUCCESS);
+
+        for (size_t f = 0; conv->dsts[f].chroma != 0; ++f)
+        {
+            fmt.i_chroma = conv->dsts[f].chroma;
+            picture_t *dst = picture_NewFromFormat(&fmt);
+            assert(dst);
+
+            unsigned count = 0;
+            vlc_tick_t start = vlc_tick_now(), elapsed;
+            do
+            {
+                test_conv(&conv->dsts[f], dst, src, &cache);
+                count++;
+                elapsed = vlc_tick_now() - start;
+            }
+            while (elapsed < VLC_TICK_FROM_MS(100));
+
+            fprintf(stderr, "bench: %u thread(s) %4.4s -> %4.4s: %.2f GB/s\n",
+                    cache.slice_count ? cache.slice_count : 1,
+                    (const char *) &conv->src_chroma,
+                    (const char *) &conv->dsts[f].chroma,
+                    size * count / secf_from_vlc_tick(elapsed) / 1e9);
+            picture_Release(dst);
+        }
+        CopyCleanCache(&cache);
+        picture_Release(src);
+    }
+}
+
 int main(void)
 {
     alarm(10);
@@ -1119,6 +1567,15 @@ int main(void)
     }
 #endif
 
+#ifndef COPY_TEST_NOAVX2
+# ifdef HAVE_AVX2_INTRINSICS
+    if (!vlc_CPU_AVX2())
+        fprintf(stderr, "WARNING: could not test AVX2\n");
+# endif
+#endif
+
+    /* Single-threaded, then split in slices */
+    for (unsigned threads = 1; threads <= 4; threads += 3)
     for (size_t i = 0; i < NB_CONVS; ++i)
     {
         const struct test_conv *conv = &convs[i];
@@ -1142,8 +1599,8 @@ int main(void)
             piccheck(src, src_dsc, true);
 
             copy_cache_t cache;
-            int ret = CopyInitCache(&cache, src->format.i_width
-                                    * src_dsc->pixel_size);
+            int ret = CopyInitCacheThreads(&cache, src->format.i_width
+                                           * src_dsc->pixel_size, threads);
             assert(ret == VLC_SUCCESS);
 
             for (size_t f = 0; conv->dsts[f].chroma != 0; ++f)
@@ -1157,25 +1614,13 @@ int main(void)
                 picture_t *dst = picture_NewFromFormat(&fmt);
                 assert(dst);
 
-                const uint8_t * src_planes[3] = { src->p[Y_PLANE].p_pixels,
-                                                  src->p[U_PLANE].p_pixels,
-                                                  src->p[V_PLANE].p_pixels };
-                const size_t    src_pitches[3] = { src->p[Y_PLANE].i_pitch,
-                                                   src->p[U_PLANE].i_pitch,
-                                                   src->p[V_PLANE].i_pitch };
-
-                fprintf(stderr, "testing: %u x %u (vis: %u x %u) %4.4s -> %4.4s\n",
+                fprintf(stderr, "testing: %u x %u (vis: %u x %u) %4.4s -> %4.4s"
+                        " (%u thread(s))\n",
                         size->i_width, size->i_height,
                         size->i_visible_width, size->i_visible_height,
                         (const char *) &src->format.i_chroma,
-                        (const char *) &dst->format.i_chroma);
-                if (test_dst->bitshift == 0)
-                    test_dst->conv(dst, src_planes, src_pitches,
-                                   src->format.i_visible_height, &cache);
-                else
-                    test_dst->conv16(dst, src_planes, src_pitches,
-                                   src->format.i_visible_height, test_dst->bitshift,
-                                   &cache);
+                        (const char *) &dst->format.i_chroma, threads);
+                test_conv(test_dst, dst, src, &cache);
                 piccheck(dst, dst_dsc, false);
                 picture_Release(dst);
             }
@@ -1183,6 +1628,9 @@ int main(void)
             CopyCleanCache(&cache);
         }
     }
+
+    bench(1);
+    bench(4);
     return 0;
 }
 
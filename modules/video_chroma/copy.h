@@ -36,16 +36,24 @@ extern "C" {
 #endif
 
 
+struct copy_slice;
+
 typedef struct {
 # ifdef CAN_COMPILE_SSE2
     uint8_t *buffer;
     size_t  size;
-# else
-    char dummy;
 # endif
+    /* Worker pool used to copy large pictures in horizontal slices */
+    struct vlc_executor *executor;
+    struct copy_slice *slices;
+    unsigned slice_count;
 } copy_cache_t;
 
 int  CopyInitCache(copy_cache_t *cache, unsigned width);
+
+/* Same as CopyInitCache(), but large pictures are split across up to threads
+ * threads. A value of 0 picks the number of threads from the CPU count. */
+int  CopyInitCacheThreads(copy_cache_t *cache, unsigned width, unsigned threads);
 void CopyCleanCache(copy_cache_t *cache);
 
 /* YUVY/RGB copies */
@@ -216,8 +216,10 @@ static int Create( filter_t *p_filter )
     if (!p_sys)
          return VLC_ENOMEM;
 
-    if( CopyInitCache( &p_sys->cache, ( p_filter->fmt_in.video.i_x_offset +
-                       p_filter->fmt_in.video.i_visible_width ) * pixel_bytes ) )
+    unsigned threads = var_InheritInteger( p_filter, "chroma-copy-threads" );
+    if( CopyInitCacheThreads( &p_sys->cache, ( p_filter->fmt_in.video.i_x_offset +
+                              p_filter->fmt_in.video.i_visible_width ) * pixel_bytes,
+                              threads ) )
         return VLC_ENOMEM;
 
     p_filter->p_sys = p_sys;
@@ -235,9 +237,17 @@ static void ProbeChroma(vlc_chroma_conv_vec *vec)
     vlc_chroma_conv_add(vec, COPY_COST, VLC_CODEC_I420_10L, VLC_CODEC_P010, true);
 }
 
+#define THREADS_TEXT N_("Threads")
+#define THREADS_LONGTEXT N_( \
+    "Number of threads used to copy large pictures " \
+    "(0 = automatic, 1 = single-threaded)." )
+
 vlc_module_begin ()
     set_description( N_("YUV planar to semiplanar conversions") )
     set_callback_video_converter( Create, 160 )
+    set_subcategory( SUBCAT_VIDEO_VFILTER )
+    add_integer_with_range( "chroma-copy-threads", 0, 0, 8,
+                            THREADS_TEXT, THREADS_LONGTEXT )
     add_submodule()
         set_callback_chroma_conv_probe(ProbeChroma)
 vlc_module_end ()
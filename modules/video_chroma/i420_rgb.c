@@ -29,6 +29,8 @@
 # include "config.h"
 #endif
 
+#include <assert.h>
+
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_filter.h>
@@ -38,12 +40,16 @@
 
 #include "i420_rgb.h"
 #include "../video_filter/filter_picture.h"
+#if defined (__SSE2__)
+# include <emmintrin.h>
+#endif
 #ifdef PLUGIN_PLAIN
 # include "i420_rgb_c.h"
 
 static void SetYUV( filter_t * );
 static void Set8bppPalette( filter_t *, uint8_t * );
 #endif
+static int PlanarInit( filter_t * );
 
 /*****************************************************************************
  * RGB2PIXEL: assemble RGB components to a pixel value, returns a uint32_t
@@ -71,7 +77,9 @@ static void ProbeChroma(vlc_chroma_conv_vec *vec)
     VLC_CODEC_BGR233, VLC_CODEC_BGR565, VLC_CODEC_BGR555
 #endif
 
-#if defined (PLUGIN_SSE2)
+#if defined (PLUGIN_AVX2)
+#define COST 0.6
+#elif defined (PLUGIN_SSE2)
 #define COST 0.75
 #else
 #define COST 1
@@ -79,16 +87,25 @@ static void ProbeChroma(vlc_chroma_conv_vec *vec)
 
     vlc_chroma_conv_add_in_outlist(vec, COST, VLC_CODEC_YV12, OUT_CHROMAS);
     vlc_chroma_conv_add_in_outlist(vec, COST, VLC_CODEC_I420, OUT_CHROMAS);
+    vlc_chroma_conv_add_in_outlist(vec, COST, VLC_CODEC_NV12, OUT_CHROMAS);
+    vlc_chroma_conv_add_in_outlist(vec, COST, VLC_CODEC_NV21, OUT_CHROMAS);
+    vlc_chroma_conv_add_in_outlist(vec, COST, VLC_CODEC_I420_10L, OUT_CHROMAS);
+    vlc_chroma_conv_add_in_outlist(vec, COST, VLC_CODEC_P010, OUT_CHROMAS);
 }
 
 vlc_module_begin ()
-#if defined (PLUGIN_SSE2)
-    set_description( N_( "SSE2 I420,IYUV,YV12 to "
+#if defined (PLUGIN_AVX2)
+    set_description( N_( "AVX2 I420,IYUV,YV12,NV12,NV21,P010,I0AL to "
+                        "RV15,RV16,RV24,RV32 conversions") )
+    set_callback_video_converter( Activate, 130 )
+# define vlc_CPU_capable() vlc_CPU_AVX2()
+#elif defined (PLUGIN_SSE2)
+    set_description( N_( "SSE2 I420,IYUV,YV12,NV12,NV21,P010,I0AL to "
                         "RV15,RV16,RV24,RV32 conversions") )
     set_callback_video_converter( Activate, 120 )
 # define vlc_CPU_capable() vlc_CPU_SSE2()
 #else
-    set_description( N_("I420,IYUV,YV12 to "
+    set_description( N_("I420,IYUV,YV12,NV12,NV21,P010,I0AL to "
                        "RGB8,RV15,RV16,RV24,RV32 conversions") )
     set_callback_video_converter( Activate, 80 )
 # define vlc_CPU_capable() (true)
@@ -109,6 +126,7 @@ VIDEO_FILTER_WRAPPER_CLOSE_EXT( I420_RGB8, Deactivate )
 VIDEO_FILTER_WRAPPER_CLOSE_EXT( I420_RGB16, Deactivate )
 VIDEO_FILTER_WRAPPER_CLOSE_EXT( I420_RGB32, Deactivate )
 #endif
+VIDEO_FILTER_WRAPPER_CLOSE( Planar, Deactivate )
 
 /*****************************************************************************
  * Activate: allocate a chroma function
@@ -117,6 +135,8 @@ VIDEO_FILTER_WRAPPER_CLOSE_EXT( I420_RGB32, Deactivate )
  *****************************************************************************/
 static int Activate( filter_t *p_filter )
 {
+    void (*pf_convert)( filter_t *, picture_t *, picture_t * );
+
     if( !vlc_CPU_capable() )
         return VLC_EGENERIC;
     if( p_filter->fmt_out.video.i_width & 1
@@ -130,10 +150,22 @@ static int Activate( filter_t *p_filter )
         return VLC_EGENERIC;
     }
 
+#ifdef PLUGIN_AVX2
+    /* The last 32 pixels of each line are converted backwards from the end
+     * of the line, which must thus be at least that wide. */
+    if( p_filter->fmt_in.video.i_x_offset
+      + p_filter->fmt_in.video.i_visible_width < 32 )
+        return VLC_EGENERIC;
+#endif
+
     switch( p_filter->fmt_in.video.i_chroma )
     {
         case VLC_CODEC_YV12:
         case VLC_CODEC_I420:
+        case VLC_CODEC_NV12:
+        case VLC_CODEC_NV21:
+        case VLC_CODEC_I420_10L:
+        case VLC_CODEC_P010:
             switch( p_filter->fmt_out.video.i_chroma )
             {
 #ifndef PLUGIN_PLAIN
@@ -141,46 +173,55 @@ static int Activate( filter_t *p_filter )
                     /* R5G6B5 pixel format */
                     msg_Dbg(p_filter, "RGB pixel format is R5G6B5");
                     p_filter->ops = &I420_R5G6B5_ops;
+                    pf_convert = I420_R5G6B5;
                     break;
                 case VLC_CODEC_RGB555:
                     /* R5G5B5 pixel format */
                     msg_Dbg(p_filter, "RGB pixel format is R5G5B5");
                     p_filter->ops = &I420_R5G5B5_ops;
+                    pf_convert = I420_R5G5B5;
                     break;
                 case VLC_CODEC_XRGB:
                     /* A8R8G8B8 pixel format */
                     msg_Dbg(p_filter, "RGB pixel format is XBGR");
                     p_filter->ops = &I420_A8R8G8B8_ops;
+                    pf_convert = I420_A8R8G8B8;
                     break;
                 case VLC_CODEC_RGBX:
                     /* R8G8B8A8 pixel format */
                     msg_Dbg(p_filter, "RGB pixel format is RGBX");
                     p_filter->ops = &I420_R8G8B8A8_ops;
+                    pf_convert = I420_R8G8B8A8;
                     break;
                 case VLC_CODEC_BGRX:
                     /* B8G8R8A8 pixel format */
                     msg_Dbg(p_filter, "RGB pixel format is BGRX");
                     p_filter->ops = &I420_B8G8R8A8_ops;
+                    pf_convert = I420_B8G8R8A8;
                     break;
                 case VLC_CODEC_XBGR:
                     /* A8B8G8R8 pixel format */
                     msg_Dbg(p_filter, "RGB pixel format is XBGR");
                     p_filter->ops = &I420_A8B8G8R8_ops;
+                    pf_convert = I420_A8B8G8R8;
                     break;
 #else
                 case VLC_CODEC_RGB233:
                 case VLC_CODEC_RGB332:
                 case VLC_CODEC_BGR233:
                     p_filter->ops = &I420_RGB8_ops;
+                    pf_convert = I420_RGB8;
                     break;
                 case VLC_CODEC_RGB565:
                 case VLC_CODEC_BGR565:
                 case VLC_CODEC_RGB555:
                 case VLC_CODEC_BGR555:
                     p_filter->ops = &I420_RGB16_ops;
+                    pf_convert = I420_RGB16;
                     break;
                 CASE_PACKED_RGBX
                     p_filter->ops = &I420_RGB32_ops;
+                    pf_convert = I420_RGB32;
                     break;
 #endif
                 default:
@@ -199,6 +240,26 @@ static int Activate( filter_t *p_filter )
 
     p_sys->i_buffer_size = 0;
     p_sys->p_buffer = NULL;
+    p_sys->p_planar = NULL;
+    p_sys->pf_convert = pf_convert;
+
+    switch( p_filter->fmt_in.video.i_chroma )
+    {
+        case VLC_CODEC_NV12:
+        case VLC_CODEC_NV21:
+        case VLC_CODEC_I420_10L:
+        case VLC_CODEC_P010:
+            msg_Dbg( p_filter, "converting %4.4s input to 8-bit planar first",
+                     (const char *)&p_filter->fmt_in.video.i_chroma );
+            if( PlanarInit( p_filter ) )
+            {
+                free( p_sys );
+                return VLC_ENOMEM;
+            }
+            p_filter->ops = &Planar_ops;
+            break;
+    }
+
     switch( p_filter->fmt_out.video.i_chroma )
     {
 #ifdef PLUGIN_PLAIN
@@ -217,6 +278,7 @@ static int Activate( filter_t *p_filter )
             p_sys->i_bytespp = 4;
             break;
         default:
+            aligned_free( p_sys->p_planar );
             free( p_sys );
             return VLC_EGENERIC;
     }
@@ -226,6 +288,7 @@ static int Activate( filter_t *p_filter )
                     * sizeof( int ) );
     if( p_sys->p_offset == NULL )
     {
+        aligned_free( p_sys->p_planar );
         free( p_sys );
         return VLC_EGENERIC;
     }
@@ -235,6 +298,7 @@ static int Activate( filter_t *p_filter )
     if( p_sys->p_base == NULL )
     {
         free( p_sys->p_offset );
+        aligned_free( p_sys->p_planar );
         free( p_sys );
         return -1;
     }
@@ -259,9 +323,221 @@ static void Deactivate( filter_t *p_filter )
 #endif
     free( p_sys->p_offset );
     free( p_sys->p_buffer );
+    aligned_free( p_sys->p_planar );
     free( p_sys );
 }
 
+/*****************************************************************************
+ * Planar: convert semi-planar and high bit depth pictures
+ *****************************************************************************
+ * The conversion functions only handle 8-bit planar input. Other 4:2:0
+ * layouts are first unpacked to 8-bit planes in a scratch buffer, which the
+ * conversion then reads from. The luma plane of NV12 and NV21 is used in
+ * place.
+ *****************************************************************************/
+static void SplitLine8( uint8_t *p_u, uint8_t *p_v, const uint8_t *p_in,
+                        unsigned i_width )
+{
+    unsigned x = 0;
+#if defined (__SSE2__)
+    const __m128i mask = _mm_set1_epi16( 0x00ff );
+
+    for( ; x + 16 <= i_width; x += 16 )
+    {
+        __m128i a = _mm_loadu_si128( (const __m128i *)&p_in[2 * x] );
+        __m128i b = _mm_loadu_si128( (const __m128i *)&p_in[2 * x + 16] );
+
+        _mm_storeu_si128( (__m128i *)&p_u[x],
+                          _mm_packus_epi16( _mm_and_si128( a, mask ),
+                                            _mm_and_si128( b, mask ) ) );
+        _mm_storeu_si128( (__m128i *)&p_v[x],
+                          _mm_packus_epi16( _mm_srli_epi16( a, 8 ),
+                                            _mm_srli_epi16( b, 8 ) ) );
+    }
+#endif
+    for( ; x < i_width; x++ )
+    {
+        p_u[x] = p_in[2 * x];
+        p_v[x] = p_in[2 * x + 1];
+    }
+}
+
+/* Keeps the 8 most significant bits of 16-bit samples, P010 style */
+static void SplitLine16( uint8_t *p_u, uint8_t *p_v, const uint16_t *p_in,
+                         unsigned i_width )
+{
+    unsigned x = 0;
+#if defined (__SSE2__)
+# define HI_U(a) _mm_srli_epi32( _mm_slli_epi32( a, 16 ), 24 )
+# define HI_V(a) _mm_srli_epi32( a, 24 )
+    for( ; x + 16 <= i_width; x += 16 )
+    {
+        __m128i a = _mm_loadu_si128( (const __m128i *)&p_in[2 * x] );
+        __m128i b = _mm_loadu_si128( (const __m128i *)&p_in[2 * x + 8] );
+        __m128i c = _mm_loadu_si128( (const __m128i *)&p_in[2 * x + 16] );
+        __m128i d = _mm_loadu_si128( (const __m128i *)&p_in[2 * x + 24] );
+
+        _mm_storeu_si128( (__m128i *)&p_u[x],
+            _mm_packus_epi16( _mm_packs_epi32( HI_U(a), HI_U(b) ),
+                              _mm_packs_epi32( HI_U(c), HI_U(d) ) ) );
+        _mm_storeu_si128( (__m128i *)&p_v[x],
+            _mm_packus_epi16( _mm_packs_epi32( HI_V(a), HI_V(b) ),
+                              _mm_packs_epi32( HI_V(c), HI_V(d) ) ) );
+    }
+# undef HI_V
+# undef HI_U
+#endif
+    for( ; x < i_width; x++ )
+    {
+        p_u[x] = p_in[2 * x] >> 8;
+        p_v[x] = p_in[2 * x + 1] >> 8;
+    }
+}
+
+/* Drops the i_shift least significant bits, saturating out of range values */
+static void NarrowLine16( uint8_t *p_out, const uint16_t *p_in,
+                          unsigned i_width, int i_shift )
+{
+    unsigned x = 0;
+
+    assert( i_shift > 0 );
+#if defined (__SSE2__)
+    const __m128i shift = _mm_cvtsi32_si128( i_shift );
+
+    for( ; x + 16 <= i_width; x += 16 )
+    {
+        __m128i a = _mm_loadu_si128( (const __m128i *)&p_in[x] );
+        __m128i b = _mm_loadu_si128( (const __m128i *)&p_in[x + 8] );
+
+        /* shifted values fit in 15 bits, the signed pack is fine */
+        a = _mm_srl_epi16( a, shift );
+        b = _mm_srl_epi16( b, shift );
+        _mm_storeu_si128( (__m128i *)&p_out[x], _mm_packus_epi16( a, b ) );
+    }
+#endif
+    for( ; x < i_width; x++ )
+    {
+        unsigned i_value = p_in[x] >> i_shift;
+        p_out[x] = i_value > 255 ? 255 : i_value;
+    }
+}
+
+static size_t SetPlanarPlane( plane_t *p_plane, unsigned i_width,
+                               unsigned i_lines, unsigned i_visible_width,
+                               unsigned i_visible_lines )
+{
+    p_plane->p_pixels = NULL;
+    p_plane->i_lines = i_lines;
+    p_plane->i_pitch = (i_width + 31) & ~31;
+    p_plane->i_pixel_pitch = 1;
+    p_plane->i_visible_lines = i_visible_lines;
+    p_plane->i_visible_pitch = i_visible_width;
+    return (size_t)p_plane->i_pitch * i_lines;
+}
+
+/* Sets up the scratch planes, which only depend on the input format */
+static int PlanarInit( filter_t *p_filter )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const video_format_t *fmt = &p_filter->fmt_in.video;
+    const bool b_luma = fmt->i_chroma == VLC_CODEC_I420_10L
+                     || fmt->i_chroma == VLC_CODEC_P010;
+    plane_t *planar = p_sys->planar;
+
+    /* Lines and samples per line actually read by the conversion */
+    const unsigned i_lines = fmt->i_y_offset + fmt->i_visible_height;
+    const unsigned i_width = fmt->i_x_offset + fmt->i_visible_width;
+
+    size_t i_size_y = SetPlanarPlane( &planar[Y_PLANE], i_width, i_lines,
+                                      fmt->i_visible_width,
+                                      fmt->i_visible_height );
+    size_t i_size_c = SetPlanarPlane( &planar[U_PLANE], (i_width + 1) / 2,
+                                      (i_lines + 1) / 2,
+                                      (fmt->i_visible_width + 1) / 2,
+                                      (fmt->i_visible_height + 1) / 2 );
+    planar[V_PLANE] = planar[U_PLANE];
+    /* the luma plane of 8-bit input is read in place */
+    if( !b_luma )
+        i_size_y = 0;
+
+    p_sys->p_planar = aligned_alloc( 32, i_size_y + 2 * i_size_c );
+    if( p_sys->p_planar == NULL )
+        return VLC_ENOMEM;
+
+    if( b_luma )
+        planar[Y_PLANE].p_pixels = p_sys->p_planar;
+    planar[U_PLANE].p_pixels = p_sys->p_planar + i_size_y;
+    planar[V_PLANE].p_pixels = planar[U_PLANE].p_pixels + i_size_c;
+    return VLC_SUCCESS;
+}
+
+static void Planar( filter_t *p_filter, picture_t *p_src, picture_t *p_dst )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const video_format_t *fmt = &p_filter->fmt_in.video;
+    const vlc_fourcc_t i_chroma = fmt->i_chroma;
+    picture_t planar = { .i_planes = 3 };
+
+    const unsigned i_lines = fmt->i_y_offset + fmt->i_visible_height;
+    const unsigned i_width = fmt->i_x_offset + fmt->i_visible_width;
+    const unsigned i_lines_c = (i_lines + 1) / 2;
+    const unsigned i_width_c = (i_width + 1) / 2;
+
+    for( int i = 0; i < 3; i++ )
+        planar.p[i] = p_sys->planar[i];
+    if( planar.p[Y_PLANE].p_pixels == NULL )
+        planar.p[Y_PLANE] = p_src->p[Y_PLANE];
+
+    const int i_pitch_u = planar.p[U_PLANE].i_pitch;
+    const int i_pitch_y = planar.p[Y_PLANE].i_pitch;
+
+    switch( i_chroma )
+    {
+        case VLC_CODEC_NV12:
+        case VLC_CODEC_NV21:
+        {
+            const bool b_swap = i_chroma == VLC_CODEC_NV21;
+            for( unsigned y = 0; y < i_lines_c; y++ )
+                SplitLine8( &planar.p[b_swap ? V_PLANE : U_PLANE].p_pixels[y * i_pitch_u],
+                            &planar.p[b_swap ? U_PLANE : V_PLANE].p_pixels[y * i_pitch_u],
+                            &p_src->p[1].p_pixels[y * p_src->p[1].i_pitch],
+                            i_width_c );
+            break;
+        }
+
+        case VLC_CODEC_P010:
+            for( unsigned y = 0; y < i_lines; y++ )
+                NarrowLine16( &planar.p[Y_PLANE].p_pixels[y * i_pitch_y],
+                              (const uint16_t *)&p_src->p[0].p_pixels[y * p_src->p[0].i_pitch],
+                              i_width, 8 );
+            for( unsigned y = 0; y < i_lines_c; y++ )
+                SplitLine16( &planar.p[U_PLANE].p_pixels[y * i_pitch_u],
+                             &planar.p[V_PLANE].p_pixels[y * i_pitch_u],
+                             (const uint16_t *)&p_src->p[1].p_pixels[y * p_src->p[1].i_pitch],
+                             i_width_c );
+            break;
+
+        case VLC_CODEC_I420_10L:
+            for( int i = 0; i < 3; i++ )
+            {
+                const unsigned i_plane_lines = i ? i_lines_c : i_lines;
+                const unsigned i_plane_width = i ? i_width_c : i_width;
+                const int i_pitch = i ? i_pitch_u : i_pitch_y;
+
+                for( unsigned y = 0; y < i_plane_lines; y++ )
+                    NarrowLine16( &planar.p[i].p_pixels[y * i_pitch],
+                                  (const uint16_t *)&p_src->p[i].p_pixels[y * p_src->p[i].i_pitch],
+                                  i_plane_width, 2 );
+            }
+            break;
+
+        default:
+            vlc_assert_unreachable();
+    }
+
+    p_sys->pf_convert( p_filter, &planar, p_dst );
+}
+
 #ifdef PLUGIN_PLAIN
 /*****************************************************************************
  * SetYUV: compute tables and set function pointers
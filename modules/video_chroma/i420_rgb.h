@@ -21,7 +21,7 @@
  *****************************************************************************/
 #include <limits.h>
 
-#if !defined (PLUGIN_SSE2)
+#if !defined (PLUGIN_SSE2) && !defined (PLUGIN_AVX2)
 # define PLUGIN_PLAIN
 #endif
 
@@ -41,6 +41,12 @@ typedef struct
     uint8_t   i_bytespp;
     int *p_offset;
 
+    /**< 8-bit planar conversion function */
+    void (*pf_convert)( filter_t *, picture_t *, picture_t * );
+    /**< Scratch 8-bit planes for semi-planar and high bit depth input */
+    uint8_t  *p_planar;
+    plane_t   planar[3];
+
 #ifdef PLUGIN_PLAIN
     /**< Pre-calculated conversion tables */
     void *p_base;                      /**< base for all conversion tables */
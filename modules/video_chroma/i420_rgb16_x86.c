@@ -31,9 +31,52 @@
 #include <vlc_cpu.h>
 
 #include "i420_rgb.h"
-#ifdef PLUGIN_SSE2
+#if defined (PLUGIN_SSE2)
 # include "i420_rgb_sse2.h"
 # define VLC_TARGET VLC_SSE
+# define SIMD_PIXELS 16
+# define SIMD_ALIGN  16
+# define SIMD_CALL                      SSE2_CALL
+# define SIMD_END                       SSE2_END
+# define SIMD_INIT_ALIGNED              SSE2_INIT_16_ALIGNED
+# define SIMD_INIT_UNALIGNED            SSE2_INIT_16_UNALIGNED
+# define SIMD_YUV_MUL                   SSE2_YUV_MUL
+# define SIMD_YUV_ADD                   SSE2_YUV_ADD
+# define SIMD_UNPACK_15_ALIGNED         SSE2_UNPACK_15_ALIGNED
+# define SIMD_UNPACK_15_UNALIGNED       SSE2_UNPACK_15_UNALIGNED
+# define SIMD_UNPACK_16_ALIGNED         SSE2_UNPACK_16_ALIGNED
+# define SIMD_UNPACK_16_UNALIGNED       SSE2_UNPACK_16_UNALIGNED
+# define SIMD_UNPACK_32_ARGB_ALIGNED    SSE2_UNPACK_32_ARGB_ALIGNED
+# define SIMD_UNPACK_32_ARGB_UNALIGNED  SSE2_UNPACK_32_ARGB_UNALIGNED
+# define SIMD_UNPACK_32_RGBA_ALIGNED    SSE2_UNPACK_32_RGBA_ALIGNED
+# define SIMD_UNPACK_32_RGBA_UNALIGNED  SSE2_UNPACK_32_RGBA_UNALIGNED
+# define SIMD_UNPACK_32_BGRA_ALIGNED    SSE2_UNPACK_32_BGRA_ALIGNED
+# define SIMD_UNPACK_32_BGRA_UNALIGNED  SSE2_UNPACK_32_BGRA_UNALIGNED
+# define SIMD_UNPACK_32_ABGR_ALIGNED    SSE2_UNPACK_32_ABGR_ALIGNED
+# define SIMD_UNPACK_32_ABGR_UNALIGNED  SSE2_UNPACK_32_ABGR_UNALIGNED
+#elif defined (PLUGIN_AVX2)
+# include "i420_rgb_avx2.h"
+# define VLC_TARGET VLC_AVX2
+# define SIMD_PIXELS 32
+# define SIMD_ALIGN  32
+# define SIMD_CALL                      AVX2_CALL
+# define SIMD_END                       AVX2_END
+# define SIMD_INIT_ALIGNED              AVX2_INIT_32_ALIGNED
+# define SIMD_INIT_UNALIGNED            AVX2_INIT_32_UNALIGNED
+# define SIMD_YUV_MUL                   AVX2_YUV_MUL
+# define SIMD_YUV_ADD                   AVX2_YUV_ADD
+# define SIMD_UNPACK_15_ALIGNED         AVX2_UNPACK_15_ALIGNED
+# define SIMD_UNPACK_15_UNALIGNED       AVX2_UNPACK_15_UNALIGNED
+# define SIMD_UNPACK_16_ALIGNED         AVX2_UNPACK_16_ALIGNED
+# define SIMD_UNPACK_16_UNALIGNED       AVX2_UNPACK_16_UNALIGNED
+# define SIMD_UNPACK_32_ARGB_ALIGNED    AVX2_UNPACK_32_ARGB_ALIGNED
+# define SIMD_UNPACK_32_ARGB_UNALIGNED  AVX2_UNPACK_32_ARGB_UNALIGNED
+# define SIMD_UNPACK_32_RGBA_ALIGNED    AVX2_UNPACK_32_RGBA_ALIGNED
+# define SIMD_UNPACK_32_RGBA_UNALIGNED  AVX2_UNPACK_32_RGBA_UNALIGNED
+# define SIMD_UNPACK_32_BGRA_ALIGNED    AVX2_UNPACK_32_BGRA_ALIGNED
+# define SIMD_UNPACK_32_BGRA_UNALIGNED  AVX2_UNPACK_32_BGRA_UNALIGNED
+# define SIMD_UNPACK_32_ABGR_ALIGNED    AVX2_UNPACK_32_ABGR_ALIGNED
+# define SIMD_UNPACK_32_ABGR_UNALIGNED  AVX2_UNPACK_32_ABGR_UNALIGNED
 #endif
 
 /*****************************************************************************
@@ -158,39 +201,39 @@ void I420_R5G5B5( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                     (p_filter->fmt_out.video.i_y_offset + p_filter->fmt_out.video.i_visible_height) :
                     (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height);
 
-#ifdef PLUGIN_SSE2
+#ifndef PLUGIN_PLAIN
 
-    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & 15;
+    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & (SIMD_PIXELS - 1);
 
     /*
-    ** SSE2 128 bits fetch/store instructions are faster
-    ** if memory access is 16 bytes aligned
+    ** SIMD fetch/store instructions are faster
+    ** if memory access is aligned to the vector size
     */
 
     p_buffer = b_hscale ? p_buffer_start : p_pic;
 
-    if( 0 == (15 & (p_src->p[Y_PLANE].i_pitch|
+    if( 0 == ((SIMD_ALIGN - 1) & (p_src->p[Y_PLANE].i_pitch|
                     p_dest->p->i_pitch|
                     ((intptr_t)p_y)|
                     ((intptr_t)p_buffer))) )
     {
-        /* use faster SSE2 aligned fetch and store */
+        /* use faster aligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)/16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)/SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_16_ALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_15_ALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_ALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_15_ALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
             /* Here we do some unaligned reads and duplicate conversions, but
              * at least we have all the pixels */
@@ -201,15 +244,15 @@ void I420_R5G5B5( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
 
-                SSE2_CALL (
-                    SSE2_INIT_16_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_15_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_15_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 2 );
@@ -225,23 +268,23 @@ void I420_R5G5B5( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
     }
     else
     {
-        /* use slower SSE2 unaligned fetch and store */
+        /* use slower unaligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)/16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)/SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_16_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_15_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_15_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
             /* Here we do some unaligned reads and duplicate conversions, but
              * at least we have all the pixels */
@@ -252,15 +295,15 @@ void I420_R5G5B5( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
 
-                SSE2_CALL (
-                    SSE2_INIT_16_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_15_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_15_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 2 );
@@ -275,8 +318,8 @@ void I420_R5G5B5( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
         }
     }
 
-    /* make sure all SSE2 stores are visible thereafter */
-    SSE2_END;
+    /* make sure all non-temporal stores are visible thereafter */
+    SIMD_END;
 #endif
 }
 
@@ -342,39 +385,39 @@ void I420_R5G6B5( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                     (p_filter->fmt_out.video.i_y_offset + p_filter->fmt_out.video.i_visible_height) :
                     (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height);
 
-#ifdef PLUGIN_SSE2
+#ifndef PLUGIN_PLAIN
 
-    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & 15;
+    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & (SIMD_PIXELS - 1);
 
     /*
-    ** SSE2 128 bits fetch/store instructions are faster
-    ** if memory access is 16 bytes aligned
+    ** SIMD fetch/store instructions are faster
+    ** if memory access is aligned to the vector size
     */
 
     p_buffer = b_hscale ? p_buffer_start : p_pic;
 
-    if( 0 == (15 & (p_src->p[Y_PLANE].i_pitch|
+    if( 0 == ((SIMD_ALIGN - 1) & (p_src->p[Y_PLANE].i_pitch|
                     p_dest->p->i_pitch|
                     ((intptr_t)p_y)|
                     ((intptr_t)p_buffer))) )
     {
-        /* use faster SSE2 aligned fetch and store */
+        /* use faster aligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)/16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)/SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_16_ALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_16_ALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_ALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_16_ALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
             /* Here we do some unaligned reads and duplicate conversions, but
              * at least we have all the pixels */
@@ -385,15 +428,15 @@ void I420_R5G6B5( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
 
-                SSE2_CALL (
-                    SSE2_INIT_16_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_16_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_16_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 2 );
@@ -409,23 +452,23 @@ void I420_R5G6B5( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
     }
     else
     {
-        /* use slower SSE2 unaligned fetch and store */
+        /* use slower unaligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)/16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)/SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL(
-                    SSE2_INIT_16_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_16_UNALIGNED
+                SIMD_CALL(
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_16_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
             /* Here we do some unaligned reads and duplicate conversions, but
              * at least we have all the pixels */
@@ -436,15 +479,15 @@ void I420_R5G6B5( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
 
-                SSE2_CALL(
-                    SSE2_INIT_16_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_16_UNALIGNED
+                SIMD_CALL(
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_16_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 2 );
@@ -459,8 +502,8 @@ void I420_R5G6B5( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
         }
     }
 
-    /* make sure all SSE2 stores are visible thereafter */
-    SSE2_END;
+    /* make sure all non-temporal stores are visible thereafter */
+    SIMD_END;
 #endif
 }
 
@@ -526,39 +569,39 @@ void I420_A8R8G8B8( filter_t *p_filter, picture_t *p_src,
                     (p_filter->fmt_out.video.i_y_offset + p_filter->fmt_out.video.i_visible_height) :
                     (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height);
 
-#ifdef PLUGIN_SSE2
+#ifndef PLUGIN_PLAIN
 
-    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & 15;
+    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & (SIMD_PIXELS - 1);
 
     /*
-    ** SSE2 128 bits fetch/store instructions are faster
-    ** if memory access is 16 bytes aligned
+    ** SIMD fetch/store instructions are faster
+    ** if memory access is aligned to the vector size
     */
 
     p_buffer = b_hscale ? p_buffer_start : p_pic;
 
-    if( 0 == (15 & (p_src->p[Y_PLANE].i_pitch|
+    if( 0 == ((SIMD_ALIGN - 1) & (p_src->p[Y_PLANE].i_pitch|
                     p_dest->p->i_pitch|
                     ((intptr_t)p_y)|
                     ((intptr_t)p_buffer))) )
     {
-        /* use faster SSE2 aligned fetch and store */
+        /* use faster aligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_32_ALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_ARGB_ALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_ALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_ARGB_ALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
 
             /* Here we do some unaligned reads and duplicate conversions, but
@@ -569,15 +612,15 @@ void I420_A8R8G8B8( filter_t *p_filter, picture_t *p_src,
                 p_u -= i_rewind >> 1;
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_ARGB_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_ARGB_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 4 );
@@ -593,23 +636,23 @@ void I420_A8R8G8B8( filter_t *p_filter, picture_t *p_src,
     }
     else
     {
-        /* use slower SSE2 unaligned fetch and store */
+        /* use slower unaligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_ARGB_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_ARGB_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
 
             /* Here we do some unaligned reads and duplicate conversions, but
@@ -620,15 +663,15 @@ void I420_A8R8G8B8( filter_t *p_filter, picture_t *p_src,
                 p_u -= i_rewind >> 1;
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_ARGB_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_ARGB_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 4 );
@@ -643,8 +686,8 @@ void I420_A8R8G8B8( filter_t *p_filter, picture_t *p_src,
         }
     }
 
-    /* make sure all SSE2 stores are visible thereafter */
-    SSE2_END;
+    /* make sure all non-temporal stores are visible thereafter */
+    SIMD_END;
 #endif
 }
 
@@ -709,39 +752,39 @@ void I420_R8G8B8A8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                     (p_filter->fmt_out.video.i_y_offset + p_filter->fmt_out.video.i_visible_height) :
                     (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height);
 
-#ifdef PLUGIN_SSE2
+#ifndef PLUGIN_PLAIN
 
-    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & 15;
+    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & (SIMD_PIXELS - 1);
 
     /*
-    ** SSE2 128 bits fetch/store instructions are faster
-    ** if memory access is 16 bytes aligned
+    ** SIMD fetch/store instructions are faster
+    ** if memory access is aligned to the vector size
     */
 
     p_buffer = b_hscale ? p_buffer_start : p_pic;
 
-    if( 0 == (15 & (p_src->p[Y_PLANE].i_pitch|
+    if( 0 == ((SIMD_ALIGN - 1) & (p_src->p[Y_PLANE].i_pitch|
                     p_dest->p->i_pitch|
                     ((intptr_t)p_y)|
                     ((intptr_t)p_buffer))) )
     {
-        /* use faster SSE2 aligned fetch and store */
+        /* use faster aligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_32_ALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_RGBA_ALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_ALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_RGBA_ALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
 
             /* Here we do some unaligned reads and duplicate conversions, but
@@ -752,15 +795,15 @@ void I420_R8G8B8A8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                 p_u -= i_rewind >> 1;
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_RGBA_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_RGBA_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 4 );
@@ -776,23 +819,23 @@ void I420_R8G8B8A8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
     }
     else
     {
-        /* use slower SSE2 unaligned fetch and store */
+        /* use slower unaligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_RGBA_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_RGBA_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
 
             /* Here we do some unaligned reads and duplicate conversions, but
@@ -803,15 +846,15 @@ void I420_R8G8B8A8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                 p_u -= i_rewind >> 1;
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_RGBA_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_RGBA_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 4 );
@@ -826,8 +869,8 @@ void I420_R8G8B8A8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
         }
     }
 
-    /* make sure all SSE2 stores are visible thereafter */
-    SSE2_END;
+    /* make sure all non-temporal stores are visible thereafter */
+    SIMD_END;
 #endif
 }
 
@@ -892,39 +935,39 @@ void I420_B8G8R8A8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                     (p_filter->fmt_out.video.i_y_offset + p_filter->fmt_out.video.i_visible_height) :
                     (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height);
 
-#ifdef PLUGIN_SSE2
+#ifndef PLUGIN_PLAIN
 
-    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & 15;
+    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & (SIMD_PIXELS - 1);
 
     /*
-    ** SSE2 128 bits fetch/store instructions are faster
-    ** if memory access is 16 bytes aligned
+    ** SIMD fetch/store instructions are faster
+    ** if memory access is aligned to the vector size
     */
 
     p_buffer = b_hscale ? p_buffer_start : p_pic;
 
-    if( 0 == (15 & (p_src->p[Y_PLANE].i_pitch|
+    if( 0 == ((SIMD_ALIGN - 1) & (p_src->p[Y_PLANE].i_pitch|
                     p_dest->p->i_pitch|
                     ((intptr_t)p_y)|
                     ((intptr_t)p_buffer))) )
     {
-        /* use faster SSE2 aligned fetch and store */
+        /* use faster aligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_32_ALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_BGRA_ALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_ALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_BGRA_ALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
 
             /* Here we do some unaligned reads and duplicate conversions, but
@@ -935,15 +978,15 @@ void I420_B8G8R8A8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                 p_u -= i_rewind >> 1;
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_BGRA_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_BGRA_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 4 );
@@ -959,23 +1002,23 @@ void I420_B8G8R8A8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
     }
     else
     {
-        /* use slower SSE2 unaligned fetch and store */
+        /* use slower unaligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_BGRA_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_BGRA_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
 
             /* Here we do some unaligned reads and duplicate conversions, but
@@ -986,15 +1029,15 @@ void I420_B8G8R8A8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                 p_u -= i_rewind >> 1;
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_BGRA_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_BGRA_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 4 );
@@ -1009,8 +1052,8 @@ void I420_B8G8R8A8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
         }
     }
 
-    /* make sure all SSE2 stores are visible thereafter */
-    SSE2_END;
+    /* make sure all non-temporal stores are visible thereafter */
+    SIMD_END;
 #endif
 }
 
@@ -1075,39 +1118,39 @@ void I420_A8B8G8R8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                     (p_filter->fmt_out.video.i_y_offset + p_filter->fmt_out.video.i_visible_height) :
                     (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height);
 
-#ifdef PLUGIN_SSE2
+#ifndef PLUGIN_PLAIN
 
-    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & 15;
+    i_rewind = (-(p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width)) & (SIMD_PIXELS - 1);
 
     /*
-    ** SSE2 128 bits fetch/store instructions are faster
-    ** if memory access is 16 bytes aligned
+    ** SIMD fetch/store instructions are faster
+    ** if memory access is aligned to the vector size
     */
 
     p_buffer = b_hscale ? p_buffer_start : p_pic;
 
-    if( 0 == (15 & (p_src->p[Y_PLANE].i_pitch|
+    if( 0 == ((SIMD_ALIGN - 1) & (p_src->p[Y_PLANE].i_pitch|
                     p_dest->p->i_pitch|
                     ((intptr_t)p_y)|
                     ((intptr_t)p_buffer))) )
     {
-        /* use faster SSE2 aligned fetch and store */
+        /* use faster aligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_32_ALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_ABGR_ALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_ALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_ABGR_ALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
 
             /* Here we do some unaligned reads and duplicate conversions, but
@@ -1118,15 +1161,15 @@ void I420_A8B8G8R8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                 p_u -= i_rewind >> 1;
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_ABGR_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_ABGR_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 4 );
@@ -1142,23 +1185,23 @@ void I420_A8B8G8R8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
     }
     else
     {
-        /* use slower SSE2 unaligned fetch and store */
+        /* use slower unaligned fetch and store */
         for( i_y = 0; i_y < (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height); i_y++ )
         {
             p_pic_start = p_pic;
 
-            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 16; i_x--; )
+            for ( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / SIMD_PIXELS; i_x--; )
             {
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_ABGR_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_ABGR_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
-                p_buffer += 16;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
+                p_buffer += SIMD_PIXELS;
             }
 
             /* Here we do some unaligned reads and duplicate conversions, but
@@ -1169,15 +1212,15 @@ void I420_A8B8G8R8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
                 p_u -= i_rewind >> 1;
                 p_v -= i_rewind >> 1;
                 p_buffer -= i_rewind;
-                SSE2_CALL (
-                    SSE2_INIT_32_UNALIGNED
-                    SSE2_YUV_MUL
-                    SSE2_YUV_ADD
-                    SSE2_UNPACK_32_ABGR_UNALIGNED
+                SIMD_CALL (
+                    SIMD_INIT_UNALIGNED
+                    SIMD_YUV_MUL
+                    SIMD_YUV_ADD
+                    SIMD_UNPACK_32_ABGR_UNALIGNED
                 );
-                p_y += 16;
-                p_u += 8;
-                p_v += 8;
+                p_y += SIMD_PIXELS;
+                p_u += SIMD_PIXELS / 2;
+                p_v += SIMD_PIXELS / 2;
             }
             SCALE_WIDTH;
             SCALE_HEIGHT( 420, 4 );
@@ -1192,7 +1235,7 @@ void I420_A8B8G8R8( filter_t *p_filter, picture_t *p_src, picture_t *p_dest )
         }
     }
 
-    /* make sure all SSE2 stores are visible thereafter */
-    SSE2_END;
+    /* make sure all non-temporal stores are visible thereafter */
+    SIMD_END;
 #endif
 }
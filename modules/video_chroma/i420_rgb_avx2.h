@@ -0,0 +1,186 @@
+/*****************************************************************************
+ * i420_rgb_avx2.h: AVX2 YUV transformation intrinsics
+ *****************************************************************************
+ * Copyright (C) 2025 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* These are the SSE2 macros of i420_rgb_sse2.h widened to 32 pixels. The
+ * arithmetic is exactly the same, so both variants give identical output.
+ *
+ * 256-bit unpack and pack instructions work on each 128-bit lane on its
+ * own: after AVX2_YUV_ADD the low lane holds pixels 0-15 and the high lane
+ * pixels 16-31, and the UNPACK macros swap lanes back in place before
+ * storing. */
+
+#include <immintrin.h>
+
+#define AVX2_CALL(AVX2_INSTRUCTIONS)        \
+    do {                                    \
+        __m256i ymm0, ymm1, ymm2, ymm3,     \
+                ymm4, ymm5, ymm6, ymm7;     \
+        AVX2_INSTRUCTIONS                   \
+    } while(0)
+
+#define AVX2_END  _mm_sfence()
+
+#define AVX2_INIT_32_ALIGNED                                        \
+    ymm0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *)p_u));   \
+    ymm1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *)p_v));   \
+    ymm6 = _mm256_load_si256((__m256i *)p_y);
+
+#define AVX2_INIT_32_UNALIGNED                                      \
+    ymm0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *)p_u));   \
+    ymm1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *)p_v));   \
+    ymm6 = _mm256_loadu_si256((__m256i *)p_y);                      \
+    _mm_prefetch(p_buffer, _MM_HINT_NTA);
+
+#define AVX2_YUV_MUL                            \
+    ymm5 = _mm256_set1_epi32(0x00800080UL);     \
+    ymm0 = _mm256_subs_epi16(ymm0, ymm5);       \
+    ymm1 = _mm256_subs_epi16(ymm1, ymm5);       \
+    ymm0 = _mm256_slli_epi16(ymm0, 3);          \
+    ymm1 = _mm256_slli_epi16(ymm1, 3);          \
+    ymm5 = _mm256_set1_epi32(0xf37df37dUL);     \
+    ymm2 = _mm256_mulhi_epi16(ymm0, ymm5);      \
+    ymm5 = _mm256_set1_epi32(0xe5fce5fcUL);     \
+    ymm3 = _mm256_mulhi_epi16(ymm1, ymm5);      \
+    ymm5 = _mm256_set1_epi32(0x40934093UL);     \
+    ymm0 = _mm256_mulhi_epi16(ymm0, ymm5);      \
+    ymm5 = _mm256_set1_epi32(0x33123312UL);     \
+    ymm1 = _mm256_mulhi_epi16(ymm1, ymm5);      \
+    ymm2 = _mm256_adds_epi16(ymm2, ymm3);       \
+    \
+    ymm5 = _mm256_set1_epi32(0x10101010UL);     \
+    ymm6 = _mm256_subs_epu8(ymm6, ymm5);        \
+    ymm5 = _mm256_set1_epi32(0x00ff00ffUL);     \
+    ymm7 = _mm256_srli_epi16(ymm6, 8);          \
+    ymm6 = _mm256_and_si256(ymm6, ymm5);        \
+    ymm6 = _mm256_slli_epi16(ymm6, 3);          \
+    ymm7 = _mm256_slli_epi16(ymm7, 3);          \
+    ymm5 = _mm256_set1_epi32(0x253f253fUL);     \
+    ymm6 = _mm256_mulhi_epi16(ymm6, ymm5);      \
+    ymm7 = _mm256_mulhi_epi16(ymm7, ymm5);
+
+#define AVX2_YUV_ADD                            \
+    ymm3 = _mm256_adds_epi16(ymm0, ymm7);       \
+    ymm4 = _mm256_adds_epi16(ymm1, ymm7);       \
+    ymm5 = _mm256_adds_epi16(ymm2, ymm7);       \
+    ymm0 = _mm256_adds_epi16(ymm0, ymm6);       \
+    ymm1 = _mm256_adds_epi16(ymm1, ymm6);       \
+    ymm2 = _mm256_adds_epi16(ymm2, ymm6);       \
+    \
+    ymm0 = _mm256_packus_epi16(ymm0, ymm0);     \
+    ymm1 = _mm256_packus_epi16(ymm1, ymm1);     \
+    ymm2 = _mm256_packus_epi16(ymm2, ymm2);     \
+    \
+    ymm3 = _mm256_packus_epi16(ymm3, ymm3);     \
+    ymm4 = _mm256_packus_epi16(ymm4, ymm4);     \
+    ymm5 = _mm256_packus_epi16(ymm5, ymm5);     \
+    \
+    ymm0 = _mm256_unpacklo_epi8(ymm0, ymm3);    \
+    ymm1 = _mm256_unpacklo_epi8(ymm1, ymm4);    \
+    ymm2 = _mm256_unpacklo_epi8(ymm2, ymm5);
+
+/* ymm3: pixels 0-7 and 16-23, ymm6: pixels 8-15 and 24-31 */
+#define AVX2_STORE_16(STORE)                                            \
+    STORE((__m256i*)p_buffer,                                           \
+          _mm256_permute2x128_si256(ymm3, ymm6, 0x20));                 \
+    STORE((__m256i*)(p_buffer+16),                                      \
+          _mm256_permute2x128_si256(ymm3, ymm6, 0x31));
+
+#define AVX2_UNPACK_15(STORE)                       \
+    ymm5 = _mm256_set1_epi32(0xf8f8f8f8UL);         \
+    ymm0 = _mm256_and_si256(ymm0, ymm5);            \
+    ymm0 = _mm256_srli_epi16(ymm0, 3);              \
+    ymm2 = _mm256_and_si256(ymm2, ymm5);            \
+    ymm1 = _mm256_and_si256(ymm1, ymm5);            \
+    ymm1 = _mm256_srli_epi16(ymm1, 1);              \
+    ymm4 = _mm256_setzero_si256();                  \
+    \
+    ymm5 = _mm256_unpacklo_epi8(ymm2, ymm4);        \
+    ymm3 = _mm256_unpacklo_epi8(ymm0, ymm1);        \
+    ymm5 = _mm256_slli_epi16(ymm5, 2);              \
+    ymm3 = _mm256_or_si256(ymm3, ymm5);             \
+    \
+    ymm7 = _mm256_unpackhi_epi8(ymm2, ymm4);        \
+    ymm6 = _mm256_unpackhi_epi8(ymm0, ymm1);        \
+    ymm7 = _mm256_slli_epi16(ymm7, 2);              \
+    ymm6 = _mm256_or_si256(ymm6, ymm7);             \
+    AVX2_STORE_16(STORE)
+
+#define AVX2_UNPACK_16(STORE)                       \
+    ymm5 = _mm256_set1_epi32(0xf8f8f8f8UL);         \
+    ymm0 = _mm256_and_si256(ymm0, ymm5);            \
+    ymm1 = _mm256_and_si256(ymm1, ymm5);            \
+    ymm5 = _mm256_set1_epi32(0xfcfcfcfcUL);         \
+    ymm2 = _mm256_and_si256(ymm2, ymm5);            \
+    ymm0 = _mm256_srli_epi16(ymm0, 3);              \
+    ymm4 = _mm256_setzero_si256();                  \
+    \
+    ymm5 = _mm256_unpacklo_epi8(ymm2, ymm4);        \
+    ymm3 = _mm256_unpacklo_epi8(ymm0, ymm1);        \
+    ymm5 = _mm256_slli_epi16(ymm5, 3);              \
+    ymm3 = _mm256_or_si256(ymm3, ymm5);             \
+    \
+    ymm7 = _mm256_unpackhi_epi8(ymm2, ymm4);        \
+    ymm6 = _mm256_unpackhi_epi8(ymm0, ymm1);        \
+    ymm7 = _mm256_slli_epi16(ymm7, 3);              \
+    ymm6 = _mm256_or_si256(ymm6, ymm7);             \
+    AVX2_STORE_16(STORE)
+
+/* Interleaves the bytes of a, b, c and d, in that memory order. ymm0-ymm2
+ * hold blue, red and green, and ymm3 is zero. */
+#define AVX2_UNPACK_32(a, b, c, d, STORE)                               \
+    ymm3 = _mm256_setzero_si256();                                      \
+    ymm4 = _mm256_unpacklo_epi8(a, b);                                  \
+    ymm5 = _mm256_unpacklo_epi8(c, d);                                  \
+    ymm6 = _mm256_unpacklo_epi16(ymm4, ymm5);                           \
+    ymm7 = _mm256_unpackhi_epi16(ymm4, ymm5);                           \
+    ymm4 = _mm256_unpackhi_epi8(a, b);                                  \
+    ymm5 = _mm256_unpackhi_epi8(c, d);                                  \
+    ymm0 = _mm256_unpacklo_epi16(ymm4, ymm5);                           \
+    ymm1 = _mm256_unpackhi_epi16(ymm4, ymm5);                           \
+    STORE((__m256i*)(p_buffer),                                         \
+          _mm256_permute2x128_si256(ymm6, ymm7, 0x20));                 \
+    STORE((__m256i*)(p_buffer+8),                                       \
+          _mm256_permute2x128_si256(ymm0, ymm1, 0x20));                 \
+    STORE((__m256i*)(p_buffer+16),                                      \
+          _mm256_permute2x128_si256(ymm6, ymm7, 0x31));                 \
+    STORE((__m256i*)(p_buffer+24),                                      \
+          _mm256_permute2x128_si256(ymm0, ymm1, 0x31));
+
+#define AVX2_UNPACK_15_ALIGNED   AVX2_UNPACK_15(_mm256_stream_si256)
+#define AVX2_UNPACK_15_UNALIGNED AVX2_UNPACK_15(_mm256_storeu_si256)
+#define AVX2_UNPACK_16_ALIGNED   AVX2_UNPACK_16(_mm256_stream_si256)
+#define AVX2_UNPACK_16_UNALIGNED AVX2_UNPACK_16(_mm256_storeu_si256)
+
+#define AVX2_UNPACK_32_ARGB_ALIGNED \
+    AVX2_UNPACK_32(ymm0, ymm2, ymm1, ymm3, _mm256_stream_si256)
+#define AVX2_UNPACK_32_ARGB_UNALIGNED \
+    AVX2_UNPACK_32(ymm0, ymm2, ymm1, ymm3, _mm256_storeu_si256)
+#define AVX2_UNPACK_32_RGBA_ALIGNED \
+    AVX2_UNPACK_32(ymm3, ymm0, ymm2, ymm1, _mm256_stream_si256)
+#define AVX2_UNPACK_32_RGBA_UNALIGNED \
+    AVX2_UNPACK_32(ymm3, ymm0, ymm2, ymm1, _mm256_storeu_si256)
+#define AVX2_UNPACK_32_BGRA_ALIGNED \
+    AVX2_UNPACK_32(ymm3, ymm1, ymm2, ymm0, _mm256_stream_si256)
+#define AVX2_UNPACK_32_BGRA_UNALIGNED \
+    AVX2_UNPACK_32(ymm3, ymm1, ymm2, ymm0, _mm256_storeu_si256)
+#define AVX2_UNPACK_32_ABGR_ALIGNED \
+    AVX2_UNPACK_32(ymm1, ymm2, ymm0, ymm3, _mm256_stream_si256)
+#define AVX2_UNPACK_32_ABGR_UNALIGNED \
+    AVX2_UNPACK_32(ymm1, ymm2, ymm0, ymm3, _mm256_storeu_si256)
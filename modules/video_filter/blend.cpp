@@ -33,15 +33,28 @@
 #include <vlc_picture.h>
 #include "filter_picture.h"
 
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#elif defined(__ARM_NEON)
+# include <arm_neon.h>
+#endif
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
 static int  Open (filter_t *);
 static void Close(filter_t *);
 
+#define FAST_TEXT N_("Fast blending")
+#define FAST_LONGTEXT N_("Use the specialised SIMD routines for the common " \
+    "subpicture and video chromas. Disabling it selects the generic C " \
+    "routines, which give the same result.")
+
 vlc_module_begin()
     set_description(N_("Video pictures blending"))
     set_callback_video_blending(Open, 100)
+    set_subcategory(SUBCAT_VIDEO_VFILTER)
+    add_bool("blend-fast", true, FAST_TEXT, FAST_LONGTEXT)
 vlc_module_end()
 
 static inline unsigned div255(unsigned v)
@@ -604,6 +617,730 @@ void Blend(const CPicture &dst_data, const CPicture &src_data,
     }
 }
 
+/*****************************************************************************
+ * Span based blending
+ *****************************************************************************
+ * The usual subpicture chromas (YUVA, RGBA, YUVP) blended onto the usual
+ * video chromas go through the routines below instead of Blend<>. The
+ * effective alpha of a chunk of source pixels is computed first, fully
+ * transparent groups of pixels are skipped without touching the
+ * destination, and the remaining spans are merged one plane at a time with
+ * SIMD kernels. The result is identical to Blend<>, which stays the
+ * reference implementation.
+ *****************************************************************************/
+#define BLEND_CHUNK 256
+#define BLEND_GROUP 16
+
+namespace {
+
+#if defined(__SSE2__)
+static inline __m128i div255_epi16(__m128i v)
+{
+    v = _mm_add_epi16(v, _mm_srli_epi16(v, 8));
+    v = _mm_add_epi16(v, _mm_set1_epi16(1));
+    return _mm_srli_epi16(v, 8);
+}
+
+static inline __m128i div255_epi32(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_srli_epi32(v, 8));
+    v = _mm_add_epi32(v, _mm_set1_epi32(1));
+    return _mm_srli_epi32(v, 8);
+}
+
+static inline __m128i merge_epi16(__m128i d, __m128i s, __m128i f)
+{
+    const __m128i g = _mm_sub_epi16(_mm_set1_epi16(255), f);
+    return div255_epi16(_mm_add_epi16(_mm_mullo_epi16(d, g),
+                                      _mm_mullo_epi16(s, f)));
+}
+#endif
+
+/**
+ * Merges n 8 bits samples: dst = div255((255 - a) * dst + a * src).
+ *
+ * A null alpha leaves the destination unchanged as div255() is exact on 8
+ * bits, so transparent pixels inside a span need no special care.
+ */
+static void MergeRow(uint8_t *dst, const uint8_t *src, const uint8_t *a,
+                     unsigned n)
+{
+    unsigned i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        const __m128i d = _mm_loadu_si128((const __m128i *)&dst[i]);
+        const __m128i s = _mm_loadu_si128((const __m128i *)&src[i]);
+        const __m128i f = _mm_loadu_si128((const __m128i *)&a[i]);
+        const __m128i lo = merge_epi16(_mm_unpacklo_epi8(d, zero),
+                                       _mm_unpacklo_epi8(s, zero),
+                                       _mm_unpacklo_epi8(f, zero));
+        const __m128i hi = merge_epi16(_mm_unpackhi_epi8(d, zero),
+                                       _mm_unpackhi_epi8(s, zero),
+                                       _mm_unpackhi_epi8(f, zero));
+        _mm_storeu_si128((__m128i *)&dst[i], _mm_packus_epi16(lo, hi));
+    }
+#elif defined(__ARM_NEON)
+    const uint16x8_t one = vdupq_n_u16(1);
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16_t d = vld1q_u8(&dst[i]);
+        const uint8x16_t s = vld1q_u8(&src[i]);
+        const uint8x16_t f = vld1q_u8(&a[i]);
+        const uint8x16_t g = vmvnq_u8(f);
+        uint16x8_t lo = vmull_u8(vget_low_u8(d), vget_low_u8(g));
+        uint16x8_t hi = vmull_u8(vget_high_u8(d), vget_high_u8(g));
+        lo = vmlal_u8(lo, vget_low_u8(s), vget_low_u8(f));
+        hi = vmlal_u8(hi, vget_high_u8(s), vget_high_u8(f));
+        lo = vaddq_u16(vaddq_u16(lo, vshrq_n_u16(lo, 8)), one);
+        hi = vaddq_u16(vaddq_u16(hi, vshrq_n_u16(hi, 8)), one);
+        vst1q_u8(&dst[i], vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+    }
+#endif
+    for (; i < n; i++)
+        ::merge(&dst[i], src[i], a[i]);
+}
+
+/**
+ * Merges n high bit depth samples (up to 15 bits).
+ *
+ * div255() is not exact above 8 bits, so samples with a null alpha are
+ * explicitly left untouched like Blend<> does.
+ */
+static void MergeRow(uint16_t *dst, const uint16_t *src, const uint8_t *a,
+                     unsigned n)
+{
+    unsigned i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(255);
+    for (; i + 8 <= n; i += 8) {
+        const __m128i d = _mm_loadu_si128((const __m128i *)&dst[i]);
+        const __m128i s = _mm_loadu_si128((const __m128i *)&src[i]);
+        const __m128i f = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&a[i]),
+                                            zero);
+        const __m128i g = _mm_sub_epi16(max, f);
+        __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(d, s),
+                                    _mm_unpacklo_epi16(g, f));
+        __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(d, s),
+                                    _mm_unpackhi_epi16(g, f));
+        __m128i r = _mm_packs_epi32(div255_epi32(lo), div255_epi32(hi));
+        const __m128i skip = _mm_cmpeq_epi16(f, zero);
+        r = _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, r));
+        _mm_storeu_si128((__m128i *)&dst[i], r);
+    }
+#elif defined(__ARM_NEON)
+    const uint16x8_t max = vdupq_n_u16(255);
+    const uint32x4_t one = vdupq_n_u32(1);
+    for (; i + 8 <= n; i += 8) {
+        const uint16x8_t d = vld1q_u16(&dst[i]);
+        const uint16x8_t s = vld1q_u16(&src[i]);
+        const uint16x8_t f = vmovl_u8(vld1_u8(&a[i]));
+        const uint16x8_t g = vsubq_u16(max, f);
+        uint32x4_t lo = vmull_u16(vget_low_u16(d), vget_low_u16(g));
+        uint32x4_t hi = vmull_u16(vget_high_u16(d), vget_high_u16(g));
+        lo = vmlal_u16(lo, vget_low_u16(s), vget_low_u16(f));
+        hi = vmlal_u16(hi, vget_high_u16(s), vget_high_u16(f));
+        lo = vaddq_u32(vaddq_u32(lo, vshrq_n_u32(lo, 8)), one);
+        hi = vaddq_u32(vaddq_u32(hi, vshrq_n_u32(hi, 8)), one);
+        const uint16x8_t r = vcombine_u16(vshrn_n_u32(lo, 8), vshrn_n_u32(hi, 8));
+        vst1q_u16(&dst[i], vbslq_u16(vceqq_u16(f, vdupq_n_u16(0)), d, r));
+    }
+#endif
+    for (; i < n; i++) {
+        if (a[i] > 0)
+            ::merge(&dst[i], src[i], a[i]);
+    }
+}
+
+/* a = div255(alpha * src) */
+static void ScaleAlpha(uint8_t *a, const uint8_t *src, unsigned alpha,
+                       unsigned n)
+{
+    if (alpha >= 255) {
+        /* div255(255 * v) == v */
+        if (a != src)
+            memcpy(a, src, n);
+        return;
+    }
+    unsigned i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i f = _mm_set1_epi16(alpha);
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)&src[i]);
+        const __m128i lo = div255_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), f));
+        const __m128i hi = div255_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), f));
+        _mm_storeu_si128((__m128i *)&a[i], _mm_packus_epi16(lo, hi));
+    }
+#elif defined(__ARM_NEON)
+    const uint8x8_t f = vdup_n_u8(alpha);
+    const uint16x8_t one = vdupq_n_u16(1);
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16_t v = vld1q_u8(&src[i]);
+        uint16x8_t lo = vmull_u8(vget_low_u8(v), f);
+        uint16x8_t hi = vmull_u8(vget_high_u8(v), f);
+        lo = vaddq_u16(vaddq_u16(lo, vshrq_n_u16(lo, 8)), one);
+        hi = vaddq_u16(vaddq_u16(hi, vshrq_n_u16(hi, 8)), one);
+        vst1q_u8(&a[i], vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+    }
+#endif
+    for (; i < n; i++)
+        a[i] = div255(alpha * src[i]);
+}
+
+/* Keeps the even samples of src, returns the number of samples written */
+static unsigned Decimate(uint8_t *dst, const uint8_t *src, unsigned n)
+{
+    unsigned i = 0;
+#if defined(__SSE2__)
+    const __m128i even = _mm_set1_epi16(0x00ff);
+    for (; 2 * i + 32 <= n; i += 16) {
+        const __m128i v0 = _mm_loadu_si128((const __m128i *)&src[2 * i]);
+        const __m128i v1 = _mm_loadu_si128((const __m128i *)&src[2 * i + 16]);
+        _mm_storeu_si128((__m128i *)&dst[i],
+                         _mm_packus_epi16(_mm_and_si128(v0, even),
+                                          _mm_and_si128(v1, even)));
+    }
+#elif defined(__ARM_NEON)
+    for (; 2 * i + 32 <= n; i += 16)
+        vst1q_u8(&dst[i], vld2q_u8(&src[2 * i]).val[0]);
+#endif
+    for (; 2 * i < n; i++)
+        dst[i] = src[2 * i];
+    return i;
+}
+
+/* dst[2i] = u[i], dst[2i + 1] = v[i] */
+static void Interleave(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                       unsigned n)
+{
+    unsigned i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        const __m128i vu = _mm_loadu_si128((const __m128i *)&u[i]);
+        const __m128i vv = _mm_loadu_si128((const __m128i *)&v[i]);
+        _mm_storeu_si128((__m128i *)&dst[2 * i], _mm_unpacklo_epi8(vu, vv));
+        _mm_storeu_si128((__m128i *)&dst[2 * i + 16], _mm_unpackhi_epi8(vu, vv));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x2_t uv;
+        uv.val[0] = vld1q_u8(&u[i]);
+        uv.val[1] = vld1q_u8(&v[i]);
+        vst2q_u8(&dst[2 * i], uv);
+    }
+#endif
+    for (; i < n; i++) {
+        dst[2 * i + 0] = u[i];
+        dst[2 * i + 1] = v[i];
+    }
+}
+
+static inline bool IsTransparent(const uint8_t *a, unsigned n)
+{
+    if (n == BLEND_GROUP) {
+        uint64_t v[2];
+        memcpy(v, a, sizeof(v));
+        return (v[0] | v[1]) == 0;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        if (a[i] > 0)
+            return false;
+    }
+    return true;
+}
+
+static inline const uint8_t *ToDepth(uint8_t *, const uint8_t *src,
+                                     unsigned, unsigned)
+{
+    return src;
+}
+
+static inline const uint16_t *ToDepth(uint16_t *dst, const uint8_t *src,
+                                      unsigned n, unsigned bits)
+{
+    const unsigned max = (1 << bits) - 1;
+    for (unsigned i = 0; i < n; i++)
+        dst[i] = src[i] * max / 255;
+    return dst;
+}
+
+/* Same fixed point constants as yuv_to_rgb() */
+#define YUV_FIX(x) ((int)((x) * (1 << 10) + 0.5))
+static const int yuv_fix_y  = YUV_FIX(255.0/219.0);
+static const int yuv_fix_rv = YUV_FIX(1.40200*255.0/224.0);
+static const int yuv_fix_gu = YUV_FIX(0.34414*255.0/224.0);
+static const int yuv_fix_gv = YUV_FIX(0.71414*255.0/224.0);
+static const int yuv_fix_bu = YUV_FIX(1.77200*255.0/224.0);
+#undef YUV_FIX
+
+/* Converts n pixels with yuv_to_rgb() */
+static void YuvToRgbRow(uint8_t *const rgb[3], const uint8_t *y,
+                        const uint8_t *u, const uint8_t *v, unsigned n)
+{
+    unsigned i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k_r  = _mm_setr_epi16(yuv_fix_y, yuv_fix_rv, yuv_fix_y, yuv_fix_rv,
+                                        yuv_fix_y, yuv_fix_rv, yuv_fix_y, yuv_fix_rv);
+    const __m128i k_gu = _mm_setr_epi16(yuv_fix_y, -yuv_fix_gu, yuv_fix_y, -yuv_fix_gu,
+                                        yuv_fix_y, -yuv_fix_gu, yuv_fix_y, -yuv_fix_gu);
+    const __m128i k_gv = _mm_setr_epi16(-yuv_fix_gv, 512, -yuv_fix_gv, 512,
+                                        -yuv_fix_gv, 512, -yuv_fix_gv, 512);
+    const __m128i k_b  = _mm_setr_epi16(yuv_fix_y, yuv_fix_bu, yuv_fix_y, yuv_fix_bu,
+                                        yuv_fix_y, yuv_fix_bu, yuv_fix_y, yuv_fix_bu);
+    const __m128i half = _mm_set1_epi32(512);
+    const __m128i one = _mm_set1_epi16(1);
+    for (; i + 8 <= n; i += 8) {
+        const __m128i vy = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&y[i]), zero),
+                                         _mm_set1_epi16(16));
+        const __m128i vu = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&u[i]), zero),
+                                         _mm_set1_epi16(128));
+        const __m128i vv = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&v[i]), zero),
+                                         _mm_set1_epi16(128));
+        const __m128i yv[2] = { _mm_unpacklo_epi16(vy, vv), _mm_unpackhi_epi16(vy, vv) };
+        const __m128i yu[2] = { _mm_unpacklo_epi16(vy, vu), _mm_unpackhi_epi16(vy, vu) };
+        const __m128i v1[2] = { _mm_unpacklo_epi16(vv, one), _mm_unpackhi_epi16(vv, one) };
+        __m128i r[2], g[2], b[2];
+        for (unsigned h = 0; h < 2; h++) {
+            r[h] = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yv[h], k_r), half), 10);
+            g[h] = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu[h], k_gu),
+                                                _mm_madd_epi16(v1[h], k_gv)), 10);
+            b[h] = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu[h], k_b), half), 10);
+        }
+        _mm_storel_epi64((__m128i *)&rgb[0][i],
+                         _mm_packus_epi16(_mm_packs_epi32(r[0], r[1]), zero));
+        _mm_storel_epi64((__m128i *)&rgb[1][i],
+                         _mm_packus_epi16(_mm_packs_epi32(g[0], g[1]), zero));
+        _mm_storel_epi64((__m128i *)&rgb[2][i],
+                         _mm_packus_epi16(_mm_packs_epi32(b[0], b[1]), zero));
+    }
+#elif defined(__ARM_NEON)
+    const int32x4_t half = vdupq_n_s32(512);
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t vy = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(&y[i]))),
+                                       vdupq_n_s16(16));
+        const int16x8_t vu = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(&u[i]))),
+                                       vdupq_n_s16(128));
+        const int16x8_t vv = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(&v[i]))),
+                                       vdupq_n_s16(128));
+        int32x4_t r[2], g[2], b[2];
+        for (unsigned h = 0; h < 2; h++) {
+            const int16x4_t hy = h ? vget_high_s16(vy) : vget_low_s16(vy);
+            const int16x4_t hu = h ? vget_high_s16(vu) : vget_low_s16(vu);
+            const int16x4_t hv = h ? vget_high_s16(vv) : vget_low_s16(vv);
+            const int32x4_t ly = vmlaq_n_s32(half, vmovl_s16(hy), yuv_fix_y);
+            r[h] = vshrq_n_s32(vmlal_n_s16(ly, hv, yuv_fix_rv), 10);
+            g[h] = vshrq_n_s32(vmlal_n_s16(vmlal_n_s16(ly, hu, -yuv_fix_gu),
+                                           hv, -yuv_fix_gv), 10);
+            b[h] = vshrq_n_s32(vmlal_n_s16(ly, hu, yuv_fix_bu), 10);
+        }
+        vst1_u8(&rgb[0][i], vqmovun_s16(vcombine_s16(vqmovn_s32(r[0]), vqmovn_s32(r[1]))));
+        vst1_u8(&rgb[1][i], vqmovun_s16(vcombine_s16(vqmovn_s32(g[0]), vqmovn_s32(g[1]))));
+        vst1_u8(&rgb[2][i], vqmovun_s16(vcombine_s16(vqmovn_s32(b[0]), vqmovn_s32(b[1]))));
+    }
+#endif
+    for (; i < n; i++) {
+        int r, g, b;
+        yuv_to_rgb(&r, &g, &b, y[i], u[i], v[i]);
+        rgb[0][i] = r;
+        rgb[1][i] = g;
+        rgb[2][i] = b;
+    }
+}
+
+/* Splits n packed 4 bytes pixels into 3 planes, the 4th byte is dropped */
+static void DeinterleaveRow(uint8_t *const out[3], const uint8_t *px, unsigned n)
+{
+    unsigned i = 0;
+#if defined(__SSE2__)
+    const __m128i mask = _mm_set1_epi32(0xff);
+    for (; i + 16 <= n; i += 16) {
+        __m128i v[4];
+        for (unsigned j = 0; j < 4; j++)
+            v[j] = _mm_loadu_si128((const __m128i *)&px[4 * i + 16 * j]);
+        for (unsigned p = 0; p < 3; p++) {
+            __m128i c[4];
+            for (unsigned j = 0; j < 4; j++)
+                c[j] = _mm_and_si128(_mm_srli_epi32(v[j], 8 * p), mask);
+            _mm_storeu_si128((__m128i *)&out[p][i],
+                             _mm_packus_epi16(_mm_packs_epi32(c[0], c[1]),
+                                              _mm_packs_epi32(c[2], c[3])));
+        }
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16x4_t v = vld4q_u8(&px[4 * i]);
+        for (unsigned p = 0; p < 3; p++)
+            vst1q_u8(&out[p][i], v.val[p]);
+    }
+#endif
+    for (; i < n; i++) {
+        for (unsigned p = 0; p < 3; p++)
+            out[p][i] = px[4 * i + p];
+    }
+}
+
+/* Converts n packed RGBA pixels with rgb_to_yuv() */
+static void RgbaToYuvRow(uint8_t *const yuv[3], const uint8_t *rgba, unsigned n)
+{
+    unsigned i = 0;
+#if defined(__SSE2__)
+    const __m128i mask = _mm_set1_epi32(0xff);
+    const __m128i round = _mm_set1_epi16(128);
+    for (; i + 8 <= n; i += 8) {
+        const __m128i p0 = _mm_loadu_si128((const __m128i *)&rgba[4 * i]);
+        const __m128i p1 = _mm_loadu_si128((const __m128i *)&rgba[4 * i + 16]);
+        const __m128i r = _mm_packs_epi32(_mm_and_si128(p0, mask),
+                                          _mm_and_si128(p1, mask));
+        const __m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), mask),
+                                          _mm_and_si128(_mm_srli_epi32(p1, 8), mask));
+        const __m128i b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), mask),
+                                          _mm_and_si128(_mm_srli_epi32(p1, 16), mask));
+        /* The luma sum fits in 16 bits unsigned, the chroma ones signed */
+        __m128i vy = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(66)),
+                                                 _mm_mullo_epi16(g, _mm_set1_epi16(129))),
+                                   _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(25)), round));
+        __m128i vu = _mm_add_epi16(_mm_sub_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(112)),
+                                                 _mm_mullo_epi16(r, _mm_set1_epi16(38))),
+                                   _mm_sub_epi16(round, _mm_mullo_epi16(g, _mm_set1_epi16(74))));
+        __m128i vv = _mm_add_epi16(_mm_sub_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(112)),
+                                                 _mm_mullo_epi16(g, _mm_set1_epi16(94))),
+                                   _mm_sub_epi16(round, _mm_mullo_epi16(b, _mm_set1_epi16(18))));
+        vy = _mm_add_epi16(_mm_srli_epi16(vy, 8), _mm_set1_epi16(16));
+        vu = _mm_add_epi16(_mm_srai_epi16(vu, 8), round);
+        vv = _mm_add_epi16(_mm_srai_epi16(vv, 8), round);
+        _mm_storel_epi64((__m128i *)&yuv[0][i], _mm_packus_epi16(vy, vy));
+        _mm_storel_epi64((__m128i *)&yuv[1][i], _mm_packus_epi16(vu, vu));
+        _mm_storel_epi64((__m128i *)&yuv[2][i], _mm_packus_epi16(vv, vv));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= n; i += 8) {
+        const uint8x8x4_t px = vld4_u8(&rgba[4 * i]);
+        const int16x8_t r = vreinterpretq_s16_u16(vmovl_u8(px.val[0]));
+        const int16x8_t g = vreinterpretq_s16_u16(vmovl_u8(px.val[1]));
+        const int16x8_t b = vreinterpretq_s16_u16(vmovl_u8(px.val[2]));
+        uint16x8_t vy = vmlaq_n_u16(vmlaq_n_u16(vmlaq_n_u16(vdupq_n_u16(128),
+                        vreinterpretq_u16_s16(r), 66), vreinterpretq_u16_s16(g), 129),
+                        vreinterpretq_u16_s16(b), 25);
+        int16x8_t vu = vmlaq_n_s16(vmlaq_n_s16(vmlaq_n_s16(vdupq_n_s16(128),
+                       r, -38), g, -74), b, 112);
+        int16x8_t vv = vmlaq_n_s16(vmlaq_n_s16(vmlaq_n_s16(vdupq_n_s16(128),
+                       r, 112), g, -94), b, -18);
+        vst1_u8(&yuv[0][i], vadd_u8(vshrn_n_u16(vy, 8), vdup_n_u8(16)));
+        vst1_u8(&yuv[1][i], vadd_u8(vmovn_u16(vreinterpretq_u16_s16(vshrq_n_s16(vu, 8))),
+                                    vdup_n_u8(128)));
+        vst1_u8(&yuv[2][i], vadd_u8(vmovn_u16(vreinterpretq_u16_s16(vshrq_n_s16(vv, 8))),
+                                    vdup_n_u8(128)));
+    }
+#endif
+    for (; i < n; i++)
+        rgb_to_yuv(&yuv[0][i], &yuv[1][i], &yuv[2][i],
+                   rgba[4 * i + 0], rgba[4 * i + 1], rgba[4 * i + 2]);
+}
+
+/* Span sources: they provide the effective alpha of a chunk of pixels and
+ * the colours of a span, as 8 bits planes in the destination colour space */
+template <bool rgb>
+class CSourceYUVA : public CPicture {
+public:
+    CSourceYUVA(const CPicture &cfg) : CPicture(cfg)
+    {
+        for (unsigned i = 0; i < 4; i++)
+            data[i] = CPicture::getLine<1>(i);
+    }
+    void getAlpha(uint8_t *a, unsigned dx, unsigned n, unsigned alpha) const
+    {
+        ScaleAlpha(a, &data[3][x + dx], alpha, n);
+    }
+    void getColors(const uint8_t *c[3], uint8_t buf[][BLEND_CHUNK],
+                   unsigned dx, unsigned n)
+    {
+        if (!rgb) {
+            for (unsigned p = 0; p < 3; p++)
+                c[p] = &data[p][x + dx];
+            return;
+        }
+        uint8_t *const out[3] = { buf[0], buf[1], buf[2] };
+        YuvToRgbRow(out, &data[0][x + dx], &data[1][x + dx], &data[2][x + dx], n);
+        for (unsigned p = 0; p < 3; p++)
+            c[p] = buf[p];
+    }
+    void nextLine()
+    {
+        y++;
+        for (unsigned i = 0; i < 4; i++)
+            data[i] += picture->p[i].i_pitch;
+    }
+private:
+    const uint8_t *data[4];
+};
+
+template <bool rgb>
+class CSourceRGBA : public CPicture {
+public:
+    CSourceRGBA(const CPicture &cfg) : CPicture(cfg)
+    {
+        data = CPicture::getLine<1>(0);
+    }
+    void getAlpha(uint8_t *a, unsigned dx, unsigned n, unsigned alpha) const
+    {
+        const uint8_t *src = &data[(x + dx) * 4];
+        for (unsigned i = 0; i < n; i++)
+            a[i] = src[4 * i + 3];
+        ScaleAlpha(a, a, alpha, n);
+    }
+    void getColors(const uint8_t *c[3], uint8_t buf[][BLEND_CHUNK],
+                   unsigned dx, unsigned n)
+    {
+        const uint8_t *src = &data[(x + dx) * 4];
+        uint8_t *const out[3] = { buf[0], buf[1], buf[2] };
+        if (rgb)
+            DeinterleaveRow(out, src, n);
+        else
+            RgbaToYuvRow(out, src, n);
+        for (unsigned p = 0; p < 3; p++)
+            c[p] = buf[p];
+    }
+    void nextLine()
+    {
+        y++;
+        data += picture->p[0].i_pitch;
+    }
+private:
+    const uint8_t *data;
+};
+
+template <bool rgb>
+class CSourceYUVP : public CPicture {
+public:
+    CSourceYUVP(const CPicture &cfg) : CPicture(cfg)
+    {
+        const video_palette_t *p = fmt->p_palette;
+        memset(palette, 0, sizeof(palette));
+        for (int i = 0; i < (rgb ? p->i_entries : 256); i++) {
+            memcpy(palette[i], p->palette[i], 4);
+            if (rgb) {
+                int r, g, b;
+                yuv_to_rgb(&r, &g, &b, p->palette[i][0], p->palette[i][1],
+                           p->palette[i][2]);
+                palette[i][0] = r;
+                palette[i][1] = g;
+                palette[i][2] = b;
+            }
+        }
+        for (unsigned i = 0; i < 256; i++)
+            palette_a[i] = palette[i][3];
+        data = CPicture::getLine<1>(0);
+    }
+    void getAlpha(uint8_t *a, unsigned dx, unsigned n, unsigned alpha) const
+    {
+        const uint8_t *src = &data[x + dx];
+        for (unsigned i = 0; i < n; i++)
+            a[i] = palette_a[src[i]];
+        ScaleAlpha(a, a, alpha, n);
+    }
+    void getColors(const uint8_t *c[3], uint8_t buf[][BLEND_CHUNK],
+                   unsigned dx, unsigned n)
+    {
+        const uint8_t *src = &data[x + dx];
+        uint8_t *const out[3] = { buf[0], buf[1], buf[2] };
+        uint8_t px[4 * BLEND_CHUNK];
+        for (unsigned i = 0; i < n; i++)
+            memcpy(&px[4 * i], palette[src[i]], 4);
+        DeinterleaveRow(out, px, n);
+        for (unsigned p = 0; p < 3; p++)
+            c[p] = buf[p];
+    }
+    void nextLine()
+    {
+        y++;
+        data += picture->p[0].i_pitch;
+    }
+private:
+    const uint8_t *data;
+    uint8_t palette[256][4];
+    uint8_t palette_a[256];
+};
+
+/* Span targets: they merge a span of source colours into the destination */
+template <typename pixel, unsigned bits>
+class CTargetI420 : public CPicture {
+public:
+    static const bool rgb = false;
+
+    CTargetI420(const CPicture &cfg) : CPicture(cfg)
+    {
+        data[0] = CPicture::getLine<1>(0);
+        data[1] = CPicture::getLine<2>(1);
+        data[2] = CPicture::getLine<2>(2);
+    }
+    void merge(unsigned dx, unsigned n, const uint8_t *const c[3],
+               const uint8_t *a)
+    {
+        pixel tmp[BLEND_CHUNK];
+
+        MergeRow(&((pixel *)data[0])[x + dx], ToDepth(tmp, c[0], n, bits),
+                 a, n);
+        if ((y % 2) != 0)
+            return;
+
+        /* The chroma of a 2x2 block comes from its top left pixel */
+        const unsigned k = (x + dx) % 2;
+        if (n <= k)
+            return;
+        uint8_t ca[BLEND_CHUNK / 2], cc[BLEND_CHUNK / 2];
+        const unsigned m = Decimate(ca, &a[k], n - k);
+        for (unsigned p = 1; p < 3; p++) {
+            Decimate(cc, &c[p][k], n - k);
+            MergeRow(&((pixel *)data[p])[(x + dx + k) / 2],
+                     ToDepth(tmp, cc, m, bits), ca, m);
+        }
+    }
+    void nextLine()
+    {
+        y++;
+        data[0] += picture->p[0].i_pitch;
+        if ((y % 2) == 0) {
+            data[1] += picture->p[1].i_pitch;
+            data[2] += picture->p[2].i_pitch;
+        }
+    }
+private:
+    uint8_t *data[3];
+};
+
+class CTargetNV12 : public CPicture {
+public:
+    static const bool rgb = false;
+
+    CTargetNV12(const CPicture &cfg) : CPicture(cfg)
+    {
+        data[0] = CPicture::getLine<1>(0);
+        data[1] = CPicture::getLine<2>(1);
+    }
+    void merge(unsigned dx, unsigned n, const uint8_t *const c[3],
+               const uint8_t *a)
+    {
+        MergeRow(&data[0][x + dx], c[0], a, n);
+        if ((y % 2) != 0)
+            return;
+
+        const unsigned k = (x + dx) % 2;
+        if (n <= k)
+            return;
+        uint8_t ca[BLEND_CHUNK / 2], cu[BLEND_CHUNK / 2], cv[BLEND_CHUNK / 2];
+        uint8_t uv[BLEND_CHUNK], aa[BLEND_CHUNK];
+        const unsigned m = Decimate(ca, &a[k], n - k);
+        Decimate(cu, &c[1][k], n - k);
+        Decimate(cv, &c[2][k], n - k);
+        Interleave(uv, cu, cv, m);
+        Interleave(aa, ca, ca, m);
+        MergeRow(&data[1][x + dx + k], uv, aa, 2 * m);
+    }
+    void nextLine()
+    {
+        y++;
+        data[0] += picture->p[0].i_pitch;
+        if ((y % 2) == 0)
+            data[1] += picture->p[1].i_pitch;
+    }
+private:
+    uint8_t *data[2];
+};
+
+class CTargetRGBA : public CPicture {
+public:
+    static const bool rgb = true;
+
+    CTargetRGBA(const CPicture &cfg) : CPicture(cfg)
+    {
+        int offset[4];
+        if (GetPackedRgbIndexes(fmt->i_chroma, &offset[0], &offset[1],
+                                &offset[2], &offset[3]) != VLC_SUCCESS)
+            vlc_assert_unreachable();
+        for (unsigned i = 0; i < 4; i++)
+            this->offset[i] = offset[i];
+        data = CPicture::getLine<1>(0);
+    }
+    /* Same operations as CPictureRGBX::merge() with a destination alpha:
+     * the colours are first merged under the existing alpha, then over it
+     * with the source alpha, and the alpha is merged with 255. */
+    void merge(unsigned dx, unsigned n, const uint8_t *const c[3],
+               const uint8_t *a)
+    {
+        uint8_t *dst = &data[(x + dx) * 4];
+        uint8_t src[4 * BLEND_CHUNK];
+        uint8_t under[4 * BLEND_CHUNK];
+        uint8_t over[4 * BLEND_CHUNK];
+
+        for (unsigned i = 0; i < n; i++) {
+            const uint8_t f = a[i] > 0 ? 255 - dst[4 * i + offset[3]] : 0;
+            for (unsigned p = 0; p < 3; p++) {
+                src[4 * i + offset[p]] = c[p][i];
+                under[4 * i + offset[p]] = f;
+            }
+            src[4 * i + offset[3]] = 255;
+            under[4 * i + offset[3]] = 0;
+            memset(&over[4 * i], a[i], 4);
+        }
+        MergeRow(dst, src, under, 4 * n);
+        MergeRow(dst, src, over, 4 * n);
+    }
+    void nextLine()
+    {
+        y++;
+        data += picture->p[0].i_pitch;
+    }
+private:
+    unsigned offset[4];
+    uint8_t *data;
+};
+
+typedef CTargetI420<uint8_t, 8>   CTargetI420_8;
+typedef CTargetI420<uint16_t, 10> CTargetI420_10;
+
+} // namespace
+
+template <class TDst, template <bool> class TSrc>
+void BlendSpans(const CPicture &dst_data, const CPicture &src_data,
+                unsigned width, unsigned height, int alpha)
+{
+    TSrc<TDst::rgb> src(src_data);
+    TDst dst(dst_data);
+    uint8_t a[BLEND_CHUNK];
+    uint8_t buf[3][BLEND_CHUNK];
+
+    for (unsigned y = 0; y < height; y++) {
+        for (unsigned x = 0; x < width; x += BLEND_CHUNK) {
+            const unsigned n = __MIN(width - x, BLEND_CHUNK);
+
+            src.getAlpha(a, x, n, alpha);
+
+            unsigned end = 0;
+            while (end < n) {
+                unsigned start = end;
+                while (start < n &&
+                       IsTransparent(&a[start], __MIN(n - start, BLEND_GROUP)))
+                    start += BLEND_GROUP;
+                if (start >= n)
+                    break;
+                end = start + BLEND_GROUP;
+                while (end < n &&
+                       !IsTransparent(&a[end], __MIN(n - end, BLEND_GROUP)))
+                    end += BLEND_GROUP;
+                end = __MIN(end, n);
+
+                const uint8_t *c[3];
+                src.getColors(c, buf, x + start, end - start);
+                dst.merge(x + start, end - start, c, &a[start]);
+            }
+        }
+        src.nextLine();
+        dst.nextLine();
+    }
+}
+
 typedef void (*blend_function_t)(const CPicture &dst_data, const CPicture &src_data,
                                  unsigned width, unsigned height, int alpha);
 
@@ -687,6 +1424,33 @@ static const struct {
 #undef YUV
 };
 
+static const struct {
+    vlc_fourcc_t     dst;
+    vlc_fourcc_t     src;
+    blend_function_t blend;
+} fast_blends[] = {
+#undef FAST
+#define FAST(csp, target) \
+    { csp, VLC_CODEC_YUVA, BlendSpans<target, CSourceYUVA> }, \
+    { csp, VLC_CODEC_RGBA, BlendSpans<target, CSourceRGBA> }, \
+    { csp, VLC_CODEC_YUVP, BlendSpans<target, CSourceYUVP> }
+
+    FAST(VLC_CODEC_RGBA,     CTargetRGBA),
+    FAST(VLC_CODEC_ARGB,     CTargetRGBA),
+    FAST(VLC_CODEC_BGRA,     CTargetRGBA),
+    FAST(VLC_CODEC_ABGR,     CTargetRGBA),
+
+    FAST(VLC_CODEC_NV12,     CTargetNV12),
+    FAST(VLC_CODEC_I420,     CTargetI420_8),
+#ifdef WORDS_BIGENDIAN
+    FAST(VLC_CODEC_I420_10B, CTargetI420_10),
+#else
+    FAST(VLC_CODEC_I420_10L, CTargetI420_10),
+#endif
+
+#undef FAST
+};
+
 struct filter_sys_t {
     filter_sys_t() : blend(NULL)
     {
@@ -742,7 +1506,13 @@ static int Open(filter_t *filter)
     const vlc_fourcc_t dst = filter->fmt_out.video.i_chroma;
 
     filter_sys_t *sys = new filter_sys_t();
-    for (size_t i = 0; i < sizeof(blends) / sizeof(*blends); i++) {
+    if (var_InheritBool(filter, "blend-fast")) {
+        for (size_t i = 0; i < sizeof(fast_blends) / sizeof(*fast_blends); i++) {
+            if (fast_blends[i].src == src && fast_blends[i].dst == dst)
+                sys->blend = fast_blends[i].blend;
+        }
+    }
+    for (size_t i = 0; !sys->blend && i < sizeof(blends) / sizeof(*blends); i++) {
         if (blends[i].src == src && blends[i].dst == dst)
             sys->blend = blends[i].blend;
     }
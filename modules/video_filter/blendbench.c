@@ -68,6 +68,12 @@ static picture_t *Filter( filter_t *, picture_t * );
 #define BLEND_CHROMA_LONGTEXT N_("Chroma which the blend image will be loaded" \
                                  " in")
 
+#define WIDTH_TEXT N_("Width of the synthetic images")
+#define HEIGHT_TEXT N_("Height of the synthetic images")
+#define SYNTH_LONGTEXT N_("Without base and blend images, every chroma pair " \
+    "with a fast blending routine is benchmarked on synthetic images of " \
+    "this size, and checked against the generic C routine.")
+
 #define CFG_PREFIX "blendbench-"
 
 vlc_module_begin ()
@@ -93,12 +99,38 @@ vlc_module_begin ()
     add_string( CFG_PREFIX "blend-chroma", "YUVA", BLEND_CHROMA_TEXT,
               BLEND_CHROMA_LONGTEXT )
 
+    set_section( N_("Synthetic images"), NULL )
+    add_integer_with_range( CFG_PREFIX "width", 1280, 16, 8192, WIDTH_TEXT,
+              SYNTH_LONGTEXT )
+    add_integer_with_range( CFG_PREFIX "height", 256, 16, 8192, HEIGHT_TEXT,
+              SYNTH_LONGTEXT )
+
     set_callback_video_filter( Create )
 vlc_module_end ()
 
 static const char *const ppsz_filter_options[] = {
     "loops", "alpha", "base-image", "base-chroma", "blend-image",
-    "blend-chroma", NULL
+    "blend-chroma", "width", "height", NULL
+};
+
+/* Chroma pairs with a fast blending routine */
+static const struct
+{
+    vlc_fourcc_t i_dst;
+    vlc_fourcc_t i_src;
+} blendbench_pairs[] = {
+#define PAIRS( dst ) \
+    { dst, VLC_CODEC_YUVA }, { dst, VLC_CODEC_RGBA }, { dst, VLC_CODEC_YUVP }
+    PAIRS( VLC_CODEC_I420 ),
+    PAIRS( VLC_CODEC_NV12 ),
+#ifdef WORDS_BIGENDIAN
+    PAIRS( VLC_CODEC_I420_10B ),
+#else
+    PAIRS( VLC_CODEC_I420_10L ),
+#endif
+    PAIRS( VLC_CODEC_RGBA ),
+    PAIRS( VLC_CODEC_BGRA ),
+#undef PAIRS
 };
 
 /*****************************************************************************
@@ -108,6 +140,7 @@ typedef struct
 {
     bool b_done;
     int i_loops, i_alpha;
+    unsigned i_width, i_height;
 
     picture_t *p_base_image;
     picture_t *p_blend_image;
@@ -176,6 +209,23 @@ static int Create( filter_t *p_filter )
     p_sys->i_alpha = var_CreateGetIntegerCommand( p_filter,
                                                   CFG_PREFIX "alpha" );
 
+    p_sys->i_width = var_CreateGetInteger( p_filter, CFG_PREFIX "width" );
+    p_sys->i_height = var_CreateGetInteger( p_filter, CFG_PREFIX "height" );
+    p_sys->p_base_image = NULL;
+    p_sys->p_blend_image = NULL;
+
+    psz_cmd = var_CreateGetString( p_filter, CFG_PREFIX "base-image" );
+    psz_temp = var_CreateGetString( p_filter, CFG_PREFIX "blend-image" );
+    i_ret = EMPTY_STR( psz_cmd ) && EMPTY_STR( psz_temp );
+    free( psz_temp );
+    free( psz_cmd );
+    if( i_ret )
+    {
+        msg_Dbg( p_filter, "no images, benchmarking synthetic %ux%u images",
+                 p_sys->i_width, p_sys->i_height );
+        return VLC_SUCCESS;
+    }
+
     psz_temp = var_CreateGetStringCommand( p_filter, CFG_PREFIX "base-chroma" );
     p_sys->i_base_chroma = !psz_temp || strlen( psz_temp ) != 4 ? 0 :
         VLC_FOURCC( psz_temp[0], psz_temp[1], psz_temp[2], psz_temp[3] );
@@ -219,8 +269,259 @@ static void Destroy( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
 
-    picture_Release( p_sys->p_base_image );
-    picture_Release( p_sys->p_blend_image );
+    if( p_sys->p_base_image )
+        picture_Release( p_sys->p_base_image );
+    if( p_sys->p_blend_image )
+        picture_Release( p_sys->p_blend_image );
+    free( p_sys );
+}
+
+/*****************************************************************************
+ * Synthetic images
+ *****************************************************************************/
+static uint8_t blendbench_Random( uint32_t *p_seed )
+{
+    *p_seed = *p_seed * 1664525 + 1013904223;
+    return *p_seed >> 24;
+}
+
+/* Subtitle like coverage: transparent bands and gaps, opaque glyph bodies
+ * with antialiased edges, at every possible alignment */
+static uint8_t blendbench_Coverage( unsigned x, unsigned y, unsigned i_height )
+{
+    if( y < i_height / 4 || y >= i_height * 3 / 4 )
+        return 0;
+
+    const unsigned i_phase = (x + 3 * y) % 48;
+    if( i_phase < 16 )
+        return 0;
+    if( i_phase < 20 )
+        return (i_phase - 15) * 51;
+    if( i_phase < 40 )
+        return 255;
+    if( i_phase < 44 )
+        return (44 - i_phase) * 51;
+    return 0;
+}
+
+static void blendbench_FillBase( picture_t *p_pic, uint32_t i_seed )
+{
+    const vlc_chroma_description_t *p_dsc =
+        vlc_fourcc_GetChromaDescription( p_pic->format.i_chroma );
+
+    for( int i = 0; i < p_pic->i_planes; i++ )
+    {
+        const plane_t *p = &p_pic->p[i];
+
+        for( int y = 0; y < p->i_lines; y++ )
+        {
+            uint8_t *p_line = &p->p_pixels[y * p->i_pitch];
+
+            for( int x = 0; x < p->i_pitch; x++ )
+                p_line[x] = blendbench_Random( &i_seed );
+            if( p_dsc->pixel_size != 2 )
+                continue;
+            for( int x = 0; x < p->i_pitch / 2; x++ )
+                ((uint16_t *)p_line)[x] &= (1 << p_dsc->pixel_bits) - 1;
+        }
+    }
+}
+
+static void blendbench_FillBlend( picture_t *p_pic, uint32_t i_seed )
+{
+    const unsigned i_width = p_pic->format.i_visible_width;
+    const unsigned i_height = p_pic->format.i_visible_height;
+
+    for( unsigned y = 0; y < i_height; y++ )
+    {
+        for( unsigned x = 0; x < i_width; x++ )
+        {
+            const uint8_t i_alpha = blendbench_Coverage( x, y, i_height );
+
+            switch( p_pic->format.i_chroma )
+            {
+            case VLC_CODEC_YUVA:
+                for( int i = 0; i < 3; i++ )
+                    p_pic->p[i].p_pixels[y * p_pic->p[i].i_pitch + x] =
+                        blendbench_Random( &i_seed );
+                p_pic->p[3].p_pixels[y * p_pic->p[3].i_pitch + x] = i_alpha;
+                break;
+            case VLC_CODEC_RGBA:
+            {
+                uint8_t *p_px = &p_pic->p[0].p_pixels[y * p_pic->p[0].i_pitch
+                                                      + 4 * x];
+                for( int i = 0; i < 3; i++ )
+                    p_px[i] = blendbench_Random( &i_seed );
+                p_px[3] = i_alpha;
+                break;
+            }
+            case VLC_CODEC_YUVP:
+                /* palette entry i has an alpha of 17 * i */
+                p_pic->p[0].p_pixels[y * p_pic->p[0].i_pitch + x] =
+                    i_alpha / 17;
+                break;
+            default:
+                vlc_assert_unreachable();
+            }
+        }
+    }
+}
+
+static bool blendbench_Compare( filter_t *p_filter, const picture_t *p_ref,
+                                const picture_t *p_pic )
+{
+    for( int i = 0; i < p_ref->i_planes; i++ )
+    {
+        const plane_t *r = &p_ref->p[i];
+        const plane_t *p = &p_pic->p[i];
+
+        for( int y = 0; y < r->i_visible_lines; y++ )
+        {
+            const uint8_t *p_r = &r->p_pixels[y * r->i_pitch];
+            const uint8_t *p_p = &p->p_pixels[y * p->i_pitch];
+
+            for( int x = 0; x < r->i_visible_pitch; x++ )
+            {
+                if( p_r[x] == p_p[x] )
+                    continue;
+                msg_Err( p_filter, "plane %d differs at byte %d of line %d: "
+                         "%u instead of %u", i, x, y, p_p[x], p_r[x] );
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static filter_t *blendbench_CreateBlender( filter_t *p_filter,
+                                           const video_format_t *p_dst,
+                                           const video_format_t *p_src,
+                                           bool b_fast )
+{
+    filter_t *p_blend = vlc_object_create( p_filter, sizeof(filter_t) );
+    if( !p_blend )
+        return NULL;
+
+    var_Create( p_blend, "blend-fast", VLC_VAR_BOOL );
+    var_SetBool( p_blend, "blend-fast", b_fast );
+
+    p_blend->fmt_out.video = *p_dst;
+    p_blend->fmt_in.video = *p_src;
+    p_blend->p_module = vlc_filter_LoadModule( p_blend, "video blending",
+                                               "blend", true );
+    if( !p_blend->p_module )
+    {
+        vlc_object_delete( p_blend );
+        return NULL;
+    }
+    return p_blend;
+}
+
+static vlc_tick_t blendbench_Time( filter_t *p_blend, picture_t *p_dst,
+                                   const picture_t *p_src, int i_loops,
+                                   int i_alpha )
+{
+    vlc_tick_t time = vlc_tick_now();
+    for( int i_iter = 0; i_iter < i_loops; ++i_iter )
+        filter_Blend( p_blend, p_dst, 17, 9, p_src, i_alpha );
+    return vlc_tick_now() - time;
+}
+
+/**
+ * Benchmarks the fast and the C blending routines of a chroma pair, and
+ * checks that they give the same result.
+ */
+static void blendbench_RunPair( filter_t *p_filter, vlc_fourcc_t i_dst,
+                                vlc_fourcc_t i_src )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    video_format_t dst_fmt, src_fmt;
+    video_palette_t palette;
+    picture_t *p_base = NULL, *p_blend_pic = NULL;
+    picture_t *p_ref = NULL, *p_fast = NULL;
+    filter_t *p_ref_blend = NULL, *p_fast_blend = NULL;
+    uint32_t i_seed = 1;
+
+    /* The blended image is placed at odd coordinates, so that both
+     * chroma sampling phases are exercised */
+    video_format_Init( &dst_fmt, i_dst );
+    video_format_Setup( &dst_fmt, i_dst,
+                        p_sys->i_width + 32, p_sys->i_height + 16,
+                        p_sys->i_width + 32, p_sys->i_height + 16, 1, 1 );
+    video_format_Init( &src_fmt, i_src );
+    video_format_Setup( &src_fmt, i_src, p_sys->i_width, p_sys->i_height,
+                        p_sys->i_width, p_sys->i_height, 1, 1 );
+    if( i_src == VLC_CODEC_YUVP )
+    {
+        palette.i_entries = 16;
+        for( int i = 0; i < palette.i_entries; i++ )
+        {
+            for( int j = 0; j < 3; j++ )
+                palette.palette[i][j] = blendbench_Random( &i_seed );
+            palette.palette[i][3] = 17 * i;
+        }
+        src_fmt.p_palette = &palette;
+    }
+
+    p_base = picture_NewFromFormat( &dst_fmt );
+    p_ref = picture_NewFromFormat( &dst_fmt );
+    p_fast = picture_NewFromFormat( &dst_fmt );
+    p_blend_pic = picture_NewFromFormat( &src_fmt );
+    if( !p_base || !p_ref || !p_fast || !p_blend_pic )
+        goto end;
+    blendbench_FillBase( p_base, i_seed );
+    blendbench_FillBlend( p_blend_pic, i_seed );
+
+    p_ref_blend = blendbench_CreateBlender( p_filter, &dst_fmt, &src_fmt,
+                                            false );
+    p_fast_blend = blendbench_CreateBlender( p_filter, &dst_fmt, &src_fmt,
+                                             true );
+    if( !p_ref_blend || !p_fast_blend )
+    {
+        msg_Err( p_filter, "%4.4s -> %4.4s: no blending routine",
+                 (const char *)&i_src, (const char *)&i_dst );
+        goto end;
+    }
+
+    bool b_match = true;
+    const int pi_alpha[] = { p_sys->i_alpha, 255 };
+    for( size_t i = 0; i < ARRAY_SIZE(pi_alpha) && b_match; i++ )
+    {
+        picture_Copy( p_ref, p_base );
+        picture_Copy( p_fast, p_base );
+        filter_Blend( p_ref_blend, p_ref, 17, 9, p_blend_pic, pi_alpha[i] );
+        filter_Blend( p_fast_blend, p_fast, 17, 9, p_blend_pic, pi_alpha[i] );
+        b_match = blendbench_Compare( p_filter, p_ref, p_fast );
+    }
+
+    vlc_tick_t ref_time = blendbench_Time( p_ref_blend, p_ref, p_blend_pic,
+                                           p_sys->i_loops, p_sys->i_alpha );
+    vlc_tick_t fast_time = blendbench_Time( p_fast_blend, p_fast, p_blend_pic,
+                                            p_sys->i_loops, p_sys->i_alpha );
+
+    const float f_pixels = (float)p_sys->i_loops * p_sys->i_width *
+                           p_sys->i_height * CLOCK_FREQ;
+    msg_Info( p_filter, "%4.4s -> %4.4s: C %.1f Mpixels/s, fast %.1f "
+              "Mpixels/s (x%.2f), %s", (const char *)&i_src,
+              (const char *)&i_dst,
+              f_pixels / __MAX(ref_time, 1) / 1000000.f,
+              f_pixels / __MAX(fast_time, 1) / 1000000.f,
+              (float)ref_time / __MAX(fast_time, 1),
+              b_match ? "identical" : "MISMATCH" );
+
+end:
+    if( p_fast_blend )
+        vlc_filter_Delete( p_fast_blend );
+    if( p_ref_blend )
+        vlc_filter_Delete( p_ref_blend );
+    if( p_blend_pic )
+        picture_Release( p_blend_pic );
+    if( p_fast )
+        picture_Release( p_fast );
+    if( p_ref )
+        picture_Release( p_ref );
+    if( p_base )
+        picture_Release( p_base );
 }
 
 /*****************************************************************************
@@ -234,6 +535,15 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
     if( p_sys->b_done )
         return p_pic;
 
+    if( !p_sys->p_base_image )
+    {
+        for( size_t i = 0; i < ARRAY_SIZE(blendbench_pairs); i++ )
+            blendbench_RunPair( p_filter, blendbench_pairs[i].i_dst,
+                                blendbench_pairs[i].i_src );
+        p_sys->b_done = true;
+        return p_pic;
+    }
+
     p_blend = vlc_object_create( p_filter, sizeof(filter_t) );
     if( !p_blend )
     {
@@ -132,6 +132,7 @@ void config_CmdLineEarlyScan( libvlc_int_t *p_this, int argc, const char *argv[]
         check_option("plugins-cache")
         check_option("plugins-scan")
         check_option("reset-plugins-cache")
+        check_option("plugins-cache-update")
 #endif
 
 #if defined(_WIN32) || defined(__OS2__)
@@ -159,6 +159,7 @@ struct vlc_input_decoder_t
     const char *psz_id;
 
     bool hw_dec;
+    bool keyframes_only;
 
     const struct vlc_input_decoder_callbacks *cbs;
     void *cbs_userdata;
@@ -183,6 +184,19 @@ struct vlc_input_decoder_t
     /* fifo */
     block_fifo_t *p_fifo;
 
+    /* Latest timestamps queued and dequeued, to estimate the buffered
+     * duration */
+    vlc_tick_t fifo_in_ts;
+    vlc_tick_t fifo_out_ts;
+    /* The input thread waits for the fifo to drain to its low watermark */
+    bool fifo_full;
+
+    struct decoder_fifo_budget
+    {
+        vlc_tick_t duration;
+        size_t bytes;
+    } fifo_pace, fifo_live;
+
     /* Lock for communication with decoder thread */
     vlc_cond_t  wait_request;
     vlc_cond_t  wait_acknowledge;
@@ -262,6 +276,9 @@ struct vlc_input_decoder_t
         decoder_cc_desc_t desc;
         bool desc_changed;
         bool b_sout_created;
+        /* Whether the stream output chain wants the CC substream, queried
+         * once instead of for every packetized frame */
+        enum { CC_SOUT_UNKNOWN, CC_SOUT_WANTED, CC_SOUT_UNWANTED } sout_wants;
         sout_packetizer_input_t *p_sout_input;
         char *sout_es_id;
     } cc;
@@ -1212,12 +1229,18 @@ static void DecoderSendSubstream(vlc_input_decoder_t *p_owner)
     if (p_dec->pf_get_cc == NULL)
         return;
 
-    bool b_wants_substreams;
-    int ret = sout_StreamControl(p_owner->p_sout,
-                                 SOUT_STREAM_WANTS_SUBSTREAMS,
-                                 &b_wants_substreams);
+    if (p_owner->cc.sout_wants == CC_SOUT_UNKNOWN)
+    {
+        bool b_wants_substreams;
+        int ret = sout_StreamControl(p_owner->p_sout,
+                                     SOUT_STREAM_WANTS_SUBSTREAMS,
+                                     &b_wants_substreams);
 
-    if (ret != VLC_SUCCESS || !b_wants_substreams)
+        p_owner->cc.sout_wants = ret == VLC_SUCCESS && b_wants_substreams
+                               ? CC_SOUT_WANTED : CC_SOUT_UNWANTED;
+    }
+
+    if (p_owner->cc.sout_wants != CC_SOUT_WANTED)
         return;
 
     if (p_owner->cc.p_sout_input == NULL && p_owner->cc.b_sout_created)
@@ -1775,6 +1798,18 @@ static void DecoderThread_DecodeBlock( vlc_input_decoder_t *p_owner, vlc_frame_t
                             frame->i_pts, frame->i_dts );
     }
 
+    /* Drop the frames that are known not to be key frames before decoding
+     * them. Frames without type flags are always decoded. */
+    if( p_owner->keyframes_only && frame != NULL &&
+        ( frame->i_flags & (BLOCK_FLAG_TYPE_P|BLOCK_FLAG_TYPE_B|
+                            BLOCK_FLAG_TYPE_PB) ) &&
+        !( frame->i_flags & BLOCK_FLAG_TYPE_I ) )
+    {
+        block_Release( frame );
+        vlc_fifo_Lock(p_owner->p_fifo);
+        return;
+    }
+
     int ret = p_dec->pf_decode( p_dec, frame );
 
     vlc_fifo_Lock(p_owner->p_fifo);
@@ -1950,6 +1985,77 @@ static void Decoder_VideoDrained(vlc_input_decoder_t *owner)
     }
 }
 
+/* Number of frames that can be queued while their duration is unknown */
+#define DECODER_FIFO_UNDATED_COUNT 64
+
+static vlc_tick_t DecoderFrameTs( const vlc_frame_t *frame )
+{
+    return frame->i_dts != VLC_TICK_INVALID ? frame->i_dts : frame->i_pts;
+}
+
+/**
+ * Checks the frames pending in the fifo against a fraction of a budget
+ *
+ * \param div 1 for the high watermark, 2 for the low watermark
+ * \param undated whether to limit the number of frames when the buffered
+ * duration is unknown
+ */
+static bool DecoderFifoAboveLocked( vlc_input_decoder_t *p_owner,
+                                    const struct decoder_fifo_budget *budget,
+                                    unsigned div, bool undated )
+{
+    vlc_fifo_Assert( p_owner->p_fifo );
+
+    size_t count = vlc_fifo_GetCount( p_owner->p_fifo );
+    if( count == 0 )
+        return false;
+
+    size_t bytes = vlc_fifo_GetBytes( p_owner->p_fifo );
+    if( bytes >= budget->bytes / div )
+        return true;
+
+    if( p_owner->fifo_in_ts == VLC_TICK_INVALID
+     || p_owner->fifo_out_ts == VLC_TICK_INVALID
+     || p_owner->fifo_in_ts < p_owner->fifo_out_ts )
+        /* No timestamps yet, or a discontinuity */
+        return undated && count >= DECODER_FIFO_UNDATED_COUNT / div;
+
+    return p_owner->fifo_in_ts - p_owner->fifo_out_ts >= budget->duration / div;
+}
+
+static void DecoderFifoResetLocked( vlc_input_decoder_t *p_owner )
+{
+    block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+    p_owner->fifo_in_ts = VLC_TICK_INVALID;
+    p_owner->fifo_out_ts = VLC_TICK_INVALID;
+}
+
+/**
+ * Takes the next frame to process
+ *
+ * The input thread is only woken up once the low watermark is reached, so
+ * that it queues several frames at once instead of ping-ponging with the
+ * DecoderThread on each of them.
+ */
+static vlc_frame_t *DecoderThread_NextFrameLocked( vlc_input_decoder_t *p_owner )
+{
+    vlc_frame_t *frame = vlc_fifo_DequeueUnlocked( p_owner->p_fifo );
+    if( frame == NULL )
+        return NULL;
+
+    vlc_tick_t ts = DecoderFrameTs( frame );
+    if( ts != VLC_TICK_INVALID )
+        p_owner->fifo_out_ts = ts;
+
+    if( p_owner->fifo_full
+     && !DecoderFifoAboveLocked( p_owner, &p_owner->fifo_pace, 2, true ) )
+    {
+        p_owner->fifo_full = false;
+        vlc_cond_signal( &p_owner->wait_fifo );
+    }
+    return frame;
+}
+
 /**
  * The decoding main loop
  *
@@ -2027,9 +2133,7 @@ static void *DecoderThread( void *p_data )
             continue;
         }
 
-        vlc_cond_signal( &p_owner->wait_fifo );
-
-        vlc_frame_t *frame = vlc_fifo_DequeueUnlocked( p_owner->p_fifo );
+        vlc_frame_t *frame = DecoderThread_NextFrameLocked( p_owner );
         if( frame == NULL )
         {
             if( likely(!p_owner->b_draining) )
@@ -2154,6 +2258,7 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     p_owner->i_preroll_end = PREROLL_NONE;
     p_owner->p_resource = cfg->resource;
     p_owner->hw_dec = cfg->hw_dec;
+    p_owner->keyframes_only = cfg->keyframes_only && fmt->i_cat == VIDEO_ES;
     p_owner->cbs = cfg->cbs;
     p_owner->cbs_userdata = cfg->cbs_data;
     p_owner->p_sout = cfg->sout;
@@ -2191,6 +2296,17 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
         vlc_object_delete(p_dec);
         return NULL;
     }
+    p_owner->fifo_in_ts = VLC_TICK_INVALID;
+    p_owner->fifo_out_ts = VLC_TICK_INVALID;
+    p_owner->fifo_full = false;
+    p_owner->fifo_pace.duration =
+        VLC_TICK_FROM_MS( var_InheritInteger( p_dec, "decoder-fifo-duration" ) );
+    p_owner->fifo_pace.bytes =
+        var_InheritInteger( p_dec, "decoder-fifo-size" ) * 1024;
+    p_owner->fifo_live.duration =
+        VLC_TICK_FROM_MS( var_InheritInteger( p_dec, "decoder-live-fifo-duration" ) );
+    p_owner->fifo_live.bytes =
+        var_InheritInteger( p_dec, "decoder-live-fifo-size" ) * 1024;
 
     vlc_cond_init( &p_owner->wait_request );
     vlc_cond_init( &p_owner->wait_acknowledge );
@@ -2277,6 +2393,7 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     p_owner->cc.p_sout_input = NULL;
     p_owner->cc.sout_es_id = NULL;
     p_owner->cc.b_sout_created = false;
+    p_owner->cc.sout_wants = CC_SOUT_UNKNOWN;
     p_owner->master_dec = NULL;
     return p_owner;
 }
@@ -2632,14 +2749,11 @@ void vlc_input_decoder_DecodeWithStatus(vlc_input_decoder_t *p_owner, vlc_frame_
     vlc_fifo_Lock( p_owner->p_fifo );
     if( !b_do_pace )
     {
-        /* FIXME: ideally we would check the time amount of data
-         * in the FIFO instead of its size. */
-        /* 400 MiB, i.e. ~ 50mb/s for 60s */
-        if( vlc_fifo_GetBytes( p_owner->p_fifo ) > 400*1024*1024 )
+        if( DecoderFifoAboveLocked( p_owner, &p_owner->fifo_live, 1, false ) )
         {
             msg_Warn( &p_owner->dec, "decoder/packetizer fifo full (data not "
                       "consumed quickly enough), resetting fifo!" );
-            block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+            DecoderFifoResetLocked( p_owner );
             frame->i_flags |= BLOCK_FLAG_DISCONTINUITY;
         }
     }
@@ -2648,13 +2762,22 @@ void vlc_input_decoder_DecodeWithStatus(vlc_input_decoder_t *p_owner, vlc_frame_
     {   /* The FIFO is not consumed when waiting, so pacing would deadlock VLC.
          * Locking is not necessary as b_waiting is only read, not written by
          * the decoder thread. */
-        while( vlc_fifo_GetCount( p_owner->p_fifo ) >= 10 )
-            vlc_fifo_WaitCond( p_owner->p_fifo, &p_owner->wait_fifo );
+        if( DecoderFifoAboveLocked( p_owner, &p_owner->fifo_pace, 1, true ) )
+        {
+            /* Resumed by the DecoderThread at the low watermark */
+            p_owner->fifo_full = true;
+            do
+                vlc_fifo_WaitCond( p_owner->p_fifo, &p_owner->wait_fifo );
+            while( p_owner->fifo_full );
+        }
     }
 
     if (vlc_fifo_IsEmpty(p_owner->p_fifo) && p_owner->frames_countdown > 0)
         decoder_Notify(p_owner, frame_next_need_data, false);
 
+    vlc_tick_t ts = DecoderFrameTs( frame );
+    if( ts != VLC_TICK_INVALID )
+        p_owner->fifo_in_ts = ts;
     vlc_fifo_QueueUnlocked( p_owner->p_fifo, frame );
     if (status != NULL)
         GetStatusLocked(p_owner, status);
@@ -2746,7 +2869,7 @@ void vlc_input_decoder_Flush( vlc_input_decoder_t *p_owner )
     enum es_format_category_e cat = p_owner->cat;
 
     /* Empty the fifo */
-    block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+    DecoderFifoResetLocked( p_owner );
 
     /* Don't need to wait for the DecoderThread to flush. Indeed, if called a
      * second time, this function will clear the FIFO again before anything was
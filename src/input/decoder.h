@@ -76,6 +76,8 @@ struct vlc_input_decoder_cfg
     sout_stream_t *sout;
     enum input_type input_type;
     bool hw_dec;
+    /* Only decode video frames flagged as key frames (or not flagged) */
+    bool keyframes_only;
     unsigned cc_decoder;
     const struct vlc_input_decoder_callbacks *cbs;
     void *cbs_data;
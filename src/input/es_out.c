@@ -217,6 +217,8 @@ typedef struct
     vlc_tick_t  i_last_pts_jitter;
     int         i_cr_average;
     float       rate;
+    float       user_rate;
+    float       rate_correction;
 
     /* */
     bool        b_paused;
@@ -2504,6 +2506,7 @@ static void EsOutCreateDecoder(es_out_sys_t *p_sys, es_out_id_t *p_es)
         .sout = priv->p_sout,
         .input_type = p_sys->input_type,
         .hw_dec = priv->hw_dec,
+        .keyframes_only = priv->keyframes_only,
         .cc_decoder = p_sys->cc_decoder,
         .cbs = &decoder_cbs,
         .cbs_data = p_es,
@@ -3822,6 +3825,19 @@ static int EsOutVaControlLocked(es_out_sys_t *p_sys, input_source_t *source,
         return VLC_SUCCESS;
     }
 
+    case ES_OUT_SET_RATE_CORRECTION:
+    {
+        const float correction = va_arg( args, double );
+        if( correction <= 0.f )
+            return VLC_EGENERIC;
+        if( correction != p_sys->rate_correction )
+        {
+            p_sys->rate_correction = correction;
+            EsOutChangeRate(p_sys, p_sys->user_rate * correction);
+        }
+        return VLC_SUCCESS;
+    }
+
     case ES_OUT_POST_SUBNODE:
     {
         input_thread_t *input = p_sys->p_input;
@@ -4080,7 +4096,8 @@ static int EsOutVaPrivControlLocked(es_out_sys_t *p_sys, input_source_t *source,
         const float rate = va_arg( args, double );
 
         assert( src_rate == rate );
-        EsOutChangeRate(p_sys, rate);
+        p_sys->user_rate = rate;
+        EsOutChangeRate(p_sys, rate * p_sys->rate_correction);
 
         return VLC_SUCCESS;
     }
@@ -4316,6 +4333,8 @@ input_EsOutNew(input_thread_t *p_input, input_source_t *main_source, float rate,
     p_sys->i_pause_date = -1;
 
     p_sys->rate = rate;
+    p_sys->user_rate = rate;
+    p_sys->rate_correction = 1.f;
     p_sys->b_paused = false;
 
     p_sys->b_buffering = true;
@@ -723,6 +723,11 @@ static int ControlLocked( es_out_t *p_out, input_source_t *in, int i_query,
         return es_out_in_Control( p_sys->p_out, in, ES_OUT_SPU_SET_HIGHLIGHT,
                                   p_es->p_es, p_hl );
     }
+    case ES_OUT_SET_RATE_CORRECTION:
+        /* Not meaningful once away from the live edge */
+        if( p_sys->b_delayed )
+            return VLC_EGENERIC;
+        return es_out_in_vaControl( p_sys->p_out, in, i_query, args );
     /* Special internal input control */
     case ES_OUT_IS_EMPTY:
     {
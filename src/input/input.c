@@ -57,6 +57,7 @@
 #include <vlc_stream_extractor.h>
 #include <vlc_renderer_discovery.h>
 #include <vlc_hash.h>
+#include <vlc_tracer.h>
 
 /*****************************************************************************
  * Local prototypes
@@ -268,6 +269,7 @@ input_thread_t * input_Create( vlc_object_t *p_parent, input_item_t *p_item,
     priv->cbs_data = cfg->cbs_data;
     priv->type = cfg->type;
     priv->preparse_subitems = cfg->preparsing.subitems;
+    priv->keyframes_only = cfg->thumbnailing.keyframes_only;
     priv->i_start = 0;
     priv->i_stop  = 0;
     priv->i_title_offset = input_priv(p_input)->i_seekpoint_offset = 0;
@@ -604,6 +606,36 @@ static void InputSourceStatistics(input_source_t *source, input_item_t *item,
                      live );
 }
 
+/* Emits the stream output metrics sampled with the input statistics */
+static void TraceSoutStatistics( input_thread_t *p_input,
+                                 const input_stats_t *st )
+{
+    struct vlc_tracer *tracer = vlc_object_get_tracer( VLC_OBJECT(p_input) );
+    if( tracer == NULL )
+        return;
+
+    vlc_tracer_Trace( tracer, VLC_TRACE( "type", "SOUT" ),
+                      VLC_TRACE( "fifo_blocks", st->i_sout_fifo_blocks ),
+                      VLC_TRACE( "fifo_bytes", st->i_sout_fifo_bytes ),
+                      VLC_TRACE( "fifo_peak", st->i_sout_fifo_peak ),
+                      VLC_TRACE( "muxed", st->i_sout_muxed_blocks ),
+                      VLC_TRACE_TICK_NS( "mux_wait", st->i_sout_mux_wait ),
+                      VLC_TRACE_TICK_NS( "mux_wait_max",
+                                         st->i_sout_mux_wait_max ),
+                      VLC_TRACE( "sent_packets", st->i_sent_packets ),
+                      VLC_TRACE( "sent_bytes", st->i_sent_bytes ),
+                      VLC_TRACE( "send_bitrate",
+                                 (double)st->f_send_bitrate * 8000. ),
+                      VLC_TRACE_TICK_NS( "write_latency",
+                                         st->i_sout_write_latency ),
+                      VLC_TRACE_TICK_NS( "write_latency_max",
+                                         st->i_sout_write_latency_max ),
+                      VLC_TRACE( "write_errors", st->i_sout_write_errors ),
+                      VLC_TRACE( "dropped", st->i_sout_dropped ),
+                      VLC_TRACE( "late", st->i_sout_late ),
+                      VLC_TRACE_END );
+}
+
 /**
  * Update timing infos and statistics.
  */
@@ -624,6 +656,12 @@ static void MainLoopStatistics( input_thread_t *p_input )
         struct input_stats_t new_stats;
         input_stats_Compute(priv->stats, &new_stats);
 
+        if (priv->p_sout != NULL)
+        {
+            sout_StreamGetStats(priv->p_sout, &new_stats);
+            TraceSoutStatistics(p_input, &new_stats);
+        }
+
         vlc_mutex_lock(&priv->p_item->lock);
         *priv->p_item->p_stats = new_stats;
         vlc_mutex_unlock(&priv->p_item->lock);
@@ -1456,6 +1494,8 @@ static void End( input_thread_t * p_input )
         /* make sure we are up to date */
         vlc_mutex_lock( &item->lock );
         input_stats_Compute( priv->stats, item->p_stats );
+        if( priv->p_sout != NULL )
+            sout_StreamGetStats( priv->p_sout, item->p_stats );
         vlc_mutex_unlock( &item->lock );
     }
 
@@ -382,6 +382,10 @@ struct vlc_input_thread_cfg
     struct {
         bool subitems;
     } preparsing;
+    struct {
+        /* Skip the decoding of non key frames */
+        bool keyframes_only;
+    } thumbnailing;
     bool interact;
 };
 /**
@@ -499,6 +503,7 @@ typedef struct input_thread_private_t
 
     enum input_type type;
     bool hw_dec;
+    bool keyframes_only;
     bool preparse_subitems;
 
     /* Current state */
@@ -111,6 +111,15 @@ void input_stats_Compute(struct input_stats *stats, input_stats_t *st)
                                                     memory_order_relaxed);
     st->i_lost_pictures = atomic_load_explicit(&stats->lost_pictures,
                                                memory_order_relaxed);
+
+    /* Stream output, filled from the chain metrics by the input thread */
+    st->i_sout_fifo_blocks = st->i_sout_fifo_bytes = st->i_sout_fifo_peak = 0;
+    st->i_sout_muxed_blocks = 0;
+    st->i_sout_mux_wait = st->i_sout_mux_wait_max = 0;
+    st->i_sent_packets = st->i_sent_bytes = 0;
+    st->f_send_bitrate = 0.f;
+    st->i_sout_write_latency = st->i_sout_write_latency_max = 0;
+    st->i_sout_write_errors = st->i_sout_dropped = st->i_sout_late = 0;
 }
 
 /** Update a counter element with new values
@@ -47,6 +47,7 @@
 #include "vlm_event.h"
 #include <vlc_sout.h>
 #include <vlc_url.h>
+#include <vlc_memstream.h>
 #include "../misc/threads.h"
 #include "../libvlc.h"
 
@@ -110,6 +111,31 @@ static void player_on_state_changed(vlc_player_t *player,
     vlc_mutex_unlock( &p_vlm->lock_manage );
 }
 
+static void source_on_state_changed(vlc_player_t *player,
+                                    enum vlc_player_state new_state, void *data)
+{
+    vlm_source_t *source = data;
+    vlm_t *p_vlm = source->vlm;
+
+    if (new_state != VLC_PLAYER_STATE_STOPPING)
+        return;
+
+    atomic_store(&source->finished, true);
+
+    /* The fan-out output tells subscribers when the source ends, but it may
+     * not exist if the source failed. The manage thread then stops or
+     * restarts the instances using the source. */
+    if (!vlc_player_GetError(player))
+        return;
+
+    atomic_store(&source->failed, true);
+
+    vlc_mutex_lock( &p_vlm->lock_manage );
+    p_vlm->input_state_changed = true;
+    vlc_cond_signal( &p_vlm->wait_manage );
+    vlc_mutex_unlock( &p_vlm->lock_manage );
+}
+
 static vlc_mutex_t vlm_mutex = VLC_STATIC_MUTEX;
 
 /*****************************************************************************
@@ -151,6 +177,9 @@ vlm_t *vlm_New( libvlc_int_t *libvlc, const char *psz_vlmconf )
     p_vlm->exiting = false;
     p_vlm->i_id = 1;
     TAB_INIT( p_vlm->i_media, p_vlm->media );
+    p_vlm->b_share_input = var_InheritBool( p_vlm, "vlm-share-input" );
+    p_vlm->i_source_id = 0;
+    TAB_INIT( p_vlm->i_source, p_vlm->source );
     var_Create( p_vlm, "intf-event", VLC_VAR_ADDRESS );
 
     if( vlc_clone( &p_vlm->thread, Manage, p_vlm ) )
@@ -209,6 +238,8 @@ void vlm_Delete( vlm_t *p_vlm )
     vlc_mutex_lock( &p_vlm->lock );
     vlm_ControlInternal( p_vlm, VLM_CLEAR_MEDIAS );
     TAB_CLEAN( p_vlm->i_media, p_vlm->media );
+    assert( p_vlm->i_source == 0 );
+    TAB_CLEAN( p_vlm->i_source, p_vlm->source );
 
     vlc_mutex_lock( &p_vlm->lock_manage );
     p_vlm->exiting = true;
@@ -259,6 +290,10 @@ static void* Manage( void* p_object )
             {
                 vlm_media_instance_sys_t *p_instance = p_media->instance[j];
 
+                if (p_instance->source != NULL
+                 && atomic_load(&p_instance->source->failed))
+                    p_instance->finished = true;
+
                 if (p_instance->finished)
                 {
                     int i_new_input_index;
@@ -487,6 +522,123 @@ static vlm_media_instance_sys_t *vlm_ControlMediaInstanceGetByName( vlm_media_sy
     return NULL;
 }
 
+static vlm_source_t *vlm_SourceAcquire( vlm_t *p_vlm, const vlm_media_t *p_cfg,
+                                        const char *psz_uri )
+{
+    struct vlc_memstream stream;
+
+    if( vlc_memstream_open( &stream ) )
+        return NULL;
+
+    vlc_memstream_puts( &stream, psz_uri );
+    for( int i = 0; i < p_cfg->i_option; i++ )
+        vlc_memstream_printf( &stream, "\n%s", p_cfg->ppsz_option[i] );
+    if( vlc_memstream_close( &stream ) )
+        return NULL;
+
+    char *psz_key = stream.ptr;
+
+    for( int i = 0; i < p_vlm->i_source; i++ )
+    {
+        vlm_source_t *source = p_vlm->source[i];
+
+        if( !atomic_load( &source->finished )
+         && !strcmp( source->psz_key, psz_key ) )
+        {
+            free( psz_key );
+            source->refs++;
+            return source;
+        }
+    }
+
+    vlm_source_t *source = calloc( 1, sizeof( *source ) );
+    if( !source )
+    {
+        free( psz_key );
+        return NULL;
+    }
+    source->vlm = p_vlm;
+    source->psz_key = psz_key;
+    source->refs = 1;
+    atomic_init( &source->finished, false );
+    atomic_init( &source->failed, false );
+
+    if( asprintf( &source->psz_name, "vlm-%u", p_vlm->i_source_id++ ) == -1 )
+    {
+        source->psz_name = NULL;
+        goto error;
+    }
+
+    source->p_item = input_item_New( psz_uri, NULL );
+    if( !source->p_item )
+        goto error;
+
+    for( int i = 0; i < p_cfg->i_option; i++ )
+        input_item_AddOption( source->p_item, p_cfg->ppsz_option[i],
+                              VLC_INPUT_OPTION_TRUSTED );
+
+    char *psz_buffer;
+    if( asprintf( &psz_buffer, "sout=#fanout{name=%s}",
+                  source->psz_name ) == -1 )
+        goto error;
+    input_item_AddOption( source->p_item, psz_buffer, VLC_INPUT_OPTION_TRUSTED );
+    free( psz_buffer );
+
+    source->player = vlc_player_New(VLC_OBJECT(p_vlm), VLC_PLAYER_LOCK_NORMAL);
+    if( !source->player )
+        goto error;
+
+    static const struct vlc_player_cbs cbs = {
+        .on_state_changed = source_on_state_changed,
+    };
+    vlc_player_Lock(source->player);
+    source->listener = vlc_player_AddListener(source->player, &cbs, source);
+    if (source->listener != NULL)
+    {
+        vlc_player_SetCurrentMedia(source->player, source->p_item);
+        vlc_player_Start(source->player);
+    }
+    vlc_player_Unlock(source->player);
+    if( !source->listener )
+        goto error;
+
+    msg_Dbg( p_vlm, "sharing input %s as %s", psz_uri, source->psz_name );
+    TAB_APPEND( p_vlm->i_source, p_vlm->source, source );
+    return source;
+
+error:
+    if( source->player )
+        vlc_player_Delete( source->player );
+    if( source->p_item )
+        input_item_Release( source->p_item );
+    free( source->psz_name );
+    free( source->psz_key );
+    free( source );
+    return NULL;
+}
+
+static void vlm_SourceRelease( vlm_t *p_vlm, vlm_source_t *source )
+{
+    assert( source->refs > 0 );
+    if( --source->refs > 0 )
+        return;
+
+    vlc_player_t *player = source->player;
+
+    vlc_player_Lock(player);
+    vlc_player_RemoveListener(player, source->listener);
+    vlc_player_Stop(player);
+    vlc_player_Unlock(player);
+    vlc_player_Delete(player);
+
+    msg_Dbg( p_vlm, "stopped shared input %s", source->psz_name );
+    TAB_REMOVE( p_vlm->i_source, p_vlm->source, source );
+    input_item_Release( source->p_item );
+    free( source->psz_name );
+    free( source->psz_key );
+    free( source );
+}
+
 static vlm_media_instance_sys_t *vlm_MediaInstanceNew( vlm_media_sys_t *p_media, const char *psz_name )
 {
     vlm_media_instance_sys_t *p_instance = calloc( 1, sizeof(vlm_media_instance_sys_t) );
@@ -543,6 +695,9 @@ static void vlm_MediaInstanceDelete( vlm_t *p_vlm, int64_t id, vlm_media_instanc
     if (had_media)
         vlm_SendEventMediaInstanceStopped( p_vlm, id, p_media->cfg.psz_name );
 
+    if( p_instance->source != NULL )
+        vlm_SourceRelease( p_vlm, p_instance->source );
+
     TAB_REMOVE( p_media->i_instance, p_media->instance, p_instance );
     input_item_Release( p_instance->p_item );
     free( p_instance->psz_name );
@@ -594,6 +749,7 @@ static int vlm_ControlMediaInstanceStart( vlm_t *p_vlm, int64_t id, const char *
         {
             if (vlc_player_IsPaused(player))
                 vlc_player_Resume(player);
+            vlc_player_Unlock(player);
             return VLC_SUCCESS;
         }
 
@@ -605,15 +761,45 @@ static int vlm_ControlMediaInstanceStart( vlm_t *p_vlm, int64_t id, const char *
 
     /* Start new one */
     p_instance->i_index = i_input_index;
+
+    char *psz_uri;
     if( strstr( p_media->cfg.ppsz_input[p_instance->i_index], "://" ) == NULL )
-    {
-        char *psz_uri = vlc_path2uri(
+        psz_uri = vlc_path2uri(
                           p_media->cfg.ppsz_input[p_instance->i_index], NULL );
-        input_item_SetURI( p_instance->p_item, psz_uri ) ;
-        free( psz_uri );
-    }
     else
-        input_item_SetURI( p_instance->p_item, p_media->cfg.ppsz_input[p_instance->i_index] ) ;
+        psz_uri = strdup( p_media->cfg.ppsz_input[p_instance->i_index] );
+
+    vlm_source_t *source = NULL;
+    if( p_vlm->b_share_input && psz_uri != NULL )
+    {
+        /* Subscribe to the shared source instead of reading the input */
+        source = vlm_SourceAcquire( p_vlm, &p_media->cfg, psz_uri );
+        if( source != NULL )
+        {
+            char *psz_fanout;
+            if( asprintf( &psz_fanout, "fanout://%s", source->psz_name ) != -1 )
+            {
+                free( psz_uri );
+                psz_uri = psz_fanout;
+            }
+            else
+            {
+                vlm_SourceRelease( p_vlm, source );
+                source = NULL;
+            }
+        }
+    }
+    if( p_instance->source != NULL )
+        vlm_SourceRelease( p_vlm, p_instance->source );
+    p_instance->source = source;
+
+    if( psz_uri == NULL )
+    {
+        vlc_player_Unlock(player);
+        return VLC_ENOMEM;
+    }
+    input_item_SetURI( p_instance->p_item, psz_uri ) ;
+    free( psz_uri );
 
     vlc_player_SetCurrentMedia(player, p_instance->p_item);
     vlc_player_Start(player);
@@ -23,10 +23,27 @@
 #ifndef LIBVLC_VLM_INTERNAL_H
 #define LIBVLC_VLM_INTERNAL_H 1
 
+#include <stdatomic.h>
 #include <vlc_vlm.h>
 #include <vlc_player.h>
 
 /* Private */
+
+/* Broadcast source shared by instances with the same input (and options) */
+typedef struct
+{
+    vlm_t *vlm;
+    char *psz_key;  /* input MRL and options */
+    char *psz_name; /* name of the fan-out published by the source */
+
+    input_item_t *p_item;
+    vlc_player_t *player;
+    vlc_player_listener_id *listener;
+    unsigned refs;
+    atomic_bool finished; /* no new subscribers */
+    atomic_bool failed; /* subscribers must be stopped */
+} vlm_source_t;
+
 typedef struct
 {
     /* instance name */
@@ -39,6 +56,9 @@ typedef struct
     vlc_player_t *player;
     vlc_player_listener_id *listener;
     bool finished;
+
+    /* shared source, or NULL if the instance reads its input itself */
+    vlm_source_t *source;
 } vlm_media_instance_sys_t;
 
 
@@ -71,6 +91,12 @@ struct vlm_t
     /* Media list */
     int                i_media;
     vlm_media_sys_t    **media;
+
+    /* Shared sources */
+    bool               b_share_input;
+    unsigned           i_source_id;
+    int                i_source;
+    vlm_source_t       **source;
 };
 
 int vlm_ControlInternal( vlm_t *p_vlm, int i_query, ... );
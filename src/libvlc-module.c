@@ -582,6 +582,28 @@ static const char *const fit_descriptions[] = {
     "This defines the maximum input delay jitter that the synchronization " \
     "algorithms should try to compensate (in milliseconds)." )
 
+#define DEC_FIFO_DURATION_TEXT N_("Decoder buffer duration")
+#define DEC_FIFO_DURATION_LONGTEXT N_( \
+    "Amount of data (in milliseconds) queued ahead of each decoder or " \
+    "stream output before the input waits, when the input can be paced. " \
+    "The input resumes once half of it has been consumed.")
+
+#define DEC_FIFO_SIZE_TEXT N_("Decoder buffer size")
+#define DEC_FIFO_SIZE_LONGTEXT N_( \
+    "Maximum amount of data (in KiB) queued ahead of each decoder or " \
+    "stream output when the input can be paced.")
+
+#define DEC_LIVE_FIFO_DURATION_TEXT N_("Live decoder buffer duration")
+#define DEC_LIVE_FIFO_DURATION_LONGTEXT N_( \
+    "Amount of data (in milliseconds) queued ahead of each decoder for " \
+    "inputs that cannot be paced (live sources) before the queue is " \
+    "considered stuck and reset.")
+
+#define DEC_LIVE_FIFO_SIZE_TEXT N_("Live decoder buffer size")
+#define DEC_LIVE_FIFO_SIZE_LONGTEXT N_( \
+    "Amount of data (in KiB) queued ahead of each decoder for inputs " \
+    "that cannot be paced (live sources) before the queue is reset.")
+
 #define CLOCK_MASTER_TEXT N_("Clock master source")
 #define CLOCK_MASTER_LONGTEXT N_( "Select the clock master source:\n" \
     "auto: best clock source, input if the access can't be paced " \
@@ -1113,6 +1135,12 @@ static const char* const ppsz_restore_playback_desc[] = {
 #define VLM_CONF_LONGTEXT N_( \
     "Read a VLM configuration file as soon as VLM is started." )
 
+#define VLM_SHARE_INPUT_TEXT N_("Share VLM broadcast inputs")
+#define VLM_SHARE_INPUT_LONGTEXT N_( \
+    "Broadcast media with the same input and options read, demux and " \
+    "packetize their source only once, and share the elementary streams " \
+    "between their stream outputs." )
+
 #define PLUGINS_CACHE_TEXT N_("Use a plugins cache")
 #define PLUGINS_CACHE_LONGTEXT N_( \
     "Use a plugins cache which will greatly improve the startup time of VLC.")
@@ -1122,6 +1150,11 @@ static const char* const ppsz_restore_playback_desc[] = {
     "Scan plugin directories for new plugins at startup. " \
     "This increases the startup time of VLC.")
 
+#define PLUGINS_CACHE_UPDATE_TEXT N_("Update the plugins cache")
+#define PLUGINS_CACHE_UPDATE_LONGTEXT N_( \
+    "Rewrite the plugins cache whenever it is missing or out of date, " \
+    "so that the next startup does not need to load every plugin.")
+
 #define KEYSTORE_TEXT N_("Preferred keystore list")
 #define KEYSTORE_LONGTEXT N_( \
     "List of keystores that VLC will use in priority." )
@@ -2010,6 +2043,19 @@ vlc_module_begin ()
                  CLOCK_MASTER_TEXT, CLOCK_MASTER_LONGTEXT )
         change_string_list( ppsz_clock_master_values, ppsz_clock_master_descriptions )
 
+    add_integer( "decoder-fifo-duration", 500, DEC_FIFO_DURATION_TEXT,
+                 DEC_FIFO_DURATION_LONGTEXT )
+        change_integer_range( 10, 60000 )
+    add_integer( "decoder-fifo-size", 16384, DEC_FIFO_SIZE_TEXT,
+                 DEC_FIFO_SIZE_LONGTEXT )
+        change_integer_range( 64, 4194304 )
+    add_integer( "decoder-live-fifo-duration", 60000,
+                 DEC_LIVE_FIFO_DURATION_TEXT, DEC_LIVE_FIFO_DURATION_LONGTEXT )
+        change_integer_range( 100, 3600000 )
+    add_integer( "decoder-live-fifo-size", 409600, DEC_LIVE_FIFO_SIZE_TEXT,
+                 DEC_LIVE_FIFO_SIZE_LONGTEXT )
+        change_integer_range( 1024, 4194304 )
+
     add_directory("input-record-path", NULL,
                   INPUT_RECORD_PATH_TEXT, INPUT_RECORD_PATH_LONGTEXT)
     add_bool( "input-record-native", true, INPUT_RECORD_NATIVE_TEXT,
@@ -2069,6 +2115,8 @@ vlc_module_begin ()
 
     set_section( N_("VLM"), NULL )
     add_loadfile("vlm-conf", NULL, VLM_CONF_TEXT, VLM_CONF_LONGTEXT)
+    add_bool( "vlm-share-input", false, VLM_SHARE_INPUT_TEXT,
+              VLM_SHARE_INPUT_LONGTEXT )
 
 
     set_subcategory( SUBCAT_SOUT_STREAM )
@@ -2102,6 +2150,9 @@ vlc_module_begin ()
     add_bool( "plugins-scan", true, PLUGINS_SCAN_TEXT,
               PLUGINS_SCAN_LONGTEXT )
         change_volatile ()
+    add_bool( "plugins-cache-update", false, PLUGINS_CACHE_UPDATE_TEXT,
+              PLUGINS_CACHE_UPDATE_LONGTEXT )
+        change_volatile ()
 #endif
     add_string( "keystore", NULL, KEYSTORE_TEXT,
                 KEYSTORE_LONGTEXT )
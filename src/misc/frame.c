@@ -101,6 +101,7 @@ vlc_frame_t *vlc_frame_Init(vlc_frame_t *restrict f, const struct vlc_frame_call
     f->i_length = 0;
     vlc_ancillary_array_Init(&f->ancillaries);
     f->cbs = cbs;
+    f->payload = NULL;
     return f;
 }
 
@@ -155,6 +156,25 @@ vlc_frame_t *vlc_frame_Alloc (size_t size)
     return f;
 }
 
+/**
+ * Payload shared by several frames.
+ *
+ * The frame that owned the payload at first keeps its memory: its release
+ * callback is only invoked once the last frame sharing the payload is
+ * released. The other frames are plain views of the payload.
+ */
+struct vlc_frame_payload
+{
+    vlc_atomic_rc_t rc;
+    vlc_frame_t *owner;
+};
+
+static bool vlc_frame_IsShared(const vlc_frame_t *frame)
+{
+    return frame->payload != NULL
+        && vlc_atomic_rc_get(&frame->payload->rc) > 1;
+}
+
 void vlc_frame_Release(vlc_frame_t *frame)
 {
 #ifndef NDEBUG
@@ -163,9 +183,72 @@ void vlc_frame_Release(vlc_frame_t *frame)
 #endif
     vlc_ancillary_array_Clear(&frame->ancillaries);
 
+    struct vlc_frame_payload *payload = frame->payload;
+    if (payload != NULL)
+    {
+        bool last = vlc_atomic_rc_dec(&payload->rc);
+
+        if (frame != payload->owner)
+            frame->cbs->free(frame);
+        if (!last)
+            return;
+
+        frame = payload->owner;
+        free(payload);
+    }
     frame->cbs->free(frame);
 }
 
+static void vlc_frame_view_Release(vlc_frame_t *frame)
+{
+    free(frame);
+}
+
+static const struct vlc_frame_callbacks vlc_frame_view_cbs =
+{
+    vlc_frame_view_Release,
+};
+
+vlc_frame_t *vlc_frame_Share(vlc_frame_t *frame)
+{
+    struct vlc_frame_payload *payload = frame->payload;
+
+    if (payload == NULL)
+    {
+        payload = malloc(sizeof (*payload));
+        if (unlikely(payload == NULL))
+            return NULL;
+
+        vlc_atomic_rc_init(&payload->rc);
+        payload->owner = frame;
+        frame->payload = payload;
+    }
+
+    vlc_frame_t *view = vlc_frame_New(&vlc_frame_view_cbs, frame->p_start,
+                                      frame->i_size);
+    if (unlikely(view == NULL))
+        return NULL;
+
+    vlc_atomic_rc_inc(&payload->rc);
+    view->payload = payload;
+    view->p_buffer = frame->p_buffer;
+    view->i_buffer = frame->i_buffer;
+    vlc_frame_CopyProperties(view, frame);
+    return view;
+}
+
+vlc_frame_t *vlc_frame_Writable(vlc_frame_t *frame)
+{
+    if (!vlc_frame_IsShared(frame))
+        return frame;
+
+    vlc_frame_t *dup = vlc_frame_Duplicate(frame);
+    if (likely(dup != NULL))
+        dup->p_next = frame->p_next;
+    vlc_frame_Release(frame);
+    return dup;
+}
+
 static vlc_frame_t *vlc_frame_ReallocDup( vlc_frame_t *frame, ssize_t i_prebody, size_t requested )
 {
     vlc_frame_t *p_rea = vlc_frame_Alloc( requested );
@@ -216,6 +299,11 @@ vlc_frame_t *vlc_frame_TryRealloc (vlc_frame_t *frame, ssize_t i_prebody, size_t
 
     size_t requested = i_prebody + i_body;
 
+    /* The spare space around the payload is shared too */
+    if( (i_prebody > 0 || i_body > frame->i_buffer)
+     && vlc_frame_IsShared( frame ) )
+        return vlc_frame_ReallocDup( frame, i_prebody, requested );
+
     if( frame->i_buffer == 0 )
     {   /* Corner case: nothing to preserve */
         if( requested <= frame->i_size )
@@ -385,6 +385,23 @@ void vlc_spu_regions_Clear( vlc_spu_regions *regions )
 
 #include <vlc_filter.h>
 
+static bool BlendRegion(picture_t *dst, vlc_blender_t *blend,
+                        const struct subpicture_region_rendered *r)
+{
+    assert(r->p_picture);
+
+    if (filter_ConfigureBlend(blend, dst->format.i_width,
+                              dst->format.i_height,  &r->p_picture->format)
+     || filter_Blend(blend, dst, r->place.x, r->place.y, r->p_picture, r->i_alpha))
+    {
+        msg_Err(blend, "blending %4.4s to %4.4s failed",
+                (char *)&blend->fmt_in.video.i_chroma,
+                (char *)&blend->fmt_out.video.i_chroma );
+        return false;
+    }
+    return true;
+}
+
 unsigned picture_BlendSubpicture(picture_t *dst,
                                  vlc_blender_t *blend, vlc_render_subpicture *src)
 {
@@ -393,17 +410,167 @@ unsigned picture_BlendSubpicture(picture_t *dst,
     assert(src);
 
     struct subpicture_region_rendered *r;
-    vlc_vector_foreach(r, &src->regions) {
-        assert(r->p_picture);
-
-        if (filter_ConfigureBlend(blend, dst->format.i_width,
-                                  dst->format.i_height,  &r->p_picture->format)
-         || filter_Blend(blend, dst, r->place.x, r->place.y, r->p_picture, r->i_alpha))
-            msg_Err(blend, "blending %4.4s to %4.4s failed",
-                    (char *)&blend->fmt_in.video.i_chroma,
-                    (char *)&blend->fmt_out.video.i_chroma );
+    vlc_vector_foreach(r, &src->regions)
+        if (BlendRegion(dst, blend, r))
+            done++;
+    return done;
+}
+
+/* Copy the lines [first, last[ of a plane, with a single memcpy() when the
+ * layouts allow it */
+static void plane_CopyLines(plane_t *dst, const plane_t *src,
+                            int first, int last)
+{
+    last = __MIN(last, __MIN(dst->i_visible_lines, src->i_visible_lines));
+    if (first >= last)
+        return;
+
+    const uint8_t *in = &src->p_pixels[first * src->i_pitch];
+    uint8_t *out = &dst->p_pixels[first * dst->i_pitch];
+
+    if (src->i_pitch == dst->i_pitch && src->i_pitch < 2 * src->i_visible_pitch)
+        memcpy(out, in, (size_t) src->i_pitch * (last - first));
+    else
+    {
+        const size_t width = __MIN(dst->i_visible_pitch, src->i_visible_pitch);
+        for (int y = first; y < last; y++)
+        {
+            memcpy(out, in, width);
+            in += src->i_pitch;
+            out += dst->i_pitch;
+        }
+    }
+}
+
+struct blend_band
+{
+    int first;
+    int last;
+};
+
+/* Lines of the picture touched by a region, false if none */
+static bool RegionLines(const struct subpicture_region_rendered *r,
+                        int height, int *first, int *last)
+{
+    *first = __MAX(r->place.y, 0);
+    *last = __MIN(r->place.y + (int) r->p_picture->format.i_visible_height,
+                  height);
+    return *first < *last;
+}
+
+static int CompareBands(const void *a, const void *b)
+{
+    const struct blend_band *ba = a, *bb = b;
+    return (ba->first > bb->first) - (ba->first < bb->first);
+}
+
+unsigned picture_CopyBlendSubpicture(picture_t *dst, const picture_t *src,
+                                     vlc_blender_t *blend,
+                                     vlc_render_subpicture *subpic)
+{
+    assert(subpic);
+
+    /* Vertical subsampling of each plane relative to the first one; bands
+     * are aligned on the largest so that no chroma line is shared between
+     * two bands (and copied again after having been blended). */
+    int align = 1;
+    bool fused = src->context == NULL && dst->i_planes == src->i_planes
+              && src->i_planes > 0 && subpic->regions.size > 0;
+    for (int i = 0; fused && i < src->i_planes; i++)
+    {
+        if (src->p[i].i_lines <= 0
+         || src->p[0].i_lines % src->p[i].i_lines != 0
+         || dst->p[0].i_lines * src->p[i].i_lines
+                != dst->p[i].i_lines * src->p[0].i_lines)
+            fused = false;
         else
+            align = __MAX(align, src->p[0].i_lines / src->p[i].i_lines);
+    }
+
+    struct blend_band *bands = NULL;
+    if (fused)
+        bands = vlc_alloc(subpic->regions.size, sizeof(*bands));
+    if (bands == NULL)
+    {
+        /* opaque pictures, unusual layouts, nothing to blend or no memory */
+        picture_Copy(dst, src);
+        return picture_BlendSubpicture(dst, blend, subpic);
+    }
+
+    picture_CopyProperties(dst, src);
+
+    const int height = __MIN(src->p[0].i_visible_lines,
+                             dst->p[0].i_visible_lines);
+
+    /* Compute the (aligned) line span of each region, then merge the
+     * overlapping ones into bands */
+    size_t count = 0;
+    struct subpicture_region_rendered *r;
+    vlc_vector_foreach(r, &subpic->regions)
+    {
+        int first, last;
+        if (!RegionLines(r, height, &first, &last))
+            continue;
+        bands[count].first = first - first % align;
+        bands[count].last = last + (align - last % align) % align;
+        count++;
+    }
+    qsort(bands, count, sizeof(*bands), CompareBands);
+
+    size_t merged = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (merged > 0 && bands[i].first <= bands[merged - 1].last)
+            bands[merged - 1].last = __MAX(bands[merged - 1].last,
+                                           bands[i].last);
+        else
+            bands[merged++] = bands[i];
+    }
+
+    /* Copy the untouched lines straight, and blend each band right after
+     * copying it, while its lines are still in the cache */
+    unsigned done = 0;
+    int line = 0;
+    for (size_t b = 0; b <= merged; b++)
+    {
+        int next = b < merged ? bands[b].first : INT_MAX;
+        for (int i = 0; i < src->i_planes; i++)
+        {
+            int div = src->p[0].i_lines / src->p[i].i_lines;
+            plane_CopyLines(&dst->p[i], &src->p[i], line / div,
+                            next == INT_MAX ? INT_MAX : next / div);
+        }
+        if (b == merged)
+            break;
+
+        for (int i = 0; i < src->i_planes; i++)
+        {
+            int div = src->p[0].i_lines / src->p[i].i_lines;
+            plane_CopyLines(&dst->p[i], &src->p[i],
+                            bands[b].first / div, bands[b].last / div);
+        }
+
+        /* regions keep their order: overlapping ones share the same band */
+        vlc_vector_foreach(r, &subpic->regions)
+        {
+            int first, last;
+            if (RegionLines(r, height, &first, &last)
+             && first >= bands[b].first && first < bands[b].last
+             && BlendRegion(dst, blend, r))
+                done++;
+        }
+        line = bands[b].last;
+    }
+
+    /* regions out of the picture do not touch any line, but still go through
+     * the blender so that the result matches picture_BlendSubpicture() */
+    vlc_vector_foreach(r, &subpic->regions)
+    {
+        int first, last;
+        if (!RegionLines(r, height, &first, &last) && BlendRegion(dst, blend, r))
             done++;
     }
+
+    free(bands);
     return done;
 }
@@ -45,6 +45,7 @@
 #include <vlc_modules.h>
 #include <vlc_fs.h>
 #include <vlc_block.h>
+#include <vlc_executor.h>
 #include "../libvlc.h"
 #include "config/configuration.h"
 #include "modules/modules.h"
@@ -291,12 +292,29 @@ error:
 
 typedef enum
 {
-    CACHE_READ_FILE  = 0x1,
-    CACHE_SCAN_DIR   = 0x2,
-    CACHE_WRITE_FILE = 0x4,
+    CACHE_READ_FILE   = 0x1,
+    CACHE_SCAN_DIR    = 0x2,
+    CACHE_WRITE_FILE  = 0x4,
+    CACHE_UPDATE_FILE = 0x8,
 } cache_mode_t;
 
-typedef struct module_bank
+typedef struct module_bank module_bank_t;
+
+/**
+ * Plug-in file found while browsing, pending registration.
+ */
+struct vlc_plugin_probe
+{
+    module_bank_t *bank;
+    char *abspath;
+    char *relpath;
+    int64_t mtime;
+    uint64_t size;
+    vlc_plugin_t *plugin;
+    struct vlc_runnable runnable;
+};
+
+struct module_bank
 {
     libvlc_int_t *obj;
     const char   *base;
@@ -305,10 +323,17 @@ typedef struct module_bank
     size_t        size;
     vlc_plugin_t **plugins;
     vlc_plugin_t *cache;
-} module_bank_t;
+
+    size_t        probec;
+    struct vlc_plugin_probe *probev;
+    bool          stale;
+};
 
 /**
  * Scans a plug-in from a file.
+ *
+ * Cached plug-ins are resolved immediately. Other plug-ins are only queued,
+ * and loaded later by AllocatePluginProbes().
  */
 static int AllocatePluginFile (module_bank_t *bank, const char *abspath,
                                const char *relpath, const struct stat *st)
@@ -331,38 +356,139 @@ static int AllocatePluginFile (module_bank_t *bank, const char *abspath,
         }
     }
 
-    if (plugin == NULL)
+    struct vlc_plugin_probe *probev =
+        realloc(bank->probev, (bank->probec + 1) * sizeof (*probev));
+    if (unlikely(probev == NULL))
+        goto error;
+    bank->probev = probev;
+
+    struct vlc_plugin_probe *probe = &probev[bank->probec];
+
+    probe->bank = bank;
+    probe->abspath = strdup(abspath);
+    probe->relpath = strdup(relpath);
+    probe->mtime = st->st_mtime;
+    probe->size = st->st_size;
+    probe->plugin = plugin;
+
+    if (unlikely(probe->abspath == NULL || probe->relpath == NULL))
+    {
+        free(probe->relpath);
+        free(probe->abspath);
+        goto error;
+    }
+
+    bank->probec++;
+    return 0;
+error:
+    if (plugin != NULL)
+        vlc_plugin_destroy(plugin);
+    return -1;
+}
+
+/**
+ * Loads a plug-in that was not found in the cache.
+ *
+ * This is invoked concurrently for distinct plug-ins. It must not access the
+ * module bank itself.
+ */
+static void AllocatePluginProbe(void *data)
+{
+    struct vlc_plugin_probe *probe = data;
+    vlc_plugin_t *plugin = module_InitDynamic(probe->bank->obj,
+                                              probe->abspath, true);
+    if (plugin != NULL)
+    {
+        plugin->path = probe->relpath;
+        plugin->mtime = probe->mtime;
+        plugin->size = probe->size;
+        probe->relpath = NULL;
+    }
+    probe->plugin = plugin;
+}
+
+/**
+ * Loads all queued plug-ins and adds them to the bank.
+ *
+ * Plug-ins missing from the cache are loaded in parallel, as opening a
+ * shared object is mostly I/O and relocation bound. They are then stored in
+ * the order in which they were found, so that the resulting bank does not
+ * depend on thread scheduling.
+ */
+static void AllocatePluginProbes(module_bank_t *bank)
+{
+    size_t missing = 0;
+
+    for (size_t i = 0; i < bank->probec; i++)
+        if (bank->probev[i].plugin == NULL)
+            missing++;
+
+    if (missing > 0)
     {
-        char *path = strdup(relpath);
-        if (path == NULL)
-            return -1;
+        unsigned threads = vlc_GetCPUCount();
+        vlc_executor_t *executor = NULL;
 
-        plugin = module_InitDynamic(bank->obj, abspath, true);
+        bank->stale = true;
 
-        if (plugin != NULL)
+        if (threads > missing)
+            threads = missing;
+        if (threads > 1)
+            executor = vlc_executor_New(threads);
+
+        if (executor != NULL)
         {
-            plugin->path = path;
-            plugin->mtime = st->st_mtime;
-            plugin->size = st->st_size;
+            msg_Dbg(bank->obj, "loading %zu plug-ins with %u threads",
+                    missing, threads);
+
+            for (size_t i = 0; i < bank->probec; i++)
+            {
+                struct vlc_plugin_probe *probe = &bank->probev[i];
+
+                if (probe->plugin != NULL)
+                    continue;
+
+                probe->runnable.run = AllocatePluginProbe;
+                probe->runnable.userdata = probe;
+                vlc_executor_Submit(executor, &probe->runnable);
+            }
+
+            vlc_executor_WaitIdle(executor);
+            vlc_executor_Delete(executor);
+        }
+        else
+        {
+            for (size_t i = 0; i < bank->probec; i++)
+                if (bank->probev[i].plugin == NULL)
+                    AllocatePluginProbe(&bank->probev[i]);
         }
-        else free(path);
     }
 
-    if (plugin == NULL)
-        return -1;
+    for (size_t i = 0; i < bank->probec; i++)
+    {
+        struct vlc_plugin_probe *probe = &bank->probev[i];
+        vlc_plugin_t *plugin = probe->plugin;
 
-    vlc_plugin_store(plugin);
+        free(probe->relpath);
+        free(probe->abspath);
 
-    if (bank->mode & CACHE_WRITE_FILE) /* Add entry to to-be-saved cache */
-    {
-        bank->plugins = xrealloc(bank->plugins,
-                                 (bank->size + 1) * sizeof (vlc_plugin_t *));
-        bank->plugins[bank->size] = plugin;
-        bank->size++;
+        if (plugin == NULL)
+            continue;
+
+        vlc_plugin_store(plugin);
+
+        /* Add entry to to-be-saved cache */
+        if (bank->mode & (CACHE_WRITE_FILE | CACHE_UPDATE_FILE))
+        {
+            bank->plugins = xrealloc(bank->plugins,
+                                     (bank->size + 1) * sizeof (*bank->plugins));
+            bank->plugins[bank->size] = plugin;
+            bank->size++;
+        }
     }
 
-    /* TODO: deal with errors */
-    return  0;
+    free(bank->probev);
+    bank->probev = NULL;
+    bank->probec = 0;
 }
 
 #ifdef __APPLE__
@@ -533,6 +659,7 @@ static void AllocatePluginPath(libvlc_int_t *obj, const char *path,
 
         /* Don't go deeper than 5 subdirectories */
         AllocatePluginDir(&bank, 5, path, NULL);
+        AllocatePluginProbes(&bank);
     }
 
     /* Deal with unmatched cache entries from cache file */
@@ -542,12 +669,16 @@ static void AllocatePluginPath(libvlc_int_t *obj, const char *path,
 
         bank.cache = plugin->next;
         if (mode & CACHE_SCAN_DIR)
+        {
             vlc_plugin_destroy(plugin);
+            bank.stale = true;
+        }
         else
             vlc_plugin_store(plugin);
     }
 
-    if (mode & CACHE_WRITE_FILE)
+    if ((mode & CACHE_WRITE_FILE)
+     || ((mode & CACHE_UPDATE_FILE) && bank.stale))
         CacheSave(obj, path, bank.plugins, bank.size);
 
     free(bank.plugins);
@@ -578,6 +709,9 @@ static void AllocateAllPlugins (libvlc_int_t *p_this)
         mode |= CACHE_SCAN_DIR;
     if (var_InheritBool(p_this, "reset-plugins-cache"))
         mode = (mode | CACHE_WRITE_FILE) & ~CACHE_READ_FILE;
+    else if ((mode & CACHE_SCAN_DIR)
+          && var_InheritBool(p_this, "plugins-cache-update"))
+        mode |= CACHE_UPDATE_FILE;
 
 #ifdef HAVE_FORCED_PLUGINS
     /* Windows Store Apps can not load external plugins with absolute paths. */
@@ -37,6 +37,7 @@ vlc_playlist_ClearItems(vlc_playlist_t *playlist)
     vlc_vector_foreach(item, &playlist->items)
         vlc_playlist_item_Release(item);
     vlc_vector_clear(&playlist->items);
+    playlist_index_Clear(&playlist->index);
 }
 
 static void
@@ -200,9 +201,8 @@ vlc_playlist_IndexOf(vlc_playlist_t *playlist, const vlc_playlist_item_t *item)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    ssize_t index;
-    vlc_vector_index_of(&playlist->items, item, &index);
-    return index;
+    return playlist_index_IndexOf(&playlist->index, playlist->items.data,
+                                  playlist->items.size, item);
 }
 
 ssize_t
@@ -210,11 +210,8 @@ vlc_playlist_IndexOfMedia(vlc_playlist_t *playlist, const input_item_t *media)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    playlist_item_vector_t *items = &playlist->items;
-    for (size_t i = 0; i < items->size; ++i)
-        if (items->data[i]->media == media)
-            return i;
-    return -1;
+    return playlist_index_IndexOfMedia(&playlist->index, playlist->items.data,
+                                       playlist->items.size, media);
 }
 
 ssize_t
@@ -222,11 +219,8 @@ vlc_playlist_IndexOfId(vlc_playlist_t *playlist, uint64_t id)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    playlist_item_vector_t *items = &playlist->items;
-    for (size_t i = 0; i < items->size; ++i)
-        if (items->data[i]->id == id)
-            return i;
-    return -1;
+    return playlist_index_IndexOfId(&playlist->index, playlist->items.data,
+                                    playlist->items.size, id);
 }
 
 void
@@ -257,7 +251,7 @@ vlc_playlist_MediaToItems(vlc_playlist_t *playlist, input_item_t *const media[],
         if (unlikely(!items[i]))
             break;
     }
-    if (i < count)
+    if (i < count || !playlist_index_Add(&playlist->index, items, count))
     {
         /* allocation failure, release partial items */
         while (i)
@@ -287,6 +281,7 @@ vlc_playlist_Insert(vlc_playlist_t *playlist, size_t index,
         vlc_vector_remove_slice(&playlist->items, index, count);
         return ret;
     }
+    playlist_index_Invalidate(&playlist->index, index);
 
     vlc_playlist_ItemsInserted(playlist, index, count, true);
     vlc_playlist_UpdateNextMedia(playlist);
@@ -303,6 +298,7 @@ vlc_playlist_Move(vlc_playlist_t *playlist, size_t index, size_t count,
     assert(target + count <= playlist->items.size);
 
     vlc_vector_move_slice(&playlist->items, index, count, target);
+    playlist_index_Invalidate(&playlist->index, __MIN(index, target));
 
     vlc_playlist_ItemsMoved(playlist, index, count, target);
     vlc_playlist_UpdateNextMedia(playlist);
@@ -316,6 +312,8 @@ vlc_playlist_Remove(vlc_playlist_t *playlist, size_t index, size_t count)
 
     vlc_playlist_ItemsRemoving(playlist, index, count);
 
+    playlist_index_Remove(&playlist->index, &playlist->items.data[index],
+                          count);
     for (size_t i = 0; i < count; ++i) {
         vlc_playlist_item_t *item = playlist->items.data[index + i];
         if (playlist->parser != NULL
@@ -326,6 +324,7 @@ vlc_playlist_Remove(vlc_playlist_t *playlist, size_t index, size_t count)
     }
 
     vlc_vector_remove_slice(&playlist->items, index, count);
+    playlist_index_Invalidate(&playlist->index, index);
 
     bool current_media_changed = vlc_playlist_ItemsRemoved(playlist, index,
                                                            count);
@@ -347,6 +346,13 @@ vlc_playlist_Replace(vlc_playlist_t *playlist, size_t index,
     if (!item)
         return VLC_ENOMEM;
 
+    if (!playlist_index_Add(&playlist->index, &item, 1))
+    {
+        vlc_playlist_item_Release(item);
+        return VLC_ENOMEM;
+    }
+    item->index = index;
+
     if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
     {
         randomizer_Remove(&playlist->randomizer,
@@ -358,6 +364,7 @@ vlc_playlist_Replace(vlc_playlist_t *playlist, size_t index,
     if (playlist->parser != NULL
             && old->preparser_req != NULL)
         vlc_preparser_Cancel(playlist->parser, old->preparser_req);
+    playlist_index_Remove(&playlist->index, &old, 1);
     vlc_playlist_item_Release(old);
     playlist->items.data[index] = item;
 
@@ -395,6 +402,7 @@ vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
                 vlc_vector_remove_slice(&playlist->items, index + 1, count - 1);
                 return ret;
             }
+            playlist_index_Invalidate(&playlist->index, index + 1);
             vlc_playlist_ItemsInserted(playlist, index + 1, count - 1, false);
         }
 
@@ -0,0 +1,301 @@
+/*****************************************************************************
+ * playlist/index.c: playlist item lookup index
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+
+#include <vlc_common.h>
+#include "index.h"
+#include "item.h"
+
+/**
+ * \addtogroup playlist_index Playlist lookup index
+ * \ingroup playlist
+ *
+ * Both tables use open addressing with linear probing, and store the item
+ * pointers directly (NULL marks an empty slot). The load factor is kept
+ * below 1/2.
+ *
+ * Several items may reference the same media, so the media table may contain
+ * several entries for the same key. The id table is unique.
+ *
+ * Positions are not stored in the tables: each item caches its own position
+ * (item->index). Inserting, moving or removing items only lowers a watermark
+ * (index->valid); the positions above it are renumbered on the next lookup
+ * which needs them. As a consequence, a lookup costs O(1) unless the content
+ * was modified before the item since the last lookup, in which case it costs
+ * as much as the memmove() the modification already implied.
+ *
+ * @{
+ */
+
+#define INDEX_MIN_CAPACITY 16
+
+static inline size_t
+HashId(uint64_t id)
+{
+    /* 64-bit mixer from splitmix64 */
+    id ^= id >> 30;
+    id *= UINT64_C(0xbf58476d1ce4e5b9);
+    id ^= id >> 27;
+    id *= UINT64_C(0x94d049bb133111eb);
+    id ^= id >> 31;
+    return id;
+}
+
+static inline size_t
+HashMedia(const input_item_t *media)
+{
+    return HashId((uintptr_t) media);
+}
+
+static inline size_t
+HashItemId(const vlc_playlist_item_t *item)
+{
+    return HashId(item->id);
+}
+
+static inline size_t
+HashItemMedia(const vlc_playlist_item_t *item)
+{
+    return HashMedia(item->media);
+}
+
+static void
+TableInsert(vlc_playlist_item_t **table, size_t mask, size_t hash,
+            vlc_playlist_item_t *item)
+{
+    size_t i = hash & mask;
+    while (table[i])
+        i = (i + 1) & mask;
+    table[i] = item;
+}
+
+static void
+TableRemove(vlc_playlist_item_t **table, size_t mask,
+            size_t (*hash)(const vlc_playlist_item_t *),
+            vlc_playlist_item_t *item)
+{
+    size_t i = hash(item) & mask;
+    while (table[i] != item)
+    {
+        assert(table[i]);
+        i = (i + 1) & mask;
+    }
+
+    /* backward shift deletion: move back the entries of the cluster which
+     * would not be reachable anymore from their home slot */
+    size_t j = i;
+    for (;;)
+    {
+        j = (j + 1) & mask;
+        if (!table[j])
+            break;
+        size_t home = hash(table[j]) & mask;
+        /* is home cyclically in ]i, j]? */
+        bool reachable = i <= j ? (i < home && home <= j)
+                                : (i < home || home <= j);
+        if (!reachable)
+        {
+            table[i] = table[j];
+            i = j;
+        }
+    }
+    table[i] = NULL;
+}
+
+void
+playlist_index_Init(struct playlist_index *index)
+{
+    index->by_id = NULL;
+    index->by_media = NULL;
+    index->capacity = 0;
+    index->count = 0;
+    index->valid = 0;
+}
+
+void
+playlist_index_Destroy(struct playlist_index *index)
+{
+    free(index->by_id);
+    free(index->by_media);
+}
+
+void
+playlist_index_Clear(struct playlist_index *index)
+{
+    playlist_index_Destroy(index);
+    playlist_index_Init(index);
+}
+
+static bool
+playlist_index_Reserve(struct playlist_index *index, size_t count)
+{
+    if (count <= index->capacity / 2)
+        return true;
+
+    size_t capacity = index->capacity ? index->capacity : INDEX_MIN_CAPACITY;
+    while (count > capacity / 2)
+    {
+        if (capacity > SIZE_MAX / 2 / sizeof(vlc_playlist_item_t *))
+            return false;
+        capacity *= 2;
+    }
+
+    vlc_playlist_item_t **by_id = calloc(capacity, sizeof(*by_id));
+    vlc_playlist_item_t **by_media = calloc(capacity, sizeof(*by_media));
+    if (unlikely(!by_id || !by_media))
+    {
+        free(by_id);
+        free(by_media);
+        return false;
+    }
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < index->capacity; ++i)
+    {
+        vlc_playlist_item_t *item = index->by_id[i];
+        if (item)
+        {
+            TableInsert(by_id, mask, HashItemId(item), item);
+            TableInsert(by_media, mask, HashItemMedia(item), item);
+        }
+    }
+
+    free(index->by_id);
+    free(index->by_media);
+    index->by_id = by_id;
+    index->by_media = by_media;
+    index->capacity = capacity;
+    return true;
+}
+
+bool
+playlist_index_Add(struct playlist_index *index,
+                   vlc_playlist_item_t *const items[], size_t count)
+{
+    if (!playlist_index_Reserve(index, index->count + count))
+        return false;
+
+    size_t mask = index->capacity - 1;
+    for (size_t i = 0; i < count; ++i)
+    {
+        TableInsert(index->by_id, mask, HashItemId(items[i]), items[i]);
+        TableInsert(index->by_media, mask, HashItemMedia(items[i]), items[i]);
+    }
+    index->count += count;
+    return true;
+}
+
+void
+playlist_index_Remove(struct playlist_index *index,
+                      vlc_playlist_item_t *const items[], size_t count)
+{
+    assert(count <= index->count);
+
+    size_t mask = index->capacity - 1;
+    for (size_t i = 0; i < count; ++i)
+    {
+        TableRemove(index->by_id, mask, HashItemId, items[i]);
+        TableRemove(index->by_media, mask, HashItemMedia, items[i]);
+    }
+    index->count -= count;
+}
+
+static vlc_playlist_item_t *
+playlist_index_FindId(struct playlist_index *index, uint64_t id)
+{
+    if (!index->count)
+        return NULL;
+
+    size_t mask = index->capacity - 1;
+    for (size_t i = HashId(id) & mask; index->by_id[i]; i = (i + 1) & mask)
+        if (index->by_id[i]->id == id)
+            return index->by_id[i];
+    return NULL;
+}
+
+static size_t
+playlist_index_Position(struct playlist_index *index,
+                        vlc_playlist_item_t *const items[], size_t size,
+                        const vlc_playlist_item_t *item)
+{
+    /* an item is never present twice, so a matching hint is always right */
+    if (item->index < size && items[item->index] == item)
+        return item->index;
+
+    assert(index->valid < size);
+    for (size_t i = index->valid; i < size; ++i)
+        items[i]->index = i;
+    index->valid = size;
+
+    assert(items[item->index] == item);
+    return item->index;
+}
+
+ssize_t
+playlist_index_IndexOf(struct playlist_index *index,
+                       vlc_playlist_item_t *const items[], size_t size,
+                       const vlc_playlist_item_t *item)
+{
+    /* the item may have been removed while the caller held it */
+    if (playlist_index_FindId(index, item->id) != item)
+        return -1;
+    return playlist_index_Position(index, items, size, item);
+}
+
+ssize_t
+playlist_index_IndexOfId(struct playlist_index *index,
+                         vlc_playlist_item_t *const items[], size_t size,
+                         uint64_t id)
+{
+    vlc_playlist_item_t *item = playlist_index_FindId(index, id);
+    if (!item)
+        return -1;
+    return playlist_index_Position(index, items, size, item);
+}
+
+ssize_t
+playlist_index_IndexOfMedia(struct playlist_index *index,
+                            vlc_playlist_item_t *const items[], size_t size,
+                            const input_item_t *media)
+{
+    if (!index->count)
+        return -1;
+
+    ssize_t result = -1;
+    size_t mask = index->capacity - 1;
+    for (size_t i = HashMedia(media) & mask; index->by_media[i];
+         i = (i + 1) & mask)
+    {
+        vlc_playlist_item_t *item = index->by_media[i];
+        if (item->media != media)
+            continue;
+        ssize_t pos = playlist_index_Position(index, items, size, item);
+        if (result == -1 || pos < result)
+            result = pos;
+    }
+    return result;
+}
+
+/** @} */
@@ -0,0 +1,122 @@
+/*****************************************************************************
+ * playlist/index.h: playlist item lookup index
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_PLAYLIST_INDEX_H
+#define VLC_PLAYLIST_INDEX_H
+
+#include <vlc_common.h>
+
+typedef struct vlc_playlist_item vlc_playlist_item_t;
+typedef struct input_item_t input_item_t;
+
+/**
+ * \defgroup playlist_index Playlist lookup index
+ * \ingroup playlist
+ *  @{ */
+
+/**
+ * Hash indexes of the playlist items, by id and by media.
+ *
+ * The position of each item is cached in the item itself, and renumbered
+ * lazily from the lowest position modified since the last lookup.
+ *
+ * See index.c for implementation details.
+ */
+struct playlist_index {
+    vlc_playlist_item_t **by_id;
+    vlc_playlist_item_t **by_media;
+    size_t capacity; /* power of 2, shared by both tables */
+    size_t count;
+    size_t valid; /* positions below this index are up-to-date */
+};
+
+/**
+ * Initialize an empty index.
+ */
+void
+playlist_index_Init(struct playlist_index *index);
+
+/**
+ * Destroy an index.
+ */
+void
+playlist_index_Destroy(struct playlist_index *index);
+
+/**
+ * Remove all the items from the index.
+ */
+void
+playlist_index_Clear(struct playlist_index *index);
+
+/**
+ * Add items to the index.
+ *
+ * Either all the items are added, or none on allocation failure.
+ */
+bool
+playlist_index_Add(struct playlist_index *index,
+                   vlc_playlist_item_t *const items[], size_t count);
+
+/**
+ * Remove items from the index.
+ */
+void
+playlist_index_Remove(struct playlist_index *index,
+                      vlc_playlist_item_t *const items[], size_t count);
+
+/**
+ * Indicate that the items from position `from` may have moved.
+ */
+static inline void
+playlist_index_Invalidate(struct playlist_index *index, size_t from)
+{
+    if (from < index->valid)
+        index->valid = from;
+}
+
+/**
+ * Return the position of an item, or -1 if it is not indexed.
+ *
+ * `items` and `size` describe the current content of the playlist.
+ */
+ssize_t
+playlist_index_IndexOf(struct playlist_index *index,
+                       vlc_playlist_item_t *const items[], size_t size,
+                       const vlc_playlist_item_t *item);
+
+/**
+ * Return the position of the item having the given id, or -1.
+ */
+ssize_t
+playlist_index_IndexOfId(struct playlist_index *index,
+                         vlc_playlist_item_t *const items[], size_t size,
+                         uint64_t id);
+
+/**
+ * Return the lowest position of an item referencing the given media, or -1.
+ */
+ssize_t
+playlist_index_IndexOfMedia(struct playlist_index *index,
+                            vlc_playlist_item_t *const items[], size_t size,
+                            const input_item_t *media);
+
+/** @} */
+
+#endif
@@ -31,6 +31,7 @@ struct vlc_playlist_item
 {
     input_item_t *media;
     uint64_t id;
+    size_t index; /**< position hint, maintained by the playlist index */
     vlc_preparser_req *preparser_req;
     vlc_atomic_rc_t rc;
 };
@@ -67,6 +67,7 @@ vlc_playlist_New(vlc_object_t *parent, enum vlc_playlist_preparsing rec,
     playlist->stopped_action = VLC_PLAYLIST_MEDIA_STOPPED_CONTINUE;
 
     vlc_vector_init(&playlist->items);
+    playlist_index_Init(&playlist->index);
     randomizer_Init(&playlist->randomizer);
     playlist->current = -1;
     playlist->has_prev = false;
@@ -91,6 +92,7 @@ vlc_playlist_Delete(vlc_playlist_t *playlist)
     vlc_playlist_PlayerDestroy(playlist);
     randomizer_Destroy(&playlist->randomizer);
     vlc_playlist_ClearItems(playlist);
+    playlist_index_Destroy(&playlist->index);
     free(playlist);
 }
 
@@ -55,6 +55,10 @@ vlc_playlist_Shuffle(vlc_playlist_t *playlist)
         vlc_playlist_item_t *tmp = playlist->items.data[i];
         playlist->items.data[i] = playlist->items.data[selected];
         playlist->items.data[selected] = tmp;
+
+        /* keep the position hints of the index up-to-date */
+        playlist->items.data[i]->index = i;
+        playlist->items.data[selected]->index = selected;
     }
 
     struct vlc_playlist_state state;
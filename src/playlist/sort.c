@@ -462,9 +462,12 @@ vlc_playlist_Sort(vlc_playlist_t *playlist,
 
     vlc_qsort(array, playlist->items.size, sizeof(*array), compare_meta, &req);
 
-    /* apply the sorting result to the playlist */
+    /* apply the sorting result to the playlist (and to the index hints) */
     for (size_t i = 0; i < playlist->items.size; ++i)
+    {
         playlist->items.data[i] = array[i]->item;
+        playlist->items.data[i]->index = i;
+    }
 
     vlc_playlist_DeleteMetaArray(array, playlist->items.size);
 
@@ -1065,6 +1065,58 @@ test_index_of(void)
     vlc_playlist_Delete(playlist);
 }
 
+static void
+test_index_of_after_edits(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[2000];
+    CreateDummyMediaArray(media, 2000);
+
+    /* enough items to resize the index several times */
+    int ret = vlc_playlist_Append(playlist, media, 2000);
+    assert(ret == VLC_SUCCESS);
+
+    /* the same media may be inserted several times */
+    ret = vlc_playlist_InsertOne(playlist, 0, media[1500]);
+    assert(ret == VLC_SUCCESS);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[1500]) == 0);
+
+    vlc_playlist_RemoveOne(playlist, 0);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[1500]) == 1500);
+
+    vlc_playlist_Move(playlist, 10, 5, 1000);
+    vlc_playlist_Remove(playlist, 3, 2);
+    vlc_playlist_Move(playlist, 1900, 50, 7);
+    vlc_playlist_Shuffle(playlist);
+    vlc_playlist_Remove(playlist, 100, 200);
+
+    size_t count = vlc_playlist_Count(playlist);
+    assert(count == 1798);
+    for (size_t i = 0; i < count; ++i)
+    {
+        vlc_playlist_item_t *item = vlc_playlist_Get(playlist, i);
+        assert(vlc_playlist_IndexOf(playlist, item) == (ssize_t) i);
+        assert(vlc_playlist_IndexOfId(playlist, item->id) == (ssize_t) i);
+        assert(vlc_playlist_IndexOfMedia(playlist, item->media) == (ssize_t) i);
+    }
+
+    /* removed items and ids are not found anymore */
+    size_t found = 0;
+    for (size_t i = 0; i < 2000; ++i)
+        if (vlc_playlist_IndexOfMedia(playlist, media[i]) != -1)
+            found++;
+    assert(found == count);
+    assert(vlc_playlist_IndexOfId(playlist, 2000) == -1);
+
+    vlc_playlist_Clear(playlist);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[0]) == -1);
+
+    DestroyMediaArray(media, 2000);
+    vlc_playlist_Delete(playlist);
+}
+
 static void
 test_prev(void)
 {
@@ -2441,6 +2493,7 @@ int main(void)
     test_playback_order_changed_callbacks();
     test_callbacks_on_add_listener();
     test_index_of();
+    test_index_of_after_edits();
     test_prev();
     test_next();
     test_goto();
@@ -31,6 +31,7 @@
 #include <vlc_interrupt.h>
 #include <vlc_modules.h>
 #include <vlc_fs.h>
+#include <vlc_image.h>
 
 #include "input/input_interface.h"
 #include "input/input_internal.h"
@@ -41,6 +42,7 @@ union vlc_preparser_cbs_internal
     const struct vlc_preparser_cbs *parser;
     const struct vlc_thumbnailer_cbs *thumbnailer;
     const struct vlc_thumbnailer_to_files_cbs *thumbnailer_to_files;
+    const struct vlc_thumbnailer_sheet_cbs *thumbnailer_sheet;
 };
 
 struct vlc_preparser_t
@@ -66,6 +68,13 @@ struct task_thumbnail_output
     unsigned int creat_mode;
 };
 
+struct task_thumbnail_sheet
+{
+    struct vlc_thumbnailer_sheet_arg arg; /**< points array owned */
+    picture_t **pics; /**< thumbnails sent by the input, one per point */
+    atomic_size_t received; /**< number of valid pics */
+};
+
 struct vlc_preparser_req
 {
     vlc_preparser_t *preparser;
@@ -79,6 +88,7 @@ struct vlc_preparser_req
     picture_t *pic;
     struct task_thumbnail_output *outputs;
     size_t output_count;
+    struct task_thumbnail_sheet *sheet;
 
     vlc_sem_t preparse_ended;
     int preparse_status;
@@ -108,6 +118,7 @@ PreparserRequestNew(vlc_preparser_t *preparser, void (*run)(void *), input_item_
     req->pic = NULL;
     req->outputs = NULL;
     req->output_count = 0;
+    req->sheet = NULL;
     vlc_atomic_rc_init(&req->rc);
 
     if (thumb_arg == NULL)
@@ -126,7 +137,8 @@ PreparserRequestNew(vlc_preparser_t *preparser, void (*run)(void *), input_item_
 
     req->runnable.run = run;
     req->runnable.userdata = req;
-    if (options & VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES)
+    if (options & (VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES |
+                   VLC_PREPARSER_TYPE_THUMBNAIL_SHEET))
         req->i11e_ctx = vlc_interrupt_create();
     else
         req->i11e_ctx = NULL;
@@ -141,6 +153,12 @@ PreparserRequestDelete(struct vlc_preparser_req *req)
     for (size_t i = 0; i < req->output_count; ++i)
         free(req->outputs[i].file_path);
     free(req->outputs);
+    if (req->sheet != NULL)
+    {
+        free((void *)req->sheet->arg.points.times);
+        free(req->sheet->pics);
+        free(req->sheet);
+    }
     if (req->i11e_ctx != NULL)
         vlc_interrupt_destroy(req->i11e_ctx);
     free(req);
@@ -555,6 +573,371 @@ error:
         vlc_preparser_req_Release(req);
 }
 
+static void
+ThumbnailSheetSeek(input_thread_t *input,
+                   const struct vlc_thumbnailer_sheet_arg *arg, size_t index)
+{
+    assert(index < arg->points.count);
+
+    /* Always seek fast: the thumbnail is taken from the nearest key frame */
+    switch (arg->points.type)
+    {
+        case VLC_THUMBNAILER_POINTS_SPACED:
+            input_SetPosition(input, (index + .5) / arg->points.count, true);
+            break;
+        case VLC_THUMBNAILER_POINTS_TIME:
+        {
+            vlc_tick_t time = arg->points.times[index];
+            if (time < VLC_TICK_0)
+                time = VLC_TICK_0;
+            input_SetTime(input, time, true);
+            break;
+        }
+        case VLC_THUMBNAILER_POINTS_POS:
+        {
+            double pos = arg->points.positions[index];
+            if (pos < 0)
+                pos = 0;
+            else if (pos > 1)
+                pos = 1;
+            input_SetPosition(input, pos, true);
+            break;
+        }
+        default:
+            vlc_assert_unreachable();
+    }
+}
+
+static bool
+on_thumbnailer_sheet_input_event( input_thread_t *input,
+                                  const struct vlc_input_event *event,
+                                  void *userdata )
+{
+    if ( event->type != INPUT_EVENT_THUMBNAIL_READY &&
+         ( event->type != INPUT_EVENT_STATE || ( event->state.value != ERROR_S &&
+                                                 event->state.value != END_S ) ) )
+         return false;
+
+    struct vlc_preparser_req *req = userdata;
+    struct task_thumbnail_sheet *sheet = req->sheet;
+
+    if (event->type == INPUT_EVENT_THUMBNAIL_READY)
+    {
+        size_t index = atomic_load_explicit(&sheet->received,
+                                            memory_order_relaxed);
+        if (index >= sheet->arg.points.count)
+            return true;
+
+        sheet->pics[index] = picture_Hold(event->thumbnail);
+
+        /* Request the next point right away, from the decoder thread, so
+         * that the demuxer does not run ahead to the end of the media while
+         * the thumbnail is being processed. */
+        if (index + 1 < sheet->arg.points.count)
+            ThumbnailSheetSeek(input, &sheet->arg, index + 1);
+
+        atomic_store_explicit(&sheet->received, index + 1,
+                              memory_order_release);
+    }
+    vlc_sem_post(&req->preparse_ended);
+    return true;
+}
+
+static picture_t *
+ThumbnailSheetScale(image_handler_t *image, picture_t *pic,
+                    unsigned *width, unsigned *height)
+{
+    const video_format_t *fmt = &pic->format;
+
+    if (*width == 0 || *height == 0)
+    {
+        /* Size the tiles from the first thumbnail, square pixels */
+        unsigned sar_num = fmt->i_sar_num ? fmt->i_sar_num : 1;
+        unsigned sar_den = fmt->i_sar_den ? fmt->i_sar_den : 1;
+        uint64_t display_width = (uint64_t)fmt->i_visible_width * sar_num
+                               / sar_den;
+
+        if (*width == 0 && *height == 0)
+        {
+            *width = display_width;
+            *height = fmt->i_visible_height;
+        }
+        else if (*width == 0)
+            *width = display_width * *height / fmt->i_visible_height;
+        else
+            *height = (uint64_t)fmt->i_visible_height * *width / display_width;
+
+        /* Keep the chroma planes of the tiles aligned in the sheet */
+        *width = __MAX(*width & ~1u, 2);
+        *height = __MAX(*height & ~1u, 2);
+    }
+
+    if (fmt->i_visible_width == *width && fmt->i_visible_height == *height)
+        return picture_Hold(pic);
+
+    video_format_t fmt_out;
+    video_format_Copy(&fmt_out, fmt);
+    fmt_out.i_width = fmt_out.i_visible_width = *width;
+    fmt_out.i_height = fmt_out.i_visible_height = *height;
+    fmt_out.i_x_offset = fmt_out.i_y_offset = 0;
+    fmt_out.i_sar_num = fmt_out.i_sar_den = 1;
+
+    picture_t *scaled = image_Convert(image, pic, fmt, &fmt_out);
+    video_format_Clean(&fmt_out);
+    return scaled;
+}
+
+static picture_t *
+ThumbnailSheetCompose(const struct task_thumbnail_sheet *sheet,
+                      picture_t *const *tiles, const picture_t *first,
+                      unsigned width, unsigned height)
+{
+    const video_format_t *tile_fmt = &first->format;
+    size_t count = sheet->arg.points.count;
+    unsigned columns = sheet->arg.columns;
+    if (columns == 0)
+        while ((size_t)columns * columns < count)
+            columns++;
+    if (columns > count)
+        columns = count;
+    unsigned rows = (count + columns - 1) / columns;
+
+    video_format_t fmt;
+    video_format_Init(&fmt, tile_fmt->i_chroma);
+    fmt.i_width = fmt.i_visible_width = width * columns;
+    fmt.i_height = fmt.i_visible_height = height * rows;
+    fmt.i_sar_num = fmt.i_sar_den = 1;
+    fmt.color_range = tile_fmt->color_range;
+    fmt.space = tile_fmt->space;
+    fmt.primaries = tile_fmt->primaries;
+    fmt.transfer = tile_fmt->transfer;
+
+    picture_t *pic = picture_NewFromFormat(&fmt);
+    if (pic == NULL)
+        return NULL;
+
+    /* Black background for the missing tiles */
+    const vlc_chroma_description_t *dsc =
+        vlc_fourcc_GetChromaDescription(fmt.i_chroma);
+    bool yuv8 = dsc != NULL && vlc_chroma_description_IsYUV(dsc)
+             && dsc->pixel_size == 1;
+    for (int i = 0; i < pic->i_planes; i++)
+    {
+        plane_t *p = &pic->p[i];
+        int value = yuv8 && (i == U_PLANE || i == V_PLANE) ? 0x80 : 0;
+        memset(p->p_pixels, value, (size_t)p->i_pitch * p->i_lines);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const picture_t *tile = tiles[i];
+        if (tile == NULL)
+            continue;
+
+        unsigned column = i % columns, row = i / columns;
+        for (int j = 0; j < pic->i_planes && j < tile->i_planes; j++)
+        {
+            const plane_t *src = &tile->p[j];
+            plane_t *dst = &pic->p[j];
+            size_t x = (size_t)column * dst->i_visible_pitch / columns;
+            size_t y = (size_t)row * dst->i_visible_lines / rows;
+            size_t size = __MIN((unsigned)src->i_visible_pitch,
+                                dst->i_visible_pitch / columns);
+            unsigned lines = __MIN((unsigned)src->i_visible_lines,
+                                   dst->i_visible_lines / rows);
+
+            for (unsigned k = 0; k < lines; k++)
+                memcpy(&dst->p_pixels[(y + k) * dst->i_pitch + x],
+                       &src->p_pixels[k * src->i_pitch], size);
+        }
+    }
+
+    picture_CopyProperties(pic, first);
+    return pic;
+}
+
+static int
+ThumbnailSheetExport(struct vlc_preparser_req *req, picture_t *pic,
+                     const struct task_thumbnail_output *output)
+{
+    if (output->fourcc == VLC_CODEC_UNKNOWN)
+        return VLC_EGENERIC;
+
+    block_t *block;
+    int ret = picture_Export(req->preparser->owner, &block, NULL, pic,
+                             output->fourcc, output->width, output->height,
+                             output->crop);
+    if (ret != VLC_SUCCESS)
+        return ret;
+
+    ret = WriteToFile(block, output->file_path, output->creat_mode);
+    block_Release(block);
+    return ret;
+}
+
+static void
+ThumbnailerSheetRun(void *userdata)
+{
+    vlc_thread_set_name("vlc-run-thsheet");
+
+    struct vlc_preparser_req *req = userdata;
+    vlc_preparser_t *preparser = req->preparser;
+    struct task_thumbnail_sheet *sheet = req->sheet;
+    const size_t count = sheet->arg.points.count;
+    picture_t *result = NULL, *first = NULL;
+    unsigned width = sheet->arg.tile_width;
+    unsigned height = sheet->arg.tile_height;
+
+    static const struct vlc_input_thread_callbacks cbs = {
+        .on_event = on_thumbnailer_sheet_input_event,
+    };
+
+    const struct vlc_input_thread_cfg cfg = {
+        .type = INPUT_TYPE_THUMBNAILING,
+        .hw_dec = sheet->arg.hw_dec ? INPUT_CFG_HW_DEC_ENABLED
+                                    : INPUT_CFG_HW_DEC_DISABLED,
+        .thumbnailing.keyframes_only = sheet->arg.keyframes_only,
+        .cbs = &cbs,
+        .cbs_data = req,
+    };
+
+    vlc_tick_t deadline = preparser->timeout != VLC_TICK_INVALID ?
+                          vlc_tick_now() + preparser->timeout :
+                          VLC_TICK_INVALID;
+
+    vlc_interrupt_set(req->i11e_ctx);
+
+    picture_t **tiles = calloc(count, sizeof(*tiles));
+    image_handler_t *image = image_HandlerCreate(preparser->owner);
+    if (tiles == NULL || image == NULL)
+        goto end;
+
+    input_thread_t *input = input_Create(preparser->owner, req->item, &cfg);
+    if (input == NULL)
+        goto end;
+
+    ThumbnailSheetSeek(input, &sheet->arg, 0);
+
+    if (input_Start(input) != VLC_SUCCESS)
+    {
+        input_Close(input);
+        goto end;
+    }
+
+    size_t done = 0;
+    while (done < count)
+    {
+        if (deadline == VLC_TICK_INVALID)
+            vlc_sem_wait(&req->preparse_ended);
+        else if (vlc_sem_timedwait(&req->preparse_ended, deadline))
+        {
+            req->preparse_status = VLC_ETIMEOUT;
+            break;
+        }
+
+        if (atomic_load(&req->interrupted))
+            break;
+
+        size_t received = atomic_load_explicit(&sheet->received,
+                                               memory_order_acquire);
+        if (done == received)
+            break; /* The input ended before reaching all the points */
+
+        picture_t *pic = sheet->pics[done];
+        sheet->pics[done] = NULL;
+
+        tiles[done] = ThumbnailSheetScale(image, pic, &width, &height);
+        picture_Release(pic);
+        if (tiles[done] != NULL)
+        {
+            if (first == NULL)
+                first = tiles[done];
+            if (req->cbs.thumbnailer_sheet->on_thumbnail != NULL)
+                req->cbs.thumbnailer_sheet->on_thumbnail(req, done, tiles[done],
+                                                         req->userdata);
+        }
+        else
+            msg_Warn(preparser->owner, "thumbnailer: cannot scale thumbnail "
+                     "%zu to %ux%u", done, width, height);
+        done++;
+    }
+
+    input_Stop(input);
+    input_Close(input);
+
+    /* Thumbnails received after the timeout or the interruption */
+    for (size_t i = done; i < count; i++)
+        if (sheet->pics[i] != NULL)
+            picture_Release(sheet->pics[i]);
+
+    if (atomic_load(&req->interrupted))
+    {
+        req->preparse_status = -EINTR;
+        goto end;
+    }
+    if (first == NULL)
+    {
+        if (req->preparse_status != VLC_ETIMEOUT)
+            req->preparse_status = VLC_EGENERIC;
+        goto end;
+    }
+    if (done < count)
+        msg_Warn(preparser->owner, "thumbnailer: only %zu of %zu thumbnails "
+                 "generated", done, count);
+
+    req->preparse_status = VLC_SUCCESS;
+
+    if (sheet->arg.tiled)
+    {
+        result = ThumbnailSheetCompose(sheet, tiles, first, width, height);
+        if (result == NULL)
+        {
+            req->preparse_status = VLC_ENOMEM;
+            goto end;
+        }
+    }
+
+    for (size_t i = 0; i < req->output_count; i++)
+    {
+        picture_t *pic = sheet->arg.tiled ? result : tiles[i];
+        if (pic == NULL)
+            continue;
+
+        int ret = ThumbnailSheetExport(req, pic, &req->outputs[i]);
+        if (ret == -EINTR)
+        {
+            req->preparse_status = -EINTR;
+            break;
+        }
+        if (ret != VLC_SUCCESS)
+        {
+            msg_Warn(preparser->owner, "thumbnailer: cannot write %s",
+                     req->outputs[i].file_path);
+            req->preparse_status = VLC_EGENERIC;
+        }
+    }
+
+end:
+    if (image != NULL)
+        image_HandlerDelete(image);
+
+    PreparserRemoveTask(preparser, req);
+    req->cbs.thumbnailer_sheet->on_ended(req, req->preparse_status,
+                                         req->preparse_status == VLC_SUCCESS ?
+                                         result : NULL, req->userdata);
+    if (result != NULL)
+        picture_Release(result);
+    if (tiles != NULL)
+    {
+        for (size_t i = 0; i < count; i++)
+            if (tiles[i] != NULL)
+                picture_Release(tiles[i]);
+        free(tiles);
+    }
+    vlc_interrupt_set(NULL);
+    vlc_preparser_req_Release(req);
+}
+
 static void
 Interrupt(struct vlc_preparser_req *req)
 {
@@ -583,7 +966,8 @@ vlc_preparser_t* vlc_preparser_New( vlc_object_t *parent,
     assert(request_type & (VLC_PREPARSER_TYPE_FETCHMETA_ALL|
                            VLC_PREPARSER_TYPE_PARSE|
                            VLC_PREPARSER_TYPE_THUMBNAIL|
-                           VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES));
+                           VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES|
+                           VLC_PREPARSER_TYPE_THUMBNAIL_SHEET));
 
     unsigned parser_threads = cfg->max_parser_threads == 0 ? 1 :
                               cfg->max_parser_threads;
@@ -616,7 +1000,8 @@ vlc_preparser_t* vlc_preparser_New( vlc_object_t *parent,
         preparser->fetcher = NULL;
 
     if (request_type & (VLC_PREPARSER_TYPE_THUMBNAIL |
-                        VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES))
+                        VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES |
+                        VLC_PREPARSER_TYPE_THUMBNAIL_SHEET))
     {
         preparser->thumbnailer = vlc_executor_New(thumbnailer_threads);
         if (!preparser->thumbnailer)
@@ -854,6 +1239,126 @@ vlc_preparser_GenerateThumbnailToFiles( vlc_preparser_t *preparser, input_item_t
     return PreparserRequestRetain(req);
 }
 
+vlc_preparser_req *
+vlc_preparser_GenerateThumbnailSheet( vlc_preparser_t *preparser,
+                                      input_item_t *item,
+                                      const struct vlc_thumbnailer_sheet_arg *arg,
+                                      const struct vlc_thumbnailer_output *outputs,
+                                      size_t output_count,
+                                      const struct vlc_thumbnailer_sheet_cbs *cbs,
+                                      void *cbs_userdata )
+{
+    assert(preparser->thumbnailer != NULL);
+    assert(arg != NULL && arg->points.count > 0);
+    assert(cbs != NULL && cbs->on_ended != NULL);
+    assert(output_count == 0 || outputs != NULL);
+    assert(output_count == 0 || arg->tiled
+        || output_count == arg->points.count);
+
+    union vlc_preparser_cbs_internal req_cbs = {
+        .thumbnailer_sheet = cbs,
+    };
+
+    struct vlc_preparser_req *req =
+        PreparserRequestNew(preparser, ThumbnailerSheetRun, item,
+                            VLC_PREPARSER_TYPE_THUMBNAIL_SHEET, NULL,
+                            req_cbs, cbs_userdata);
+    if (req == NULL)
+        return NULL;
+
+    const size_t count = arg->points.count;
+    struct task_thumbnail_sheet *sheet = malloc(sizeof(*sheet));
+    if (unlikely(sheet == NULL))
+    {
+        PreparserRequestDelete(req);
+        return NULL;
+    }
+    sheet->arg = *arg;
+    sheet->arg.points.times = NULL;
+    sheet->pics = calloc(count, sizeof(*sheet->pics));
+    atomic_init(&sheet->received, 0);
+    req->sheet = sheet;
+    if (unlikely(sheet->pics == NULL))
+    {
+        PreparserRequestDelete(req);
+        return NULL;
+    }
+
+    /* Copy the points, the caller array is not valid after this call */
+    switch (arg->points.type)
+    {
+        case VLC_THUMBNAILER_POINTS_SPACED:
+            break;
+        case VLC_THUMBNAILER_POINTS_TIME:
+        {
+            vlc_tick_t *times = vlc_alloc(count, sizeof(*times));
+            if (unlikely(times == NULL))
+            {
+                PreparserRequestDelete(req);
+                return NULL;
+            }
+            memcpy(times, arg->points.times, count * sizeof(*times));
+            sheet->arg.points.times = times;
+            break;
+        }
+        case VLC_THUMBNAILER_POINTS_POS:
+        {
+            double *positions = vlc_alloc(count, sizeof(*positions));
+            if (unlikely(positions == NULL))
+            {
+                PreparserRequestDelete(req);
+                return NULL;
+            }
+            memcpy(positions, arg->points.positions,
+                   count * sizeof(*positions));
+            sheet->arg.points.positions = positions;
+            break;
+        }
+        default:
+            vlc_assert_unreachable();
+    }
+
+    if (output_count > 0)
+    {
+        req->outputs = vlc_alloc(output_count, sizeof(*req->outputs));
+        if (unlikely(req->outputs == NULL))
+        {
+            PreparserRequestDelete(req);
+            return NULL;
+        }
+    }
+
+    for (size_t i = 0; i < output_count; ++i)
+    {
+        struct task_thumbnail_output *dst = &req->outputs[i];
+        const struct vlc_thumbnailer_output *src = &outputs[i];
+        assert(src->file_path != NULL);
+
+        int ret = CheckThumbnailerFormat(src->format, NULL, NULL, &dst->fourcc);
+        if (ret != 0)
+            dst->fourcc = VLC_CODEC_UNKNOWN;
+
+        dst->width = src->width;
+        dst->height = src->height;
+        dst->crop = src->crop;
+        dst->creat_mode = src->creat_mode;
+        dst->file_path = strdup(src->file_path);
+
+        if (unlikely(dst->file_path == NULL))
+        {
+            PreparserRequestDelete(req);
+            return NULL;
+        }
+        req->output_count++;
+    }
+
+    PreparserAddTask(preparser, req);
+
+    vlc_executor_Submit(preparser->thumbnailer, &req->runnable);
+
+    return PreparserRequestRetain(req);
+}
+
 size_t vlc_preparser_Cancel( vlc_preparser_t *preparser, vlc_preparser_req *req )
 {
     vlc_mutex_lock(&preparser->lock);
@@ -874,7 +1379,8 @@ size_t vlc_preparser_Cancel( vlc_preparser_t *preparser, vlc_preparser_req *req
                                                &req_itr->runnable);
             }
             else if (req_itr->options & (VLC_PREPARSER_TYPE_THUMBNAIL |
-                                         VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES))
+                                         VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES |
+                                         VLC_PREPARSER_TYPE_THUMBNAIL_SHEET))
             {
                 assert(preparser->thumbnailer != NULL);
                 canceled = vlc_executor_Cancel(preparser->thumbnailer,
@@ -909,6 +1415,11 @@ size_t vlc_preparser_Cancel( vlc_preparser_t *preparser, vlc_preparser_req *req
                                                        req_itr->preparse_status, NULL,
                                                        req_itr->userdata);
                 }
+                else if (req_itr->options & VLC_PREPARSER_TYPE_THUMBNAIL_SHEET)
+                    req_itr->cbs.thumbnailer_sheet->on_ended(req_itr,
+                                                             req_itr->preparse_status,
+                                                             NULL,
+                                                             req_itr->userdata);
                 else
                 {
                     assert(req_itr->options & VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES);
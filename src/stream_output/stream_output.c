@@ -31,6 +31,7 @@
 #endif
 
 #include <assert.h>
+#include <stdatomic.h>
 
 #include <vlc_common.h>
 #include <vlc_arrays.h>
@@ -49,6 +50,7 @@
 #include <vlc_frame.h>
 #include <vlc_codec.h>
 #include <vlc_modules.h>
+#include <vlc_atomic.h>
 
 #include "input/input_interface.h"
 
@@ -59,6 +61,12 @@
  * Local prototypes
  *****************************************************************************/
 static char *sout_stream_url_to_chain( bool, const char * );
+struct sout_metrics;
+static struct sout_metrics *sout_MetricsNew( void );
+static void sout_MetricsRelease( struct sout_metrics * );
+static sout_stream_t *sout_StreamChainNewMetrics( vlc_object_t *, const char *,
+                                                  sout_stream_t *,
+                                                  struct sout_metrics * );
 
 /*
  * Generic MRL parser
@@ -103,11 +111,17 @@ sout_stream_t *sout_NewInstance( vlc_object_t *p_parent, const char *psz_dest )
 
     msg_Dbg(p_parent, "creating stream output chain `%s'", psz_chain);
 
-    p_sout = sout_StreamChainNew(p_parent, psz_chain, NULL);
+    /* All the elements of the instance share the same metrics */
+    struct sout_metrics *metrics = sout_MetricsNew();
+
+    p_sout = sout_StreamChainNewMetrics(p_parent, psz_chain, NULL, metrics);
     if (p_sout == NULL)
         msg_Err(p_parent, "failed to create stream output chain `%s'",
                 psz_chain);
     free(psz_chain);
+
+    if (metrics != NULL)
+        sout_MetricsRelease(metrics);
     return p_sout;
 }
 
@@ -211,6 +225,251 @@ int sout_InputSendBuffer( sout_stream_t *p_sout,
     return sout_StreamIdSend( p_sout, p_input->id, frame );
 }
 
+/*****************************************************************************
+ * Chain metrics
+ *****************************************************************************/
+
+/* Counters shared by all the elements, muxers and access outputs of a stream
+ * output instance. Gauges and peaks are sampled (and the windowed values
+ * reset) by sout_StreamGetStats(). */
+struct sout_metrics
+{
+    vlc_atomic_rc_t rc;
+
+    /* Muxer input fifos */
+    atomic_uint_fast64_t fifo_blocks;
+    atomic_uint_fast64_t fifo_bytes;
+    atomic_uint_fast64_t fifo_peak;
+    atomic_uint_fast64_t muxed;
+    atomic_uint_fast64_t mux_wait_sum;
+    atomic_uint_fast64_t mux_wait_count;
+    atomic_uint_fast64_t mux_wait_max;
+
+    /* Access outputs */
+    atomic_uint_fast64_t writes;
+    atomic_uint_fast64_t written;
+    atomic_uint_fast64_t write_errors;
+    atomic_uint_fast64_t write_time_sum;
+    atomic_uint_fast64_t write_time_count;
+    atomic_uint_fast64_t write_time_max;
+
+    atomic_uint_fast64_t dropped;
+    atomic_uint_fast64_t late;
+
+    /* Owner side, only touched by sout_StreamGetStats() */
+    uint64_t rate_bytes;
+    vlc_tick_t rate_date;
+    float rate;
+};
+
+static struct sout_metrics *sout_MetricsNew(void)
+{
+    struct sout_metrics *metrics = malloc(sizeof (*metrics));
+    if (unlikely(metrics == NULL))
+        return NULL;
+
+    vlc_atomic_rc_init(&metrics->rc);
+    atomic_init(&metrics->fifo_blocks, 0);
+    atomic_init(&metrics->fifo_bytes, 0);
+    atomic_init(&metrics->fifo_peak, 0);
+    atomic_init(&metrics->muxed, 0);
+    atomic_init(&metrics->mux_wait_sum, 0);
+    atomic_init(&metrics->mux_wait_count, 0);
+    atomic_init(&metrics->mux_wait_max, 0);
+    atomic_init(&metrics->writes, 0);
+    atomic_init(&metrics->written, 0);
+    atomic_init(&metrics->write_errors, 0);
+    atomic_init(&metrics->write_time_sum, 0);
+    atomic_init(&metrics->write_time_count, 0);
+    atomic_init(&metrics->write_time_max, 0);
+    atomic_init(&metrics->dropped, 0);
+    atomic_init(&metrics->late, 0);
+    metrics->rate_bytes = 0;
+    metrics->rate_date = VLC_TICK_INVALID;
+    metrics->rate = 0.f;
+    return metrics;
+}
+
+static struct sout_metrics *sout_MetricsHold(struct sout_metrics *metrics)
+{
+    vlc_atomic_rc_inc(&metrics->rc);
+    return metrics;
+}
+
+static void sout_MetricsRelease(struct sout_metrics *metrics)
+{
+    if (vlc_atomic_rc_dec(&metrics->rc))
+        free(metrics);
+}
+
+static inline void sout_MetricsAdd(atomic_uint_fast64_t *counter,
+                                   uint64_t value)
+{
+    atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+}
+
+static inline uint64_t sout_MetricsGet(atomic_uint_fast64_t *counter)
+{
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+static inline uint64_t sout_MetricsReset(atomic_uint_fast64_t *counter)
+{
+    return atomic_exchange_explicit(counter, 0, memory_order_relaxed);
+}
+
+static void sout_MetricsMax(atomic_uint_fast64_t *peak, uint64_t value)
+{
+    uint_fast64_t cur = atomic_load_explicit(peak, memory_order_relaxed);
+
+    while (value > cur
+        && !atomic_compare_exchange_weak_explicit(peak, &cur, value,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed));
+}
+
+static struct sout_metrics *sout_StreamMetrics(sout_stream_t *);
+
+/* Sub-chain elements, muxers and access outputs account in the metrics of the
+ * closest stream output element above them. */
+static struct sout_metrics *sout_MetricsFind(vlc_object_t *obj)
+{
+    for (; obj != NULL; obj = vlc_object_parent(obj))
+    {
+        const char *type = vlc_object_typename(obj);
+
+        if (type != NULL && strcmp(type, "stream out") == 0)
+        {
+            struct sout_metrics *metrics =
+                sout_StreamMetrics(container_of(obj, sout_stream_t, obj));
+            if (metrics != NULL)
+                return metrics;
+        }
+    }
+    return NULL;
+}
+
+struct sout_access_out_private
+{
+    sout_access_out_t access;
+    struct sout_metrics *metrics;
+};
+
+#define sout_access_priv(a) \
+        container_of(a, struct sout_access_out_private, access)
+
+struct sout_mux_private
+{
+    sout_mux_t mux;
+    struct sout_metrics *metrics;
+};
+
+#define sout_mux_priv(m) container_of(m, struct sout_mux_private, mux)
+
+struct sout_input_private
+{
+    sout_input_t input;
+
+    /* Dates at which the queued blocks were sent, oldest first */
+    vlc_tick_t *dates;
+    size_t dates_size; /* power of 2 */
+    size_t dates_head;
+    size_t dates_count;
+
+    /* Fifo depth last accounted in the metrics */
+    size_t fifo_blocks;
+    size_t fifo_bytes;
+};
+
+#define sout_input_priv(i) container_of(i, struct sout_input_private, input)
+
+static struct sout_metrics *sout_MuxMetrics(sout_mux_t *p_mux)
+{
+    return sout_mux_priv(p_mux)->metrics;
+}
+
+static void sout_InputPushDate(struct sout_input_private *priv, vlc_tick_t now)
+{
+    if (priv->dates_count == priv->dates_size)
+    {
+        size_t size = priv->dates_size ? priv->dates_size * 2 : 16;
+        vlc_tick_t *dates = malloc(size * sizeof (*dates));
+        if (unlikely(dates == NULL))
+            return; /* the wait of this block will not be accounted */
+
+        for (size_t i = 0; i < priv->dates_count; i++)
+            dates[i] = priv->dates[(priv->dates_head + i)
+                                   & (priv->dates_size - 1)];
+        free(priv->dates);
+        priv->dates = dates;
+        priv->dates_size = size;
+        priv->dates_head = 0;
+    }
+
+    priv->dates[(priv->dates_head + priv->dates_count)
+                & (priv->dates_size - 1)] = now;
+    priv->dates_count++;
+}
+
+/* Accounts the blocks dequeued by the muxer since the previous call and the
+ * new depth of the input fifo */
+static void sout_InputAccount(struct sout_metrics *metrics,
+                              struct sout_input_private *priv, vlc_tick_t now)
+{
+    block_fifo_t *fifo = priv->input.p_fifo;
+
+    vlc_fifo_Lock(fifo);
+    size_t blocks = vlc_fifo_GetCount(fifo);
+    size_t bytes = vlc_fifo_GetBytes(fifo);
+    vlc_fifo_Unlock(fifo);
+
+    if (priv->dates_count > blocks)
+    {
+        uint64_t muxed = priv->dates_count - blocks;
+        uint64_t wait = 0, wait_max = 0;
+
+        while (priv->dates_count > blocks)
+        {
+            vlc_tick_t date = priv->dates[priv->dates_head];
+            uint64_t w = now > date ? now - date : 0;
+
+            wait += w;
+            if (w > wait_max)
+                wait_max = w;
+            priv->dates_head = (priv->dates_head + 1) & (priv->dates_size - 1);
+            priv->dates_count--;
+        }
+        sout_MetricsAdd(&metrics->muxed, muxed);
+        sout_MetricsAdd(&metrics->mux_wait_sum, wait);
+        sout_MetricsAdd(&metrics->mux_wait_count, muxed);
+        sout_MetricsMax(&metrics->mux_wait_max, wait_max);
+    }
+
+    /* Unsigned wrap-around turns these into signed deltas */
+    sout_MetricsAdd(&metrics->fifo_blocks, blocks - priv->fifo_blocks);
+    sout_MetricsAdd(&metrics->fifo_bytes, bytes - priv->fifo_bytes);
+    sout_MetricsMax(&metrics->fifo_peak, blocks);
+    priv->fifo_blocks = blocks;
+    priv->fifo_bytes = bytes;
+}
+
+static void sout_MuxAccount(sout_mux_t *p_mux, struct sout_metrics *metrics)
+{
+    vlc_tick_t now = vlc_tick_now();
+
+    for (int i = 0; i < p_mux->i_nb_inputs; i++)
+        sout_InputAccount(metrics, sout_input_priv(p_mux->pp_inputs[i]), now);
+}
+
+void sout_MuxDropBlock( sout_mux_t *p_mux, block_t *p_block, bool b_late )
+{
+    struct sout_metrics *metrics = sout_MuxMetrics( p_mux );
+
+    if( metrics != NULL )
+        sout_MetricsAdd( b_late ? &metrics->late : &metrics->dropped, 1 );
+    block_Release( p_block );
+}
+
 #undef sout_AccessOutNew
 /*****************************************************************************
  * sout_AccessOutNew: allocate a new access out
@@ -218,12 +477,15 @@ int sout_InputSendBuffer( sout_stream_t *p_sout,
 sout_access_out_t *sout_AccessOutNew( vlc_object_t *p_sout,
                                       const char *psz_access, const char *psz_name )
 {
+    struct sout_access_out_private *priv;
     sout_access_out_t *p_access;
     char              *psz_next;
 
-    p_access = vlc_custom_create( p_sout, sizeof( *p_access ), "access out" );
-    if( !p_access )
+    priv = vlc_custom_create( p_sout, sizeof( *priv ), "access out" );
+    if( !priv )
         return NULL;
+    priv->metrics = sout_MetricsFind( p_sout );
+    p_access = &priv->access;
 
     psz_next = config_ChainCreate( &p_access->psz_access, &p_access->p_cfg,
                                    psz_access );
@@ -294,7 +556,24 @@ ssize_t sout_AccessOutRead( sout_access_out_t *p_access, block_t *p_buffer )
  *****************************************************************************/
 ssize_t sout_AccessOutWrite( sout_access_out_t *p_access, block_t *p_buffer )
 {
-    return p_access->pf_write( p_access, p_buffer );
+    struct sout_metrics *metrics = sout_access_priv( p_access )->metrics;
+
+    if( metrics == NULL )
+        return p_access->pf_write( p_access, p_buffer );
+
+    vlc_tick_t start = vlc_tick_now();
+    ssize_t ret = p_access->pf_write( p_access, p_buffer );
+    uint64_t duration = vlc_tick_now() - start;
+
+    sout_MetricsAdd( &metrics->writes, 1 );
+    if( ret >= 0 )
+        sout_MetricsAdd( &metrics->written, ret );
+    else
+        sout_MetricsAdd( &metrics->write_errors, 1 );
+    sout_MetricsAdd( &metrics->write_time_sum, duration );
+    sout_MetricsAdd( &metrics->write_time_count, 1 );
+    sout_MetricsMax( &metrics->write_time_max, duration );
+    return ret;
 }
 
 /**
@@ -319,12 +598,15 @@ int sout_AccessOutControl (sout_access_out_t *access, int query, ...)
  *****************************************************************************/
 sout_mux_t *sout_MuxNew( sout_access_out_t *p_access, const char *psz_mux )
 {
+    struct sout_mux_private *priv;
     sout_mux_t *p_mux;
     char       *psz_next;
 
-    p_mux = vlc_custom_create( p_access, sizeof( *p_mux ), "mux" );
-    if( p_mux == NULL )
+    priv = vlc_custom_create( p_access, sizeof( *priv ), "mux" );
+    if( priv == NULL )
         return NULL;
+    priv->metrics = sout_MetricsFind( VLC_OBJECT(p_access) );
+    p_mux = &priv->mux;
 
     psz_next = config_ChainCreate( &p_mux->psz_mux, &p_mux->p_cfg, psz_mux );
     free( psz_next );
@@ -398,6 +680,7 @@ void sout_MuxDelete( sout_mux_t *p_mux )
  *****************************************************************************/
 sout_input_t *sout_MuxAddStream( sout_mux_t *p_mux, const es_format_t *p_fmt )
 {
+    struct sout_input_private *priv;
     sout_input_t *p_input;
 
     if( !p_mux->b_add_stream_any_time && !p_mux->b_waiting_stream )
@@ -410,9 +693,13 @@ sout_input_t *sout_MuxAddStream( sout_mux_t *p_mux, const es_format_t *p_fmt )
     msg_Dbg( p_mux, "adding a new input" );
 
     /* create a new sout input */
-    p_input = malloc( sizeof( sout_input_t ) );
-    if( !p_input )
+    priv = malloc( sizeof( *priv ) );
+    if( !priv )
         return NULL;
+    priv->dates = NULL;
+    priv->dates_size = priv->dates_head = priv->dates_count = 0;
+    priv->fifo_blocks = priv->fifo_bytes = 0;
+    p_input = &priv->input;
 
     // FIXME: remove either fmt or p_fmt...
     es_format_Copy( &p_input->fmt, p_fmt );
@@ -428,7 +715,7 @@ sout_input_t *sout_MuxAddStream( sout_mux_t *p_mux, const es_format_t *p_fmt )
         TAB_REMOVE( p_mux->i_nb_inputs, p_mux->pp_inputs, p_input );
         block_FifoRelease( p_input->p_fifo );
         es_format_Clean( &p_input->fmt );
-        free( p_input );
+        free( priv );
         return NULL;
     }
 
@@ -463,9 +750,18 @@ void sout_MuxDeleteStream( sout_mux_t *p_mux, sout_input_t *p_input )
             msg_Warn( p_mux, "no more input streams for this mux" );
         }
 
+        struct sout_input_private *priv = sout_input_priv( p_input );
+        struct sout_metrics *metrics = sout_MuxMetrics( p_mux );
+        if( metrics != NULL )
+        {
+            sout_MetricsAdd( &metrics->fifo_blocks, -(uint64_t)priv->fifo_blocks );
+            sout_MetricsAdd( &metrics->fifo_bytes, -(uint64_t)priv->fifo_bytes );
+        }
+
         block_FifoRelease( p_input->p_fifo );
         es_format_Clean( &p_input->fmt );
-        free( p_input );
+        free( priv->dates );
+        free( priv );
     }
 }
 
@@ -475,7 +771,16 @@ void sout_MuxDeleteStream( sout_mux_t *p_mux, sout_input_t *p_input )
 int sout_MuxSendBuffer( sout_mux_t *p_mux, sout_input_t *p_input,
                          block_t *p_buffer )
 {
+    struct sout_metrics *metrics = sout_MuxMetrics( p_mux );
     vlc_tick_t i_dts = p_buffer->i_dts;
+
+    if( metrics != NULL )
+    {
+        struct sout_input_private *priv = sout_input_priv( p_input );
+
+        sout_InputPushDate( priv, vlc_tick_now() );
+        sout_MetricsMax( &metrics->fifo_peak, priv->fifo_blocks + 1 );
+    }
     block_FifoPut( p_input->p_fifo, p_buffer );
 
     if( i_dts == VLC_TICK_INVALID )
@@ -490,16 +795,31 @@ int sout_MuxSendBuffer( sout_mux_t *p_mux, sout_input_t *p_input,
 
         /* Wait until we have enough data before muxing */
         if( llabs( i_dts - p_mux->i_add_stream_start ) < i_caching )
+        {
+            if( metrics != NULL )
+                sout_InputAccount( metrics, sout_input_priv( p_input ),
+                                   vlc_tick_now() );
             return VLC_SUCCESS;
+        }
         p_mux->b_waiting_stream = false;
     }
-    return p_mux->pf_mux( p_mux );
+
+    int ret = p_mux->pf_mux( p_mux );
+    if( metrics != NULL )
+        sout_MuxAccount( p_mux, metrics );
+    return ret;
 }
 
 void sout_MuxFlush( sout_mux_t *p_mux, sout_input_t *p_input )
 {
-    VLC_UNUSED(p_mux);
+    struct sout_input_private *priv = sout_input_priv( p_input );
+    struct sout_metrics *metrics = sout_MuxMetrics( p_mux );
+
     block_FifoEmpty( p_input->p_fifo );
+    /* Flushed blocks were not muxed */
+    priv->dates_count = 0;
+    if( metrics != NULL )
+        sout_InputAccount( metrics, priv, vlc_tick_now() );
 }
 
 /*****************************************************************************
@@ -681,6 +1001,7 @@ static void mrl_Clean( mrl_t *p_mrl )
 struct sout_stream_private {
     sout_stream_t stream;
     vlc_mutex_t lock;
+    struct sout_metrics *metrics;
 };
 
 struct vlc_sout_clock_bus {
@@ -693,6 +1014,11 @@ struct vlc_sout_clock_bus {
 #define sout_stream_priv(s) \
         container_of(s, struct sout_stream_private, stream)
 
+static struct sout_metrics *sout_StreamMetrics(sout_stream_t *s)
+{
+    return sout_stream_priv(s)->metrics;
+}
+
 static void sout_StreamLock(sout_stream_t *s)
 {
     vlc_mutex_lock(&sout_stream_priv(s)->lock);
@@ -783,6 +1109,10 @@ static void sout_StreamDelete( sout_stream_t *p_stream )
 
     msg_Dbg( p_stream, "destroying chain done" );
     vlc_objres_clear(VLC_OBJECT(p_stream));
+
+    struct sout_metrics *metrics = sout_stream_priv(p_stream)->metrics;
+    if (metrics != NULL)
+        sout_MetricsRelease(metrics);
     vlc_object_delete(p_stream);
 }
 
@@ -861,7 +1191,55 @@ void sout_StreamChainDelete(sout_stream_t *p_first, sout_stream_t *end)
     }
 }
 
-static sout_stream_t *sout_StreamNewEmpty(vlc_object_t *parent, char *name)
+void sout_StreamGetStats(sout_stream_t *p_sout, input_stats_t *st)
+{
+    struct sout_metrics *metrics = sout_StreamMetrics(p_sout);
+    if (metrics == NULL)
+        return;
+
+    st->i_sout_fifo_blocks = sout_MetricsGet(&metrics->fifo_blocks);
+    st->i_sout_fifo_bytes = sout_MetricsGet(&metrics->fifo_bytes);
+    /* Restart the peak from the current depth */
+    st->i_sout_fifo_peak =
+        atomic_exchange_explicit(&metrics->fifo_peak, st->i_sout_fifo_blocks,
+                                 memory_order_relaxed);
+    st->i_sout_muxed_blocks = sout_MetricsGet(&metrics->muxed);
+
+    uint64_t sum = sout_MetricsReset(&metrics->mux_wait_sum);
+    uint64_t count = sout_MetricsReset(&metrics->mux_wait_count);
+    st->i_sout_mux_wait = count ? sum / count : 0;
+    st->i_sout_mux_wait_max = sout_MetricsReset(&metrics->mux_wait_max);
+
+    st->i_sent_packets = sout_MetricsGet(&metrics->writes);
+    st->i_sent_bytes = sout_MetricsGet(&metrics->written);
+    st->i_sout_write_errors = sout_MetricsGet(&metrics->write_errors);
+    sum = sout_MetricsReset(&metrics->write_time_sum);
+    count = sout_MetricsReset(&metrics->write_time_count);
+    st->i_sout_write_latency = count ? sum / count : 0;
+    st->i_sout_write_latency_max = sout_MetricsReset(&metrics->write_time_max);
+
+    st->i_sout_dropped = sout_MetricsGet(&metrics->dropped);
+    st->i_sout_late = sout_MetricsGet(&metrics->late);
+
+    /* Same unit and sampling period as the input bitrates */
+    vlc_tick_t now = vlc_tick_now();
+    if (metrics->rate_date == VLC_TICK_INVALID)
+    {
+        metrics->rate_date = now;
+        metrics->rate_bytes = st->i_sent_bytes;
+    }
+    else if (now - metrics->rate_date >= VLC_TICK_FROM_SEC(1))
+    {
+        metrics->rate = (st->i_sent_bytes - metrics->rate_bytes)
+                      / (float)(now - metrics->rate_date);
+        metrics->rate_date = now;
+        metrics->rate_bytes = st->i_sent_bytes;
+    }
+    st->f_send_bitrate = metrics->rate;
+}
+
+static sout_stream_t *sout_StreamNewEmpty(vlc_object_t *parent, char *name,
+                                          struct sout_metrics *metrics)
 {
     assert(name != NULL);
 
@@ -871,6 +1249,7 @@ static sout_stream_t *sout_StreamNewEmpty(vlc_object_t *parent, char *name)
         return NULL;
 
     vlc_mutex_init(&priv->lock);
+    priv->metrics = (metrics != NULL) ? sout_MetricsHold(metrics) : NULL;
     priv->stream.psz_name = name;
     priv->stream.p_cfg = NULL;
     priv->stream.p_next = NULL;
@@ -889,7 +1268,8 @@ sout_stream_t *sout_StreamNew(vlc_object_t *parent, const char *config)
     char *leftover = config_ChainCreate(&name, &parsed_conf, config);
     free(leftover);
 
-    sout_stream_t *stream = sout_StreamNewEmpty(parent, name);
+    sout_stream_t *stream = sout_StreamNewEmpty(parent, name,
+                                                sout_MetricsFind(parent));
     if (unlikely(stream == NULL))
         return NULL;
 
@@ -903,11 +1283,12 @@ sout_stream_t *sout_StreamNew(vlc_object_t *parent, const char *config)
  * XXX name and p_cfg are used (-> do NOT free them)
  */
 static sout_stream_t *sout_StreamNewModule( vlc_object_t *parent, char *psz_name,
-                               config_chain_t *p_cfg, sout_stream_t *p_next)
+                               config_chain_t *p_cfg, sout_stream_t *p_next,
+                               struct sout_metrics *metrics )
 {
     const char *cap = (p_next != NULL) ? "sout filter" : "sout output";
 
-    sout_stream_t *p_stream = sout_StreamNewEmpty(parent, psz_name);
+    sout_stream_t *p_stream = sout_StreamNewEmpty(parent, psz_name, metrics);
     if (unlikely(p_stream == NULL))
         return NULL;
 
@@ -930,8 +1311,10 @@ static sout_stream_t *sout_StreamNewModule( vlc_object_t *parent, char *psz_name
     return p_stream;
 }
 
-sout_stream_t *sout_StreamChainNew(vlc_object_t *parent, const char *psz_chain,
-                                   sout_stream_t *sink)
+static sout_stream_t *sout_StreamChainNewMetrics(vlc_object_t *parent,
+                                                 const char *psz_chain,
+                                                 sout_stream_t *sink,
+                                                 struct sout_metrics *metrics)
 {
     if(!psz_chain || !*psz_chain)
     {
@@ -970,7 +1353,7 @@ sout_stream_t *sout_StreamChainNew(vlc_object_t *parent, const char *psz_chain,
         prev = sout_StreamNewModule(parent,
                                     vlc_array_item_at_index(&name, i),
                                     vlc_array_item_at_index(&cfg, i),
-                                    front);
+                                    front, metrics);
         if (prev == NULL)
             goto error;
 
@@ -1008,6 +1391,13 @@ error:
     return NULL;
 }
 
+sout_stream_t *sout_StreamChainNew(vlc_object_t *parent, const char *psz_chain,
+                                   sout_stream_t *sink)
+{
+    return sout_StreamChainNewMetrics(parent, psz_chain, sink,
+                                      sout_MetricsFind(parent));
+}
+
 static char *sout_stream_url_to_chain( bool b_sout_display,
                                        const char *psz_url )
 {
@@ -33,6 +33,14 @@
 sout_stream_t *sout_NewInstance( vlc_object_t *, const char * );
 #define sout_NewInstance(a,b) sout_NewInstance(VLC_OBJECT(a),b)
 
+/**
+ * Fills the stream output fields of the statistics from the metrics of an
+ * instance created by sout_NewInstance().
+ *
+ * Averages and peaks cover the period since the previous call.
+ */
+void sout_StreamGetStats( sout_stream_t *, input_stats_t * );
+
 sout_packetizer_input_t *
 sout_InputNew( sout_stream_t *, const es_format_t *, const char * );
 int sout_InputDelete( sout_stream_t *, sout_packetizer_input_t * );
@@ -86,11 +86,59 @@ static void test_block (void)
     //assert (block == NULL);
 }
 
+static void test_block_Share (void)
+{
+    block_t *block = block_Alloc (sizeof (text));
+    assert (block != NULL);
+    memcpy (block->p_buffer, text, sizeof (text));
+    block->i_pts = 42;
+
+    block_t *copy = block_Share (block);
+    assert (copy != NULL);
+    assert (copy->p_buffer == block->p_buffer);
+    assert (copy->i_buffer == sizeof (text));
+    assert (copy->i_pts == 42);
+
+    /* Writing copies the shared payload */
+    block_t *writable = block_Writable (copy);
+    assert (writable != NULL);
+    assert (writable->p_buffer != block->p_buffer);
+    assert (!memcmp (writable->p_buffer, text, sizeof (text)));
+    writable->p_buffer[0] = 't';
+    assert (block->p_buffer[0] == 'T');
+    block_Release (writable);
+
+    /* Growing copies the shared payload */
+    copy = block_Share (block);
+    assert (copy != NULL);
+    copy = block_Realloc (copy, 4, sizeof (text) + 4);
+    assert (copy != NULL);
+    assert (!memcmp (copy->p_buffer + 4, text, sizeof (text)));
+    memset (copy->p_buffer, 0, 4);
+    block_Release (copy);
+
+    /* The payload outlives the frame it was shared from */
+    copy = block_Share (block);
+    assert (copy != NULL);
+    block_t *other = block_Share (copy);
+    assert (other != NULL);
+    block_Release (block);
+    assert (!memcmp (copy->p_buffer, text, sizeof (text)));
+    block_Release (copy);
+
+    /* The last frame is writable without copying */
+    uint8_t *payload = other->p_buffer;
+    other = block_Writable (other);
+    assert (other != NULL && other->p_buffer == payload);
+    block_Release (other);
+}
+
 int main (void)
 {
     test_block_File(false);
     test_block_File(true);
     test_block ();
+    test_block_Share ();
     return 0;
 }
 
@@ -1343,8 +1343,8 @@ static int PrerenderPicture(vout_thread_sys_t *sys, picture_t *filtered,
             picture_t *blent = picture_pool_Get(sys->private_pool);
             if (blent) {
                 video_format_CopyCropAr(&blent->format, &filtered->format);
-                picture_Copy(blent, filtered);
-                if (picture_BlendSubpicture(blent, sys->spu_blend, subpic)) {
+                if (picture_CopyBlendSubpicture(blent, filtered,
+                                                sys->spu_blend, subpic)) {
                     picture_Release(todisplay);
                     snap_pic = todisplay = blent;
                 } else
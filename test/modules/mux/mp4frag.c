@@ -0,0 +1,246 @@
+/*****************************************************************************
+ * mp4frag.c: fragmented MP4 muxer unit testing
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+
+#include <vlc_common.h>
+
+#include <vlc_block.h>
+#include <vlc_plugin.h>
+#include <vlc_sout.h>
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#define FRAME_LENGTH VLC_TICK_FROM_MS(40)
+#define FRAME_COUNT 75
+
+struct test_scenario
+{
+    const char *mux;
+    /** Keyframe interval of the video track, 0 for no video track. */
+    unsigned gop;
+    bool audio;
+    /** Every fragment is expected to start on keyframes. */
+    bool all_independent;
+
+    /** Fragments starting on a keyframe of every keyframed track. */
+    unsigned independent_fragments;
+    unsigned fragments;
+    vlc_tick_t fragments_length;
+};
+
+static struct test_scenario *CURRENT_SCENARIO = NULL;
+
+static bool IsFragmentHeader(const block_t *block)
+{
+    return block->i_buffer >= 8 && memcmp(&block->p_buffer[4], "moof", 4) == 0;
+}
+
+static ssize_t AccessOutWrite(sout_access_out_t *access, block_t *block)
+{
+    struct test_scenario *scenario = access->p_sys;
+    assert(block->p_next == NULL);
+
+    const uint32_t type = block->i_flags & BLOCK_FLAG_TYPE_MASK;
+    if (IsFragmentHeader(block))
+    {
+        /* The fragment is independent when all the keyframed tracks start it
+         * with a keyframe: with a single video track, on a gop boundary. */
+        const vlc_tick_t start = scenario->fragments_length;
+        const bool independent =
+            scenario->gop == 0 ||
+            start % (scenario->gop * FRAME_LENGTH) == 0;
+        assert(type == (independent ? BLOCK_FLAG_TYPE_I : BLOCK_FLAG_TYPE_PB));
+
+        assert(block->i_length > 0);
+        scenario->fragments_length += block->i_length;
+        scenario->fragments++;
+        if (type == BLOCK_FLAG_TYPE_I)
+            scenario->independent_fragments++;
+    }
+    else
+    {
+        /* Only the fragment header is flagged for the HTTP stream output */
+        assert(type == 0);
+    }
+
+    const ssize_t r = block->i_buffer;
+    block_ChainRelease(block);
+    return r;
+}
+
+static sout_access_out_t *CreateAccessOut(vlc_object_t *parent,
+                                          const struct test_scenario *cb)
+{
+    sout_access_out_t *access = vlc_object_create(parent, sizeof(*access));
+    if (unlikely(access == NULL))
+        return NULL;
+
+    access->psz_access = strdup("mock");
+    if (unlikely(access->psz_access == NULL))
+    {
+        vlc_object_delete(access);
+        return NULL;
+    }
+
+    access->p_cfg = NULL;
+    access->p_module = NULL;
+    access->p_sys = (void *)cb;
+    access->psz_path = NULL;
+
+    access->pf_control = NULL;
+    access->pf_read = NULL;
+    access->pf_seek = NULL;
+    access->pf_write = AccessOutWrite;
+    return access;
+}
+
+static block_t *MakeFrame(unsigned index, bool keyframe)
+{
+    block_t *frame = block_Alloc(64);
+    assert(frame != NULL);
+    memset(frame->p_buffer, 0, frame->i_buffer);
+    frame->i_pts = frame->i_dts = VLC_TICK_0 + index * FRAME_LENGTH;
+    frame->i_length = FRAME_LENGTH;
+    frame->i_flags = keyframe ? BLOCK_FLAG_TYPE_I : BLOCK_FLAG_TYPE_P;
+    return frame;
+}
+
+static struct test_scenario TEST_SCENARIOS[] = {
+    {
+        /* 1s gop cut in fragments of at most 500ms */
+        .mux = "mp4frag{frag-duration=500}",
+        .gop = 25,
+    },
+    {
+        /* Fragments longer than the gop start on keyframes */
+        .mux = "mp4frag{frag-duration=1500}",
+        .gop = 25,
+        .all_independent = true,
+    },
+    {
+        .mux = "mp4frag{frag-duration=500}",
+        .gop = 25,
+        .audio = true,
+    },
+    {
+        /* Without keyframed tracks, every fragment is independent */
+        .mux = "mp4frag{frag-duration=500}",
+        .audio = true,
+        .all_independent = true,
+    },
+};
+
+static void RunTests(libvlc_instance_t *instance)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(TEST_SCENARIOS); ++i)
+    {
+        CURRENT_SCENARIO = &TEST_SCENARIOS[i];
+        test_log("scenario %zu: %s gop %u%s\n", i, CURRENT_SCENARIO->mux,
+                 CURRENT_SCENARIO->gop,
+                 CURRENT_SCENARIO->audio ? " with audio" : "");
+
+        sout_access_out_t *access = CreateAccessOut(
+            VLC_OBJECT(instance->p_libvlc_int), CURRENT_SCENARIO);
+        assert(access != NULL);
+
+        sout_mux_t *mux = sout_MuxNew(access, CURRENT_SCENARIO->mux);
+        assert(mux != NULL);
+
+        sout_input_t *video = NULL, *audio = NULL;
+        es_format_t fmt;
+        if (CURRENT_SCENARIO->gop != 0)
+        {
+            es_format_Init(&fmt, VIDEO_ES, VLC_CODEC_MP4V);
+            fmt.video.i_width = fmt.video.i_visible_width = 64;
+            fmt.video.i_height = fmt.video.i_visible_height = 64;
+            fmt.video.i_frame_rate = 25;
+            fmt.video.i_frame_rate_base = 1;
+            video = sout_MuxAddStream(mux, &fmt);
+            assert(video != NULL);
+        }
+        if (CURRENT_SCENARIO->audio)
+        {
+            es_format_Init(&fmt, AUDIO_ES, VLC_CODEC_S16L);
+            fmt.audio.i_rate = 8000;
+            fmt.audio.i_channels = 1;
+            fmt.audio.i_bitspersample = 16;
+            audio = sout_MuxAddStream(mux, &fmt);
+            assert(audio != NULL);
+        }
+
+        // Disable mux caching.
+        mux->b_waiting_stream = false;
+
+        for (unsigned n = 0; n < FRAME_COUNT; ++n)
+        {
+            int status;
+            if (video != NULL)
+            {
+                const bool keyframe = n % CURRENT_SCENARIO->gop == 0;
+                status = sout_MuxSendBuffer(mux, video, MakeFrame(n, keyframe));
+                assert(status == VLC_SUCCESS);
+            }
+            if (audio != NULL)
+            {
+                status = sout_MuxSendBuffer(mux, audio, MakeFrame(n, false));
+                assert(status == VLC_SUCCESS);
+            }
+        }
+
+        if (video != NULL)
+            sout_MuxDeleteStream(mux, video);
+        if (audio != NULL)
+            sout_MuxDeleteStream(mux, audio);
+        sout_MuxDelete(mux);
+        sout_AccessOutDelete(access);
+
+        /* The fragment lengths add up to the whole content */
+        assert(CURRENT_SCENARIO->fragments_length == FRAME_COUNT * FRAME_LENGTH);
+        assert(CURRENT_SCENARIO->independent_fragments > 0);
+        if (CURRENT_SCENARIO->all_independent)
+            assert(CURRENT_SCENARIO->independent_fragments ==
+                   CURRENT_SCENARIO->fragments);
+        else
+            assert(CURRENT_SCENARIO->independent_fragments <
+                   CURRENT_SCENARIO->fragments);
+    }
+}
+
+int main(void)
+{
+    test_init();
+
+    const char *const args[] = {
+        "-vvv",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    if (vlc == NULL)
+        return 1;
+
+    RunTests(vlc);
+
+    libvlc_release(vlc);
+}
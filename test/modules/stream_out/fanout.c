@@ -0,0 +1,186 @@
+/*****************************************************************************
+ * fanout.c: fan-out stream output and subscriber tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+
+#include "../../libvlc/test.h"
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_demux.h>
+#include <vlc_modules.h>
+#include <vlc_sout.h>
+
+#include "../lib/libvlc_internal.h"
+
+/* Subscriber queue size in KiB, the smallest allowed (see main()) */
+#define QUEUE_SIZE 64
+
+struct received
+{
+    enum es_format_category_e cat;
+    uint32_t flags;
+};
+
+struct capture
+{
+    es_out_t out;
+    size_t count;
+    struct received frames[64];
+};
+
+static es_out_id_t *capture_Add(es_out_t *out, input_source_t *in,
+                                const es_format_t *fmt)
+{
+    (void) out; (void) in;
+    /* The category is all the test needs to tell the ES apart */
+    return (es_out_id_t *)(uintptr_t)(fmt->i_cat + 1);
+}
+
+static int capture_Send(es_out_t *out, es_out_id_t *id, block_t *block)
+{
+    struct capture *cap = container_of(out, struct capture, out);
+
+    assert(cap->count < ARRAY_SIZE(cap->frames));
+    cap->frames[cap->count].cat = (uintptr_t)id - 1;
+    cap->frames[cap->count].flags = block->i_flags;
+    cap->count++;
+    block_Release(block);
+    return VLC_SUCCESS;
+}
+
+static void capture_Del(es_out_t *out, es_out_id_t *id)
+{
+    (void) out; (void) id;
+}
+
+static int capture_Control(es_out_t *out, input_source_t *in, int query,
+                           va_list args)
+{
+    (void) out; (void) in; (void) args;
+    return query == ES_OUT_SET_PCR ? VLC_SUCCESS : VLC_EGENERIC;
+}
+
+static const struct es_out_callbacks capture_cbs =
+{
+    .add = capture_Add,
+    .send = capture_Send,
+    .del = capture_Del,
+    .control = capture_Control,
+};
+
+static void Publish(sout_stream_t *sout, void *id, size_t size,
+                    uint32_t flags)
+{
+    block_t *block = block_Alloc(size);
+    assert(block != NULL);
+    memset(block->p_buffer, 0, size);
+    block->i_flags = flags;
+    block->i_dts = block->i_pts = VLC_TICK_0;
+    sout_StreamIdSend(sout, id, block);
+}
+
+static void test_OverflowResync(vlc_object_t *parent)
+{
+    sout_stream_t *sout = sout_StreamChainNew(parent, "fanout{name=test}",
+                                              NULL);
+    assert(sout != NULL);
+
+    es_format_t vfmt, afmt;
+    es_format_Init(&vfmt, VIDEO_ES, VLC_CODEC_H264);
+    es_format_Init(&afmt, AUDIO_ES, VLC_CODEC_MP4A);
+    void *video = sout_StreamIdAdd(sout, &vfmt, "video");
+    void *audio = sout_StreamIdAdd(sout, &afmt, "audio");
+    assert(video != NULL && audio != NULL);
+
+    /* Subscribe as the input would, through the access_demux */
+    struct capture cap = { .out.cbs = &capture_cbs, .count = 0 };
+    demux_t *demux = vlc_object_create(parent, sizeof (*demux));
+    assert(demux != NULL);
+    demux->psz_name = (char *)"fanout";
+    demux->psz_url = (char *)"fanout://test";
+    demux->psz_location = (char *)"test";
+    demux->out = &cap.out;
+
+    module_t *module = module_need(demux, "access", "fanout", true);
+    assert(module != NULL);
+    assert(demux->pf_demux(demux) == VLC_DEMUXER_SUCCESS);
+
+    Publish(sout, video, 1024, BLOCK_FLAG_TYPE_I);
+    Publish(sout, audio, 256, 0);
+    assert(demux->pf_demux(demux) == VLC_DEMUXER_SUCCESS);
+    assert(cap.count == 2);
+
+    /* Overflow the subscriber queue with video frames */
+    for (unsigned i = 0; i < 8; i++)
+        Publish(sout, video, (QUEUE_SIZE << 10) / 4, BLOCK_FLAG_TYPE_P);
+    assert(demux->pf_demux(demux) == VLC_DEMUXER_SUCCESS);
+
+    size_t resumed = cap.count;
+    assert(resumed > 2 && resumed < 2 + 8);
+
+    /* Audio goes through, but video waits for its next key frame */
+    Publish(sout, audio, 256, 0);
+    Publish(sout, video, 1024, BLOCK_FLAG_TYPE_P);
+    Publish(sout, audio, 256, 0);
+    Publish(sout, video, 1024, BLOCK_FLAG_TYPE_I);
+    Publish(sout, video, 1024, BLOCK_FLAG_TYPE_P);
+    assert(demux->pf_demux(demux) == VLC_DEMUXER_SUCCESS);
+
+    assert(cap.count == resumed + 4);
+    assert(cap.frames[resumed].cat == AUDIO_ES);
+    assert(cap.frames[resumed + 1].cat == AUDIO_ES);
+    assert(cap.frames[resumed + 2].cat == VIDEO_ES);
+    assert(cap.frames[resumed + 2].flags & BLOCK_FLAG_TYPE_I);
+    assert(cap.frames[resumed + 3].cat == VIDEO_ES);
+    assert(cap.frames[resumed + 3].flags & BLOCK_FLAG_TYPE_P);
+
+    sout_StreamIdDel(sout, video);
+    sout_StreamIdDel(sout, audio);
+    sout_StreamChainDelete(sout, NULL);
+
+    assert(demux->pf_demux(demux) == VLC_DEMUXER_EOF);
+    module_unneed(demux, module);
+    vlc_object_delete(demux);
+}
+
+int main(void)
+{
+#ifndef ENABLE_SOUT
+    return 77;
+#endif
+    test_init();
+
+    const char * const args[] = {
+        "-vvv", "--fanout-queue-size=64",
+    };
+
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    assert(vlc != NULL);
+
+    test_OverflowResync(VLC_OBJECT(vlc->p_libvlc_int));
+
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,256 @@
+/*****************************************************************************
+ * playlist.c: HLS segment queue and media playlist unit tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+
+#include <vlc_common.h>
+
+#include <vlc_block.h>
+#include <vlc_httpd.h>
+#include <vlc_list.h>
+
+#include "../../../libvlc/test.h"
+#include "../../../../modules/stream_out/hls/hls.h"
+#include "../../../../modules/stream_out/hls/segments.h"
+#include "../../../../modules/stream_out/hls/storage.h"
+
+#define HEADER                                                                 \
+    "#EXTM3U\n"                                                                \
+    "#EXT-X-TARGETDURATION:1\n"                                                \
+    "#EXT-X-VERSION:7\n"
+#define PART_HEADER                                                            \
+    "#EXT-X-SERVER-CONTROL:PART-HOLD-BACK=1.500\n"                             \
+    "#EXT-X-PART-INF:PART-TARGET=0.500\n"
+#define MAP "#EXT-X-MAP:URI=\"/playlist-0-init.mp4\"\n"
+#define PARTS(a, b)                                                            \
+    "#EXT-X-PART:DURATION=0.500,URI=\"/playlist-0-part-" #a ".m4s\""         \
+    ",INDEPENDENT=YES\n"                                                       \
+    "#EXT-X-PART:DURATION=0.500,URI=\"/playlist-0-part-" #b ".m4s\"\n"
+#define SEGMENT(id, ext) "#EXTINF:1.00,\n/playlist-0-" #id "." ext "\n"
+
+static block_t *MakeContent(const char *str)
+{
+    block_t *block = block_Alloc(strlen(str));
+    assert(block != NULL);
+    memcpy(block->p_buffer, str, block->i_buffer);
+    return block;
+}
+
+static void CheckStorage(const hls_storage_t *storage, const char *expected)
+{
+    uint8_t *content;
+    const ssize_t size = storage->get_content(storage, &content);
+    assert(size >= 0);
+    if ((size_t)size != strlen(expected) ||
+        memcmp(content, expected, size) != 0)
+    {
+        fprintf(stderr, "expected:\n%s\ngot:\n%.*s\n", expected, (int)size,
+                (const char *)content);
+        assert(!"Unexpected content");
+    }
+    free(content);
+}
+
+static void CheckManifest(const hls_segment_queue_t *queue, bool ended,
+                          const char *expected)
+{
+    hls_storage_t *manifest =
+        hls_segment_queue_GenerateManifest(queue, "playlist-0.m3u8", ended);
+    assert(manifest != NULL);
+    CheckStorage(manifest, expected);
+    hls_storage_Destroy(manifest);
+}
+
+static unsigned CountParts(const hls_segment_t *segment)
+{
+    unsigned count = 0;
+    const hls_part_t *part;
+    hls_segment_Foreach_part_const(segment, part)
+        ++count;
+    return count;
+}
+
+/* Publish a one second segment made of two parts */
+static void AddPartedSegment(hls_segment_queue_t *queue)
+{
+    int status = hls_segment_queue_NewPart(queue, MakeContent("moof0mdat0"),
+                                           VLC_TICK_FROM_MS(500), true);
+    assert(status == VLC_SUCCESS);
+    status = hls_segment_queue_NewPart(queue, MakeContent("moof1mdat1"),
+                                       VLC_TICK_FROM_MS(500), false);
+    assert(status == VLC_SUCCESS);
+
+    block_t *content = MakeContent("moof0mdat0");
+    block_ChainAppend(&content, MakeContent("moof1mdat1"));
+    status = hls_segment_queue_NewSegment(queue, content, VLC_TICK_FROM_SEC(1),
+                                          2);
+    assert(status == VLC_SUCCESS);
+}
+
+static void TestTransportStream(void)
+{
+    struct hls_config config = {
+        .base_url = (char *)"",
+        .max_segments = 2,
+        .segment_length = VLC_TICK_FROM_SEC(1),
+    };
+    const struct hls_segment_queue_config queue_config = {
+        .playlist_type = HLS_PLAYLIST_TYPE_TS,
+    };
+    hls_segment_queue_t queue;
+    hls_segment_queue_Init(&queue, &queue_config, &config);
+
+    /* Self-initializing segments and no parts */
+    CheckManifest(&queue, false, HEADER "#EXT-X-MEDIA-SEQUENCE:0\n");
+
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        const int status = hls_segment_queue_NewSegment(
+            &queue, MakeContent("ts"), VLC_TICK_FROM_SEC(1), 0);
+        assert(status == VLC_SUCCESS);
+    }
+    assert(queue.total_segments == 3);
+
+    /* The oldest segment went away with the queue at capacity */
+    const hls_segment_t *first = hls_segment_GetFirst(&queue);
+    assert(first->id == 1);
+    CheckStorage(first->storage, "ts");
+    assert(strcmp(first->storage->mime, "video/MP2T") == 0);
+
+    CheckManifest(&queue, false,
+                  HEADER "#EXT-X-MEDIA-SEQUENCE:1\n"
+                  SEGMENT(1, "ts") SEGMENT(2, "ts"));
+
+    hls_segment_queue_Clear(&queue);
+}
+
+static void TestCMAF(void)
+{
+    struct hls_config config = {
+        .base_url = (char *)"",
+        .segment_length = VLC_TICK_FROM_SEC(1),
+        .cmaf = true,
+        .part_length = VLC_TICK_FROM_MS(500),
+    };
+    const struct hls_segment_queue_config queue_config = {
+        .playlist_type = HLS_PLAYLIST_TYPE_FMP4,
+    };
+    hls_segment_queue_t queue;
+    hls_segment_queue_Init(&queue, &queue_config, &config);
+
+    CheckManifest(&queue, false,
+                  HEADER PART_HEADER "#EXT-X-PLAYLIST-TYPE:EVENT\n"
+                  "#EXT-X-MEDIA-SEQUENCE:0\n");
+
+    /* The initialization section is published once under a stable URL */
+    int status = hls_segment_queue_SetInit(&queue, MakeContent("ftypmoov"));
+    assert(status == VLC_SUCCESS);
+    assert(strcmp(queue.init_url, "/playlist-0-init.mp4") == 0);
+    CheckStorage(queue.init, "ftypmoov");
+    assert(strcmp(queue.init->mime, "video/mp4") == 0);
+
+    status = hls_segment_queue_SetInit(&queue, MakeContent("ftypmoov2"));
+    assert(status == VLC_SUCCESS);
+    assert(strcmp(queue.init_url, "/playlist-0-init.mp4") == 0);
+    CheckStorage(queue.init, "ftypmoov2");
+
+    /* Parts are listed as soon as they are complete */
+    status = hls_segment_queue_NewPart(&queue, MakeContent("moof0mdat0"),
+                                       VLC_TICK_FROM_MS(500), true);
+    assert(status == VLC_SUCCESS);
+    status = hls_segment_queue_NewPart(&queue, MakeContent("moof1mdat1"),
+                                       VLC_TICK_FROM_MS(500), false);
+    assert(status == VLC_SUCCESS);
+
+    const hls_part_t *part = vlc_list_first_entry_or_null(
+        &queue.pending_parts, hls_part_t, priv_node);
+    assert(part != NULL);
+    CheckStorage(part->storage, "moof0mdat0");
+    assert(strcmp(part->storage->mime, "video/mp4") == 0);
+
+    CheckManifest(&queue, false,
+                  HEADER PART_HEADER "#EXT-X-PLAYLIST-TYPE:EVENT\n"
+                  "#EXT-X-MEDIA-SEQUENCE:0\n" MAP PARTS(0, 1));
+
+    /* The segment takes over the parts it is made of */
+    block_t *content = MakeContent("moof0mdat0");
+    block_ChainAppend(&content, MakeContent("moof1mdat1"));
+    status = hls_segment_queue_NewSegment(&queue, content, VLC_TICK_FROM_SEC(1),
+                                          2);
+    assert(status == VLC_SUCCESS);
+    assert(vlc_list_is_empty(&queue.pending_parts));
+
+    const hls_segment_t *first = hls_segment_GetFirst(&queue);
+    assert(CountParts(first) == 2);
+    CheckStorage(first->storage, "moof0mdat0moof1mdat1");
+
+    CheckManifest(&queue, false,
+                  HEADER PART_HEADER "#EXT-X-PLAYLIST-TYPE:EVENT\n"
+                  "#EXT-X-MEDIA-SEQUENCE:0\n" MAP
+                  PARTS(0, 1) SEGMENT(0, "m4s"));
+
+    /* Parts expire once their segment is not among the last three */
+    for (unsigned i = 0; i < 3; ++i)
+        AddPartedSegment(&queue);
+    assert(CountParts(first) == 0);
+
+    const hls_segment_t *segment;
+    unsigned index = 0;
+    hls_segment_queue_Foreach_const(&queue, segment)
+        assert(CountParts(segment) == (index++ == 0 ? 0 : 2));
+
+    /* A pending part of the next segment */
+    status = hls_segment_queue_NewPart(&queue, MakeContent("moof8mdat8"),
+                                       VLC_TICK_FROM_MS(500), true);
+    assert(status == VLC_SUCCESS);
+
+    CheckManifest(&queue, false,
+                  HEADER PART_HEADER "#EXT-X-PLAYLIST-TYPE:EVENT\n"
+                  "#EXT-X-MEDIA-SEQUENCE:0\n" MAP
+                  SEGMENT(0, "m4s")
+                  PARTS(2, 3) SEGMENT(1, "m4s")
+                  PARTS(4, 5) SEGMENT(2, "m4s")
+                  PARTS(6, 7) SEGMENT(3, "m4s")
+                  "#EXT-X-PART:DURATION=0.500,URI=\"/playlist-0-part-8.m4s\""
+                  ",INDEPENDENT=YES\n");
+
+    /* Parts are of no use once the playlist ended */
+    CheckManifest(&queue, true,
+                  HEADER "#EXT-X-PLAYLIST-TYPE:VOD\n"
+                  "#EXT-X-MEDIA-SEQUENCE:0\n" MAP
+                  SEGMENT(0, "m4s") SEGMENT(1, "m4s")
+                  SEGMENT(2, "m4s") SEGMENT(3, "m4s")
+                  "#EXT-X-ENDLIST\n");
+
+    hls_segment_queue_Clear(&queue);
+}
+
+int main(void)
+{
+    test_init();
+
+    TestTransportStream();
+    TestCMAF();
+    return 0;
+}
@@ -126,6 +126,31 @@ static int OpenDecoder(vlc_object_t *obj)
     return VLC_SUCCESS;
 }
 
+static int AudioDecoderDecode(decoder_t *dec, vlc_frame_t *frame)
+{
+    if (frame == NULL)
+        return VLCDEC_SUCCESS;
+
+    int ret = decoder_UpdateAudioFormat(dec);
+    assert(ret == VLC_SUCCESS);
+    decoder_QueueAudio(dec, frame);
+    return VLCDEC_SUCCESS;
+}
+
+static int OpenAudioDecoder(vlc_object_t *obj)
+{
+    decoder_t *dec = (decoder_t*)obj;
+
+    /* The mock source already outputs raw samples */
+    if (dec->fmt_in->i_codec != VLC_CODEC_FL32)
+        return VLC_EGENERIC;
+
+    dec->pf_decode = AudioDecoderDecode;
+    es_format_Clean(&dec->fmt_out);
+    es_format_Copy(&dec->fmt_out, dec->fmt_in);
+    return VLC_SUCCESS;
+}
+
 static int OpenFilter(filter_t *filter)
 {
     static const struct vlc_filter_operations ops = {
@@ -179,6 +204,23 @@ static vlc_frame_t *EncodeVideo(encoder_t *enc, picture_t *pic)
     return frame;
 }
 
+static vlc_frame_t *EncodeAudio(encoder_t *enc, vlc_frame_t *in)
+{
+    struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
+    if (scenario->encoder_encode_audio != NULL)
+        scenario->encoder_encode_audio(enc, in);
+
+    if (in == NULL)
+        return NULL;
+
+    assert(in->i_nb_samples > 0);
+    vlc_frame_t *frame = vlc_frame_Alloc(4);
+    assert(frame);
+    frame->i_pts = frame->i_dts = in->i_pts;
+    frame->i_length = in->i_length;
+    return frame;
+}
+
 static void CloseEncoder(encoder_t *enc)
 {
     struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
@@ -211,6 +253,30 @@ static int OpenEncoder(vlc_object_t *obj)
     return VLC_SUCCESS;
 }
 
+static int OpenAudioEncoder(vlc_object_t *obj)
+{
+    encoder_t *enc = (encoder_t *)obj;
+    enc->p_sys = NULL;
+
+    struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
+    assert(scenario->encoder_setup != NULL);
+    scenario->encoder_setup(enc);
+
+    msg_Dbg(obj, "Encoder format %4.4s -> %4.4s rate %u",
+            (const char *)&enc->fmt_in.i_codec,
+            (const char *)&enc->fmt_out.i_codec,
+            enc->fmt_in.audio.i_rate);
+
+    static const struct vlc_encoder_operations ops =
+    {
+        .encode_audio = EncodeAudio,
+        .close = CloseEncoder,
+    };
+    enc->ops = &ops;
+
+    return VLC_SUCCESS;
+}
+
 static int ErrorCheckerSend(sout_stream_t *stream, void *id, vlc_frame_t *f)
 {
     struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
@@ -257,7 +323,11 @@ static int OutputCheckerSend(sout_stream_t *stream, void *id, vlc_frame_t *f)
 static void *OutputCheckerAdd(sout_stream_t *stream, const es_format_t *fmt,
                               const char *es_id)
 {
-    (void)stream; (void)fmt; (void)es_id;
+    (void)stream;
+    struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
+
+    if (scenario->report_add != NULL)
+        scenario->report_add(fmt, es_id);
     return (void*)0x42;
 }
 
@@ -303,6 +373,12 @@ static void play_scenario(intf_thread_t *intf, struct transcode_scenario *scenar
     var_Create(intf, "sout-transcode-vcodec", VLC_VAR_STRING);
     var_SetString(intf, "sout-transcode-vcodec", "test");
 
+    var_Create(intf, "sout-transcode-aenc", VLC_VAR_STRING);
+    var_SetString(intf, "sout-transcode-aenc", MODULE_STRING);
+
+    var_Create(intf, "sout-transcode-acodec", VLC_VAR_STRING);
+    var_SetString(intf, "sout-transcode-acodec", "test");
+
     vlc_player_t *player = vlc_player_New(&intf->obj,
         VLC_PLAYER_LOCK_NORMAL);
     assert(player);
@@ -334,6 +410,8 @@ static void play_scenario(intf_thread_t *intf, struct transcode_scenario *scenar
     vlc_player_Delete(player);
     input_item_Release(media);
 
+    var_Destroy(intf, "sout-transcode-acodec");
+    var_Destroy(intf, "sout-transcode-aenc");
     var_Destroy(intf, "sout-transcode-vcodec");
     var_Destroy(intf, "sout-transcode-venc");
 }
@@ -358,11 +436,16 @@ static int OpenIntf(vlc_object_t *obj)
  *  - decoder for generating video format and context
  *  - filter for generating video format and context
  *  - encoder to check the previous video format and context
+ *  - audio decoder and encoder for the audio pipeline
  **/
 vlc_module_begin()
     set_callbacks(OpenDecoder, CloseDecoder)
     set_capability("video decoder", INT_MAX)
 
+    add_submodule()
+        set_callback(OpenAudioDecoder)
+        set_capability("audio decoder", INT_MAX)
+
     add_submodule()
         set_callback(OpenErrorChecker)
         set_capability("sout filter", 0)
@@ -386,6 +469,10 @@ vlc_module_begin()
         set_callback(OpenEncoder)
         set_capability("video encoder", 0)
 
+    add_submodule()
+        set_callback(OpenAudioEncoder)
+        set_capability("audio encoder", 0)
+
     add_submodule()
         set_callback(OpenIntf)
         set_capability("interface", 0)
@@ -33,10 +33,14 @@ struct transcode_scenario {
     void (*encoder_setup)(encoder_t *);
     void (*encoder_close)(encoder_t *);
     void (*encoder_encode)(encoder_t *, picture_t *);
+    void (*encoder_encode_audio)(encoder_t *, vlc_frame_t *);
     void (*filter_setup)(filter_t *);
     void (*converter_setup)(filter_t *);
     void (*report_error)(sout_stream_t *);
+    void (*report_add)(const es_format_t *, const char *es_id);
     void (*report_output)(const vlc_frame_t *);
+    /* Number of elementary streams expected at the output, if reported */
+    unsigned output_count;
 };
 
 
@@ -27,6 +27,8 @@
 #include <vlc_common.h>
 #include <vlc_frame.h>
 
+#include <stdatomic.h>
+
 #include "transcode.h"
 
 #include <vlc_filter.h>
@@ -40,6 +42,18 @@ static struct scenario_data
     bool encoder_opened;
     bool encoder_closed;
     bool error_reported;
+    unsigned output_count;
+    char *main_es_id;
+    /* Blocks given to the audio encoder, and whether it was drained */
+    unsigned encoded_count;
+    atomic_bool encoder_drained;
+    /* Dates of the first pictures seen by each encoder */
+    size_t encoder_count;
+    struct {
+        encoder_t *enc;
+        unsigned picture_count;
+        vlc_tick_t dates[64];
+    } encoders[3];
 } scenario_data;
 
 static void decoder_fixed_size(decoder_t *dec, vlc_fourcc_t chroma,
@@ -200,6 +214,64 @@ static void encoder_encode_dummy(encoder_t *enc, picture_t *pic)
     msg_Info(enc, "Encode");
 }
 
+/* Sizes of the rendition={...} outputs, the main output being 800x600 */
+static const struct
+{
+    unsigned width;
+    unsigned height;
+} rendition_sizes[] = {
+    { 400, 300 }, /* width=400,height=300 */
+    { 200, 150 }, /* scale=0.25 */
+};
+
+static void encoder_i420_renditions(encoder_t *enc)
+{
+    /* The main output and the renditions are sized by transcode */
+    assert(scenario_data.encoder_count < ARRAY_SIZE(scenario_data.encoders));
+    msg_Info(enc, "Setting up the encoder I420: %ux%u",
+             enc->fmt_in.video.i_visible_width,
+             enc->fmt_in.video.i_visible_height);
+    enc->fmt_in.video.i_chroma
+        = enc->fmt_in.i_codec
+        = VLC_CODEC_I420;
+    scenario_data.encoders[scenario_data.encoder_count++].enc = enc;
+    scenario_data.encoder_opened = true;
+}
+
+static void encoder_encode_record(encoder_t *enc, picture_t *pic)
+{
+    for (size_t i = 0; i < scenario_data.encoder_count; ++i)
+    {
+        if (scenario_data.encoders[i].enc != enc)
+            continue;
+
+        unsigned index = scenario_data.encoders[i].picture_count++;
+        if (index < ARRAY_SIZE(scenario_data.encoders[i].dates))
+            scenario_data.encoders[i].dates[index] = pic->date;
+        return;
+    }
+    assert(!"Unknown encoder");
+}
+
+static void encoder_fl32(encoder_t *enc)
+{
+    /* Opened once to test the format, then for good */
+    assert(enc->fmt_in.i_cat == AUDIO_ES);
+    enc->fmt_in.audio.i_format
+        = enc->fmt_in.i_codec
+        = VLC_CODEC_FL32;
+    scenario_data.encoder_opened = true;
+}
+
+static void encoder_encode_audio_count(encoder_t *enc, vlc_frame_t *in)
+{
+    (void)enc;
+    if (in == NULL)
+        atomic_store(&scenario_data.encoder_drained, true);
+    else
+        scenario_data.encoded_count++;
+}
+
 static void encoder_close(encoder_t *enc)
 {
     (void)enc;
@@ -208,14 +280,62 @@ static void encoder_close(encoder_t *enc)
 
 static void wait_output_10_frames_reported(const vlc_frame_t *out)
 {
-    // Count frame output.
+    unsigned count = scenario_data.output_frame_count;
+
+    // Count frame output, threaded encoders can return several at once.
     for (; out != NULL; out = out->p_next )
         ++scenario_data.output_frame_count;
 
-    if (scenario_data.output_frame_count == 10)
+    if (count < 10 && scenario_data.output_frame_count >= 10)
         vlc_sem_post(&scenario_data.wait_stop);
 }
 
+static void renditions_output_added(const es_format_t *fmt, const char *es_id)
+{
+    unsigned width = 800, height = 600;
+    const char *suffix = strstr(es_id, "/rendition-");
+
+    if (suffix == NULL)
+    {
+        /* The main output comes first */
+        assert(scenario_data.main_es_id == NULL);
+        scenario_data.main_es_id = strdup(es_id);
+        assert(scenario_data.main_es_id != NULL);
+    }
+    else
+    {
+        /* Renditions are named after the ES they are encoded from */
+        assert(scenario_data.main_es_id != NULL);
+        assert(strlen(scenario_data.main_es_id) == (size_t)(suffix - es_id));
+        assert(strncmp(es_id, scenario_data.main_es_id, suffix - es_id) == 0);
+
+        unsigned index = strtoul(suffix + strlen("/rendition-"), NULL, 10);
+        assert(index < ARRAY_SIZE(rendition_sizes));
+        width = rendition_sizes[index].width;
+        height = rendition_sizes[index].height;
+    }
+
+    assert(fmt->i_cat == VIDEO_ES);
+    assert(fmt->video.i_visible_width == width);
+    assert(fmt->video.i_visible_height == height);
+    scenario_data.output_count++;
+}
+
+static void wait_output_10_frames_before_drain(const vlc_frame_t *out)
+{
+    unsigned count = scenario_data.output_frame_count;
+
+    for (; out != NULL; out = out->p_next )
+        ++scenario_data.output_frame_count;
+
+    /* The threaded encoder hands its output back while the input plays */
+    if (count < 10 && scenario_data.output_frame_count >= 10)
+    {
+        assert(!atomic_load(&scenario_data.encoder_drained));
+        vlc_sem_post(&scenario_data.wait_stop);
+    }
+}
+
 static void wait_output_reported(const vlc_frame_t *out)
 {
     (void)out;
@@ -241,6 +361,19 @@ static void converter_fixed_size(filter_t *filter, vlc_fourcc_t chroma_in,
     scenario_data.converter_opened = true;
 }
 
+static void converter_i420_renditions(filter_t *filter)
+{
+    /* Renditions scale the pictures of the main output down */
+    assert(filter->fmt_in.video.i_chroma == VLC_CODEC_I420);
+    assert(filter->fmt_in.video.i_visible_width == 800);
+    assert(filter->fmt_in.video.i_visible_height == 600);
+    assert(filter->fmt_out.video.i_chroma == VLC_CODEC_I420);
+    assert(filter->fmt_out.video.i_visible_width < 800);
+    assert(filter->fmt_out.video.i_visible_height < 600);
+
+    scenario_data.converter_opened = true;
+}
+
 static void converter_i420_to_nv12_800_600(filter_t *filter)
     { converter_fixed_size(filter, VLC_CODEC_I420, VLC_CODEC_NV12, 800, 600); }
 
@@ -260,6 +393,7 @@ static void converter_i420_to_nv12_800_600_vctx(filter_t *filter)
 }
 
 const char source_800_600[] = "mock://video_track_count=1;length=100000000000;video_width=800;video_height=600";
+const char source_audio[] = "mock://video_track_count=0;audio_track_count=1;length=100000000000";
 struct transcode_scenario transcode_scenarios[] =
 {{
     .source = source_800_600,
@@ -356,6 +490,41 @@ struct transcode_scenario transcode_scenarios[] =
     .encoder_close = encoder_close,
     .converter_setup = converter_nv12_to_i420_800_600_vctx,
     .report_output = wait_output_10_frames_reported,
+},{
+    /* The threaded encoder must hand back its output while running, not
+     * only when drained at the end of the stream. */
+    .source = source_800_600,
+    .sout = "sout=#transcode{threads=2}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_i420_800_600,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .report_output = wait_output_10_frames_reported,
+},{
+    /* Renditions are encoded from the same pictures as the main output,
+     * each to its own size and elementary stream. */
+    .source = source_800_600,
+    .sout = "sout=#transcode{rendition={width=400,height=300},"
+                            "rendition={scale=0.25}}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_i420_renditions,
+    .encoder_encode = encoder_encode_record,
+    .encoder_close = encoder_close,
+    .converter_setup = converter_i420_renditions,
+    .report_add = renditions_output_added,
+    .report_output = wait_output_10_frames_reported,
+    .output_count = 3,
+},{
+    /* The threaded audio encoder must hand back its output while running,
+     * and return every block once drained. */
+    .source = source_audio,
+    .sout = "sout=#transcode{athreads=1}:output_checker",
+    .encoder_setup = encoder_fl32,
+    .encoder_encode_audio = encoder_encode_audio_count,
+    .encoder_close = encoder_close,
+    .report_output = wait_output_10_frames_before_drain,
 },{
     /* Ensure that error are correctly forwarded back to the stream output
      * pipeline. */
@@ -374,6 +543,11 @@ void transcode_scenario_init(void)
     scenario_data.output_frame_count = 0;
     scenario_data.converter_opened = false;
     scenario_data.encoder_opened = false;
+    scenario_data.output_count = 0;
+    scenario_data.main_es_id = NULL;
+    scenario_data.encoder_count = 0;
+    scenario_data.encoded_count = 0;
+    atomic_init(&scenario_data.encoder_drained, false);
     vlc_sem_init(&scenario_data.wait_stop, 0);
 }
 
@@ -393,4 +567,30 @@ void transcode_scenario_check(struct transcode_scenario *scenario)
 
     if (scenario_data.encoder_opened && scenario->encoder_close != NULL)
         assert(scenario_data.encoder_closed);
+
+    if (scenario->output_count != 0)
+        assert(scenario_data.output_count == scenario->output_count);
+    free(scenario_data.main_es_id);
+
+    if (scenario->encoder_encode_audio != NULL)
+    {
+        /* Draining at the end returned the blocks still being encoded */
+        assert(atomic_load(&scenario_data.encoder_drained));
+        assert(scenario_data.encoded_count > 0);
+        assert(scenario_data.output_frame_count ==
+               scenario_data.encoded_count);
+    }
+
+    /* Every encoder got the very same pictures */
+    for (size_t i = 1; i < scenario_data.encoder_count; ++i)
+    {
+        unsigned count = scenario_data.encoders[0].picture_count;
+        assert(count > 0);
+        assert(scenario_data.encoders[i].picture_count == count);
+        if (count > ARRAY_SIZE(scenario_data.encoders[i].dates))
+            count = ARRAY_SIZE(scenario_data.encoders[i].dates);
+        for (unsigned j = 0; j < count; ++j)
+            assert(scenario_data.encoders[i].dates[j] ==
+                   scenario_data.encoders[0].dates[j]);
+    }
 }
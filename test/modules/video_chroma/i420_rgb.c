@@ -0,0 +1,448 @@
+/*****************************************************************************
+ * i420_rgb.c: YUV to RGB converters test
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+#include <vlc_modules.h>
+#include "../../../lib/libvlc_internal.h"
+#include "../../libvlc/test.h"
+
+#include <vlc/vlc.h>
+
+/* The plain C converter is the reference for the SIMD ones */
+#define REFERENCE_MODULE "i420_rgb"
+
+static const char *const modules[] = {
+    REFERENCE_MODULE,
+    "i420_rgb_sse2",
+    "i420_rgb_avx2",
+};
+#define NB_MODULES ARRAY_SIZE(modules)
+
+/* Inputs which must convert exactly like the I420 picture they derive from */
+static const vlc_fourcc_t inputs[] = {
+    VLC_CODEC_NV12,
+    VLC_CODEC_NV21,
+    VLC_CODEC_I420_10L,
+    VLC_CODEC_P010,
+};
+#define NB_INPUTS ARRAY_SIZE(inputs)
+
+static const vlc_fourcc_t outputs[] = {
+    VLC_CODEC_XRGB,
+    VLC_CODEC_RGBX,
+    VLC_CODEC_BGRX,
+    VLC_CODEC_XBGR,
+    VLC_CODEC_RGB565,
+    VLC_CODEC_RGB555,
+};
+#define NB_OUTPUTS ARRAY_SIZE(outputs)
+
+/* Largest difference of a 8-bit component between the SIMD converters and
+ * the table based C converter, which does not expand the video range */
+#define MAX_DIFF 20
+
+/* The converters need even output dimensions, and scale the input to other
+ * sizes by width instead of pitch: only compare unscaled conversions, with
+ * widths which are not a multiple of the SIMD width and padded pitches. */
+struct test_size
+{
+    unsigned i_width;
+    unsigned i_height;
+    unsigned i_pad; /* samples added to the pitch of every plane */
+};
+
+static const struct test_size sizes[] = {
+    { 32, 2, 0 },
+    { 34, 18, 7 },
+    { 90, 62, 13 },
+    { 320, 240, 0 },
+    { 322, 6, 1 },
+    { 1922, 4, 3 },
+};
+#define NB_SIZES ARRAY_SIZE(sizes)
+
+static vlc_object_t *parent;
+
+static void pic_rsc_destroy(picture_t *pic)
+{
+    for (int i = 0; i < pic->i_planes; i++)
+        free(pic->p[i].p_pixels);
+}
+
+/* Allocates a picture with the given extra pitch, not aligned on purpose */
+static picture_t *NewPicture(const video_format_t *fmt, unsigned pad)
+{
+    const vlc_chroma_description_t *dsc =
+        vlc_fourcc_GetChromaDescription(fmt->i_chroma);
+    assert(dsc != NULL);
+
+    picture_resource_t rsc = { .pf_destroy = pic_rsc_destroy };
+    for (unsigned i = 0; i < dsc->plane_count; i++)
+    {
+        rsc.p[i].i_lines = (fmt->i_height + dsc->p[i].h.den - 1)
+                         / dsc->p[i].h.den * dsc->p[i].h.num;
+        rsc.p[i].i_pitch = ((fmt->i_width + dsc->p[i].w.den - 1)
+                          / dsc->p[i].w.den * dsc->p[i].w.num + pad)
+                         * dsc->pixel_size;
+        rsc.p[i].p_pixels = calloc(rsc.p[i].i_lines, rsc.p[i].i_pitch);
+        assert(rsc.p[i].p_pixels != NULL);
+    }
+
+    picture_t *pic = picture_NewFromResource(fmt, &rsc);
+    assert(pic != NULL);
+    return pic;
+}
+
+static picture_t *NewOutput(filter_t *filter)
+{
+    const struct test_size *size = filter->owner.sys;
+
+    return NewPicture(&filter->fmt_out.video, size->i_pad);
+}
+
+static const struct filter_video_callbacks output_cbs = {
+    .buffer_new = NewOutput,
+};
+
+static filter_t *CreateConverter(const char *module, vlc_fourcc_t in,
+                                 vlc_fourcc_t out,
+                                 const struct test_size *size)
+{
+    filter_t *filter = vlc_object_create(parent, sizeof (*filter));
+    assert(filter != NULL);
+
+    video_format_t fmt;
+    video_format_Init(&fmt, in);
+    video_format_Setup(&fmt, in, size->i_width, size->i_height,
+                       size->i_width, size->i_height, 1, 1);
+    es_format_InitFromVideo(&filter->fmt_in, &fmt);
+    video_format_Setup(&fmt, out, size->i_width, size->i_height,
+                       size->i_width, size->i_height, 1, 1);
+    es_format_InitFromVideo(&filter->fmt_out, &fmt);
+    video_format_Clean(&fmt);
+
+    filter->owner.video = &output_cbs;
+    filter->owner.sys = (void *)size;
+
+    if (vlc_filter_LoadModule(filter, "video converter", module, true) == NULL)
+    {
+        es_format_Clean(&filter->fmt_in);
+        es_format_Clean(&filter->fmt_out);
+        vlc_object_delete(filter);
+        return NULL;
+    }
+    return filter;
+}
+
+static void DeleteConverter(filter_t *filter)
+{
+    vlc_filter_UnloadModule(filter);
+    es_format_Clean(&filter->fmt_in);
+    es_format_Clean(&filter->fmt_out);
+    vlc_object_delete(filter);
+}
+
+static picture_t *Convert(filter_t *filter, picture_t *src)
+{
+    picture_t *dst = filter->ops->filter_video(filter, picture_Hold(src));
+    assert(dst != NULL);
+    return dst;
+}
+
+/* Creates a picture of the given chroma holding the samples of an 8-bit
+ * planar picture; the extra bits of 10-bit formats are set to noise, which
+ * the conversion must drop. */
+static picture_t *NewInput(const picture_t *ref, vlc_fourcc_t chroma,
+                           unsigned pad)
+{
+    video_format_t fmt = ref->format;
+    fmt.i_chroma = chroma;
+
+    picture_t *pic = NewPicture(&fmt, pad);
+    const unsigned lines_c = ref->p[U_PLANE].i_lines;
+    const unsigned width_c = ref->p[U_PLANE].i_pitch - pad;
+
+    switch (chroma)
+    {
+        case VLC_CODEC_I420:
+            for (int i = 0; i < 3; i++)
+                for (int y = 0; y < ref->p[i].i_lines; y++)
+                    memcpy(&pic->p[i].p_pixels[y * pic->p[i].i_pitch],
+                           &ref->p[i].p_pixels[y * ref->p[i].i_pitch],
+                           ref->p[i].i_pitch);
+            break;
+
+        case VLC_CODEC_NV12:
+        case VLC_CODEC_NV21:
+        {
+            const int u = chroma == VLC_CODEC_NV21;
+
+            for (int y = 0; y < ref->p[Y_PLANE].i_lines; y++)
+                memcpy(&pic->p[0].p_pixels[y * pic->p[0].i_pitch],
+                       &ref->p[Y_PLANE].p_pixels[y * ref->p[Y_PLANE].i_pitch],
+                       ref->p[Y_PLANE].i_pitch);
+            for (unsigned y = 0; y < lines_c; y++)
+            {
+                uint8_t *p = &pic->p[1].p_pixels[y * pic->p[1].i_pitch];
+
+                for (unsigned x = 0; x < width_c; x++)
+                {
+                    p[2 * x + u] = ref->p[U_PLANE].p_pixels[y * ref->p[U_PLANE].i_pitch + x];
+                    p[2 * x + !u] = ref->p[V_PLANE].p_pixels[y * ref->p[V_PLANE].i_pitch + x];
+                }
+            }
+            break;
+        }
+
+        case VLC_CODEC_I420_10L:
+            for (int i = 0; i < 3; i++)
+                for (int y = 0; y < ref->p[i].i_lines; y++)
+                {
+                    uint16_t *p = (uint16_t *)&pic->p[i].p_pixels[y * pic->p[i].i_pitch];
+                    const uint8_t *s = &ref->p[i].p_pixels[y * ref->p[i].i_pitch];
+
+                    for (int x = 0; x < ref->p[i].i_pitch - (int)pad; x++)
+                        p[x] = (s[x] << 2) | (rand() & 0x3);
+                }
+            break;
+
+        case VLC_CODEC_P010:
+            for (int y = 0; y < ref->p[Y_PLANE].i_lines; y++)
+            {
+                uint16_t *p = (uint16_t *)&pic->p[0].p_pixels[y * pic->p[0].i_pitch];
+                const uint8_t *s = &ref->p[Y_PLANE].p_pixels[y * ref->p[Y_PLANE].i_pitch];
+
+                for (int x = 0; x < ref->p[Y_PLANE].i_pitch - (int)pad; x++)
+                    p[x] = (s[x] << 8) | (rand() & 0xc0);
+            }
+            for (unsigned y = 0; y < lines_c; y++)
+            {
+                uint16_t *p = (uint16_t *)&pic->p[1].p_pixels[y * pic->p[1].i_pitch];
+
+                for (unsigned x = 0; x < width_c; x++)
+                {
+                    p[2 * x] = (ref->p[U_PLANE].p_pixels[y * ref->p[U_PLANE].i_pitch + x] << 8)
+                             | (rand() & 0xc0);
+                    p[2 * x + 1] = (ref->p[V_PLANE].p_pixels[y * ref->p[V_PLANE].i_pitch + x] << 8)
+                                 | (rand() & 0xc0);
+                }
+            }
+            break;
+
+        default:
+            vlc_assert_unreachable();
+    }
+    return pic;
+}
+
+static picture_t *NewReference(const struct test_size *size)
+{
+    video_format_t fmt;
+
+    video_format_Init(&fmt, VLC_CODEC_I420);
+    video_format_Setup(&fmt, VLC_CODEC_I420, size->i_width, size->i_height,
+                       size->i_width, size->i_height, 1, 1);
+
+    /* Keep to the video range: the C tables are not meant for samples out of
+     * range, which do not convert the same way in all converters. */
+    picture_t *pic = NewPicture(&fmt, size->i_pad);
+    for (int i = 0; i < pic->i_planes; i++)
+        for (int j = 0; j < pic->p[i].i_lines * pic->p[i].i_pitch; j++)
+            pic->p[i].p_pixels[j] = 16 + rand() % (i == Y_PLANE ? 220 : 225);
+    return pic;
+}
+
+static size_t PixelSize(vlc_fourcc_t chroma)
+{
+    const vlc_chroma_description_t *dsc =
+        vlc_fourcc_GetChromaDescription(chroma);
+    assert(dsc != NULL);
+    return dsc->pixel_size;
+}
+
+static void CheckSame(const picture_t *a, const picture_t *b)
+{
+    const size_t line = a->format.i_visible_width
+                      * PixelSize(a->format.i_chroma);
+
+    for (unsigned y = 0; y < a->format.i_visible_height; y++)
+        assert(!memcmp(&a->p[0].p_pixels[y * a->p[0].i_pitch],
+                       &b->p[0].p_pixels[y * b->p[0].i_pitch], line));
+}
+
+static void CheckClose(const picture_t *a, const picture_t *b)
+{
+    const size_t line = a->format.i_visible_width
+                      * PixelSize(a->format.i_chroma);
+
+    for (unsigned y = 0; y < a->format.i_visible_height; y++)
+    {
+        const uint8_t *pa = &a->p[0].p_pixels[y * a->p[0].i_pitch];
+        const uint8_t *pb = &b->p[0].p_pixels[y * b->p[0].i_pitch];
+
+        for (size_t x = 0; x < line; x++)
+            if (abs(pa[x] - pb[x]) > MAX_DIFF)
+            {
+                fprintf(stderr, "error: %u x %zu: 0x%02X vs 0x%02X\n",
+                        y, x, pa[x], pb[x]);
+                assert(!"pixel doesn't match");
+            }
+    }
+}
+
+static void test_size(const struct test_size *size)
+{
+    picture_t *ref = NewReference(size);
+    picture_t *srcs[NB_INPUTS];
+
+    for (size_t i = 0; i < NB_INPUTS; i++)
+        srcs[i] = NewInput(ref, inputs[i], size->i_pad);
+
+    for (size_t o = 0; o < NB_OUTPUTS; o++)
+    {
+        picture_t *plain = NULL, *simd = NULL;
+
+        for (size_t m = 0; m < NB_MODULES; m++)
+        {
+            filter_t *filter = CreateConverter(modules[m], VLC_CODEC_I420,
+                                               outputs[o], size);
+            if (filter == NULL)
+                continue;
+
+            fprintf(stderr, "testing: %s %ux%u (pad %u) -> %4.4s\n",
+                    modules[m], size->i_width, size->i_height, size->i_pad,
+                    (const char *)&outputs[o]);
+
+            picture_t *dst = Convert(filter, ref);
+            DeleteConverter(filter);
+
+            if (!strcmp(modules[m], REFERENCE_MODULE))
+                plain = picture_Hold(dst);
+            else if (simd == NULL)
+            {
+                /* The C tables do not rescale the video range, and the
+                 * 16-bit C output is not rounded the same way */
+                if (plain != NULL && PixelSize(outputs[o]) == 4)
+                    CheckClose(plain, dst);
+                simd = picture_Hold(dst);
+            }
+            else /* all the SIMD converters share the same arithmetic */
+                CheckSame(simd, dst);
+
+            for (size_t i = 0; i < NB_INPUTS; i++)
+            {
+                filter = CreateConverter(modules[m], inputs[i], outputs[o],
+                                         size);
+                if (filter == NULL)
+                    continue;
+
+                picture_t *other = Convert(filter, srcs[i]);
+                DeleteConverter(filter);
+                CheckSame(dst, other);
+                picture_Release(other);
+            }
+            picture_Release(dst);
+        }
+        if (plain != NULL)
+            picture_Release(plain);
+        if (simd != NULL)
+            picture_Release(simd);
+    }
+
+    for (size_t i = 0; i < NB_INPUTS; i++)
+        picture_Release(srcs[i]);
+    picture_Release(ref);
+}
+
+/* Reports the conversion rate of each converter, in frames per second */
+static void bench(void)
+{
+    static const struct test_size hd = { 1920, 1080, 0 };
+    static const vlc_fourcc_t chromas[] = {
+        VLC_CODEC_I420, VLC_CODEC_NV12, VLC_CODEC_P010,
+    };
+    picture_t *ref = NewReference(&hd);
+
+    for (size_t c = 0; c < ARRAY_SIZE(chromas); c++)
+    {
+        picture_t *src = NewInput(ref, chromas[c], hd.i_pad);
+
+        for (size_t m = 0; m < NB_MODULES; m++)
+        {
+            filter_t *filter = CreateConverter(modules[m], chromas[c],
+                                               VLC_CODEC_XRGB, &hd);
+            if (filter == NULL)
+                continue;
+
+            unsigned count = 0;
+            vlc_tick_t start = vlc_tick_now(), elapsed;
+            do
+            {
+                picture_Release(Convert(filter, src));
+                count++;
+                elapsed = vlc_tick_now() - start;
+            }
+            while (elapsed < VLC_TICK_FROM_MS(100));
+
+            fprintf(stderr, "bench: %s %4.4s -> XRGB 1080p: %.1f fps\n",
+                    modules[m], (const char *)&chromas[c],
+                    count / secf_from_vlc_tick(elapsed));
+            DeleteConverter(filter);
+        }
+        picture_Release(src);
+    }
+    picture_Release(ref);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs,
+                                        test_defaults_args);
+    assert(vlc != NULL);
+    parent = VLC_OBJECT(vlc->p_libvlc_int);
+
+    if (!module_exists(REFERENCE_MODULE))
+    {
+        libvlc_release(vlc);
+        return 77;
+    }
+
+    srand(42);
+    for (size_t i = 0; i < NB_SIZES; i++)
+        test_size(&sizes[i]);
+
+    bench();
+
+    libvlc_release(vlc);
+    return 0;
+}
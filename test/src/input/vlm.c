@@ -0,0 +1,110 @@
+/*****************************************************************************
+ * vlm.c: VLM shared input unit test
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_vlm.h>
+#include "../../../lib/libvlc_internal.h"
+#include "../../../src/input/vlm_internal.h"
+#include "../../libvlc/test.h"
+
+#include <vlc/vlc.h>
+
+#define MOCK_LONG "mock://video_track_count=1;audio_track_count=0;" \
+                  "length=3600000000"
+#define MOCK_OTHER MOCK_LONG ";video_width=320"
+
+static void Execute(vlm_t *vlm, const char *cmd)
+{
+    vlm_message_t *msg = NULL;
+
+    test_log("%s\n", cmd);
+    int ret = vlm_ExecuteCommand(vlm, cmd, &msg);
+    assert(ret == VLC_SUCCESS);
+    vlm_MessageDelete(msg);
+}
+
+/* Checks the number of shared sources and the references of the first one */
+static void CheckSources(vlm_t *vlm, int count, unsigned refs)
+{
+    vlc_mutex_lock(&vlm->lock);
+    assert(vlm->i_source == count);
+    if (count > 0)
+        assert(vlm->source[0]->refs == refs);
+    vlc_mutex_unlock(&vlm->lock);
+}
+
+int main(void)
+{
+    test_init();
+
+    const char *argv[test_defaults_nargs + 1];
+    for (int i = 0; i < test_defaults_nargs; i++)
+        argv[i] = test_defaults_args[i];
+    argv[test_defaults_nargs] = "--vlm-share-input";
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs + 1, argv);
+    assert(vlc != NULL);
+
+    vlm_t *vlm = vlm_New(vlc->p_libvlc_int, NULL);
+    assert(vlm != NULL);
+
+    Execute(vlm, "new a broadcast enabled input " MOCK_LONG " output #dummy");
+    Execute(vlm, "new b broadcast enabled input " MOCK_LONG " output #dummy");
+    Execute(vlm, "new c broadcast enabled input " MOCK_OTHER " output #dummy");
+    CheckSources(vlm, 0, 0);
+
+    /* The same input is read once, whatever the number of subscribers */
+    Execute(vlm, "control a play");
+    CheckSources(vlm, 1, 1);
+    Execute(vlm, "control b play");
+    CheckSources(vlm, 1, 2);
+
+    /* Another input gets its own source */
+    Execute(vlm, "control c play");
+    CheckSources(vlm, 2, 2);
+
+    /* Restarting an instance does not leak a reference */
+    Execute(vlm, "control a play");
+    CheckSources(vlm, 2, 2);
+
+    Execute(vlm, "control a stop");
+    CheckSources(vlm, 2, 1);
+    Execute(vlm, "control b stop");
+    CheckSources(vlm, 1, 1);
+    Execute(vlm, "control c stop");
+    CheckSources(vlm, 0, 0);
+
+    /* A stopped source is not reused */
+    Execute(vlm, "control b play");
+    CheckSources(vlm, 1, 1);
+    Execute(vlm, "del b");
+    CheckSources(vlm, 0, 0);
+
+    vlm_Delete(vlm);
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,253 @@
+/*****************************************************************************
+ * thumbnail_sheet.c: test thumbnail sheet API
+ *****************************************************************************
+ * Copyright (C) 2025 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_preparser.h>
+#include <vlc_input_item.h>
+#include <vlc_picture.h>
+
+#include <errno.h>
+
+#define MOCK_WIDTH 640
+#define MOCK_HEIGHT 480
+#define MOCK_DURATION VLC_TICK_FROM_SEC( 5 * 60 )
+
+#define STRINGIFY_(x) #x
+#define STRINGIFY(x) STRINGIFY_(x)
+#define MOCK_URL "mock://video_track_count=1;length=300000000;" \
+                 "video_width="STRINGIFY(MOCK_WIDTH)";" \
+                 "video_height="STRINGIFY(MOCK_HEIGHT)
+
+static const vlc_tick_t test_times[] = {
+    VLC_TICK_FROM_SEC( 10 ), VLC_TICK_FROM_SEC( 200 ), VLC_TICK_FROM_SEC( 100 ),
+};
+
+static const double test_positions[] = { .1, .9 };
+
+static const struct test_entry
+{
+    struct vlc_thumbnailer_sheet_arg arg;
+    size_t expected_thumbnails;
+    unsigned expected_tile_width;
+    unsigned expected_tile_height;
+    unsigned expected_sheet_width; /* 0 if no sheet is expected */
+    unsigned expected_sheet_height;
+} test_entries[] = {
+    /* 4 evenly spaced points in a 2x2 sheet, height from the aspect ratio */
+    {
+        .arg = {
+            .points = { .type = VLC_THUMBNAILER_POINTS_SPACED, .count = 4 },
+            .tile_width = 160, .tiled = true,
+        },
+        .expected_thumbnails = 4,
+        .expected_tile_width = 160, .expected_tile_height = 120,
+        .expected_sheet_width = 320, .expected_sheet_height = 240,
+    },
+    /* Unsorted times on a single row, not scaled */
+    {
+        .arg = {
+            .points = { .type = VLC_THUMBNAILER_POINTS_TIME,
+                        .times = test_times, .count = ARRAY_SIZE(test_times) },
+            .columns = 3, .tiled = true,
+        },
+        .expected_thumbnails = 3,
+        .expected_tile_width = MOCK_WIDTH, .expected_tile_height = MOCK_HEIGHT,
+        .expected_sheet_width = 3 * MOCK_WIDTH,
+        .expected_sheet_height = MOCK_HEIGHT,
+    },
+    /* Separate key frames, width from the aspect ratio */
+    {
+        .arg = {
+            .points = { .type = VLC_THUMBNAILER_POINTS_POS,
+                        .positions = test_positions,
+                        .count = ARRAY_SIZE(test_positions) },
+            .tile_height = 96, .keyframes_only = true,
+        },
+        .expected_thumbnails = 2,
+        .expected_tile_width = 128, .expected_tile_height = 96,
+    },
+};
+
+struct test_ctx
+{
+    vlc_cond_t cond;
+    vlc_mutex_t lock;
+    const struct test_entry *entry;
+    size_t thumbnail_count;
+    bool b_done;
+};
+
+static void on_thumbnail( vlc_preparser_req *req, size_t index,
+                          picture_t *thumbnail, void *data )
+{
+    (void) req;
+    struct test_ctx *ctx = data;
+    const struct test_entry *entry = ctx->entry;
+
+    vlc_mutex_lock( &ctx->lock );
+    assert( index == ctx->thumbnail_count );
+    assert( index < entry->arg.points.count );
+    assert( thumbnail != NULL );
+    assert( thumbnail->format.i_visible_width == entry->expected_tile_width );
+    assert( thumbnail->format.i_visible_height == entry->expected_tile_height );
+    ctx->thumbnail_count++;
+    vlc_mutex_unlock( &ctx->lock );
+}
+
+static void on_ended( vlc_preparser_req *req, int status, picture_t *sheet,
+                      void *data )
+{
+    struct test_ctx *ctx = data;
+    const struct test_entry *entry = ctx->entry;
+
+    vlc_mutex_lock( &ctx->lock );
+    assert( status == VLC_SUCCESS );
+    assert( ctx->thumbnail_count == entry->expected_thumbnails );
+    if ( entry->expected_sheet_width != 0 )
+    {
+        assert( sheet != NULL );
+        assert( sheet->format.i_visible_width == entry->expected_sheet_width );
+        assert( sheet->format.i_visible_height == entry->expected_sheet_height );
+    }
+    else
+        assert( sheet == NULL );
+
+    ctx->b_done = true;
+    vlc_cond_signal( &ctx->cond );
+    vlc_mutex_unlock( &ctx->lock );
+    vlc_preparser_req_Release( req );
+}
+
+static void test_sheets( libvlc_instance_t *p_vlc )
+{
+    struct test_ctx ctx;
+    vlc_cond_init( &ctx.cond );
+    vlc_mutex_init( &ctx.lock );
+
+    const struct vlc_preparser_cfg cfg = {
+        .types = VLC_PREPARSER_TYPE_THUMBNAIL_SHEET,
+        .timeout = VLC_TICK_FROM_SEC( 20 ),
+    };
+    vlc_preparser_t *p_thumbnailer = vlc_preparser_New(
+                VLC_OBJECT( p_vlc->p_libvlc_int ), &cfg );
+    assert( p_thumbnailer != NULL );
+
+    input_item_t *p_item = input_item_New( MOCK_URL, "mock item" );
+    assert( p_item != NULL );
+
+    static const struct vlc_thumbnailer_sheet_cbs cbs = {
+        .on_thumbnail = on_thumbnail,
+        .on_ended = on_ended,
+    };
+
+    for ( size_t i = 0; i < ARRAY_SIZE(test_entries); ++i )
+    {
+        ctx.entry = &test_entries[i];
+        ctx.thumbnail_count = 0;
+        ctx.b_done = false;
+
+        vlc_mutex_lock( &ctx.lock );
+
+        vlc_preparser_req *req =
+            vlc_preparser_GenerateThumbnailSheet( p_thumbnailer, p_item,
+                                                  &test_entries[i].arg,
+                                                  NULL, 0, &cbs, &ctx );
+        assert( req != NULL );
+
+        while ( ctx.b_done == false )
+            vlc_cond_wait( &ctx.cond, &ctx.lock );
+
+        vlc_mutex_unlock( &ctx.lock );
+    }
+
+    input_item_Release( p_item );
+    vlc_preparser_Delete( p_thumbnailer );
+}
+
+static void on_ended_cancel( vlc_preparser_req *req, int status,
+                             picture_t *sheet, void *data )
+{
+    assert( sheet == NULL );
+    assert( status == -EINTR );
+
+    vlc_sem_t *sem = data;
+    vlc_sem_post( sem );
+    vlc_preparser_req_Release( req );
+}
+
+static void test_cancel_sheet( libvlc_instance_t *p_vlc )
+{
+    const struct vlc_preparser_cfg cfg = {
+        .types = VLC_PREPARSER_TYPE_THUMBNAIL_SHEET,
+        .timeout = VLC_TICK_INVALID,
+    };
+    vlc_preparser_t *p_thumbnailer = vlc_preparser_New(
+                VLC_OBJECT( p_vlc->p_libvlc_int ), &cfg );
+    assert( p_thumbnailer != NULL );
+
+    /* No video: the request would never end without being cancelled */
+    const char *psz_mrl = "mock://video_track_count=0;audio_track_count=1;"
+                          "can_control_pace=false;length=20000000";
+    input_item_t *p_item = input_item_New( psz_mrl, "mock item" );
+    assert( p_item != NULL );
+
+    static const struct vlc_thumbnailer_sheet_cbs cbs = {
+        .on_ended = on_ended_cancel,
+    };
+    const struct vlc_thumbnailer_sheet_arg arg = {
+        .points = { .type = VLC_THUMBNAILER_POINTS_SPACED, .count = 9 },
+        .tiled = true,
+    };
+
+    vlc_sem_t sem;
+    vlc_sem_init( &sem, 0 );
+    vlc_preparser_req *req =
+        vlc_preparser_GenerateThumbnailSheet( p_thumbnailer, p_item, &arg,
+                                              NULL, 0, &cbs, &sem );
+    assert( req != NULL );
+
+    vlc_preparser_Cancel( p_thumbnailer, req );
+
+    vlc_sem_wait( &sem );
+
+    input_item_Release( p_item );
+
+    vlc_preparser_Delete( p_thumbnailer );
+}
+
+int main( void )
+{
+    test_init();
+
+    static const char * argv[] = {
+        "-v",
+        "--ignore-config",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(argv), argv);
+    assert(vlc);
+
+    test_sheets( vlc );
+    test_cancel_sheet( vlc );
+
+    libvlc_release( vlc );
+}